@@ -78,6 +78,7 @@ AudioSystem::~AudioSystem() noexcept {
         bool done_cleanup = false;
         do {
             std::this_thread::yield();
+            DeactivateFinishedChannels();
             std::scoped_lock<std::mutex> lock(_cs);
             done_cleanup = _active_channels.empty();
         } while(!done_cleanup);
@@ -233,7 +234,7 @@ AudioDSPResults AudioSystem::CalculateDSP(const Audio3DEmitter& emitter, const A
 }
 
 void AudioSystem::BeginFrame() noexcept {
-    /* DO NOTHING */
+    DeactivateFinishedChannels();
 }
 
 void AudioSystem::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
@@ -292,6 +293,13 @@ void AudioSystem::RegisterWavFilesFromFolder(std::filesystem::path folderpath, b
     FileUtils::ForEachFileInFolder(folderpath, ".wav", cb, recursive);
 }
 
+void AudioSystem::DeactivateFinishedChannels() noexcept {
+    Channel* channel = nullptr;
+    while(_finished_channels.try_pop(channel)) {
+        DeactivateChannel(*channel);
+    }
+}
+
 void AudioSystem::DeactivateChannel(Channel& channel) noexcept {
     std::scoped_lock<std::mutex> lock(_cs);
     const auto found_iter = std::find_if(std::begin(_active_channels), std::end(_active_channels),
@@ -454,7 +462,10 @@ void STDMETHODCALLTYPE AudioSystem::Channel::VoiceCallback::OnBufferEnd(void* pB
     channel.Stop();
     channel._sound->RemoveChannel(&channel);
     channel._sound = nullptr;
-    channel._audio_system->DeactivateChannel(channel);
+    //Runs on the XAudio2 thread; hand the channel to the game thread instead of contending for _cs here.
+    if(!channel._audio_system->_finished_channels.try_push(&channel)) {
+        channel._audio_system->DeactivateChannel(channel);
+    }
 }
 
 void STDMETHODCALLTYPE AudioSystem::Channel::VoiceCallback::OnLoopEnd(void* pBufferContext) {
@@ -11,6 +11,7 @@
 
 #include "Engine/Core/EngineSubsystem.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/LockFreeQueue.hpp"
 #include "Engine/Platform/Win.hpp"
 
 #include "Engine/Services/IAudioService.hpp"
@@ -206,6 +207,7 @@ private:
     void InitializeAudioSystem() noexcept;
 
     void DeactivateChannel(Channel& channel) noexcept;
+    void DeactivateFinishedChannels() noexcept;
 
     void EmitterListenerDSP_worker() noexcept;
 
@@ -231,4 +233,6 @@ private:
     AudioDSPSettings _dsp_settings{};
     std::atomic_bool _is_running{false};
     std::condition_variable _signal{};
+    //Channels whose buffers ended, pushed from the XAudio2 callback thread and recycled on the game thread.
+    MpscQueue<Channel*, 1024> _finished_channels{};
 };
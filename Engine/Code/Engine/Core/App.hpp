@@ -2,21 +2,28 @@
 
 #include "Engine/Audio/AudioSystem.hpp"
 
+#include "Engine/Core/ArgumentParser.hpp"
 #include "Engine/Core/Config.hpp"
 #include "Engine/Core/Console.hpp"
 #include "Engine/Core/EngineConfig.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/EngineSubsystem.hpp"
 #include "Engine/Core/FileLogger.hpp"
+#include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/KeyValueParser.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/TaskGraph.hpp"
 #include "Engine/Core/TimeUtils.hpp"
 
 #include "Engine/Input/InputSystem.hpp"
 
+#include "Engine/Memory/FrameArena.hpp"
+
 #include "Engine/Physics/PhysicsSystem.hpp"
+#include "Engine/Profiling/AllocationProfiler.hpp"
 #include "Engine/Profiling/AllocationTracker.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Window.hpp"
@@ -41,6 +48,7 @@
 #include <condition_variable>
 #include <iomanip>
 #include <memory>
+#include <sstream>
 
 template<typename T>
 class App : public EngineSubsystem, public IAppService {
@@ -76,6 +84,11 @@ private:
 
     void SetupEngineSystemPointers();
     void SetupEngineSystemChainOfResponsibility();
+    void SetupFrameGraph() noexcept;
+    void RegisterFrameGraphCommands() noexcept;
+    void SetupAllocationProfiler() noexcept;
+    void SetupProfiler() noexcept;
+    void WriteProfileCapture() noexcept;
 
     void Initialize() noexcept override;
     void BeginFrame() noexcept override;
@@ -95,6 +108,9 @@ private:
 
     std::string _title{"UNTITLED GAME"};
 
+    TaskGraph _frameGraph{};
+    std::filesystem::path _profileCapturePath{};
+
     std::unique_ptr<JobSystem> _theJobSystem{};
     std::unique_ptr<FileLogger> _theFileLogger{};
     std::unique_ptr<Config> _theConfig{};
@@ -238,6 +254,166 @@ void App<T>::Initialize() noexcept {
     g_theAudioSystem->Initialize();
     g_thePhysicsSystem->Initialize();
     g_theGame->Initialize();
+
+    SetupFrameGraph();
+    RegisterFrameGraphCommands();
+    SetupAllocationProfiler();
+    SetupProfiler();
+}
+
+template<typename T>
+void App<T>::SetupFrameGraph() noexcept {
+    //Resources name what a stage touches; see TaskGraph for how ordering is inferred from them.
+    //Anything that calls ImGui, Win32 or the immediate context stays on the main thread.
+    _frameGraph.Clear();
+    _frameGraph.AddStage({"input.update", {}, {"input"}, TaskAffinity::MainThread}, [](TimeUtils::FPSeconds deltaSeconds) { g_theInputSystem->Update(deltaSeconds); });
+    _frameGraph.AddStage({"ui.update", {"input"}, {"ui"}, TaskAffinity::MainThread}, [](TimeUtils::FPSeconds deltaSeconds) { g_theUISystem->Update(deltaSeconds); });
+    _frameGraph.AddStage({"console.update", {"input"}, {"console"}, TaskAffinity::MainThread}, [](TimeUtils::FPSeconds deltaSeconds) { g_theConsole->Update(deltaSeconds); });
+    _frameGraph.AddStage({"audio.update", {}, {"audio"}}, [](TimeUtils::FPSeconds deltaSeconds) { g_theAudioSystem->Update(deltaSeconds); });
+    _frameGraph.AddStage({"physics.update", {"renderer"}, {"physics"}}, [](TimeUtils::FPSeconds deltaSeconds) { g_thePhysicsSystem->Update(deltaSeconds); });
+    _frameGraph.AddStage({"game.update", {"input", "ui", "console"}, {"game", "physics", "audio", "renderer"}, TaskAffinity::MainThread}, [](TimeUtils::FPSeconds deltaSeconds) { g_theGame->Update(deltaSeconds); });
+    g_theGame->RegisterFrameStages(_frameGraph);
+    _frameGraph.AddStage({"renderer.update", {}, {"renderer"}, TaskAffinity::MainThread}, [](TimeUtils::FPSeconds deltaSeconds) { g_theRenderer->Update(deltaSeconds); });
+    _frameGraph.AddStage({"render", {"input", "ui", "console", "audio", "physics", "game", "renderer"}, {"frame"}, TaskAffinity::MainThread}, [this](TimeUtils::FPSeconds /*deltaSeconds*/) { Render(); });
+}
+
+template<typename T>
+void App<T>::RegisterFrameGraphCommands() noexcept {
+    Console::Command framegraph{};
+    framegraph.command_name = "framegraph";
+    framegraph.help_text_short = "Displays the stages of the last frame with their timings.";
+    framegraph.help_text_long = "framegraph: Displays every frame stage with start time, duration, priority, thread and dependencies. Stages on the critical path are marked with '*'. The same table is written to the log.";
+    framegraph.command_function = [this](const std::string& /*args*/) -> void {
+        std::ostringstream ss;
+        _frameGraph.DumpLastFrame(ss);
+        g_theFileLogger->LogLineAndFlush(ss.str());
+        std::istringstream lines(ss.str());
+        for(std::string line{}; std::getline(lines, line);) {
+            g_theConsole->PrintMsg(line);
+        }
+    };
+    g_theConsole->RegisterCommand(framegraph);
+}
+
+template<typename T>
+void App<T>::SetupAllocationProfiler() noexcept {
+#if defined(PROFILE_BUILD) && defined(TRACK_MEMORY)
+    //Verbose tracking attributes every allocation; otherwise sample so it can stay on.
+    AllocationProfiler::SetSampleInterval(TRACK_MEMORY == TRACK_MEMORY_VERBOSE ? 1u : 128u);
+    AllocationTracker::trace(true);
+#endif
+    Console::Command memprofile{};
+    memprofile.command_name = "memprofile";
+    memprofile.help_text_short = "Displays the call sites that allocate the most memory.";
+    memprofile.help_text_long = "memprofile [top count|dump filename|rate interval|reset|on|off]: Displays the top allocating call sites of the last frame and since the last reset (default 10). 'dump' writes every call site with its size-class histogram to a file in the log folder for diffing between builds. 'rate' records every Nth allocation per thread.";
+    memprofile.command_function = [](const std::string& args) -> void {
+        ArgumentParser arg_set(args);
+        std::string subcommand{};
+        auto top_count = 10u;
+        if(arg_set >> subcommand) {
+            subcommand = StringUtils::TrimWhitespace(subcommand);
+            if(subcommand == "on" || subcommand == "off") {
+                AllocationTracker::trace(subcommand == "on");
+                g_theConsole->PrintMsg(std::string{"Allocation profiling "} + (AllocationTracker::is_tracing() ? "on." : "off."));
+                return;
+            } else if(subcommand == "reset") {
+                AllocationProfiler::Reset();
+                return;
+            } else if(subcommand == "rate") {
+                auto interval = 1u;
+                if(arg_set >> interval) {
+                    AllocationProfiler::SetSampleInterval(interval);
+                }
+                g_theConsole->PrintMsg("Allocation sample interval: " + std::to_string(AllocationProfiler::GetSampleInterval()));
+                return;
+            } else if(subcommand == "dump") {
+                std::string filename{"allocations"};
+                if(arg_set >> filename) {
+                    filename = StringUtils::TrimWhitespace(filename);
+                }
+                const auto filepath = (FileUtils::GetKnownFolderPath(FileUtils::KnownPathID::GameLogs) / filename).replace_extension(".tsv");
+                if(AllocationProfiler::WriteToFile(filepath)) {
+                    g_theConsole->PrintMsg("Allocation profile written to " + filepath.string());
+                } else {
+                    g_theConsole->ErrorMsg("Could not write allocation profile to " + filepath.string());
+                }
+                return;
+            } else if(subcommand == "top") {
+                arg_set >> top_count;
+            }
+        }
+        if(!AllocationTracker::is_tracing()) {
+            g_theConsole->WarnMsg("Allocation profiling is off. Use 'memprofile on' in builds that track memory.");
+        }
+        std::ostringstream ss;
+        AllocationProfiler::DumpReport(ss, top_count);
+        g_theFileLogger->LogLineAndFlush(ss.str());
+        std::istringstream lines(ss.str());
+        for(std::string line{}; std::getline(lines, line);) {
+            g_theConsole->PrintMsg(line);
+        }
+    };
+    g_theConsole->RegisterCommand(memprofile);
+}
+
+template<typename T>
+void App<T>::SetupProfiler() noexcept {
+#ifdef PROFILE_BUILD
+    Profiler::SetThreadName("Main Thread");
+    Profiler::Enable(true);
+#endif
+    Console::Command profile{};
+    profile.command_name = "profile";
+    profile.help_text_short = "Displays the most expensive profiled scopes of the last frame.";
+    profile.help_text_long = "profile [top count|capture frames [filename]|on|off]: Displays call counts and inclusive/exclusive times of the last frame's scopes, most exclusive time first (default 20). 'capture' records every scope of the next N frames (default 60) and writes them to a Chrome trace-event file in the log folder.";
+    profile.command_function = [this](const std::string& args) -> void {
+        ArgumentParser arg_set(args);
+        std::string subcommand{};
+        auto top_count = 20u;
+        if(arg_set >> subcommand) {
+            subcommand = StringUtils::TrimWhitespace(subcommand);
+            if(subcommand == "on" || subcommand == "off") {
+                Profiler::Enable(subcommand == "on");
+                g_theConsole->PrintMsg(std::string{"Profiler "} + (Profiler::IsEnabled() ? "on." : "off."));
+                return;
+            } else if(subcommand == "capture") {
+                auto frame_count = 60u;
+                std::string filename{"profile"};
+                if(arg_set >> frame_count) {
+                    if(arg_set >> filename) {
+                        filename = StringUtils::TrimWhitespace(filename);
+                    }
+                }
+                _profileCapturePath = (FileUtils::GetKnownFolderPath(FileUtils::KnownPathID::GameLogs) / filename).replace_extension(".json");
+                Profiler::Enable(true);
+                Profiler::StartCapture(frame_count);
+                g_theConsole->PrintMsg("Capturing " + std::to_string(frame_count) + " frames.");
+                return;
+            } else if(subcommand == "top") {
+                arg_set >> top_count;
+            }
+        }
+        if(!Profiler::IsEnabled()) {
+            g_theConsole->WarnMsg("Profiler is off. Use 'profile on' in profile builds.");
+        }
+        std::ostringstream ss;
+        Profiler::DumpReport(ss, top_count);
+        g_theFileLogger->LogLineAndFlush(ss.str());
+        std::istringstream lines(ss.str());
+        for(std::string line{}; std::getline(lines, line);) {
+            g_theConsole->PrintMsg(line);
+        }
+    };
+    g_theConsole->RegisterCommand(profile);
+}
+
+template<typename T>
+void App<T>::WriteProfileCapture() noexcept {
+    if(Profiler::WriteChromeTrace(_profileCapturePath)) {
+        g_theConsole->PrintMsg("Profile capture written to " + _profileCapturePath.string());
+    } else {
+        g_theConsole->ErrorMsg("Could not write profile capture to " + _profileCapturePath.string());
+    }
 }
 
 template<typename T>
@@ -257,15 +433,10 @@ void App<T>::BeginFrame() noexcept {
     g_theRenderer->BeginFrame();
 }
 
+//Runs the update stages and render submission through the frame graph.
 template<typename T>
 void App<T>::Update(TimeUtils::FPSeconds deltaSeconds) noexcept {
-    g_theUISystem->Update(deltaSeconds);
-    g_theInputSystem->Update(deltaSeconds);
-    g_theConsole->Update(deltaSeconds);
-    g_theAudioSystem->Update(deltaSeconds);
-    g_thePhysicsSystem->Update(deltaSeconds);
-    g_theGame->Update(deltaSeconds);
-    g_theRenderer->Update(deltaSeconds);
+    _frameGraph.Execute(*g_theJobSystem, deltaSeconds);
 }
 
 template<typename T>
@@ -288,6 +459,10 @@ void App<T>::EndFrame() noexcept {
     g_theInputSystem->EndFrame();
     g_thePhysicsSystem->EndFrame();
     g_theRenderer->EndFrame();
+    if(Profiler::EndFrame()) {
+        WriteProfileCapture();
+    }
+    FrameArena::EndFrame();
 }
 
 template<typename T>
@@ -395,7 +570,6 @@ void App<T>::RunFrame() {
 #endif
 
     Update(deltaSeconds);
-    Render();
     EndFrame();
     AllocationTracker::tick();
 }
@@ -17,6 +17,7 @@
 #include <cstdio>
 #include <filesystem>
 #include <iostream>
+#include <iterator>
 
 namespace FS = std::filesystem;
 
@@ -36,17 +37,43 @@ void FileLogger::Log_worker() noexcept {
     auto& js = ServiceLocator::get<IJobSystemService>();
     js.SetCategorySignal(JobType::Logging, &_signal);
 
+    std::vector<std::string> batch{};
+    batch.reserve(_queue.capacity());
     while(IsRunning()) {
-        std::unique_lock<std::mutex> lock(_cs);
-        //Condition to wake up: not running or queue has jobs.
-        _signal.wait(lock, [this]() -> bool { return !_is_running || !_queue.empty(); });
-        if(!_queue.empty()) {
-            const std::string str = _queue.front();
-            _queue.pop();
+        {
+            std::unique_lock<std::mutex> lock(_cs);
+            _worker_sleeping = true;
+            //Pairs with the fence in WakeWorker: either the producer sees this flag or the predicate sees the message.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            //Condition to wake up: not running, queue has messages, a flush was requested or logging jobs are waiting.
+            _signal.wait(lock, [this, &jc]() -> bool { return !_is_running || !_queue.empty() || _requesting_flush || jc.HasJobs(); });
+            _worker_sleeping = false;
+        }
+        WriteQueuedMessages(batch);
+        RequestFlush();
+        jc.ConsumeAll();
+    }
+    WriteQueuedMessages(batch);
+    _stream.flush();
+}
+
+void FileLogger::WriteQueuedMessages(std::vector<std::string>& batch) noexcept {
+    batch.clear();
+    while(_queue.pop_bulk(std::back_inserter(batch), _queue.capacity())) {
+        for(const auto& str : batch) {
             _stream << str;
-            RequestFlush();
-            jc.ConsumeAll();
         }
+        batch.clear();
+    }
+}
+
+void FileLogger::WakeWorker() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_worker_sleeping) {
+        {
+            std::scoped_lock<std::mutex> lock(_cs);
+        }
+        _signal.notify_all();
     }
 }
 
@@ -183,11 +210,16 @@ void FileLogger::Shutdown() noexcept {
 }
 
 void FileLogger::Log(const std::string& msg) noexcept {
-    {
-        std::scoped_lock<std::mutex> lock(_cs);
-        _queue.push(msg);
+    auto str = msg;
+    //A full queue means the worker is behind; wake it and wait for room rather than dropping the message.
+    while(!_queue.try_push(std::move(str))) {
+        if(!_is_running) {
+            return;
+        }
+        WakeWorker();
+        std::this_thread::yield();
     }
-    _signal.notify_all();
+    WakeWorker();
 }
 
 void FileLogger::LogLine(const std::string& msg) noexcept {
@@ -257,6 +289,7 @@ void FileLogger::InsertMessage(std::stringstream& msg, const std::string& messag
 
 void FileLogger::Flush() noexcept {
     _requesting_flush = true;
+    WakeWorker();
     while(_requesting_flush) {
         std::this_thread::yield();
     }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/LockFreeQueue.hpp"
 #include "Engine/Services/IFileLoggerService.hpp"
 
 #include <atomic>
@@ -12,6 +12,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 class JobSystem;
 
@@ -52,6 +53,8 @@ private:
     void InsertMessage(std::stringstream& msg, const std::string& messageLiteral) noexcept;
 
     void Log_worker() noexcept;
+    void WriteQueuedMessages(std::vector<std::string>& batch) noexcept;
+    void WakeWorker() noexcept;
     void RequestFlush() noexcept;
     [[nodiscard]] bool IsRunning() const noexcept;
 
@@ -65,7 +68,8 @@ private:
     std::streambuf* _old_cout{};
     std::thread _worker{};
     std::condition_variable _signal{};
-    ThreadSafeQueue<std::string> _queue;
+    MpscQueue<std::string, 1024> _queue{};
     std::atomic_bool _is_running = false;
     std::atomic_bool _requesting_flush = false;
+    std::atomic_bool _worker_sleeping = false;
 };
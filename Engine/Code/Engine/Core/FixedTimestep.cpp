@@ -0,0 +1,51 @@
+#include "Engine/Core/FixedTimestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(float steps_per_second /*= 60.0f*/, int max_steps_per_frame /*= 4*/) noexcept {
+    SetStepsPerSecond(steps_per_second);
+    SetMaxStepsPerFrame(max_steps_per_frame);
+}
+
+void FixedTimestep::SetStepsPerSecond(float steps_per_second) noexcept {
+    _step = TimeUtils::FPSeconds{1.0f / (std::max)(1.0f, steps_per_second)};
+    _accumulated = TimeUtils::FPSeconds{std::fmod(_accumulated.count(), _step.count())};
+}
+
+void FixedTimestep::SetMaxStepsPerFrame(int max_steps_per_frame) noexcept {
+    _max_steps_per_frame = (std::max)(1, max_steps_per_frame);
+}
+
+int FixedTimestep::Advance(TimeUtils::FPSeconds frameSeconds) noexcept {
+    _accumulated += (std::max)(frameSeconds, TimeUtils::FPSeconds::zero());
+    auto steps = 0;
+    while(_step <= _accumulated && steps < _max_steps_per_frame) {
+        _accumulated -= _step;
+        ++steps;
+    }
+    if(_step <= _accumulated) {
+        _accumulated = TimeUtils::FPSeconds{std::fmod(_accumulated.count(), _step.count())};
+    }
+    return steps;
+}
+
+void FixedTimestep::Reset() noexcept {
+    _accumulated = TimeUtils::FPSeconds::zero();
+}
+
+TimeUtils::FPSeconds FixedTimestep::GetStepDuration() const noexcept {
+    return _step;
+}
+
+float FixedTimestep::GetAlpha() const noexcept {
+    return _accumulated / _step;
+}
+
+TimeUtils::FPSeconds FixedTimestep::GetAccumulatedTime() const noexcept {
+    return _accumulated;
+}
+
+void FixedTimestep::SetAccumulatedTime(TimeUtils::FPSeconds accumulated) noexcept {
+    _accumulated = TimeUtils::FPSeconds{std::fmod((std::max)(accumulated.count(), 0.0f), _step.count())};
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+//Turns variable frame times into a whole number of fixed-length steps.
+//The time left over after the last step is exposed as an interpolation factor for rendering.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(float steps_per_second = 60.0f, int max_steps_per_frame = 4) noexcept;
+
+    void SetStepsPerSecond(float steps_per_second) noexcept;
+    void SetMaxStepsPerFrame(int max_steps_per_frame) noexcept;
+
+    //Adds a frame's time and returns how many steps to run now, at most the per-frame maximum.
+    //Time beyond that is dropped; carrying it over would only make the next frame slower still.
+    [[nodiscard]] int Advance(TimeUtils::FPSeconds frameSeconds) noexcept;
+    void Reset() noexcept;
+
+    [[nodiscard]] TimeUtils::FPSeconds GetStepDuration() const noexcept;
+    //Fraction of a step accumulated since the last step ran, in [0, 1).
+    [[nodiscard]] float GetAlpha() const noexcept;
+    //Time carried towards the next step; saved and restored with physics snapshots so replays step on the same frames.
+    [[nodiscard]] TimeUtils::FPSeconds GetAccumulatedTime() const noexcept;
+    void SetAccumulatedTime(TimeUtils::FPSeconds accumulated) noexcept;
+
+protected:
+private:
+    TimeUtils::FPSeconds _step{};
+    TimeUtils::FPSeconds _accumulated{};
+    int _max_steps_per_frame = 4;
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, std::size_t Capacity = 64>
+class InlineFunction;
+
+//Move-only callable wrapper that stores its target in a fixed inline buffer.
+//Targets that do not fit (or are not nothrow-movable) are moved to the heap
+//and counted in heap_fallback_count() so hot paths can be audited.
+template<typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() noexcept = default;
+    InlineFunction(std::nullptr_t) noexcept {}
+    InlineFunction(const InlineFunction& other) = delete;
+    InlineFunction& operator=(const InlineFunction& rhs) = delete;
+
+    InlineFunction(InlineFunction&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& rhs) noexcept {
+        if(this != &rhs) {
+            reset();
+            MoveFrom(rhs);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    template<typename F, typename Fn = std::decay_t<F>, typename = std::enable_if_t<!std::is_same_v<Fn, InlineFunction> && std::is_invocable_r_v<R, Fn&, Args...>>>
+    InlineFunction(F&& f) {
+        Emplace<Fn>(std::forward<F>(f));
+    }
+
+    template<typename F, typename Fn = std::decay_t<F>, typename = std::enable_if_t<!std::is_same_v<Fn, InlineFunction> && std::is_invocable_r_v<R, Fn&, Args...>>>
+    InlineFunction& operator=(F&& f) {
+        reset();
+        Emplace<Fn>(std::forward<F>(f));
+        return *this;
+    }
+
+    ~InlineFunction() noexcept {
+        reset();
+    }
+
+    //Throws std::bad_function_call when empty, like std::function.
+    R operator()(Args... args) {
+        if(!_invoke) {
+            throw std::bad_function_call{};
+        }
+        return _invoke(Target(), std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept {
+        return _invoke != nullptr;
+    }
+
+    [[nodiscard]] bool is_inline() const noexcept {
+        return _invoke && !_on_heap;
+    }
+
+    void reset() noexcept {
+        if(_manage) {
+            _manage(Operation::Destroy, &_storage, nullptr);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+        _on_heap = false;
+    }
+
+    [[nodiscard]] static std::size_t heap_fallback_count() noexcept {
+        return _heap_fallbacks.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    template<typename Fn>
+    [[nodiscard]] static constexpr bool fits_inline() noexcept {
+        return sizeof(Fn) <= Capacity && alignof(Fn) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+protected:
+private:
+    enum class Operation {
+        Move,
+        Destroy,
+    };
+    using invoke_t = R (*)(void*, Args&&...);
+    using manage_t = void (*)(Operation, void*, void*);
+
+    template<typename Fn, typename F>
+    void Emplace(F&& f) {
+        if constexpr(std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>) {
+            if(!f) {
+                return;
+            }
+        } else if constexpr(std::is_same_v<Fn, std::function<R(Args...)>>) {
+            if(!f) {
+                return;
+            }
+        }
+        if constexpr(fits_inline<Fn>()) {
+            ::new(static_cast<void*>(&_storage)) Fn(std::forward<F>(f));
+            _invoke = [](void* target, Args&&... args) -> R {
+                return std::invoke(*static_cast<Fn*>(target), std::forward<Args>(args)...);
+            };
+            _manage = [](Operation op, void* dst, void* src) {
+                switch(op) {
+                case Operation::Move:
+                    ::new(dst) Fn(std::move(*static_cast<Fn*>(src)));
+                    static_cast<Fn*>(src)->~Fn();
+                    break;
+                case Operation::Destroy:
+                    static_cast<Fn*>(dst)->~Fn();
+                    break;
+                }
+            };
+            _on_heap = false;
+        } else {
+            ::new(static_cast<void*>(&_storage)) Fn*(new Fn(std::forward<F>(f)));
+            _heap_fallbacks.fetch_add(1u, std::memory_order_relaxed);
+            _invoke = [](void* target, Args&&... args) -> R {
+                return std::invoke(**static_cast<Fn**>(target), std::forward<Args>(args)...);
+            };
+            _manage = [](Operation op, void* dst, void* src) {
+                switch(op) {
+                case Operation::Move:
+                    ::new(dst) Fn*(*static_cast<Fn**>(src));
+                    break;
+                case Operation::Destroy:
+                    delete *static_cast<Fn**>(dst);
+                    break;
+                }
+            };
+            _on_heap = true;
+        }
+    }
+
+    void MoveFrom(InlineFunction& other) noexcept {
+        if(!other._manage) {
+            return;
+        }
+        other._manage(Operation::Move, &_storage, &other._storage);
+        _invoke = std::exchange(other._invoke, nullptr);
+        _manage = std::exchange(other._manage, nullptr);
+        _on_heap = std::exchange(other._on_heap, false);
+    }
+
+    [[nodiscard]] void* Target() noexcept {
+        return &_storage;
+    }
+
+    std::aligned_storage_t<Capacity, alignof(std::max_align_t)> _storage;
+    invoke_t _invoke = nullptr;
+    manage_t _manage = nullptr;
+    bool _on_heap = false;
+    inline static std::atomic<std::size_t> _heap_fallbacks{0u};
+};
@@ -0,0 +1,125 @@
+#include "Engine/Core/JobPool.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+
+struct JobPoolCache;
+
+struct JobBlock {
+    alignas(std::max_align_t) std::byte storage[JobPool::block_size()];
+    JobPoolCache* owner = nullptr;
+    JobBlock* next = nullptr;
+};
+
+struct JobPoolCache {
+    JobBlock* local_free = nullptr;
+    std::atomic<JobBlock*> remote_free{nullptr};
+    std::vector<std::unique_ptr<JobBlock[]>> slabs{};
+    std::atomic_bool in_use = false;
+};
+
+struct JobPoolRegistry {
+    std::mutex cs{};
+    std::vector<std::unique_ptr<JobPoolCache>> caches{};
+};
+
+JobPoolRegistry& GetRegistry() noexcept {
+    static JobPoolRegistry registry{};
+    return registry;
+}
+
+//Caches outlive their threads; an exited thread's cache is handed to the next thread that needs one.
+JobPoolCache* AcquireCache() noexcept {
+    auto& registry = GetRegistry();
+    std::scoped_lock<std::mutex> lock(registry.cs);
+    for(auto& cache : registry.caches) {
+        if(!cache->in_use.exchange(true, std::memory_order_acquire)) {
+            return cache.get();
+        }
+    }
+    auto& cache = registry.caches.emplace_back(std::make_unique<JobPoolCache>());
+    cache->in_use = true;
+    return cache.get();
+}
+
+struct JobPoolCacheHandle {
+    JobPoolCache* cache = nullptr;
+    ~JobPoolCacheHandle() noexcept {
+        if(cache) {
+            cache->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local JobPoolCacheHandle tl_cache{};
+
+JobPoolCache& GetLocalCache() noexcept {
+    if(!tl_cache.cache) {
+        tl_cache.cache = AcquireCache();
+    }
+    return *tl_cache.cache;
+}
+
+void GrowCache(JobPoolCache& cache) noexcept {
+    auto slab = std::make_unique<JobBlock[]>(JobPool::blocks_per_slab());
+    for(std::size_t i = 0u; i < JobPool::blocks_per_slab(); ++i) {
+        slab[i].owner = &cache;
+        slab[i].next = i + 1u < JobPool::blocks_per_slab() ? &slab[i + 1u] : cache.local_free;
+    }
+    cache.local_free = &slab[0];
+    auto& registry = GetRegistry();
+    std::scoped_lock<std::mutex> lock(registry.cs);
+    cache.slabs.push_back(std::move(slab));
+}
+
+} // namespace
+
+void* JobPool::allocate(std::size_t size) noexcept {
+    GUARANTEE_OR_DIE(size <= _block_size, "JobPool block size is too small for the requested object.");
+    auto& cache = GetLocalCache();
+    if(!cache.local_free) {
+        cache.local_free = cache.remote_free.exchange(nullptr, std::memory_order_acquire);
+    }
+    if(!cache.local_free) {
+        GrowCache(cache);
+    }
+    auto* block = cache.local_free;
+    cache.local_free = block->next;
+    return block->storage;
+}
+
+void JobPool::deallocate(void* ptr) noexcept {
+    if(!ptr) {
+        return;
+    }
+    auto* block = reinterpret_cast<JobBlock*>(ptr);
+    auto* owner = block->owner;
+    if(owner == tl_cache.cache) {
+        block->next = owner->local_free;
+        owner->local_free = block;
+        return;
+    }
+    auto* head = owner->remote_free.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while(!owner->remote_free.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+JobPool::stats_t JobPool::stats() noexcept {
+    auto& registry = GetRegistry();
+    std::scoped_lock<std::mutex> lock(registry.cs);
+    stats_t result{};
+    result.cache_count = registry.caches.size();
+    for(const auto& cache : registry.caches) {
+        result.slab_count += cache->slabs.size();
+    }
+    result.block_count = result.slab_count * _blocks_per_slab;
+    return result;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+//Thread-caching free-list allocator for Job objects.
+//Each thread allocates from its own cache; blocks freed on another thread are
+//pushed onto the owning cache's lock-free remote list and reclaimed in bulk
+//the next time the owner runs dry. Slabs are only allocated while the pool
+//grows, so steady-state dispatch does not touch the heap.
+class JobPool {
+public:
+    struct stats_t {
+        std::size_t slab_count = 0u;
+        std::size_t block_count = 0u;
+        std::size_t cache_count = 0u;
+    };
+
+    [[nodiscard]] static void* allocate(std::size_t size) noexcept;
+    static void deallocate(void* ptr) noexcept;
+
+    [[nodiscard]] static stats_t stats() noexcept;
+    [[nodiscard]] static constexpr std::size_t block_size() noexcept {
+        return _block_size;
+    }
+    [[nodiscard]] static constexpr std::size_t blocks_per_slab() noexcept {
+        return _blocks_per_slab;
+    }
+
+protected:
+private:
+    static constexpr std::size_t _block_size = 256u;
+    static constexpr std::size_t _blocks_per_slab = 128u;
+};
@@ -5,12 +5,25 @@
 #include "Engine/Core/TypeUtils.hpp"
 #include "Engine/Platform/Win.hpp"
 
+#include "Engine/Profiling/Profiler.hpp"
+
+#include <algorithm>
 #include <chrono>
+#include <intrin.h>
 #include <sstream>
 
-std::vector<ThreadSafeQueue<Job*>*> JobSystem::_queues = std::vector<ThreadSafeQueue<Job*>*>{};
+std::vector<MpmcQueue<Job*>*> JobSystem::_queues = std::vector<MpmcQueue<Job*>*>{};
 std::vector<std::condition_variable*> JobSystem::_signals = std::vector<std::condition_variable*>{};
 std::vector<std::thread> JobSystem::_threads = std::vector<std::thread>{};
+std::mutex JobSystem::_wait_cs{};
+std::condition_variable JobSystem::_wait_signal{};
+std::atomic<std::size_t> JobSystem::_waiter_count{0u};
+
+namespace {
+std::atomic<std::uint64_t> s_next_instance_id{1u};
+thread_local std::uint64_t tl_slot_owner_id = 0u;
+thread_local std::size_t tl_slot_index = 0u;
+} // namespace
 
 void JobSystem::GenericJobWorker(std::condition_variable* signal) noexcept {
     JobConsumer jc;
@@ -28,8 +41,34 @@ void JobSystem::GenericJobWorker(std::condition_variable* signal) noexcept {
     }
 }
 
-JobSystem::JobSystem(int genericCount, std::size_t categoryCount, std::condition_variable* mainJobSignal) noexcept
-: _main_job_signal(mainJobSignal) {
+void JobSystem::StealingJobWorker(std::size_t slot_index) noexcept {
+    tl_slot_owner_id = _instance_id;
+    tl_slot_index = slot_index;
+#ifdef PROFILE_BUILD
+    Profiler::SetThreadName("Generic Job Thread " + std::to_string(slot_index - 1u));
+#endif
+    auto& slot = *_slots[slot_index];
+    constexpr auto max_idle_spins = 64u;
+    auto idle_spins = 0u;
+    while(IsRunning()) {
+        if(auto* job = FindGenericJob(slot_index)) {
+            Execute(job);
+            idle_spins = 0u;
+            continue;
+        }
+        if(++idle_spins < max_idle_spins) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle_spins = 0u;
+        Park(slot);
+    }
+}
+
+JobSystem::JobSystem(int genericCount, std::size_t categoryCount, std::condition_variable* mainJobSignal, JobSchedulerMode mode /*= JobSchedulerMode::WorkStealing*/) noexcept
+: _main_job_signal(mainJobSignal)
+, _instance_id(s_next_instance_id++)
+, _mode(mode) {
     Initialize(genericCount, categoryCount);
 }
 
@@ -38,18 +77,24 @@ JobSystem::~JobSystem() noexcept {
 }
 
 void JobSystem::Initialize(int genericCount, std::size_t categoryCount) noexcept {
-    auto core_count = static_cast<int>(std::thread::hardware_concurrency());
-    if(genericCount <= 0) {
-        core_count += genericCount;
-    }
-    --core_count;
+    //Positive counts are exact, zero or negative counts are relative to the hardware thread count minus the calling thread.
+    const auto hardware_count = static_cast<int>(std::thread::hardware_concurrency());
+    const auto core_count = static_cast<std::size_t>((std::max)(1, genericCount > 0 ? genericCount : hardware_count + genericCount - 1));
     _queues.resize(categoryCount);
     _signals.resize(categoryCount);
     _threads.resize(core_count);
     _is_running = true;
 
+    //Slot 0 belongs to the creating thread so jobs it dispatches are stolen by the workers.
+    _slots.resize(core_count + 1);
+    for(auto& slot : _slots) {
+        slot = std::make_unique<WorkerSlot>();
+    }
+    tl_slot_owner_id = _instance_id;
+    tl_slot_index = 0u;
+
     for(std::size_t i = 0; i < categoryCount; ++i) {
-        _queues[i] = new ThreadSafeQueue<Job*>{};
+        _queues[i] = new MpmcQueue<Job*>{};
     }
 
     for(std::size_t i = 0; i < categoryCount; ++i) {
@@ -57,8 +102,10 @@ void JobSystem::Initialize(int genericCount, std::size_t categoryCount) noexcept
     }
     _signals[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)] = new std::condition_variable;
 
-    for(std::size_t i = 0; i < static_cast<std::size_t>(core_count); ++i) {
-        auto t = std::thread(&JobSystem::GenericJobWorker, this, _signals[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)]);
+    for(std::size_t i = 0; i < core_count; ++i) {
+        auto t = _mode == JobSchedulerMode::WorkStealing
+                 ? std::thread(&JobSystem::StealingJobWorker, this, i + 1)
+                 : std::thread(&JobSystem::GenericJobWorker, this, _signals[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)]);
         std::wstring desc{L"Generic Job Thread "};
         desc += std::to_wstring(i);
         ThreadUtils::SetThreadDescription(t, desc);
@@ -80,6 +127,7 @@ void JobSystem::Shutdown() noexcept {
             signal->notify_all();
         }
     }
+    UnparkAll();
 
     for(auto& thread : _threads) {
         if(thread.joinable()) {
@@ -105,6 +153,9 @@ void JobSystem::Shutdown() noexcept {
 
     _threads.clear();
     _threads.shrink_to_fit();
+
+    _slots.clear();
+    _slots.shrink_to_fit();
 }
 
 void JobSystem::MainStep() noexcept {
@@ -118,18 +169,18 @@ void JobSystem::SetCategorySignal(const JobType& category_id, std::condition_var
     _signals[static_cast<std::underlying_type_t<JobType>>(category_id)] = signal;
 }
 
-Job* JobSystem::Create(const JobType& category, const std::function<void(void*)>& cb, void* user_data) noexcept {
+Job* JobSystem::Create(const JobType& category, JobCallback cb, void* user_data) noexcept {
     auto* j = new Job();
     j->type = category;
     j->state = JobState::Created;
-    j->work_cb = cb;
+    j->work_cb = std::move(cb);
     j->user_data = user_data;
     j->num_dependencies = 1;
     return j;
 }
 
-void JobSystem::Run(const JobType& category, const std::function<void(void*)>& cb, void* user_data) noexcept {
-    Job* job = Create(category, cb, user_data);
+void JobSystem::Run(const JobType& category, JobCallback cb, void* user_data) noexcept {
+    Job* job = Create(category, std::move(cb), user_data);
     job->state = JobState::Running;
     DispatchAndRelease(job);
 }
@@ -137,15 +188,187 @@ void JobSystem::Run(const JobType& category, const std::function<void(void*)>& c
 void JobSystem::Dispatch(Job* job) noexcept {
     job->state = JobState::Dispatched;
     ++job->num_dependencies;
+    if(_mode == JobSchedulerMode::WorkStealing && job->type == JobType::Generic) {
+        DispatchGeneric(job);
+        return;
+    }
     const auto jobtype = TypeUtils::GetUnderlyingValue<JobType>(job->type);
     _queues[jobtype]->push(job);
     auto* signal = _signals[jobtype];
     if(signal) {
+        if(job->type == JobType::Generic) {
+            //Generic workers check for jobs while holding _cs; taking it here closes the lost-wakeup window.
+            std::scoped_lock<std::mutex> lock(_cs);
+        }
         signal->notify_all();
     }
+    if(job->type == JobType::Generic || job->type == JobType::Main) {
+        NotifyWaiters();
+    }
+}
+
+void JobSystem::DispatchGeneric(Job* job) noexcept {
+    auto* slot = GetCurrentThreadSlot();
+    if(!slot || !slot->deque.push(job)) {
+        _queues[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)]->push(job);
+    }
+    UnparkOne();
+    NotifyWaiters();
+}
+
+//Pass _slots.size() as slot_index for threads that do not own a slot.
+Job* JobSystem::FindGenericJob(std::size_t slot_index) noexcept {
+    Job* job = nullptr;
+    const auto slot_count = _slots.size();
+    if(slot_index < slot_count && _slots[slot_index]->deque.pop(job)) {
+        return job;
+    }
+    if(_queues[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)]->try_pop(job)) {
+        return job;
+    }
+    for(std::size_t i = 1u; i <= slot_count; ++i) {
+        const auto victim = (slot_index + i) % slot_count;
+        if(victim != slot_index && _slots[victim]->deque.steal(job)) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::TryExecuteGenericJob() noexcept {
+    Job* job = nullptr;
+    if(_mode == JobSchedulerMode::WorkStealing) {
+        job = FindGenericJob(GetCurrentThreadSlotIndex());
+    } else if(!_queues[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)]->try_pop(job)) {
+        job = nullptr;
+    }
+    if(!job) {
+        return false;
+    }
+    Execute(job);
+    return true;
+}
+
+//Main category jobs may only run on the thread that created the JobSystem, the same one that drains them in BeginFrame.
+bool JobSystem::TryExecuteMainJob() noexcept {
+    const auto main_index = TypeUtils::GetUnderlyingValue<JobType>(JobType::Main);
+    if(GetCurrentThreadSlotIndex() != 0u || main_index >= _queues.size()) {
+        return false;
+    }
+    Job* job = nullptr;
+    if(!_queues[main_index]->try_pop(job)) {
+        return false;
+    }
+    Execute(job);
+    return true;
+}
+
+bool JobSystem::TryHelpWhileWaiting() noexcept {
+    return TryExecuteMainJob() || TryExecuteGenericJob();
+}
+
+bool JobSystem::HasJobsToHelpWith() const noexcept {
+    const auto main_index = TypeUtils::GetUnderlyingValue<JobType>(JobType::Main);
+    if(GetCurrentThreadSlotIndex() == 0u && main_index < _queues.size() && !_queues[main_index]->empty()) {
+        return true;
+    }
+    return HasGenericJobs();
+}
+
+bool JobSystem::HasGenericJobs() const noexcept {
+    if(!_queues[TypeUtils::GetUnderlyingValue<JobType>(JobType::Generic)]->empty()) {
+        return true;
+    }
+    return std::any_of(std::cbegin(_slots), std::cend(_slots), [](const auto& slot) { return !slot->deque.empty(); });
+}
+
+JobSystem::WorkerSlot* JobSystem::GetCurrentThreadSlot() const noexcept {
+    const auto slot_index = GetCurrentThreadSlotIndex();
+    return slot_index < _slots.size() ? _slots[slot_index].get() : nullptr;
+}
+
+std::size_t JobSystem::GetCurrentThreadSlotIndex() const noexcept {
+    if(tl_slot_owner_id != _instance_id || tl_slot_index >= _slots.size()) {
+        return _slots.size();
+    }
+    return tl_slot_index;
+}
+
+void JobSystem::Park(WorkerSlot& slot) noexcept {
+    std::unique_lock<std::mutex> lock(slot.park_cs);
+    slot.parked = true;
+    ++_parked_count;
+    //Pairs with the fence in UnparkOne: either the dispatcher sees this worker parked or this worker sees the job.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(IsRunning() && !HasGenericJobs()) {
+        //Condition to wake up: Not running or explicitly unparked
+        slot.wake_signal.wait(lock, [&slot, this]() -> bool { return !_is_running || slot.unparked; });
+    }
+    slot.unparked = false;
+    slot.parked = false;
+    --_parked_count;
+}
+
+void JobSystem::UnparkOne() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_parked_count == 0u) {
+        return;
+    }
+    const auto slot_count = _slots.size();
+    const auto start = _next_unpark++;
+    for(std::size_t i = 0u; i < slot_count; ++i) {
+        auto& slot = *_slots[(start + i) % slot_count];
+        if(!slot.parked) {
+            continue;
+        }
+        {
+            std::scoped_lock<std::mutex> lock(slot.park_cs);
+            if(!slot.parked || slot.unparked) {
+                continue;
+            }
+            slot.unparked = true;
+        }
+        slot.wake_signal.notify_one();
+        return;
+    }
+}
+
+void JobSystem::UnparkAll() noexcept {
+    for(auto& slot : _slots) {
+        {
+            std::scoped_lock<std::mutex> lock(slot->park_cs);
+            slot->unparked = true;
+        }
+        slot->wake_signal.notify_one();
+    }
+}
+
+void JobSystem::Execute(Job* job) noexcept {
+    job->state = JobState::Running;
+    std::invoke(job->work_cb, job->user_data);
+    job->OnFinish();
+    job->state = JobState::Finished;
+    ReleaseJob(job);
+    NotifyWaiters();
+}
+
+void JobSystem::NotifyWaiters() noexcept {
+    //Pairs with the fence in ParkWaiter: either the waiter sees the new state or this sees the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_waiter_count == 0u) {
+        return;
+    }
+    {
+        std::scoped_lock<std::mutex> lock(_wait_cs);
+    }
+    _wait_signal.notify_all();
 }
 
 bool JobSystem::Release(Job* job) noexcept {
+    return ReleaseJob(job);
+}
+
+bool JobSystem::ReleaseJob(Job* job) noexcept {
     const auto dcount = --job->num_dependencies;
     if(dcount != 0) {
         return false;
@@ -154,12 +377,41 @@ bool JobSystem::Release(Job* job) noexcept {
     return true;
 }
 
+//Waiters run eligible jobs instead of idling. When there is nothing to help with they
+//back off from spinning to yielding and finally park until a job finishes or new work arrives.
 void JobSystem::Wait(Job* job) noexcept {
+    constexpr auto max_spins = 64u;
+    constexpr auto max_yields = 16u;
+    auto idle_count = 0u;
     while(job->state != JobState::Finished) {
-        std::this_thread::yield();
+        if(IsRunning() && TryHelpWhileWaiting()) {
+            idle_count = 0u;
+            continue;
+        }
+        if(idle_count < max_spins) {
+            _mm_pause();
+        } else if(idle_count < max_spins + max_yields) {
+            std::this_thread::yield();
+        } else {
+            ParkWaiter(job);
+            idle_count = 0u;
+            continue;
+        }
+        ++idle_count;
     }
 }
 
+void JobSystem::ParkWaiter(const Job* job) noexcept {
+    std::unique_lock<std::mutex> lock(_wait_cs);
+    ++_waiter_count;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    //Bounded so a finish signalled from outside Execute or Dispatch only costs latency, never a hang.
+    _wait_signal.wait_for(lock, std::chrono::milliseconds{1}, [job, this]() -> bool {
+        return job->state == JobState::Finished || (IsRunning() && HasJobsToHelpWith());
+    });
+    --_waiter_count;
+}
+
 void JobSystem::DispatchAndRelease(Job* job) noexcept {
     Dispatch(job);
     Release(job);
@@ -182,3 +434,50 @@ void JobSystem::SetIsRunning(bool value /*= true*/) noexcept {
 std::condition_variable* JobSystem::GetMainJobSignal() const noexcept {
     return _main_job_signal;
 }
+
+void JobSystem::ParallelForRange(std::size_t begin, std::size_t end, std::size_t grain, JobRangeCallback& cb) noexcept {
+    if(end <= begin) {
+        return;
+    }
+    grain = (std::max)(grain, std::size_t{1u});
+    const auto chunk_count = (end - begin + grain - 1u) / grain;
+    //Still chunk by chunk when nothing runs in parallel; callers index per-chunk storage by (first - begin) / grain.
+    if(chunk_count == 1u || !IsRunning()) {
+        for(auto first = begin; first < end; first += grain) {
+            cb(first, (std::min)(first + grain, end));
+        }
+        return;
+    }
+    //Chunks are claimed dynamically so helpers that start late simply find nothing left to do.
+    std::atomic<std::size_t> next_chunk{0u};
+    std::atomic<std::size_t> active_helpers{0u};
+    const auto run_chunks = [&]() {
+        for(auto chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++) {
+            const auto first = begin + chunk * grain;
+            cb(first, (std::min)(first + grain, end));
+        }
+    };
+    const auto helper_count = (std::min)(GetGenericWorkerCount(), chunk_count - 1u);
+    active_helpers = helper_count;
+    for(std::size_t i = 0u; i < helper_count; ++i) {
+        Run(JobType::Generic, [&run_chunks, &active_helpers](void*) {
+            run_chunks();
+            --active_helpers;
+        }, nullptr);
+    }
+    run_chunks();
+    //Helpers reference this stack frame; keep executing jobs until all of them have returned.
+    while(active_helpers != 0u) {
+        if(!TryExecuteGenericJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+JobSchedulerMode JobSystem::GetSchedulerMode() const noexcept {
+    return _mode;
+}
+
+std::size_t JobSystem::GetGenericWorkerCount() const noexcept {
+    return _threads.size();
+}
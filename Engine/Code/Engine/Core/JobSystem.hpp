@@ -1,7 +1,8 @@
 #pragma once
 
 #include "Engine/Core/EngineSubsystem.hpp"
-#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/LockFreeQueue.hpp"
+#include "Engine/Core/WorkStealingQueue.hpp"
 
 #include "Engine/Services/IJobSystemService.hpp"
 
@@ -9,42 +10,87 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 class JobSystem : public IJobSystemService {
 public:
-    JobSystem(int genericCount, std::size_t categoryCount, std::condition_variable* mainJobSignal) noexcept;
+    JobSystem(int genericCount, std::size_t categoryCount, std::condition_variable* mainJobSignal, JobSchedulerMode mode = JobSchedulerMode::WorkStealing) noexcept;
     virtual ~JobSystem() noexcept;
 
     void BeginFrame() noexcept;
     void Shutdown() noexcept;
 
     void SetCategorySignal(const JobType& category_id, std::condition_variable* signal) noexcept;
-    [[nodiscard]] Job* Create(const JobType& category, const std::function<void(void*)>& cb, void* user_data) noexcept;
-    void Run(const JobType& category, const std::function<void(void*)>& cb, void* user_data) noexcept;
+    [[nodiscard]] Job* Create(const JobType& category, JobCallback cb, void* user_data) noexcept;
+    void Run(const JobType& category, JobCallback cb, void* user_data) noexcept;
     void Dispatch(Job* job) noexcept;
     bool Release(Job* job) noexcept;
     void Wait(Job* job) noexcept;
     void DispatchAndRelease(Job* job) noexcept;
     void WaitAndRelease(Job* job) noexcept;
+    [[nodiscard]] bool TryHelpWhileWaiting() noexcept;
     [[nodiscard]] bool IsRunning() const noexcept;
     [[nodiscard]] std::condition_variable* GetMainJobSignal() const noexcept;
 
+    void ParallelForRange(std::size_t begin, std::size_t end, std::size_t grain, JobRangeCallback& cb) noexcept;
+
+    [[nodiscard]] JobSchedulerMode GetSchedulerMode() const noexcept;
+    [[nodiscard]] std::size_t GetGenericWorkerCount() const noexcept;
+
 protected:
 private:
+    //One per generic worker thread plus one for the thread that created the JobSystem.
+    //Generic jobs dispatched from a slot's owner go to its own deque; idle workers steal.
+    struct alignas(64) WorkerSlot {
+        WorkStealingQueue<Job*> deque{};
+        std::mutex park_cs{};
+        std::condition_variable wake_signal{};
+        std::atomic_bool parked = false;
+        bool unparked = false;
+    };
+
     void Initialize(int genericCount, std::size_t categoryCount) noexcept;
     void SetIsRunning(bool value = true) noexcept;
     void MainStep() noexcept;
     void GenericJobWorker(std::condition_variable* signal) noexcept;
+    void StealingJobWorker(std::size_t slot_index) noexcept;
+
+    void DispatchGeneric(Job* job) noexcept;
+    [[nodiscard]] Job* FindGenericJob(std::size_t slot_index) noexcept;
+    [[nodiscard]] bool TryExecuteGenericJob() noexcept;
+    [[nodiscard]] bool TryExecuteMainJob() noexcept;
+    [[nodiscard]] bool HasJobsToHelpWith() const noexcept;
+    void ParkWaiter(const Job* job) noexcept;
+    [[nodiscard]] std::size_t GetCurrentThreadSlotIndex() const noexcept;
+    [[nodiscard]] bool HasGenericJobs() const noexcept;
+    [[nodiscard]] WorkerSlot* GetCurrentThreadSlot() const noexcept;
+    void Park(WorkerSlot& slot) noexcept;
+    void UnparkOne() noexcept;
+    void UnparkAll() noexcept;
+
+    static void Execute(Job* job) noexcept;
+    static bool ReleaseJob(Job* job) noexcept;
+    static void NotifyWaiters() noexcept;
 
-    static std::vector<ThreadSafeQueue<Job*>*> _queues;
+    static std::vector<MpmcQueue<Job*>*> _queues;
     static std::vector<std::condition_variable*> _signals;
     static std::vector<std::thread> _threads;
+    //Threads parked in Wait; woken whenever a job finishes or new work is dispatched.
+    static std::mutex _wait_cs;
+    static std::condition_variable _wait_signal;
+    static std::atomic<std::size_t> _waiter_count;
+    std::vector<std::unique_ptr<WorkerSlot>> _slots{};
     std::condition_variable* _main_job_signal = nullptr;
     std::mutex _cs{};
     std::atomic_bool _is_running = false;
+    std::atomic<std::size_t> _parked_count{0u};
+    std::atomic<std::size_t> _next_unpark{0u};
+    std::uint64_t _instance_id = 0u;
+    JobSchedulerMode _mode = JobSchedulerMode::WorkStealing;
     friend class JobConsumer;
-};
\ No newline at end of file
+};
@@ -1,5 +1,6 @@
 #include "Engine/Core/JobTypes.hpp"
 
+#include "Engine/Core/JobPool.hpp"
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/TypeUtils.hpp"
 
@@ -26,15 +27,11 @@ bool JobConsumer::ConsumeJob() noexcept {
             continue;
         }
         auto& queue = *consumable;
-        if(queue.empty()) {
+        Job* job = nullptr;
+        if(!queue.try_pop(job)) {
             return false;
         }
-        auto* job = queue.front();
-        queue.pop();
-        std::invoke(job->work_cb, job->user_data);
-        job->OnFinish();
-        job->state = JobState::Finished;
-        delete job;
+        JobSystem::Execute(job);
     }
     return true;
 }
@@ -67,10 +64,20 @@ bool JobConsumer::HasJobs() const noexcept {
     return false;
 }
 
+static_assert(sizeof(Job) <= JobPool::block_size(), "Job no longer fits in a JobPool block.");
+
 Job::~Job() noexcept {
     delete user_data;
 }
 
+void* Job::operator new(std::size_t size) noexcept {
+    return JobPool::allocate(size);
+}
+
+void Job::operator delete(void* ptr) noexcept {
+    JobPool::deallocate(ptr);
+}
+
 void Job::DependencyOf(Job* dependency) noexcept {
     DependentOn(dependency);
 }
@@ -1,10 +1,11 @@
 #pragma once
 
-#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/InlineFunction.hpp"
+#include "Engine/Core/LockFreeQueue.hpp"
 #include "Engine/Core/TimeUtils.hpp"
 
 #include <atomic>
-#include <functional>
+#include <cstddef>
 #include <vector>
 
 class Job;
@@ -29,13 +30,29 @@ enum class JobState : unsigned int {
     Max,
 };
 
+enum class JobSchedulerMode : unsigned int {
+    WorkStealing,
+    SharedQueue,
+    Max,
+};
+
+//Captures up to 64 bytes are stored in the Job itself; larger ones fall back to the heap.
+using JobCallback = InlineFunction<void(void*), 64>;
+//Receives a half-open index range [first, last).
+using JobRangeCallback = InlineFunction<void(std::size_t, std::size_t), 64>;
+
 class Job {
 public:
     Job() noexcept = default;
     ~Job() noexcept;
+
+    //Jobs are carved from JobPool so dispatching does not touch the heap.
+    [[nodiscard]] static void* operator new(std::size_t size) noexcept;
+    static void operator delete(void* ptr) noexcept;
+
     JobType type{};
-    JobState state{};
-    std::function<void(void*)> work_cb;
+    std::atomic<JobState> state{JobState::None};
+    JobCallback work_cb;
     void* user_data{};
 
     void DependencyOf(Job* dependency) noexcept;
@@ -59,6 +76,6 @@ public:
     [[nodiscard]] bool HasJobs() const noexcept;
 
 private:
-    std::vector<ThreadSafeQueue<Job*>*> _consumables{};
+    std::vector<MpmcQueue<Job*>*> _consumables{};
     friend class JobSystem;
 };
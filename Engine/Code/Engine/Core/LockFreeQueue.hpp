@@ -0,0 +1,507 @@
+#pragma once
+//Lock-free queue family.
+//SpscQueue: bounded ring, one producer and one consumer.
+//MpscQueue: bounded ring, any number of producers and one consumer.
+//    Bounded MPMC queue - Dmitry Vyukov
+//    https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//MpmcQueue: unbounded, any number of producers and consumers.
+//    A Wait-free Queue as Fast as Fetch-and-Add - Yang, Mellor-Crummey [PPoPP 2016] (segmented FAA array, without the wait-free helping)
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace LockFreeQueue {
+    constexpr std::size_t cache_line_size = 64u;
+}
+
+//Bounded single-producer single-consumer ring buffer.
+//Each side caches the other side's index so the shared cache lines are only touched when the cached view runs out.
+template<typename T, std::size_t Capacity = 1024>
+class SpscQueue {
+public:
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "SpscQueue Capacity must be a power of two.");
+    static_assert(std::is_default_constructible_v<T> && std::is_nothrow_move_assignable_v<T>, "SpscQueue elements must be default constructible and nothrow move assignable.");
+
+    SpscQueue() noexcept = default;
+    SpscQueue(const SpscQueue& other) = delete;
+    SpscQueue(SpscQueue&& other) = delete;
+    SpscQueue& operator=(const SpscQueue& rhs) = delete;
+    SpscQueue& operator=(SpscQueue&& rhs) = delete;
+    ~SpscQueue() noexcept = default;
+
+    //Producer only.
+    [[nodiscard]] bool try_push(const T& value) noexcept {
+        return try_emplace(value);
+    }
+
+    //Producer only.
+    [[nodiscard]] bool try_push(T&& value) noexcept {
+        return try_emplace(std::move(value));
+    }
+
+    //Consumer only.
+    [[nodiscard]] bool try_pop(T& value) noexcept {
+        return pop_bulk(&value, 1u) == 1u;
+    }
+
+    //Consumer only. Moves up to max_count elements to out and publishes the space with a single store.
+    template<typename OutputIt>
+    std::size_t pop_bulk(OutputIt out, std::size_t max_count) noexcept {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if(_cached_tail - head < max_count) {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+        }
+        const auto available = _cached_tail - head;
+        const auto count = available < max_count ? available : max_count;
+        for(std::size_t i = 0u; i < count; ++i) {
+            *out = std::move(_buffer[(head + i) & _mask]);
+            ++out;
+        }
+        if(count) {
+            _head.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    //Approximate when called concurrently.
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0u;
+    }
+
+    //Approximate when called concurrently.
+    [[nodiscard]] std::size_t size() const noexcept {
+        const auto head = _head.load(std::memory_order_acquire);
+        const auto tail = _tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+protected:
+private:
+    template<typename U>
+    [[nodiscard]] bool try_emplace(U&& value) noexcept {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if(tail - _cached_head >= Capacity) {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if(tail - _cached_head >= Capacity) {
+                return false;
+            }
+        }
+        _buffer[tail & _mask] = std::forward<U>(value);
+        _tail.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr std::size_t _mask = Capacity - 1u;
+    alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> _head{0u};
+    std::size_t _cached_tail = 0u;
+    alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> _tail{0u};
+    std::size_t _cached_head = 0u;
+    alignas(LockFreeQueue::cache_line_size) std::array<T, Capacity> _buffer{};
+};
+
+//Bounded multi-producer single-consumer ring buffer.
+//Producers claim a cell with a CAS on the tail; each cell carries a sequence number that tells
+//the consumer when the value in it has been published. A producer that stalls between claiming
+//and publishing holds up the consumer at that cell, but never the other producers.
+template<typename T, std::size_t Capacity = 1024>
+class MpscQueue {
+public:
+    static_assert(Capacity >= 2u && !(Capacity & (Capacity - 1)), "MpscQueue Capacity must be a power of two.");
+    static_assert(std::is_default_constructible_v<T> && std::is_nothrow_move_assignable_v<T>, "MpscQueue elements must be default constructible and nothrow move assignable.");
+
+    MpscQueue() noexcept {
+        for(std::size_t i = 0u; i < Capacity; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpscQueue(const MpscQueue& other) = delete;
+    MpscQueue(MpscQueue&& other) = delete;
+    MpscQueue& operator=(const MpscQueue& rhs) = delete;
+    MpscQueue& operator=(MpscQueue&& rhs) = delete;
+    ~MpscQueue() noexcept = default;
+
+    //Any thread.
+    [[nodiscard]] bool try_push(const T& value) noexcept {
+        return try_emplace(value);
+    }
+
+    //Any thread.
+    [[nodiscard]] bool try_push(T&& value) noexcept {
+        return try_emplace(std::move(value));
+    }
+
+    //Consumer only.
+    [[nodiscard]] bool try_pop(T& value) noexcept {
+        return pop_bulk(&value, 1u) == 1u;
+    }
+
+    //Consumer only. Stops early at the first cell that has not been published yet.
+    template<typename OutputIt>
+    std::size_t pop_bulk(OutputIt out, std::size_t max_count) noexcept {
+        auto head = _head.load(std::memory_order_relaxed);
+        auto count = std::size_t{0u};
+        for(; count < max_count; ++count, ++head) {
+            auto& cell = _cells[head & _mask];
+            if(cell.sequence.load(std::memory_order_acquire) != head + 1u) {
+                break;
+            }
+            *out = std::move(cell.value);
+            ++out;
+            cell.sequence.store(head + Capacity, std::memory_order_release);
+        }
+        if(count) {
+            _head.store(head, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    //Exact for the consumer, approximate for everyone else.
+    [[nodiscard]] bool empty() const noexcept {
+        const auto head = _head.load(std::memory_order_relaxed);
+        return _cells[head & _mask].sequence.load(std::memory_order_acquire) != head + 1u;
+    }
+
+    //Approximate when called concurrently.
+    [[nodiscard]] std::size_t size() const noexcept {
+        const auto head = _head.load(std::memory_order_relaxed);
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : std::size_t{0u};
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+protected:
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0u};
+        T value{};
+    };
+
+    template<typename U>
+    [[nodiscard]] bool try_emplace(U&& value) noexcept {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        for(;;) {
+            auto& cell = _cells[tail & _mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(tail);
+            if(difference == 0) {
+                if(_tail.compare_exchange_weak(tail, tail + 1u, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(tail + 1u, std::memory_order_release);
+                    return true;
+                }
+            } else if(difference < 0) {
+                return false;
+            } else {
+                tail = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static constexpr std::size_t _mask = Capacity - 1u;
+    alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> _tail{0u};
+    alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> _head{0u};
+    alignas(LockFreeQueue::cache_line_size) std::array<Cell, Capacity> _cells{};
+};
+
+//Unbounded multi-producer multi-consumer queue.
+//Elements live in fixed-size segments; producers and consumers claim cells with a fetch-add on the
+//segment's indices. A consumer that claims a cell before its producer has published marks it as
+//skipped and the producer retries with a fresh cell. Drained segments are unlinked and freed once
+//no operation that could still see them is in flight; one is kept as a spare so a queue at a steady
+//depth stops allocating.
+template<typename T, std::size_t SegmentSize = 256>
+class MpmcQueue {
+public:
+    static_assert(SegmentSize >= 2u, "MpmcQueue SegmentSize must be at least 2.");
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>, "MpmcQueue elements must be nothrow movable.");
+
+    MpmcQueue() noexcept {
+        auto* segment = new Segment();
+        _head.store(segment, std::memory_order_relaxed);
+        _tail.store(segment, std::memory_order_relaxed);
+    }
+    MpmcQueue(const MpmcQueue& other) = delete;
+    MpmcQueue(MpmcQueue&& other) = delete;
+    MpmcQueue& operator=(const MpmcQueue& rhs) = delete;
+    MpmcQueue& operator=(MpmcQueue&& rhs) = delete;
+
+    ~MpmcQueue() noexcept {
+        for(auto* segment = _head.load(std::memory_order_relaxed); segment;) {
+            auto* next = segment->next.load(std::memory_order_relaxed);
+            segment->DestroyPublished();
+            delete segment;
+            segment = next;
+        }
+        DeleteList(_retired.load(std::memory_order_relaxed));
+        delete _spare.load(std::memory_order_relaxed);
+    }
+
+    //Any thread. Only fails if a new segment cannot be allocated, in which case value is left untouched.
+    [[nodiscard]] bool try_push(const T& value) noexcept {
+        T copy{value};
+        return try_push(std::move(copy));
+    }
+
+    //Any thread. Only fails if a new segment cannot be allocated, in which case value is left untouched.
+    [[nodiscard]] bool try_push(T&& value) noexcept {
+        OperationGuard guard{*this};
+        for(;;) {
+            auto* segment = _tail.load(std::memory_order_acquire);
+            const auto index = segment->enqueue_index.fetch_add(1u, std::memory_order_acq_rel);
+            if(index < SegmentSize) {
+                auto& cell = segment->cells[index];
+                ::new(static_cast<void*>(&cell.storage)) T(std::move(value));
+                auto expected = CellState::Empty;
+                if(cell.state.compare_exchange_strong(expected, CellState::Full, std::memory_order_release, std::memory_order_relaxed)) {
+                    return true;
+                }
+                //A consumer gave up on this cell; take the value back and try another one.
+                value = std::move(*cell.Value());
+                cell.Value()->~T();
+                continue;
+            }
+            if(auto* next = segment->next.load(std::memory_order_acquire)) {
+                _tail.compare_exchange_strong(segment, next, std::memory_order_acq_rel);
+                continue;
+            }
+            auto* fresh = AcquireSegment();
+            if(!fresh) {
+                return false;
+            }
+            ::new(static_cast<void*>(&fresh->cells[0].storage)) T(std::move(value));
+            fresh->cells[0].state.store(CellState::Full, std::memory_order_relaxed);
+            fresh->enqueue_index.store(1u, std::memory_order_relaxed);
+            Segment* expected_next = nullptr;
+            if(segment->next.compare_exchange_strong(expected_next, fresh, std::memory_order_acq_rel)) {
+                _tail.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel);
+                return true;
+            }
+            //Another producer linked a segment first; undo and use theirs.
+            value = std::move(*fresh->cells[0].Value());
+            fresh->cells[0].Value()->~T();
+            fresh->cells[0].state.store(CellState::Empty, std::memory_order_relaxed);
+            ReleaseSegment(fresh);
+            _tail.compare_exchange_strong(segment, expected_next, std::memory_order_acq_rel);
+        }
+    }
+
+    //Any thread. Retries until the element is queued.
+    void push(const T& value) noexcept {
+        T copy{value};
+        while(!try_push(std::move(copy))) {
+            std::this_thread::yield();
+        }
+    }
+
+    //Any thread.
+    [[nodiscard]] bool try_pop(T& value) noexcept {
+        OperationGuard guard{*this};
+        auto* segment = _head.load(std::memory_order_acquire);
+        for(;;) {
+            const auto dequeued = segment->dequeue_index.load(std::memory_order_acquire);
+            if(dequeued >= SegmentSize) {
+                auto* next = segment->next.load(std::memory_order_acquire);
+                if(!next) {
+                    return false;
+                }
+                if(_head.compare_exchange_strong(segment, next, std::memory_order_acq_rel)) {
+                    //No new operation can reach the old segment once head and tail have both moved past it.
+                    auto* old = segment;
+                    _tail.compare_exchange_strong(old, next, std::memory_order_acq_rel);
+                    Retire(segment);
+                    segment = next;
+                }
+                continue;
+            }
+            //Checking before claiming keeps polling an empty queue from burning through cells.
+            if(dequeued >= segment->enqueue_index.load(std::memory_order_acquire)) {
+                return false;
+            }
+            const auto index = segment->dequeue_index.fetch_add(1u, std::memory_order_acq_rel);
+            if(index >= SegmentSize) {
+                continue;
+            }
+            auto& cell = segment->cells[index];
+            //The producer for this cell may be mid-publish; give it a moment before skipping the cell.
+            constexpr auto max_publish_spins = 128u;
+            for(auto spins = 0u; spins < max_publish_spins && cell.state.load(std::memory_order_acquire) == CellState::Empty; ++spins) {
+                /* DO NOTHING */
+            }
+            auto expected = CellState::Empty;
+            if(cell.state.compare_exchange_strong(expected, CellState::Skipped, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                continue;
+            }
+            value = std::move(*cell.Value());
+            cell.Value()->~T();
+            cell.state.store(CellState::Consumed, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    //Any thread.
+    template<typename OutputIt>
+    std::size_t pop_bulk(OutputIt out, std::size_t max_count) noexcept {
+        auto count = std::size_t{0u};
+        T value{};
+        while(count < max_count && try_pop(value)) {
+            *out = std::move(value);
+            ++out;
+            ++count;
+        }
+        return count;
+    }
+
+    //Approximate when called concurrently.
+    [[nodiscard]] bool empty() const noexcept {
+        OperationGuard guard{const_cast<MpmcQueue&>(*this)};
+        const auto* segment = _head.load(std::memory_order_acquire);
+        const auto dequeued = segment->dequeue_index.load(std::memory_order_acquire);
+        if(dequeued < SegmentSize && dequeued < segment->enqueue_index.load(std::memory_order_acquire)) {
+            return false;
+        }
+        return !segment->next.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] static constexpr std::size_t segment_size() noexcept {
+        return SegmentSize;
+    }
+
+protected:
+private:
+    enum class CellState : unsigned char {
+        Empty,
+        Full,
+        Skipped,
+        Consumed,
+    };
+
+    struct Cell {
+        std::atomic<CellState> state{CellState::Empty};
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        [[nodiscard]] T* Value() noexcept {
+            return std::launder(reinterpret_cast<T*>(&storage));
+        }
+    };
+
+    struct Segment {
+        alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> enqueue_index{0u};
+        alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> dequeue_index{0u};
+        alignas(LockFreeQueue::cache_line_size) std::atomic<Segment*> next{nullptr};
+        Segment* retired_next = nullptr;
+        std::array<Cell, SegmentSize> cells{};
+
+        void DestroyPublished() noexcept {
+            for(auto& cell : cells) {
+                if(cell.state.load(std::memory_order_relaxed) == CellState::Full) {
+                    cell.Value()->~T();
+                    cell.state.store(CellState::Consumed, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void Reset() noexcept {
+            enqueue_index.store(0u, std::memory_order_relaxed);
+            dequeue_index.store(0u, std::memory_order_relaxed);
+            next.store(nullptr, std::memory_order_relaxed);
+            retired_next = nullptr;
+            for(auto& cell : cells) {
+                cell.state.store(CellState::Empty, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    //Counts operations in flight so retired segments are only freed when nobody can be looking at them.
+    class OperationGuard {
+    public:
+        explicit OperationGuard(MpmcQueue& queue) noexcept
+        : _queue(queue) {
+            _queue._active_operations.fetch_add(1u, std::memory_order_seq_cst);
+        }
+        ~OperationGuard() noexcept {
+            _queue.TryReclaim();
+            _queue._active_operations.fetch_sub(1u, std::memory_order_seq_cst);
+        }
+        OperationGuard(const OperationGuard& other) = delete;
+        OperationGuard& operator=(const OperationGuard& rhs) = delete;
+
+    private:
+        MpmcQueue& _queue;
+    };
+
+    [[nodiscard]] Segment* AcquireSegment() noexcept {
+        if(auto* spare = _spare.exchange(nullptr, std::memory_order_acq_rel)) {
+            spare->Reset();
+            return spare;
+        }
+        return new(std::nothrow) Segment();
+    }
+
+    void ReleaseSegment(Segment* segment) noexcept {
+        Segment* expected = nullptr;
+        if(!_spare.compare_exchange_strong(expected, segment, std::memory_order_acq_rel)) {
+            delete segment;
+        }
+    }
+
+    void Retire(Segment* segment) noexcept {
+        PushRetired(segment, segment);
+    }
+
+    void PushRetired(Segment* first, Segment* last) noexcept {
+        auto* head = _retired.load(std::memory_order_relaxed);
+        do {
+            last->retired_next = head;
+        } while(!_retired.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void TryReclaim() noexcept {
+        if(!_retired.load(std::memory_order_relaxed) || _active_operations.load(std::memory_order_seq_cst) != 1u) {
+            return;
+        }
+        auto* list = _retired.exchange(nullptr, std::memory_order_acq_rel);
+        if(!list) {
+            return;
+        }
+        //Anything that was looking at these segments started before they were unlinked and would still be counted.
+        if(_active_operations.load(std::memory_order_seq_cst) != 1u) {
+            auto* last = list;
+            while(last->retired_next) {
+                last = last->retired_next;
+            }
+            PushRetired(list, last);
+            return;
+        }
+        while(list) {
+            auto* next = list->retired_next;
+            ReleaseSegment(list);
+            list = next;
+        }
+    }
+
+    static void DeleteList(Segment* list) noexcept {
+        while(list) {
+            auto* next = list->retired_next;
+            delete list;
+            list = next;
+        }
+    }
+
+    alignas(LockFreeQueue::cache_line_size) std::atomic<Segment*> _head{nullptr};
+    alignas(LockFreeQueue::cache_line_size) std::atomic<Segment*> _tail{nullptr};
+    alignas(LockFreeQueue::cache_line_size) std::atomic<std::size_t> _active_operations{0u};
+    std::atomic<Segment*> _retired{nullptr};
+    std::atomic<Segment*> _spare{nullptr};
+};
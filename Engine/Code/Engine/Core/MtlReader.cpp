@@ -4,7 +4,7 @@
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
-#include "Engine/Profiling/ProfileLogScope.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Material.hpp"
@@ -110,7 +110,7 @@ namespace FileUtils {
     }
 
     bool MtlReader::Load(std::filesystem::path filepath) noexcept {
-        PROFILE_LOG_SCOPE_FUNCTION();
+        PROFILE_SCOPE_FUNCTION();
 
         namespace FS = std::filesystem;
         bool not_exist = !FS::exists(filepath);
@@ -125,7 +125,7 @@ namespace FileUtils {
     }
 
     bool MtlReader::Parse(std::filesystem::path filepath) noexcept {
-        PROFILE_LOG_SCOPE_FUNCTION();
+        PROFILE_SCOPE_FUNCTION();
         if(auto buffer = FileUtils::ReadBinaryBufferFromFile(filepath); buffer.has_value()) {
             if(std::stringstream ss{}; ss.write(reinterpret_cast<const char*>(buffer->data()), buffer->size())) {
                 buffer->clear();
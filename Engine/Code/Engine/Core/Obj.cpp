@@ -5,7 +5,7 @@
 #include "Engine/Core/MtlReader.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
-#include "Engine/Profiling/ProfileLogScope.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include "Engine/Renderer/Renderer.hpp"
 
@@ -31,7 +31,7 @@ Obj::Obj(std::filesystem::path filepath) noexcept {
 }
 
 bool Obj::Load(std::filesystem::path filepath) noexcept {
-    PROFILE_LOG_SCOPE_FUNCTION();
+    PROFILE_SCOPE_FUNCTION();
 
     namespace FS = std::filesystem;
     bool not_exist = !FS::exists(filepath);
@@ -48,7 +48,7 @@ bool Obj::Load(std::filesystem::path filepath) noexcept {
 }
 
 bool Obj::Save(std::filesystem::path filepath) noexcept {
-    PROFILE_LOG_SCOPE_FUNCTION();
+    PROFILE_SCOPE_FUNCTION();
 
     namespace FS = std::filesystem;
     filepath.make_preferred();
@@ -177,7 +177,7 @@ void Obj::Unload() noexcept {
 }
 
 bool Obj::Parse(const std::filesystem::path& filepath) noexcept {
-    PROFILE_LOG_SCOPE_FUNCTION();
+    PROFILE_SCOPE_FUNCTION();
     _verts.clear();
     _tex_coords.clear();
     _normals.clear();
@@ -0,0 +1,340 @@
+#include "Engine/Core/TaskGraph.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include "Engine/Profiling/Profiler.hpp"
+
+#include "Engine/Services/IJobSystemService.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <intrin.h>
+#include <iomanip>
+#include <unordered_map>
+
+std::size_t TaskGraph::AddStage(TaskStageDesc desc, TaskCallback cb) noexcept {
+    auto node = std::make_unique<Node>();
+    node->desc = std::move(desc);
+    node->cb = std::move(cb);
+    _nodes.push_back(std::move(node));
+    _is_dirty = true;
+    return _nodes.size() - 1u;
+}
+
+void TaskGraph::AddDependency(std::size_t before, std::size_t after) noexcept {
+    GUARANTEE_OR_DIE(before < _nodes.size() && after < _nodes.size(), "TaskGraph::AddDependency: stage index out of range.");
+    _explicit_edges.emplace_back(before, after);
+    _is_dirty = true;
+}
+
+void TaskGraph::Clear() noexcept {
+    _nodes.clear();
+    _topological_order.clear();
+    _explicit_edges.clear();
+    _timings.clear();
+    _is_dirty = true;
+}
+
+void TaskGraph::Execute(IJobSystemService& jobs, TimeUtils::FPSeconds deltaSeconds) noexcept {
+    ExecuteOn(jobs.IsRunning() ? &jobs : nullptr, deltaSeconds);
+}
+
+void TaskGraph::ExecuteSerial(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    ExecuteOn(nullptr, deltaSeconds);
+}
+
+void TaskGraph::ExecuteOn(IJobSystemService* jobs, TimeUtils::FPSeconds deltaSeconds) noexcept {
+    if(_nodes.empty()) {
+        return;
+    }
+    if(_is_dirty) {
+        Compile();
+    }
+    UpdatePriorities();
+    _jobs = jobs;
+    ResetForExecute(deltaSeconds);
+    for(std::size_t i = 0u; i < _nodes.size(); ++i) {
+        if(_nodes[i]->dependencies.empty()) {
+            MakeReady(i);
+        }
+    }
+    //The calling thread owns MainThread stages and helps with the rest so the graph always makes progress.
+    auto idle_count = 0u;
+    while(_remaining != 0u) {
+        auto index = std::size_t{0u};
+        if(TryPopReady(_ready_main, index) || TryPopReady(_ready_any, index)) {
+            RunNode(index);
+            idle_count = 0u;
+        } else {
+            HelpOrBackOff(idle_count);
+        }
+    }
+    //Helper jobs reference this graph; wait for the ones that found nothing left to run.
+    //Queued helpers may be waiting for a worker, so run them here rather than idling.
+    idle_count = 0u;
+    while(_active_helpers != 0u) {
+        HelpOrBackOff(idle_count);
+    }
+    _jobs = nullptr;
+    FinishExecute();
+}
+
+void TaskGraph::Compile() noexcept {
+    struct ResourceState {
+        std::size_t last_writer = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> readers_since_write{};
+    };
+    constexpr auto no_writer = static_cast<std::size_t>(-1);
+    std::unordered_map<std::string, ResourceState> resources{};
+    for(auto& node : _nodes) {
+        node->dependencies.clear();
+        node->dependents.clear();
+    }
+    for(std::size_t i = 0u; i < _nodes.size(); ++i) {
+        auto& node = *_nodes[i];
+        for(const auto& read : node.desc.reads) {
+            auto& state = resources[read];
+            if(state.last_writer != no_writer) {
+                node.dependencies.push_back(state.last_writer);
+            }
+            state.readers_since_write.push_back(i);
+        }
+        for(const auto& write : node.desc.writes) {
+            auto& state = resources[write];
+            if(state.last_writer != no_writer) {
+                node.dependencies.push_back(state.last_writer);
+            }
+            for(const auto reader : state.readers_since_write) {
+                if(reader != i) {
+                    node.dependencies.push_back(reader);
+                }
+            }
+            state.last_writer = i;
+            state.readers_since_write.clear();
+        }
+    }
+    for(const auto& [before, after] : _explicit_edges) {
+        _nodes[after]->dependencies.push_back(before);
+    }
+    for(std::size_t i = 0u; i < _nodes.size(); ++i) {
+        auto& deps = _nodes[i]->dependencies;
+        std::sort(std::begin(deps), std::end(deps));
+        deps.erase(std::unique(std::begin(deps), std::end(deps)), std::end(deps));
+        for(const auto dep : deps) {
+            _nodes[dep]->dependents.push_back(i);
+        }
+    }
+
+    _topological_order.clear();
+    _topological_order.reserve(_nodes.size());
+    std::vector<std::size_t> in_degree(_nodes.size());
+    for(std::size_t i = 0u; i < _nodes.size(); ++i) {
+        in_degree[i] = _nodes[i]->dependencies.size();
+        if(in_degree[i] == 0u) {
+            _topological_order.push_back(i);
+        }
+    }
+    for(std::size_t head = 0u; head < _topological_order.size(); ++head) {
+        for(const auto dependent : _nodes[_topological_order[head]]->dependents) {
+            if(--in_degree[dependent] == 0u) {
+                _topological_order.push_back(dependent);
+            }
+        }
+    }
+    GUARANTEE_OR_DIE(_topological_order.size() == _nodes.size(), "TaskGraph contains a dependency cycle.");
+    _timings.resize(_nodes.size());
+    _is_dirty = false;
+}
+
+void TaskGraph::UpdatePriorities() noexcept {
+    //Priority is the length of the longest path from the start of a stage to the end of the frame.
+    for(auto iter = std::rbegin(_topological_order); iter != std::rend(_topological_order); ++iter) {
+        auto& node = *_nodes[*iter];
+        auto longest_tail = 0.0f;
+        for(const auto dependent : node.dependents) {
+            longest_tail = (std::max)(longest_tail, _nodes[dependent]->priority);
+        }
+        node.priority = node.estimated_cost_ms + longest_tail;
+    }
+}
+
+void TaskGraph::ResetForExecute(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    _delta_seconds = deltaSeconds;
+    _ready_any.clear();
+    _ready_main.clear();
+    _ready_any.reserve(_nodes.size());
+    _ready_main.reserve(_nodes.size());
+    for(auto& node : _nodes) {
+        node->pending = node->dependencies.size();
+    }
+    _remaining = _nodes.size();
+    _active_helpers = 0u;
+    _frame_start = TimeUtils::Now();
+}
+
+void TaskGraph::RunNode(std::size_t index) noexcept {
+    auto& node = *_nodes[index];
+    const auto start = TimeUtils::Now();
+    if(node.cb) {
+        PROFILE_SCOPE(node.desc.name.c_str());
+        node.cb(_delta_seconds);
+    }
+    const auto end = TimeUtils::Now();
+    auto& timing = _timings[index];
+    timing.name = node.desc.name;
+    timing.thread_id = std::this_thread::get_id();
+    timing.start = TimeUtils::FPMilliseconds{start - _frame_start};
+    timing.duration = TimeUtils::FPMilliseconds{end - start};
+    timing.priority = node.priority;
+    for(const auto dependent : node.dependents) {
+        if(--_nodes[dependent]->pending == 0u) {
+            MakeReady(dependent);
+        }
+    }
+    std::scoped_lock<std::mutex> lock(_ready_cs);
+    if(--_remaining == 0u) {
+        _progress_signal.notify_all();
+    }
+}
+
+void TaskGraph::MakeReady(std::size_t index) noexcept {
+    const auto by_priority = [this](std::size_t a, std::size_t b) { return _nodes[a]->priority < _nodes[b]->priority; };
+    const auto is_main = _nodes[index]->desc.affinity == TaskAffinity::MainThread;
+    {
+        std::scoped_lock<std::mutex> lock(_ready_cs);
+        auto& queue = is_main ? _ready_main : _ready_any;
+        queue.push_back(index);
+        std::push_heap(std::begin(queue), std::end(queue), by_priority);
+        _progress_signal.notify_all();
+    }
+    if(is_main || !_jobs) {
+        return;
+    }
+    //One helper per ready stage; each takes whichever ready stage has the highest priority when it starts.
+    ++_active_helpers;
+    _jobs->Run(JobType::Generic, [this](void*) {
+        auto next = std::size_t{0u};
+        if(TryPopReady(_ready_any, next)) {
+            RunNode(next);
+        }
+        --_active_helpers;
+    }, nullptr);
+}
+
+//Mirrors JobSystem::Wait: run other jobs while stages are in flight elsewhere, and when there are none
+//back off from spinning to yielding and finally park until a stage becomes ready or the graph drains.
+void TaskGraph::HelpOrBackOff(unsigned int& idle_count) noexcept {
+    constexpr auto max_spins = 64u;
+    constexpr auto max_yields = 16u;
+    if(_jobs && _jobs->IsRunning() && _jobs->TryHelpWhileWaiting()) {
+        idle_count = 0u;
+        return;
+    }
+    if(idle_count < max_spins) {
+        _mm_pause();
+    } else if(idle_count < max_spins + max_yields) {
+        std::this_thread::yield();
+    } else {
+        //Bounded because helpers finishing and jobs queued by other systems do not signal; missing them only costs latency.
+        std::unique_lock<std::mutex> lock(_ready_cs);
+        _progress_signal.wait_for(lock, std::chrono::milliseconds{1}, [this]() -> bool {
+            if(_remaining == 0u) {
+                return _active_helpers == 0u;
+            }
+            return !_ready_main.empty() || !_ready_any.empty();
+        });
+        idle_count = 0u;
+        return;
+    }
+    ++idle_count;
+}
+
+bool TaskGraph::TryPopReady(std::vector<std::size_t>& queue, std::size_t& index) noexcept {
+    const auto by_priority = [this](std::size_t a, std::size_t b) { return _nodes[a]->priority < _nodes[b]->priority; };
+    std::scoped_lock<std::mutex> lock(_ready_cs);
+    if(queue.empty()) {
+        return false;
+    }
+    std::pop_heap(std::begin(queue), std::end(queue), by_priority);
+    index = queue.back();
+    queue.pop_back();
+    return true;
+}
+
+void TaskGraph::FinishExecute() noexcept {
+    _frame_duration = TimeUtils::FPMilliseconds{TimeUtils::Now() - _frame_start};
+
+    //Longest chain of measured durations through the executed graph.
+    constexpr auto none = static_cast<std::size_t>(-1);
+    std::vector<float> path_length(_nodes.size(), 0.0f);
+    std::vector<std::size_t> path_parent(_nodes.size(), none);
+    auto tail = none;
+    for(const auto index : _topological_order) {
+        auto longest_head = 0.0f;
+        for(const auto dep : _nodes[index]->dependencies) {
+            if(path_parent[index] == none || path_length[dep] > longest_head) {
+                longest_head = path_length[dep];
+                path_parent[index] = dep;
+            }
+        }
+        path_length[index] = longest_head + _timings[index].duration.count();
+        if(tail == none || path_length[tail] < path_length[index]) {
+            tail = index;
+        }
+        _timings[index].on_critical_path = false;
+    }
+    _critical_path_duration = TimeUtils::FPMilliseconds{tail == none ? 0.0f : path_length[tail]};
+    for(auto index = tail; index != none; index = path_parent[index]) {
+        _timings[index].on_critical_path = true;
+    }
+
+    //Smooth the cost estimates so one slow frame does not reshuffle priorities.
+    constexpr auto smoothing = 0.25f;
+    for(std::size_t i = 0u; i < _nodes.size(); ++i) {
+        auto& node = *_nodes[i];
+        const auto measured = _timings[i].duration.count();
+        node.estimated_cost_ms = node.has_estimate ? node.estimated_cost_ms + (measured - node.estimated_cost_ms) * smoothing : measured;
+        node.has_estimate = true;
+    }
+}
+
+std::size_t TaskGraph::GetStageCount() const noexcept {
+    return _nodes.size();
+}
+
+const std::vector<TaskStageTiming>& TaskGraph::GetLastFrameTimings() const noexcept {
+    return _timings;
+}
+
+TimeUtils::FPMilliseconds TaskGraph::GetLastFrameDuration() const noexcept {
+    return _frame_duration;
+}
+
+TimeUtils::FPMilliseconds TaskGraph::GetLastCriticalPathDuration() const noexcept {
+    return _critical_path_duration;
+}
+
+const std::vector<std::size_t>& TaskGraph::GetDependencies(std::size_t stage) const noexcept {
+    return _nodes[stage]->dependencies;
+}
+
+void TaskGraph::DumpLastFrame(std::ostream& out) const noexcept {
+    const auto old_flags = out.flags();
+    const auto old_precision = out.precision();
+    out << "TaskGraph: " << _nodes.size() << " stages, frame " << std::fixed << std::setprecision(3) << _frame_duration.count() << " ms, critical path " << _critical_path_duration.count() << " ms\n";
+    out << "  " << std::left << std::setw(24) << "stage" << std::right << std::setw(12) << "start ms" << std::setw(14) << "duration ms" << std::setw(12) << "priority" << "  " << std::left << std::setw(20) << "thread" << "after\n";
+    for(const auto index : _topological_order) {
+        const auto& timing = _timings[index];
+        out << (timing.on_critical_path ? "* " : "  ");
+        out << std::left << std::setw(24) << _nodes[index]->desc.name;
+        out << std::right << std::setw(12) << timing.start.count() << std::setw(14) << timing.duration.count() << std::setw(12) << timing.priority;
+        out << "  " << std::left << std::setw(20) << timing.thread_id;
+        const auto& deps = _nodes[index]->dependencies;
+        for(auto iter = std::cbegin(deps); iter != std::cend(deps); ++iter) {
+            out << (iter == std::cbegin(deps) ? "" : ", ") << _nodes[*iter]->desc.name;
+        }
+        out << '\n';
+    }
+    out.flags(old_flags);
+    out.precision(old_precision);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class IJobSystemService;
+
+enum class TaskAffinity : unsigned int {
+    AnyThread,
+    MainThread,
+    Max,
+};
+
+//A stage declares the named resources it reads and writes.
+//Edges are inferred in declaration order: a stage runs after the last earlier writer of anything it touches
+//and after every earlier reader of anything it writes.
+struct TaskStageDesc {
+    std::string name{};
+    std::vector<std::string> reads{};
+    std::vector<std::string> writes{};
+    TaskAffinity affinity = TaskAffinity::AnyThread;
+};
+
+//Timing of a single stage from the most recent Execute, relative to the start of that Execute.
+struct TaskStageTiming {
+    std::string name{};
+    std::thread::id thread_id{};
+    TimeUtils::FPMilliseconds start{};
+    TimeUtils::FPMilliseconds duration{};
+    float priority = 0.0f;
+    bool on_critical_path = false;
+};
+
+//Frame task graph: independent stages run concurrently on the generic job workers, MainThread stages
+//run on the thread that calls Execute. When several stages are ready the one with the longest remaining
+//path to the end of the frame (using the measured cost of previous frames) is started first.
+class TaskGraph {
+public:
+    using TaskCallback = std::function<void(TimeUtils::FPSeconds)>;
+
+    TaskGraph() noexcept = default;
+    TaskGraph(const TaskGraph& other) = delete;
+    TaskGraph(TaskGraph&& other) = delete;
+    TaskGraph& operator=(const TaskGraph& rhs) = delete;
+    TaskGraph& operator=(TaskGraph&& rhs) = delete;
+    ~TaskGraph() noexcept = default;
+
+    std::size_t AddStage(TaskStageDesc desc, TaskCallback cb) noexcept;
+    //Explicit ordering for dependencies that are not expressed through resources.
+    void AddDependency(std::size_t before, std::size_t after) noexcept;
+    void Clear() noexcept;
+
+    void Execute(IJobSystemService& jobs, TimeUtils::FPSeconds deltaSeconds) noexcept;
+    //Runs every stage on the calling thread in dependency order.
+    void ExecuteSerial(TimeUtils::FPSeconds deltaSeconds) noexcept;
+
+    [[nodiscard]] std::size_t GetStageCount() const noexcept;
+    [[nodiscard]] const std::vector<TaskStageTiming>& GetLastFrameTimings() const noexcept;
+    [[nodiscard]] TimeUtils::FPMilliseconds GetLastFrameDuration() const noexcept;
+    [[nodiscard]] TimeUtils::FPMilliseconds GetLastCriticalPathDuration() const noexcept;
+    [[nodiscard]] const std::vector<std::size_t>& GetDependencies(std::size_t stage) const noexcept;
+
+    //Writes the executed graph with per-stage timings, critical path stages are marked with '*'.
+    void DumpLastFrame(std::ostream& out) const noexcept;
+
+protected:
+private:
+    struct Node {
+        TaskStageDesc desc{};
+        TaskCallback cb{};
+        std::vector<std::size_t> dependencies{};
+        std::vector<std::size_t> dependents{};
+        std::atomic<std::size_t> pending{0u};
+        float estimated_cost_ms = 1.0f;
+        float priority = 0.0f;
+        bool has_estimate = false;
+    };
+
+    void ExecuteOn(IJobSystemService* jobs, TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void Compile() noexcept;
+    void UpdatePriorities() noexcept;
+    void ResetForExecute(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void RunNode(std::size_t index) noexcept;
+    void MakeReady(std::size_t index) noexcept;
+    [[nodiscard]] bool TryPopReady(std::vector<std::size_t>& queue, std::size_t& index) noexcept;
+    void HelpOrBackOff(unsigned int& idle_count) noexcept;
+    void FinishExecute() noexcept;
+
+    std::vector<std::unique_ptr<Node>> _nodes{};
+    std::vector<std::size_t> _topological_order{};
+    std::vector<std::pair<std::size_t, std::size_t>> _explicit_edges{};
+    std::vector<std::size_t> _ready_any{};
+    std::vector<std::size_t> _ready_main{};
+    std::vector<TaskStageTiming> _timings{};
+    std::mutex _ready_cs{};
+    //Signalled under _ready_cs when a stage becomes ready or the last stage finishes.
+    std::condition_variable _progress_signal{};
+    std::atomic<std::size_t> _remaining{0u};
+    std::atomic<std::size_t> _active_helpers{0u};
+    IJobSystemService* _jobs = nullptr;
+    TimeUtils::FPSeconds _delta_seconds{};
+    TimeUtils::FPMilliseconds _frame_duration{};
+    TimeUtils::FPMilliseconds _critical_path_duration{};
+    decltype(TimeUtils::Now()) _frame_start{};
+    bool _is_dirty = true;
+};
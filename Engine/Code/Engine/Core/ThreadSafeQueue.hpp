@@ -15,6 +15,16 @@ public:
         _queue.pop();
     }
 
+    [[nodiscard]] bool try_pop(T& value) noexcept {
+        std::scoped_lock<std::mutex> lock(_cs);
+        if(_queue.empty()) {
+            return false;
+        }
+        value = std::move(_queue.front());
+        _queue.pop();
+        return true;
+    }
+
     template<class... Args>
     decltype(auto) emplace(Args&&... args) {
         std::scoped_lock<std::mutex> lock(_cs);
@@ -0,0 +1,95 @@
+#pragma once
+//Chase-Lev work-stealing deque.
+//https://www.di.ens.fr/~zappa/readings/ppopp13.pdf
+//Correct and Efficient Work-Stealing for Weak Memory Models - Le, Pop, Cohen, Zappa Nardelli [PPoPP 2013]
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+//Fixed-capacity deque. The owning thread pushes and pops at the bottom,
+//any other thread may steal from the top. Push fails when the deque is full
+//so the caller can fall back to a shared queue instead of growing.
+template<typename T, std::size_t Capacity = 4096>
+class WorkStealingQueue {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingQueue elements must be trivially copyable.");
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "WorkStealingQueue Capacity must be a power of two.");
+
+    WorkStealingQueue() noexcept = default;
+    WorkStealingQueue(const WorkStealingQueue& other) = delete;
+    WorkStealingQueue(WorkStealingQueue&& other) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue& rhs) = delete;
+    WorkStealingQueue& operator=(WorkStealingQueue&& rhs) = delete;
+    ~WorkStealingQueue() noexcept = default;
+
+    //Owner thread only.
+    [[nodiscard]] bool push(const T& value) noexcept {
+        const auto b = _bottom.load(std::memory_order_relaxed);
+        const auto t = _top.load(std::memory_order_acquire);
+        if(static_cast<std::size_t>(b - t) >= Capacity) {
+            return false;
+        }
+        _buffer[static_cast<std::size_t>(b) & _mask].store(value, std::memory_order_relaxed);
+        _bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    //Owner thread only. Takes the most recently pushed element.
+    [[nodiscard]] bool pop(T& value) noexcept {
+        const auto b = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = _top.load(std::memory_order_relaxed);
+        if(b < t) {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        value = _buffer[static_cast<std::size_t>(b) & _mask].load(std::memory_order_relaxed);
+        if(t != b) {
+            return true;
+        }
+        //Last element: race any thieves for it.
+        const bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    //Any thread. Takes the oldest element.
+    [[nodiscard]] bool steal(T& value) noexcept {
+        auto t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto b = _bottom.load(std::memory_order_acquire);
+        if(b <= t) {
+            return false;
+        }
+        value = _buffer[static_cast<std::size_t>(t) & _mask].load(std::memory_order_relaxed);
+        return _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    //Approximate when called concurrently with push/pop/steal.
+    [[nodiscard]] bool empty() const noexcept {
+        const auto t = _top.load(std::memory_order_acquire);
+        const auto b = _bottom.load(std::memory_order_acquire);
+        return b <= t;
+    }
+
+    //Approximate when called concurrently with push/pop/steal.
+    [[nodiscard]] std::size_t size() const noexcept {
+        const auto t = _top.load(std::memory_order_acquire);
+        const auto b = _bottom.load(std::memory_order_acquire);
+        return b <= t ? std::size_t{0u} : static_cast<std::size_t>(b - t);
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+protected:
+private:
+    static constexpr std::size_t _mask = Capacity - 1;
+    alignas(64) std::atomic<std::int64_t> _top{0};
+    alignas(64) std::atomic<std::int64_t> _bottom{0};
+    alignas(64) std::array<std::atomic<T>, Capacity> _buffer{};
+};
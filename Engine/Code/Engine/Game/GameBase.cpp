@@ -24,6 +24,10 @@ void GameBase::EndFrame() noexcept {
     /* DO NOTHING */
 }
 
+void GameBase::RegisterFrameStages([[maybe_unused]] TaskGraph& frameGraph) noexcept {
+    /* DO NOTHING */
+}
+
 void GameBase::HandleWindowResize([[maybe_unused]] unsigned int newWidth, [[maybe_unused]] unsigned int newHeight) noexcept {
     /* DO NOTHING */
 }
@@ -7,6 +7,7 @@
 #include <memory>
 
 class Scene;
+class TaskGraph;
 
 class GameBase {
 public:
@@ -23,6 +24,9 @@ public:
     virtual void Render() const noexcept;
     virtual void EndFrame() noexcept;
 
+    //Called once after Initialize. Stages added here run after the game's Update stage and before render submission.
+    virtual void RegisterFrameStages([[maybe_unused]] TaskGraph& frameGraph) noexcept;
+
     virtual void HandleWindowResize([[maybe_unused]] unsigned int newWidth, [[maybe_unused]] unsigned int newHeight) noexcept;
 
     virtual const GameSettings& GetSettings() const noexcept;
@@ -16,7 +16,7 @@
 #include "Engine/Math/Rotator.hpp"
 #include "Engine/Math/Quaternion.hpp"
 #include "Engine/Math/Sphere3.hpp"
-#include "Engine/Profiling/ProfileLogScope.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -725,7 +725,7 @@ bool IsPointInside(const Polygon2& poly2, const Vector2& point) noexcept {
     //Crossing Number Test
     const auto crossing_inside = [&]()
     {
-        PROFILE_LOG_SCOPE("Crossing Inside");
+        PROFILE_SCOPE("Crossing Inside");
         int cn = 0; // the  crossing number counter
         const auto n = pointCount;
         // loop through all edges of the polygon
@@ -743,7 +743,7 @@ bool IsPointInside(const Polygon2& poly2, const Vector2& point) noexcept {
 #endif
     //Winding Number Test
     const auto winding_inside = [&]() {
-        PROFILE_LOG_SCOPE("Winding Inside");
+        PROFILE_SCOPE("Winding Inside");
         int wn = 0; // the  winding number counter
         const auto isLeft = [&](const Vector2& P0, const Vector2& P1, const Vector2& P2) {
             return ((P1.x - P0.x) * (P2.y - P0.y)
@@ -0,0 +1,117 @@
+#include "Engine/Memory/ChunkedMemoryPool.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+constexpr std::size_t chunk_alignment = alignof(std::max_align_t);
+constexpr std::size_t chunk_header_size = (sizeof(void*) + chunk_alignment - 1u) / chunk_alignment * chunk_alignment;
+} // namespace
+
+ChunkedMemoryPool::ChunkedMemoryPool(std::size_t blockSize, std::size_t blocksPerChunk /*= 256u*/, std::pmr::memory_resource* upstream /*= std::pmr::get_default_resource()*/) noexcept
+: _upstream{upstream}
+, _blocks_per_chunk{(std::max)(blocksPerChunk, std::size_t{1u})} {
+    constexpr auto link_size = sizeof(FreeBlock);
+    _block_size = ((std::max)(blockSize, link_size) + link_size - 1u) / link_size * link_size;
+    //Every block starts at a multiple of the block size from a max-aligned base,
+    //so it is aligned to the largest power of two dividing the block size.
+    _block_alignment = (std::min)(_block_size & (~_block_size + 1u), chunk_alignment);
+}
+
+ChunkedMemoryPool::~ChunkedMemoryPool() noexcept {
+    release();
+}
+
+void ChunkedMemoryPool::release() noexcept {
+    const auto chunk_bytes = GetChunkBytes();
+    while(_chunks) {
+        auto* next = _chunks->next;
+        _upstream->deallocate(_chunks, chunk_bytes, chunk_alignment);
+        _chunks = next;
+    }
+    _free_list = nullptr;
+    _untouched = nullptr;
+    _untouched_end = nullptr;
+    _chunk_count = 0u;
+    _count = 0u;
+}
+
+void* ChunkedMemoryPool::allocate_block() {
+    if(_free_list) {
+        auto* block = _free_list;
+        _free_list = block->next;
+        ++_count;
+        return block;
+    }
+    if(_untouched == _untouched_end) {
+        AllocateChunk();
+    }
+    auto* block = _untouched;
+    _untouched += _block_size;
+    ++_count;
+    return block;
+}
+
+void ChunkedMemoryPool::deallocate_block(void* ptr) noexcept {
+    _free_list = ::new(ptr) FreeBlock{_free_list};
+    --_count;
+}
+
+void ChunkedMemoryPool::AllocateChunk() {
+    auto* chunk = static_cast<std::byte*>(_upstream->allocate(GetChunkBytes(), chunk_alignment));
+    _chunks = ::new(chunk) ChunkHeader{_chunks};
+    _untouched = chunk + chunk_header_size;
+    _untouched_end = _untouched + _block_size * _blocks_per_chunk;
+    ++_chunk_count;
+}
+
+std::size_t ChunkedMemoryPool::GetChunkBytes() const noexcept {
+    return chunk_header_size + _block_size * _blocks_per_chunk;
+}
+
+bool ChunkedMemoryPool::IsPoolRequest(std::size_t bytes, std::size_t alignment) const noexcept {
+    return bytes <= _block_size && alignment <= _block_alignment;
+}
+
+void* ChunkedMemoryPool::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if(IsPoolRequest(bytes, alignment)) {
+        return allocate_block();
+    }
+    return _upstream->allocate(bytes, alignment);
+}
+
+void ChunkedMemoryPool::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    if(IsPoolRequest(bytes, alignment)) {
+        deallocate_block(ptr);
+        return;
+    }
+    _upstream->deallocate(ptr, bytes, alignment);
+}
+
+bool ChunkedMemoryPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+std::size_t ChunkedMemoryPool::block_size() const noexcept {
+    return _block_size;
+}
+
+std::size_t ChunkedMemoryPool::block_alignment() const noexcept {
+    return _block_alignment;
+}
+
+std::size_t ChunkedMemoryPool::blocks_per_chunk() const noexcept {
+    return _blocks_per_chunk;
+}
+
+std::size_t ChunkedMemoryPool::chunk_count() const noexcept {
+    return _chunk_count;
+}
+
+std::size_t ChunkedMemoryPool::size() const noexcept {
+    return _count;
+}
+
+std::pmr::memory_resource* ChunkedMemoryPool::upstream_resource() const noexcept {
+    return _upstream;
+}
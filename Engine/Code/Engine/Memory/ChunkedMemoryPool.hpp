@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+//Growable fixed-block pool: blocks come from chunks requested from the upstream resource as the pool runs dry
+//and are recycled through an intrusive free list, so allocation and deallocation are O(1) in any order.
+//Chunks are only returned upstream by release() or the destructor.
+//Requests larger than a block or more strictly aligned than a block are forwarded to the upstream resource.
+//Not synchronized; use ThreadCachedPoolResource when several threads share a pool.
+class ChunkedMemoryPool : public std::pmr::memory_resource {
+public:
+    explicit ChunkedMemoryPool(std::size_t blockSize, std::size_t blocksPerChunk = 256u, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+    ChunkedMemoryPool(const ChunkedMemoryPool& other) = delete;
+    ChunkedMemoryPool(ChunkedMemoryPool&& other) = delete;
+    ChunkedMemoryPool& operator=(const ChunkedMemoryPool& rhs) = delete;
+    ChunkedMemoryPool& operator=(ChunkedMemoryPool&& rhs) = delete;
+    ~ChunkedMemoryPool() noexcept override;
+
+    //Returns every chunk to the upstream resource. Outstanding blocks become invalid.
+    void release() noexcept;
+
+    //Direct block access without the size checks of allocate/deallocate. Throws std::bad_alloc if upstream does.
+    [[nodiscard]] void* allocate_block();
+    void deallocate_block(void* ptr) noexcept;
+
+    [[nodiscard]] std::size_t block_size() const noexcept;
+    [[nodiscard]] std::size_t block_alignment() const noexcept;
+    [[nodiscard]] std::size_t blocks_per_chunk() const noexcept;
+    [[nodiscard]] std::size_t chunk_count() const noexcept;
+    //Number of pool blocks currently handed out. Upstream allocations are not counted.
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+protected:
+    [[nodiscard]] void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next = nullptr;
+    };
+    struct ChunkHeader {
+        ChunkHeader* next = nullptr;
+    };
+
+    [[nodiscard]] bool IsPoolRequest(std::size_t bytes, std::size_t alignment) const noexcept;
+    void AllocateChunk();
+    [[nodiscard]] std::size_t GetChunkBytes() const noexcept;
+
+    std::pmr::memory_resource* _upstream = nullptr;
+    ChunkHeader* _chunks = nullptr;
+    FreeBlock* _free_list = nullptr;
+    //Unused tail of the newest chunk, carved one block at a time so new chunks are not walked up front.
+    std::byte* _untouched = nullptr;
+    std::byte* _untouched_end = nullptr;
+    std::size_t _block_size = 0u;
+    std::size_t _block_alignment = 0u;
+    std::size_t _blocks_per_chunk = 0u;
+    std::size_t _chunk_count = 0u;
+    std::size_t _count = 0u;
+};
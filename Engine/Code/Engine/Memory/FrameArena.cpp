@@ -0,0 +1,58 @@
+#include "Engine/Memory/FrameArena.hpp"
+
+#include "Engine/Memory/LinearArena.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace FrameArena {
+
+namespace {
+std::atomic<std::uint64_t> s_frame_index{0u};
+
+struct ThreadArenas {
+    std::array<LinearArena, 2> arenas;
+    std::uint64_t frame_index = 0u;
+};
+
+//Lazily resets whichever arenas are older than the previous frame, then returns this thread's pair.
+ThreadArenas& GetThreadArenas() noexcept {
+    thread_local ThreadArenas t_arenas;
+    const auto frame_index = s_frame_index.load(std::memory_order_acquire);
+    if(t_arenas.frame_index != frame_index) {
+        if(frame_index - t_arenas.frame_index > 1u) {
+            t_arenas.arenas[0].Reset();
+            t_arenas.arenas[1].Reset();
+        } else {
+            t_arenas.arenas[frame_index & 1u].Reset();
+        }
+        t_arenas.frame_index = frame_index;
+    }
+    return t_arenas;
+}
+} // namespace
+
+std::pmr::memory_resource* Current() noexcept {
+    auto& t_arenas = GetThreadArenas();
+    return &t_arenas.arenas[t_arenas.frame_index & 1u];
+}
+
+std::pmr::memory_resource* Previous() noexcept {
+    auto& t_arenas = GetThreadArenas();
+    return &t_arenas.arenas[(t_arenas.frame_index + 1u) & 1u];
+}
+
+void EndFrame() noexcept {
+    s_frame_index.fetch_add(1u, std::memory_order_release);
+}
+
+std::uint64_t GetFrameIndex() noexcept {
+    return s_frame_index.load(std::memory_order_acquire);
+}
+
+std::size_t GetThreadBytesUsed() noexcept {
+    auto& t_arenas = GetThreadArenas();
+    return t_arenas.arenas[t_arenas.frame_index & 1u].bytes_used();
+}
+
+} // namespace FrameArena
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+//Per-thread, double-buffered scratch memory for data that only lives for a frame.
+//Each thread owns two LinearArenas: one for the current frame and one holding what it allocated last frame,
+//so data produced during update can still be read by the render stage of the next frame.
+//EndFrame advances the frame; a thread resets its older arena the first time it touches the arenas in the new frame,
+//so allocating never takes a lock and costs a pointer bump.
+//Frame memory must not be kept past the end of the following frame, and deallocating it is a no-op.
+namespace FrameArena {
+
+//This thread's arena for the current frame.
+[[nodiscard]] std::pmr::memory_resource* Current() noexcept;
+//This thread's arena holding its allocations from the previous frame.
+[[nodiscard]] std::pmr::memory_resource* Previous() noexcept;
+
+//Called once per frame by the App after every frame stage has finished.
+void EndFrame() noexcept;
+
+[[nodiscard]] std::uint64_t GetFrameIndex() noexcept;
+//Bytes allocated by the calling thread so far this frame.
+[[nodiscard]] std::size_t GetThreadBytesUsed() noexcept;
+
+} // namespace FrameArena
@@ -0,0 +1,104 @@
+#include "Engine/Memory/LinearArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+constexpr std::size_t block_alignment = alignof(std::max_align_t);
+constexpr std::size_t block_header_size = (2u * sizeof(std::size_t) + block_alignment - 1u) / block_alignment * block_alignment;
+} // namespace
+
+LinearArena::LinearArena(std::size_t initialBytes /*= 64u * 1024u*/, std::pmr::memory_resource* upstream /*= std::pmr::get_default_resource()*/) noexcept
+: _upstream{upstream}
+, _next_block_size{(std::max)(initialBytes, std::size_t{256u})} {
+    /* DO NOTHING */
+}
+
+LinearArena::~LinearArena() noexcept {
+    release();
+}
+
+void LinearArena::Reset() noexcept {
+    //Several blocks means the last run outgrew the arena; replace them with one block that fits it all.
+    if(_block_count > 1u) {
+        _next_block_size = _capacity;
+        FreeBlocks();
+    }
+    if(_blocks) {
+        _cursor = reinterpret_cast<std::byte*>(_blocks) + block_header_size;
+        _end = _cursor + _blocks->size;
+    }
+    _bytes_used = 0u;
+}
+
+void LinearArena::release() noexcept {
+    FreeBlocks();
+    _bytes_used = 0u;
+}
+
+void LinearArena::FreeBlocks() noexcept {
+    while(_blocks) {
+        auto* next = _blocks->next;
+        _upstream->deallocate(_blocks, block_header_size + _blocks->size, block_alignment);
+        _blocks = next;
+    }
+    _cursor = nullptr;
+    _end = nullptr;
+    _capacity = 0u;
+    _block_count = 0u;
+}
+
+void LinearArena::AllocateBlock(std::size_t minimum_bytes) {
+    const auto size = (std::max)(_next_block_size, minimum_bytes);
+    auto* memory = static_cast<std::byte*>(_upstream->allocate(block_header_size + size, block_alignment));
+    _blocks = ::new(memory) BlockHeader{_blocks, size};
+    _cursor = memory + block_header_size;
+    _end = _cursor + size;
+    _capacity += size;
+    ++_block_count;
+    _next_block_size = size * 2u;
+}
+
+void* LinearArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    const auto align_up = [alignment](std::byte* ptr) {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        return ptr + ((alignment - (address & (alignment - 1u))) & (alignment - 1u));
+    };
+    auto* result = _cursor ? align_up(_cursor) : nullptr;
+    if(!result || static_cast<std::size_t>(_end - result) < bytes) {
+        AllocateBlock(bytes + alignment);
+        result = align_up(_cursor);
+    }
+    _bytes_used += bytes;
+    _cursor = result + bytes;
+    return result;
+}
+
+void LinearArena::do_deallocate(void* ptr, std::size_t bytes, std::size_t /*alignment*/) {
+    //Only the most recent allocation can be given back, e.g. a scratch buffer released before anything else is allocated.
+    if(static_cast<std::byte*>(ptr) + bytes == _cursor) {
+        _cursor = static_cast<std::byte*>(ptr);
+        _bytes_used -= bytes;
+    }
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+std::size_t LinearArena::bytes_used() const noexcept {
+    return _bytes_used;
+}
+
+std::size_t LinearArena::capacity() const noexcept {
+    return _capacity;
+}
+
+std::size_t LinearArena::block_count() const noexcept {
+    return _block_count;
+}
+
+std::pmr::memory_resource* LinearArena::upstream_resource() const noexcept {
+    return _upstream;
+}
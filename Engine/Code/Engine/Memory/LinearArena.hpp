@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+//Bump allocator: allocation is a pointer bump, deallocation is a no-op and Reset frees everything at once.
+//When the current block is exhausted a larger one is requested from upstream; Reset folds those blocks into
+//a single block big enough for the whole previous run, so a steady workload settles into one block.
+//Not synchronized.
+class LinearArena : public std::pmr::memory_resource {
+public:
+    explicit LinearArena(std::size_t initialBytes = 64u * 1024u, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+    LinearArena(const LinearArena& other) = delete;
+    LinearArena(LinearArena&& other) = delete;
+    LinearArena& operator=(const LinearArena& rhs) = delete;
+    LinearArena& operator=(LinearArena&& rhs) = delete;
+    ~LinearArena() noexcept override;
+
+    //Invalidates every allocation made since the last Reset.
+    void Reset() noexcept;
+    //Reset and return every block to the upstream resource.
+    void release() noexcept;
+
+    //Bytes handed out since the last Reset, not counting alignment padding.
+    [[nodiscard]] std::size_t bytes_used() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t block_count() const noexcept;
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+protected:
+    [[nodiscard]] void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct BlockHeader {
+        BlockHeader* next = nullptr;
+        std::size_t size = 0u;
+    };
+
+    void AllocateBlock(std::size_t minimum_bytes);
+    void FreeBlocks() noexcept;
+
+    std::pmr::memory_resource* _upstream = nullptr;
+    BlockHeader* _blocks = nullptr;
+    std::byte* _cursor = nullptr;
+    std::byte* _end = nullptr;
+    std::size_t _next_block_size = 0u;
+    std::size_t _bytes_used = 0u;
+    std::size_t _capacity = 0u;
+    std::size_t _block_count = 0u;
+};
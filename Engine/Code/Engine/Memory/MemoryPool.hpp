@@ -1,65 +1,124 @@
 #pragma once
 
-#include <cstdlib>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <new>
 
+//Fixed capacity pool of maxSize blocks, each large enough to hold one T.
+//Blocks are allocated and freed in any order in O(1) through an intrusive free list threaded through the unused blocks.
+//Requests that do not fit in a block, or that arrive after every block is in use, are forwarded to the upstream resource.
+//Not synchronized; use ThreadCachedPoolResource when several threads share a pool.
 template<typename T, std::size_t maxSize>
-class MemoryPool {
+class MemoryPool : public std::pmr::memory_resource {
+    struct FreeBlock {
+        FreeBlock* next = nullptr;
+    };
+
 public:
+    static constexpr std::size_t block_alignment = (std::max)(alignof(T), alignof(FreeBlock));
+    static constexpr std::size_t block_size = ((std::max)(sizeof(T), sizeof(FreeBlock)) + block_alignment - 1u) / block_alignment * block_alignment;
+
     MemoryPool() noexcept;
+    explicit MemoryPool(std::pmr::memory_resource* upstream) noexcept;
     MemoryPool(const MemoryPool& other) = delete;
     MemoryPool(MemoryPool&& other) = delete;
     MemoryPool& operator=(const MemoryPool& rhs) = delete;
     MemoryPool& operator=(MemoryPool&& rhs) = delete;
-    ~MemoryPool() noexcept;
+    ~MemoryPool() noexcept override;
 
-    [[nodiscard]] void* allocate(std::size_t size) noexcept;
-    void deallocate(void* ptr, std::size_t size) noexcept;
+    [[nodiscard]] constexpr std::size_t capacity() const noexcept;
+    //Number of pool blocks currently handed out. Upstream allocations are not counted.
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool owns(const void* ptr) const noexcept;
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
 
 protected:
+    [[nodiscard]] void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
 private:
-    std::size_t _count = 0;
-    std::size_t _max = 0;
-    T* _data = nullptr;
-    T* _ptr = nullptr;
+    std::pmr::memory_resource* _upstream = nullptr;
+    std::byte* _data = nullptr;
+    FreeBlock* _free_list = nullptr;
+    //Blocks at or past this index have never been handed out, so the free list is built lazily.
+    std::size_t _untouched = 0u;
+    std::size_t _count = 0u;
 };
 
 template<typename T, std::size_t maxSize>
-[[nodiscard]] void* MemoryPool<T, maxSize>::allocate(std::size_t size) noexcept {
-    std::size_t elems = size / sizeof(T);
-    if(_count + elems < _max) {
-        auto front = _ptr;
-        _count += elems;
-        _ptr += _count;
-        return static_cast<void*>(front);
-    }
-    return nullptr;
+MemoryPool<T, maxSize>::MemoryPool() noexcept
+: MemoryPool(std::pmr::get_default_resource()) {
+    /* DO NOTHING */
 }
 
 template<typename T, std::size_t maxSize>
-void MemoryPool<T, maxSize>::deallocate(void* ptr, std::size_t size) noexcept {
-    const auto elems = static_cast<int>(size / sizeof(T));
-    if(0 < _count - elems) {
-        _ptr -= elems;
-        _count -= elems;
-    } else {
-        _ptr = _data;
-        _count = 0;
-    }
+MemoryPool<T, maxSize>::MemoryPool(std::pmr::memory_resource* upstream) noexcept
+: _upstream{upstream} {
+    //On failure the pool simply has no blocks and every request goes upstream.
+    _data = static_cast<std::byte*>(::operator new(maxSize * block_size, std::align_val_t{block_alignment}, std::nothrow));
 }
 
 template<typename T, std::size_t maxSize>
 MemoryPool<T, maxSize>::~MemoryPool() noexcept {
-    std::free(_data);
+    ::operator delete(_data, std::align_val_t{block_alignment});
     _data = nullptr;
-    _ptr = nullptr;
-    _count = 0;
-    _max = 0;
+    _free_list = nullptr;
+    _untouched = 0u;
+    _count = 0u;
+}
+
+template<typename T, std::size_t maxSize>
+constexpr std::size_t MemoryPool<T, maxSize>::capacity() const noexcept {
+    return maxSize;
+}
+
+template<typename T, std::size_t maxSize>
+std::size_t MemoryPool<T, maxSize>::size() const noexcept {
+    return _count;
+}
+
+template<typename T, std::size_t maxSize>
+bool MemoryPool<T, maxSize>::owns(const void* ptr) const noexcept {
+    const auto less = std::less<const void*>{};
+    return _data && !less(ptr, _data) && less(ptr, _data + maxSize * block_size);
+}
+
+template<typename T, std::size_t maxSize>
+std::pmr::memory_resource* MemoryPool<T, maxSize>::upstream_resource() const noexcept {
+    return _upstream;
+}
+
+template<typename T, std::size_t maxSize>
+void* MemoryPool<T, maxSize>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if(bytes <= block_size && alignment <= block_alignment && _data) {
+        if(_free_list) {
+            auto* block = _free_list;
+            _free_list = block->next;
+            ++_count;
+            return block;
+        }
+        if(_untouched < maxSize) {
+            ++_count;
+            return _data + (_untouched++ * block_size);
+        }
+    }
+    return _upstream->allocate(bytes, alignment);
+}
+
+template<typename T, std::size_t maxSize>
+void MemoryPool<T, maxSize>::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    if(!owns(ptr)) {
+        _upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+    _free_list = ::new(ptr) FreeBlock{_free_list};
+    --_count;
 }
 
 template<typename T, std::size_t maxSize>
-MemoryPool<T, maxSize>::MemoryPool() noexcept {
-    _data = static_cast<T*>(std::malloc(maxSize * sizeof(T)));
-    _ptr = _data;
-    _count = 0;
-    _max = maxSize;
+bool MemoryPool<T, maxSize>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
 }
@@ -0,0 +1,178 @@
+#include "Engine/Memory/ThreadCachedPoolResource.hpp"
+
+#include <algorithm>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+std::atomic<std::uint64_t> s_next_resource_id{1u};
+constexpr auto no_size_class = static_cast<std::size_t>(-1);
+
+struct FreeBlock {
+    FreeBlock* next = nullptr;
+};
+
+//Ids whose chunks are still allocated. Threads cannot see each other's caches, so each one drops its caches
+//for ids no longer listed here the next time it creates a cache.
+struct LiveIds {
+    std::mutex cs{};
+    std::unordered_set<std::uint64_t> ids{};
+};
+
+[[nodiscard]] LiveIds& GetLiveIds() noexcept {
+    static LiveIds live{};
+    return live;
+}
+
+[[nodiscard]] std::uint64_t RegisterId() noexcept {
+    const auto id = s_next_resource_id++;
+    auto& live = GetLiveIds();
+    std::scoped_lock<std::mutex> lock(live.cs);
+    live.ids.insert(id);
+    return id;
+}
+
+void UnregisterId(std::uint64_t id) noexcept {
+    auto& live = GetLiveIds();
+    std::scoped_lock<std::mutex> lock(live.cs);
+    live.ids.erase(id);
+}
+} // namespace
+
+struct ThreadCachedPoolResource::ThreadCache {
+    struct Bin {
+        FreeBlock* head = nullptr;
+        std::size_t count = 0u;
+    };
+    std::array<Bin, size_class_count> bins{};
+};
+
+ThreadCachedPoolResource::SharedClass::SharedClass(std::size_t blockSize, std::size_t blocksPerChunk, std::pmr::memory_resource* upstream) noexcept
+: pool{blockSize, blocksPerChunk, upstream} {
+    /* DO NOTHING */
+}
+
+ThreadCachedPoolResource::ThreadCachedPoolResource(std::size_t maxCachedBlocksPerClass /*= 64u*/, std::size_t blocksPerChunk /*= 128u*/, std::pmr::memory_resource* upstream /*= std::pmr::get_default_resource()*/) noexcept
+: _upstream{upstream}
+, _max_cached{(std::max)(maxCachedBlocksPerClass, std::size_t{2u})}
+, _id{RegisterId()} {
+    auto block_size = min_block_size;
+    for(auto& shared : _classes) {
+        shared = std::make_unique<SharedClass>(block_size, blocksPerChunk, upstream);
+        block_size <<= 1u;
+    }
+}
+
+ThreadCachedPoolResource::~ThreadCachedPoolResource() noexcept {
+    UnregisterId(_id);
+}
+
+void ThreadCachedPoolResource::release() noexcept {
+    for(auto& shared : _classes) {
+        std::scoped_lock<std::mutex> lock(shared->cs);
+        shared->pool.release();
+    }
+    UnregisterId(_id);
+    _id = RegisterId();
+}
+
+std::size_t ThreadCachedPoolResource::max_cached_blocks_per_class() const noexcept {
+    return _max_cached;
+}
+
+std::pmr::memory_resource* ThreadCachedPoolResource::upstream_resource() const noexcept {
+    return _upstream;
+}
+
+std::size_t ThreadCachedPoolResource::GetSizeClass(std::size_t bytes, std::size_t alignment) noexcept {
+    const auto size = (std::max)(bytes, alignment);
+    if(size > max_block_size || alignment > alignof(std::max_align_t)) {
+        return no_size_class;
+    }
+    auto size_class = std::size_t{0u};
+    for(auto block_size = min_block_size; block_size < size; block_size <<= 1u) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+ThreadCachedPoolResource::ThreadCache& ThreadCachedPoolResource::GetThreadCache() noexcept {
+    thread_local std::unordered_map<std::uint64_t, ThreadCache> caches{};
+    thread_local std::uint64_t last_id = 0u;
+    thread_local ThreadCache* last_cache = nullptr;
+    const auto id = _id.load(std::memory_order_relaxed);
+    if(id == last_id) {
+        return *last_cache;
+    }
+    auto [found, inserted] = caches.try_emplace(id);
+    //New caches are rare, so this is where caches of destroyed or released resources are dropped.
+    //Their blocks belong to chunks that were already returned upstream.
+    if(inserted) {
+        auto& live = GetLiveIds();
+        std::scoped_lock<std::mutex> lock(live.cs);
+        for(auto iter = std::begin(caches); iter != std::end(caches);) {
+            iter = live.ids.count(iter->first) ? std::next(iter) : caches.erase(iter);
+        }
+    }
+    last_cache = &found->second;
+    last_id = id;
+    return *last_cache;
+}
+
+void ThreadCachedPoolResource::Refill(ThreadCache& cache, std::size_t size_class) {
+    auto& bin = cache.bins[size_class];
+    auto& shared = *_classes[size_class];
+    const auto batch = _max_cached / 2u;
+    std::scoped_lock<std::mutex> lock(shared.cs);
+    for(std::size_t i = 0u; i < batch; ++i) {
+        bin.head = ::new(shared.pool.allocate_block()) FreeBlock{bin.head};
+        ++bin.count;
+    }
+}
+
+void ThreadCachedPoolResource::Trim(ThreadCache& cache, std::size_t size_class) noexcept {
+    auto& bin = cache.bins[size_class];
+    auto& shared = *_classes[size_class];
+    std::scoped_lock<std::mutex> lock(shared.cs);
+    while(bin.count > _max_cached / 2u) {
+        auto* block = bin.head;
+        bin.head = block->next;
+        --bin.count;
+        shared.pool.deallocate_block(block);
+    }
+}
+
+void* ThreadCachedPoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    const auto size_class = GetSizeClass(bytes, alignment);
+    if(size_class == no_size_class) {
+        return _upstream->allocate(bytes, alignment);
+    }
+    auto& cache = GetThreadCache();
+    auto& bin = cache.bins[size_class];
+    if(!bin.head) {
+        Refill(cache, size_class);
+    }
+    auto* block = bin.head;
+    bin.head = block->next;
+    --bin.count;
+    return block;
+}
+
+void ThreadCachedPoolResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    const auto size_class = GetSizeClass(bytes, alignment);
+    if(size_class == no_size_class) {
+        _upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+    auto& cache = GetThreadCache();
+    auto& bin = cache.bins[size_class];
+    bin.head = ::new(ptr) FreeBlock{bin.head};
+    if(++bin.count > _max_cached) {
+        Trim(cache, size_class);
+    }
+}
+
+bool ThreadCachedPoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
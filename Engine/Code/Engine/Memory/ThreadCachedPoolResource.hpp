@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Engine/Memory/ChunkedMemoryPool.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+//Thread-safe pool resource for any mix of small allocations.
+//Requests are rounded up to a power of two size class between min_block_size and max_block_size, each backed by a shared ChunkedMemoryPool.
+//Every thread keeps a small cache of free blocks per size class in front of the shared pools, so most allocations and
+//deallocations never take a lock; the cache is refilled from, and overflows back to, the shared pool in batches.
+//Larger or over-aligned requests are forwarded to the upstream resource.
+//Blocks may be freed on a different thread than the one that allocated them.
+//Blocks cached by a thread that exits are not reused until release() or the destructor returns the chunks upstream.
+class ThreadCachedPoolResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t min_block_size = 16u;
+    static constexpr std::size_t max_block_size = 4096u;
+    static constexpr std::size_t size_class_count = 9u;
+
+    explicit ThreadCachedPoolResource(std::size_t maxCachedBlocksPerClass = 64u, std::size_t blocksPerChunk = 128u, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+    ThreadCachedPoolResource(const ThreadCachedPoolResource& other) = delete;
+    ThreadCachedPoolResource(ThreadCachedPoolResource&& other) = delete;
+    ThreadCachedPoolResource& operator=(const ThreadCachedPoolResource& rhs) = delete;
+    ThreadCachedPoolResource& operator=(ThreadCachedPoolResource&& rhs) = delete;
+    ~ThreadCachedPoolResource() noexcept override;
+
+    //Returns every chunk to the upstream resource and invalidates all thread caches. Outstanding blocks become invalid.
+    void release() noexcept;
+
+    [[nodiscard]] std::size_t max_cached_blocks_per_class() const noexcept;
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+protected:
+    [[nodiscard]] void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct SharedClass {
+        explicit SharedClass(std::size_t blockSize, std::size_t blocksPerChunk, std::pmr::memory_resource* upstream) noexcept;
+        std::mutex cs{};
+        ChunkedMemoryPool pool;
+    };
+    struct ThreadCache;
+
+    [[nodiscard]] static std::size_t GetSizeClass(std::size_t bytes, std::size_t alignment) noexcept;
+    [[nodiscard]] ThreadCache& GetThreadCache() noexcept;
+    void Refill(ThreadCache& cache, std::size_t size_class);
+    void Trim(ThreadCache& cache, std::size_t size_class) noexcept;
+
+    std::array<std::unique_ptr<SharedClass>, size_class_count> _classes{};
+    std::pmr::memory_resource* _upstream = nullptr;
+    std::size_t _max_cached = 0u;
+    //Thread caches are keyed by this id rather than by address so a cache can never outlive its resource's chunks.
+    std::atomic<std::uint64_t> _id{0u};
+};
@@ -0,0 +1,95 @@
+#include "Engine/Physics/BroadPhase.hpp"
+
+#include "Engine/Physics/BruteForceBroadPhase.hpp"
+#include "Engine/Physics/DynamicAABBTreeBroadPhase.hpp"
+#include "Engine/Physics/SweepAndPruneBroadPhase.hpp"
+
+#include <algorithm>
+
+bool BroadPhase::Pair::operator<(const Pair& rhs) const noexcept {
+    return a < rhs.a || (a == rhs.a && b < rhs.b);
+}
+
+bool BroadPhase::Pair::operator==(const Pair& rhs) const noexcept {
+    return a == rhs.a && b == rhs.b;
+}
+
+bool BroadPhase::Pair::operator!=(const Pair& rhs) const noexcept {
+    return !(*this == rhs);
+}
+
+std::unique_ptr<BroadPhase> BroadPhase::Create(BroadPhaseType type, float margin) noexcept {
+    switch(type) {
+    case BroadPhaseType::BruteForce: return std::make_unique<BruteForceBroadPhase>();
+    case BroadPhaseType::SweepAndPrune: return std::make_unique<SweepAndPruneBroadPhase>();
+    case BroadPhaseType::DynamicAABBTree: return std::make_unique<DynamicAABBTreeBroadPhase>(margin);
+    default: return std::make_unique<DynamicAABBTreeBroadPhase>(margin);
+    }
+}
+
+BroadPhase::ProxyId BroadPhase::CreateProxy(const AABB2& bounds, RigidBody* body) noexcept {
+    ProxyId proxy = null_proxy;
+    if(_free_proxies.empty()) {
+        proxy = static_cast<ProxyId>(_proxies.size());
+        _proxies.emplace_back();
+    } else {
+        proxy = _free_proxies.back();
+        _free_proxies.pop_back();
+    }
+    auto& p = _proxies[proxy];
+    p.bounds = bounds;
+    p.body = body;
+    p.index = 0u;
+    p.alive = true;
+    ++_proxy_count;
+    OnCreateProxy(proxy);
+    return proxy;
+}
+
+void BroadPhase::DestroyProxy(ProxyId proxy) noexcept {
+    if(proxy >= _proxies.size() || !_proxies[proxy].alive) {
+        return;
+    }
+    OnDestroyProxy(proxy);
+    _proxies[proxy] = Proxy{};
+    _free_proxies.push_back(proxy);
+    --_proxy_count;
+}
+
+void BroadPhase::MoveProxy(ProxyId proxy, const AABB2& bounds) noexcept {
+    if(proxy >= _proxies.size() || !_proxies[proxy].alive) {
+        return;
+    }
+    _proxies[proxy].bounds = bounds;
+    OnMoveProxy(proxy);
+}
+
+void BroadPhase::Clear() noexcept {
+    OnClear();
+    _proxies.clear();
+    _free_proxies.clear();
+    _proxy_count = 0u;
+}
+
+void BroadPhase::FindPairs(std::pmr::vector<Pair>& pairs) noexcept {
+    pairs.clear();
+    CollectPairs(pairs);
+    std::sort(std::begin(pairs), std::end(pairs));
+    pairs.erase(std::unique(std::begin(pairs), std::end(pairs)), std::end(pairs));
+}
+
+RigidBody* BroadPhase::GetBody(ProxyId proxy) const noexcept {
+    return proxy < _proxies.size() ? _proxies[proxy].body : nullptr;
+}
+
+const AABB2& BroadPhase::GetBounds(ProxyId proxy) const noexcept {
+    return _proxies[proxy].bounds;
+}
+
+std::size_t BroadPhase::GetProxyCount() const noexcept {
+    return _proxy_count;
+}
+
+bool BroadPhase::DoBoundsOverlap(const AABB2& a, const AABB2& b) noexcept {
+    return !(a.maxs.x < b.mins.x || b.maxs.x < a.mins.x || a.maxs.y < b.mins.y || b.maxs.y < a.mins.y);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+class RigidBody;
+
+enum class BroadPhaseType {
+    BruteForce,
+    SweepAndPrune,
+    DynamicAABBTree,
+};
+
+//Finds the pairs of bodies whose bounds overlap so the narrow phase only tests those.
+//Bodies are tracked as proxies that are created, moved and destroyed as the bodies are; the body pointer is
+//only carried along for the caller and never dereferenced. Implementations only differ in how they find the
+//overlaps: FindPairs always reports every overlapping pair exactly once, lower id first, sorted, so the result
+//does not depend on which broad phase is selected.
+class BroadPhase {
+public:
+    using ProxyId = std::uint32_t;
+    static constexpr ProxyId null_proxy = (std::numeric_limits<ProxyId>::max)();
+
+    struct Pair {
+        ProxyId a = null_proxy;
+        ProxyId b = null_proxy;
+        [[nodiscard]] bool operator<(const Pair& rhs) const noexcept;
+        [[nodiscard]] bool operator==(const Pair& rhs) const noexcept;
+        [[nodiscard]] bool operator!=(const Pair& rhs) const noexcept;
+    };
+
+    //margin only applies to broad phases that keep fattened bounds.
+    [[nodiscard]] static std::unique_ptr<BroadPhase> Create(BroadPhaseType type, float margin) noexcept;
+
+    BroadPhase() noexcept = default;
+    BroadPhase(const BroadPhase& other) = delete;
+    BroadPhase(BroadPhase&& other) = delete;
+    BroadPhase& operator=(const BroadPhase& rhs) = delete;
+    BroadPhase& operator=(BroadPhase&& rhs) = delete;
+    virtual ~BroadPhase() noexcept = default;
+
+    [[nodiscard]] ProxyId CreateProxy(const AABB2& bounds, RigidBody* body) noexcept;
+    void DestroyProxy(ProxyId proxy) noexcept;
+    void MoveProxy(ProxyId proxy, const AABB2& bounds) noexcept;
+    void Clear() noexcept;
+
+    //Replaces the contents of pairs with every overlapping pair.
+    void FindPairs(std::pmr::vector<Pair>& pairs) noexcept;
+
+    [[nodiscard]] RigidBody* GetBody(ProxyId proxy) const noexcept;
+    [[nodiscard]] const AABB2& GetBounds(ProxyId proxy) const noexcept;
+    [[nodiscard]] std::size_t GetProxyCount() const noexcept;
+    [[nodiscard]] virtual BroadPhaseType GetType() const noexcept = 0;
+
+protected:
+    struct Proxy {
+        AABB2 bounds{};
+        RigidBody* body = nullptr;
+        //Implementation defined, e.g. the tree leaf that holds this proxy.
+        std::uint32_t index = 0u;
+        bool alive = false;
+    };
+
+    [[nodiscard]] static bool DoBoundsOverlap(const AABB2& a, const AABB2& b) noexcept;
+
+    virtual void OnCreateProxy(ProxyId proxy) noexcept = 0;
+    virtual void OnDestroyProxy(ProxyId proxy) noexcept = 0;
+    virtual void OnMoveProxy(ProxyId proxy) noexcept = 0;
+    virtual void OnClear() noexcept = 0;
+    //Appends overlapping pairs in any order; duplicates are allowed.
+    virtual void CollectPairs(std::pmr::vector<Pair>& pairs) noexcept = 0;
+
+    std::vector<Proxy> _proxies{};
+
+private:
+    std::vector<ProxyId> _free_proxies{};
+    std::size_t _proxy_count = 0u;
+};
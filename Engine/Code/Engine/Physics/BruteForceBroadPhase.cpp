@@ -0,0 +1,35 @@
+#include "Engine/Physics/BruteForceBroadPhase.hpp"
+
+BroadPhaseType BruteForceBroadPhase::GetType() const noexcept {
+    return BroadPhaseType::BruteForce;
+}
+
+void BruteForceBroadPhase::OnCreateProxy(ProxyId /*proxy*/) noexcept {
+    /* DO NOTHING */
+}
+
+void BruteForceBroadPhase::OnDestroyProxy(ProxyId /*proxy*/) noexcept {
+    /* DO NOTHING */
+}
+
+void BruteForceBroadPhase::OnMoveProxy(ProxyId /*proxy*/) noexcept {
+    /* DO NOTHING */
+}
+
+void BruteForceBroadPhase::OnClear() noexcept {
+    /* DO NOTHING */
+}
+
+void BruteForceBroadPhase::CollectPairs(std::pmr::vector<Pair>& pairs) noexcept {
+    const auto count = static_cast<ProxyId>(_proxies.size());
+    for(ProxyId a = 0u; a < count; ++a) {
+        if(!_proxies[a].alive) {
+            continue;
+        }
+        for(ProxyId b = a + 1u; b < count; ++b) {
+            if(_proxies[b].alive && DoBoundsOverlap(_proxies[a].bounds, _proxies[b].bounds)) {
+                pairs.push_back(Pair{a, b});
+            }
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Engine/Physics/BroadPhase.hpp"
+
+//Tests every pair of proxies. O(n^2); kept as the reference the other broad phases are checked against.
+class BruteForceBroadPhase : public BroadPhase {
+public:
+    BruteForceBroadPhase() noexcept = default;
+    virtual ~BruteForceBroadPhase() noexcept = default;
+
+    [[nodiscard]] BroadPhaseType GetType() const noexcept override;
+
+protected:
+    void OnCreateProxy(ProxyId proxy) noexcept override;
+    void OnDestroyProxy(ProxyId proxy) noexcept override;
+    void OnMoveProxy(ProxyId proxy) noexcept override;
+    void OnClear() noexcept override;
+    void CollectPairs(std::pmr::vector<Pair>& pairs) noexcept override;
+
+private:
+};
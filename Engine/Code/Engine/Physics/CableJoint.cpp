@@ -32,34 +32,7 @@ CableJoint::CableJoint(const CableJointDef& def) noexcept {
 }
 
 void CableJoint::Notify([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
-    auto* first_body = GetBodyA();
-    auto* second_body = GetBodyB();
-    if(first_body == nullptr && second_body == nullptr) {
-        return;
-    }
-
-    const auto fb_pos = GetAnchorA();
-    const auto sb_pos = GetAnchorB();
-
-    const auto distance = MathUtils::CalcDistance(fb_pos, sb_pos);
-    const auto displacement_towards_first = fb_pos - sb_pos;
-    const auto displacement_towards_second = sb_pos - fb_pos;
-    const auto direction_to_first = displacement_towards_first.GetNormalize();
-    const auto direction_to_second = displacement_towards_second.GetNormalize();
-    const auto m1 = (first_body ? first_body->GetMass() : 0.0f);
-    const auto m2 = (second_body ? second_body->GetMass() : 0.0f);
-    const auto mass_sum = m1 + m2;
-    const auto mass1_ratio = m1 / mass_sum;
-    const auto mass2_ratio = m2 / mass_sum;
-    const auto length = _def.length;
-    if(length < distance) {
-        if(first_body) {
-            first_body->ApplyImpulse(direction_to_second * mass1_ratio);
-        }
-        if(second_body) {
-            second_body->ApplyImpulse(direction_to_first * mass2_ratio);
-        }
-    }
+    /* DO NOTHING */
 }
 
 void CableJoint::DebugRender() const noexcept {
@@ -127,85 +100,6 @@ float CableJoint::GetMassB() const noexcept {
     return _def.rigidBodyB ? _def.rigidBodyB->GetMass() : 0.0f;
 }
 
-bool CableJoint::ConstraintViolated() const noexcept {
-    const bool violated = [this]() -> const bool {
-        const auto distance = MathUtils::CalcDistance(GetAnchorA(), GetAnchorB());
-        return _def.length < distance;
-    }();
-    return violated;
-}
-
-void CableJoint::SolvePositionConstraint() const noexcept {
-    auto* first_body = GetBodyA();
-    auto* second_body = GetBodyB();
-    if(first_body == nullptr && second_body == nullptr) {
-        return;
-    }
-    const auto posA = GetAnchorA();
-    const auto posB = GetAnchorB();
-
-    const auto distance = MathUtils::CalcDistance(posA, posB);
-    const auto displacement_towards_first = posA - posB;
-    const auto displacement_towards_second = posB - posA;
-    const auto direction_to_first = displacement_towards_first.GetNormalize();
-    const auto direction_to_second = displacement_towards_second.GetNormalize();
-    const auto m1 = (first_body ? first_body->GetMass() : 0.0f);
-    const auto m2 = (second_body ? second_body->GetMass() : 0.0f);
-    const auto mass_sum = m1 + m2;
-    const auto mass1_ratio = m1 / mass_sum;
-    const auto mass2_ratio = m2 / mass_sum;
-    const auto length = _def.length;
-    auto newPosition1 = posA;
-    auto newPosition2 = posB;
-    if(length < distance) {
-        if(first_body) {
-            const auto newDisplacement = mass1_ratio * direction_to_second * std::abs(length - distance);
-            const auto newPosition = first_body->GetPosition() + newDisplacement;
-            newPosition1 = newPosition;
-        }
-        if(second_body) {
-            const auto newDisplacement = mass2_ratio * direction_to_first * std::abs(length - distance);
-            const auto newPosition = second_body->GetPosition() + newDisplacement;
-            newPosition2 = newPosition;
-        }
-    }
-    if(first_body) {
-        first_body->SetPosition(newPosition1, true);
-    }
-    if(second_body) {
-        second_body->SetPosition(newPosition2, true);
-    }
-}
-
-void CableJoint::SolveVelocityConstraint() const noexcept {
-    auto* first_body = GetBodyA();
-    auto* second_body = GetBodyB();
-    if(first_body == nullptr && second_body == nullptr) {
-        return;
-    }
-
-    const auto posA = GetAnchorA();
-    const auto posB = GetAnchorB();
-
-    const auto displacement_towards_first = posA - posB;
-    const auto displacement_towards_second = posB - posA;
-    const auto direction_to_first = displacement_towards_first.GetNormalize();
-    const auto direction_to_second = displacement_towards_second.GetNormalize();
-    const auto m1 = GetMassA();
-    const auto m2 = GetMassB();
-    const auto mass_sum = m1 + m2;
-    const auto mass1_ratio = m1 / mass_sum;
-    const auto mass2_ratio = m2 / mass_sum;
-    auto v1 = first_body ? first_body->GetVelocity() : Vector2::Zero;
-    auto v2 = second_body ? second_body->GetVelocity() : Vector2::Zero;
-    auto newVelocity1 = v1;
-    auto newVelocity2 = v2;
-    newVelocity1 = mass1_ratio * MathUtils::Reject(v1, direction_to_second);
-    newVelocity2 = mass2_ratio * MathUtils::Reject(v2, direction_to_first);
-    if(first_body) {
-        first_body->SetVelocity(newVelocity1);
-    }
-    if(second_body) {
-        second_body->SetVelocity(newVelocity2);
-    }
+std::optional<Joint::DistanceConstraint> CableJoint::GetDistanceConstraint() const noexcept {
+    return DistanceConstraint{_def.length, true};
 }
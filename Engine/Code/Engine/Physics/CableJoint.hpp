@@ -37,9 +37,7 @@ public:
 
 protected:
 private:
-    [[nodiscard]] bool ConstraintViolated() const noexcept override;
-    void SolvePositionConstraint() const noexcept override;
-    void SolveVelocityConstraint() const noexcept override;
+    [[nodiscard]] std::optional<DistanceConstraint> GetDistanceConstraint() const noexcept override;
 
     CableJointDef _def{};
 
@@ -94,8 +94,9 @@ OBB2 ColliderPolygon::GetBounds() const noexcept {
 }
 
 Vector2 ColliderPolygon::Support(const Vector2& d) const noexcept {
+    //Scaling d does not change which vertex is furthest along it.
     const auto& verts = _polygon.GetVerts();
-    return *std::max_element(std::cbegin(verts), std::cend(verts), [&d](const Vector2& a, const Vector2& b) { return MathUtils::DotProduct(a, d.GetNormalize()) < MathUtils::DotProduct(b, d.GetNormalize()); });
+    return *std::max_element(std::cbegin(verts), std::cend(verts), [&d](const Vector2& a, const Vector2& b) { return MathUtils::DotProduct(a, d) < MathUtils::DotProduct(b, d); });
 }
 
 Vector2 ColliderPolygon::CalcCenter() const noexcept {
@@ -110,6 +111,10 @@ ColliderPolygon* ColliderPolygon::Clone() const noexcept {
     return new ColliderPolygon(GetSides(), GetPosition(), GetHalfExtents(), GetOrientationDegrees());
 }
 
+ColliderShape ColliderPolygon::GetShape() const noexcept {
+    return ColliderShape::Polygon;
+}
+
 ColliderOBB::ColliderOBB(const Vector2& position, const Vector2& half_extents)
 : m_obb{position, half_extents, 0.0f} {
     /* DO NOTHING */
@@ -129,7 +134,11 @@ Vector2 ColliderOBB::GetHalfExtents() const noexcept {
 }
 
 Vector2 ColliderOBB::Support(const Vector2& d) const noexcept {
-    return MathUtils::CalcClosestPoint(m_obb.position + d, m_obb);
+    const auto right = m_obb.GetRight();
+    const auto up = Vector2{right.y, -right.x};
+    const auto x = MathUtils::DotProduct(d, right) < 0.0f ? -m_obb.half_extents.x : m_obb.half_extents.x;
+    const auto y = MathUtils::DotProduct(d, up) < 0.0f ? -m_obb.half_extents.y : m_obb.half_extents.y;
+    return m_obb.position + right * x + up * y;
 }
 
 void ColliderOBB::SetPosition(const Vector2& position) noexcept {
@@ -160,6 +169,10 @@ ColliderOBB* ColliderOBB::Clone() const noexcept {
     return new ColliderOBB(CalcCenter(), CalcDimensions() * 0.5f);
 }
 
+ColliderShape ColliderOBB::GetShape() const noexcept {
+    return ColliderShape::OBB;
+}
+
 ColliderCircle::ColliderCircle(const Position& position, float radius)
 : ColliderPolygon(16, position.Get(), Vector2(radius, radius), 0.0f) {
     /* DO NOTHING */
@@ -211,6 +224,10 @@ ColliderCircle* ColliderCircle::Clone() const noexcept {
     return new ColliderCircle(GetPosition(), GetHalfExtents().x);
 }
 
+ColliderShape ColliderCircle::GetShape() const noexcept {
+    return ColliderShape::Circle;
+}
+
 ColliderAABB::ColliderAABB(const Vector2& position, const Vector2& half_extents)
 : ColliderPolygon(4, position, half_extents, 45.0f) {
     /* DO NOTHING */
@@ -232,7 +249,9 @@ Vector2 ColliderAABB::GetHalfExtents() const noexcept {
 }
 
 Vector2 ColliderAABB::Support(const Vector2& d) const noexcept {
-    return ColliderPolygon::Support(d);
+    //The underlying polygon is only axis-aligned for square extents; support the box it is bounded by instead.
+    const auto half_extents = GetHalfExtents();
+    return CalcCenter() + Vector2{d.x < 0.0f ? -half_extents.x : half_extents.x, d.y < 0.0f ? -half_extents.y : half_extents.y};
 }
 
 void ColliderAABB::SetPosition(const Vector2& position) noexcept {
@@ -262,3 +281,7 @@ Vector2 ColliderAABB::CalcCenter() const noexcept {
 ColliderAABB* ColliderAABB::Clone() const noexcept {
     return new ColliderAABB(CalcCenter(), CalcDimensions() * 0.5f);
 }
+
+ColliderShape ColliderAABB::GetShape() const noexcept {
+    return ColliderShape::AABB;
+}
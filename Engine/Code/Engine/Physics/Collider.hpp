@@ -9,6 +9,14 @@
 class Renderer;
 struct Position;
 
+//Lets the narrow phase pick a closed-form test without a dynamic_cast.
+enum class ColliderShape {
+    Polygon,
+    AABB,
+    OBB,
+    Circle,
+};
+
 class Collider {
 public:
     virtual ~Collider() = default;
@@ -23,6 +31,7 @@ public:
     [[nodiscard]] virtual OBB2 GetBounds() const noexcept = 0;
     [[nodiscard]] virtual Vector2 Support(const Vector2& d) const noexcept = 0;
     [[nodiscard]] virtual Collider* Clone() const noexcept = 0;
+    [[nodiscard]] virtual ColliderShape GetShape() const noexcept = 0;
 };
 
 class ColliderPolygon : public Collider {
@@ -40,6 +49,7 @@ public:
     [[nodiscard]] virtual Vector2 Support(const Vector2& d) const noexcept override;
     [[nodiscard]] virtual Vector2 CalcCenter() const noexcept override;
     [[nodiscard]] virtual ColliderPolygon* Clone() const noexcept override;
+    [[nodiscard]] virtual ColliderShape GetShape() const noexcept override;
 
     [[nodiscard]] int GetSides() const;
     void SetSides(int sides);
@@ -76,6 +86,7 @@ public:
     [[nodiscard]] virtual OBB2 GetBounds() const noexcept override;
     [[nodiscard]] virtual Vector2 CalcCenter() const noexcept override;
     [[nodiscard]] virtual ColliderAABB* Clone() const noexcept override;
+    [[nodiscard]] virtual ColliderShape GetShape() const noexcept override;
 
 protected:
 private:
@@ -97,6 +108,7 @@ public:
     [[nodiscard]] virtual OBB2 GetBounds() const noexcept override;
     [[nodiscard]] virtual Vector2 CalcCenter() const noexcept override;
     [[nodiscard]] virtual ColliderOBB* Clone() const noexcept override;
+    [[nodiscard]] virtual ColliderShape GetShape() const noexcept override;
 
 protected:
 private:
@@ -118,6 +130,7 @@ public:
     [[nodiscard]] virtual OBB2 GetBounds() const noexcept override;
     [[nodiscard]] virtual Vector2 CalcCenter() const noexcept override;
     [[nodiscard]] virtual ColliderCircle* Clone() const noexcept override;
+    [[nodiscard]] virtual ColliderShape GetShape() const noexcept override;
 
 protected:
 private:
@@ -0,0 +1,203 @@
+#include "Engine/Physics/ConstraintSolver.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void ConstraintSolver::Reset(const Settings& settings) noexcept {
+    _settings = settings;
+    _positions.clear();
+    _start_positions.clear();
+    _velocities.clear();
+    _inverse_masses.clear();
+    _constraints.clear();
+}
+
+ConstraintSolver::BodyIndex ConstraintSolver::AddBody(const Vector2& position, const Vector2& velocity, float inverse_mass) noexcept {
+    _positions.push_back(position);
+    _start_positions.push_back(position);
+    _velocities.push_back(velocity);
+    _inverse_masses.push_back(inverse_mass);
+    return static_cast<BodyIndex>(_positions.size() - 1u);
+}
+
+std::size_t ConstraintSolver::AddContact(BodyIndex a, BodyIndex b, const Vector2& normal, float depth, float friction, float restitution, float normal_impulse /*= 0.0f*/, float tangent_impulse /*= 0.0f*/) noexcept {
+    Constraint constraint{};
+    constraint.type = ConstraintType::Contact;
+    constraint.a = a;
+    constraint.b = b;
+    constraint.normal = normal;
+    constraint.length = depth;
+    constraint.friction = friction;
+    constraint.restitution = restitution;
+    constraint.normal_impulse = normal_impulse;
+    constraint.tangent_impulse = tangent_impulse;
+    _constraints.push_back(constraint);
+    return _constraints.size() - 1u;
+}
+
+std::size_t ConstraintSolver::AddDistance(BodyIndex a, BodyIndex b, const Vector2& anchor_a, const Vector2& anchor_b, float length, bool can_slacken, float impulse /*= 0.0f*/) noexcept {
+    Constraint constraint{};
+    constraint.type = can_slacken ? ConstraintType::Cable : ConstraintType::Rod;
+    constraint.a = a;
+    constraint.b = b;
+    constraint.offset_a = anchor_a - _positions[a];
+    constraint.offset_b = anchor_b - _positions[b];
+    constraint.length = length;
+    constraint.normal_impulse = impulse;
+    _constraints.push_back(constraint);
+    return _constraints.size() - 1u;
+}
+
+void ConstraintSolver::SolveVelocities(int iterations) noexcept {
+    PrepareVelocities();
+    for(int iteration = 0; iteration < iterations; ++iteration) {
+        for(auto& constraint : _constraints) {
+            if(!constraint.is_active) {
+                continue;
+            }
+            const auto& n = constraint.normal;
+            switch(constraint.type) {
+            case ConstraintType::Contact:
+            {
+                //Friction first so the normal impulse, which is more important, gets the last word.
+                const auto t = Vector2{-n.y, n.x};
+                const auto vt = MathUtils::DotProduct(_velocities[constraint.b] - _velocities[constraint.a], t);
+                const auto max_friction = constraint.friction * constraint.normal_impulse;
+                const auto tangent_impulse = std::clamp(constraint.tangent_impulse - vt * constraint.mass, -max_friction, max_friction);
+                ApplyImpulse(constraint, t * (tangent_impulse - constraint.tangent_impulse));
+                constraint.tangent_impulse = tangent_impulse;
+
+                const auto vn = MathUtils::DotProduct(_velocities[constraint.b] - _velocities[constraint.a], n);
+                const auto normal_impulse = (std::max)(constraint.normal_impulse - (vn - constraint.velocity_bias) * constraint.mass, 0.0f);
+                ApplyImpulse(constraint, n * (normal_impulse - constraint.normal_impulse));
+                constraint.normal_impulse = normal_impulse;
+                break;
+            }
+            case ConstraintType::Rod:
+            case ConstraintType::Cable:
+            {
+                const auto vn = MathUtils::DotProduct(_velocities[constraint.b] - _velocities[constraint.a], n);
+                auto impulse = constraint.normal_impulse - vn * constraint.mass;
+                //A cable can only pull its ends together.
+                if(constraint.type == ConstraintType::Cable) {
+                    impulse = (std::min)(impulse, 0.0f);
+                }
+                ApplyImpulse(constraint, n * (impulse - constraint.normal_impulse));
+                constraint.normal_impulse = impulse;
+                break;
+            }
+            }
+        }
+    }
+}
+
+bool ConstraintSolver::SolvePositions(int iterations) noexcept {
+    for(int iteration = 0; iteration < iterations; ++iteration) {
+        auto max_error = 0.0f;
+        for(const auto& constraint : _constraints) {
+            const auto ia = _inverse_masses[constraint.a];
+            const auto ib = _inverse_masses[constraint.b];
+            const auto k = ia + ib;
+            if(k <= 0.0f) {
+                continue;
+            }
+            auto n = constraint.normal;
+            auto correction = 0.0f;
+            if(constraint.type == ConstraintType::Contact) {
+                //The contact was found at the start positions; estimate the penetration left from how far the bodies moved since.
+                const auto moved_apart = MathUtils::DotProduct((_positions[constraint.b] - _start_positions[constraint.b]) - (_positions[constraint.a] - _start_positions[constraint.a]), n);
+                const auto penetration = constraint.length - moved_apart;
+                max_error = (std::max)(max_error, penetration - _settings.linear_slop);
+                correction = -std::clamp(_settings.baumgarte * (penetration - _settings.linear_slop), 0.0f, _settings.max_linear_correction);
+            } else {
+                const auto d = (_positions[constraint.b] + constraint.offset_b) - (_positions[constraint.a] + constraint.offset_a);
+                const auto length = d.CalcLength();
+                if(length <= 0.0f) {
+                    continue;
+                }
+                n = d / length;
+                auto error = length - constraint.length;
+                if(constraint.type == ConstraintType::Cable) {
+                    error = (std::max)(error, 0.0f);
+                }
+                max_error = (std::max)(max_error, std::abs(error));
+                correction = std::clamp(_settings.baumgarte * error, -_settings.max_linear_correction, _settings.max_linear_correction);
+            }
+            //Positive corrections pull the bodies together along n, negative ones push them apart.
+            const auto impulse = n * (correction / k);
+            _positions[constraint.a] += impulse * ia;
+            _positions[constraint.b] -= impulse * ib;
+        }
+        if(max_error <= _settings.linear_slop) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Vector2 ConstraintSolver::GetPosition(BodyIndex body) const noexcept {
+    return _positions[body];
+}
+
+void ConstraintSolver::SetPosition(BodyIndex body, const Vector2& position) noexcept {
+    _positions[body] = position;
+}
+
+Vector2 ConstraintSolver::GetVelocity(BodyIndex body) const noexcept {
+    return _velocities[body];
+}
+
+float ConstraintSolver::GetNormalImpulse(std::size_t constraint) const noexcept {
+    return _constraints[constraint].normal_impulse;
+}
+
+float ConstraintSolver::GetTangentImpulse(std::size_t constraint) const noexcept {
+    return _constraints[constraint].tangent_impulse;
+}
+
+std::size_t ConstraintSolver::GetBodyCount() const noexcept {
+    return _positions.size();
+}
+
+std::size_t ConstraintSolver::GetConstraintCount() const noexcept {
+    return _constraints.size();
+}
+
+void ConstraintSolver::PrepareVelocities() noexcept {
+    for(auto& constraint : _constraints) {
+        const auto k = _inverse_masses[constraint.a] + _inverse_masses[constraint.b];
+        constraint.is_active = 0.0f < k;
+        if(constraint.type != ConstraintType::Contact) {
+            const auto d = (_positions[constraint.b] + constraint.offset_b) - (_positions[constraint.a] + constraint.offset_a);
+            const auto length = d.CalcLength();
+            constraint.is_active = constraint.is_active && 0.0f < length;
+            //A slack cable does nothing this step.
+            if(constraint.type == ConstraintType::Cable && length < constraint.length) {
+                constraint.is_active = false;
+            }
+            if(constraint.is_active) {
+                constraint.normal = d / length;
+            }
+        }
+        if(!constraint.is_active) {
+            constraint.normal_impulse = 0.0f;
+            constraint.tangent_impulse = 0.0f;
+            continue;
+        }
+        constraint.mass = 1.0f / k;
+        if(constraint.type == ConstraintType::Contact) {
+            const auto vn = MathUtils::DotProduct(_velocities[constraint.b] - _velocities[constraint.a], constraint.normal);
+            constraint.velocity_bias = vn < -_settings.restitution_threshold ? -constraint.restitution * vn : 0.0f;
+        }
+        //Warm start: last step's impulses are usually close to this step's answer.
+        const auto t = Vector2{-constraint.normal.y, constraint.normal.x};
+        ApplyImpulse(constraint, constraint.normal * constraint.normal_impulse + t * constraint.tangent_impulse);
+    }
+}
+
+void ConstraintSolver::ApplyImpulse(const Constraint& constraint, const Vector2& impulse) noexcept {
+    _velocities[constraint.a] -= impulse * _inverse_masses[constraint.a];
+    _velocities[constraint.b] += impulse * _inverse_masses[constraint.b];
+}
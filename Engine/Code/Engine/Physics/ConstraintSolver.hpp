@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Engine/Math/Vector2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Sequential impulse solver for contacts and distance joints.
+//Bodies are copied into flat arrays and every constraint is solved in the same loop without virtual calls.
+//Accumulated impulses are passed in and read back so callers can warm start the next step with them.
+//Only linear motion is solved; impulses act through the body centers.
+class ConstraintSolver {
+public:
+    using BodyIndex = std::uint32_t;
+
+    struct Settings {
+        //Penetration allowed before position correction kicks in; keeps resting contacts from jittering.
+        float linear_slop = 0.005f;
+        //Largest position correction per constraint per iteration.
+        float max_linear_correction = 0.2f;
+        //Fraction of the remaining error each position iteration removes.
+        float baumgarte = 0.2f;
+        //Closing speeds below this do not bounce.
+        float restitution_threshold = 1.0f;
+    };
+
+    void Reset(const Settings& settings) noexcept;
+
+    //Bodies with zero inverse mass take part but are never moved.
+    [[nodiscard]] BodyIndex AddBody(const Vector2& position, const Vector2& velocity, float inverse_mass) noexcept;
+    //normal points from a to b and depth is the penetration along it. Returns the constraint index.
+    std::size_t AddContact(BodyIndex a, BodyIndex b, const Vector2& normal, float depth, float friction, float restitution, float normal_impulse = 0.0f, float tangent_impulse = 0.0f) noexcept;
+    //Keeps the world anchors length apart; cables may also be shorter. Returns the constraint index.
+    std::size_t AddDistance(BodyIndex a, BodyIndex b, const Vector2& anchor_a, const Vector2& anchor_b, float length, bool can_slacken, float impulse = 0.0f) noexcept;
+
+    //Applies the accumulated impulses, then iterates over every constraint.
+    void SolveVelocities(int iterations) noexcept;
+    //Pushes bodies apart after their positions were integrated. Returns true once every error is within the slop.
+    bool SolvePositions(int iterations) noexcept;
+
+    [[nodiscard]] Vector2 GetPosition(BodyIndex body) const noexcept;
+    void SetPosition(BodyIndex body, const Vector2& position) noexcept;
+    [[nodiscard]] Vector2 GetVelocity(BodyIndex body) const noexcept;
+    [[nodiscard]] float GetNormalImpulse(std::size_t constraint) const noexcept;
+    [[nodiscard]] float GetTangentImpulse(std::size_t constraint) const noexcept;
+
+    [[nodiscard]] std::size_t GetBodyCount() const noexcept;
+    [[nodiscard]] std::size_t GetConstraintCount() const noexcept;
+
+protected:
+private:
+    enum class ConstraintType : std::uint8_t {
+        Contact,
+        Rod,
+        Cable,
+    };
+
+    struct Constraint {
+        ConstraintType type = ConstraintType::Contact;
+        BodyIndex a = 0u;
+        BodyIndex b = 0u;
+        //Contact normal, or the joint axis from anchor a to anchor b.
+        Vector2 normal{};
+        //Joint anchors relative to the body positions.
+        Vector2 offset_a{};
+        Vector2 offset_b{};
+        //Contact depth when found, or the joint length.
+        float length = 0.0f;
+        float friction = 0.0f;
+        float restitution = 0.0f;
+        float velocity_bias = 0.0f;
+        float mass = 0.0f;
+        float normal_impulse = 0.0f;
+        float tangent_impulse = 0.0f;
+        bool is_active = true;
+    };
+
+    void PrepareVelocities() noexcept;
+    void ApplyImpulse(const Constraint& constraint, const Vector2& impulse) noexcept;
+
+    Settings _settings{};
+    std::vector<Vector2> _positions{};
+    std::vector<Vector2> _start_positions{};
+    std::vector<Vector2> _velocities{};
+    std::vector<float> _inverse_masses{};
+    std::vector<Constraint> _constraints{};
+};
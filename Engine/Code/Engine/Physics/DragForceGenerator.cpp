@@ -11,6 +11,9 @@ DragForceGenerator::DragForceGenerator(const Vector2& k1k2) noexcept
 
 void DragForceGenerator::notify([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) const noexcept {
     for(auto* body : _observers) {
+        if(!body->IsAwake()) {
+            continue;
+        }
         if(auto dragForce = body->GetVelocity(); !MathUtils::IsEquivalentToZero(dragForce)) {
             auto dragCoeff = dragForce.CalcLength();
             dragCoeff = _k1k2.x * dragCoeff + _k1k2.y * dragCoeff * dragCoeff;
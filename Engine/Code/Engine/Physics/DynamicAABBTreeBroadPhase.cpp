@@ -0,0 +1,281 @@
+#include "Engine/Physics/DynamicAABBTreeBroadPhase.hpp"
+
+#include <algorithm>
+
+namespace {
+
+[[nodiscard]] AABB2 Union(const AABB2& a, const AABB2& b) noexcept {
+    return AABB2{Vector2{(std::min)(a.mins.x, b.mins.x), (std::min)(a.mins.y, b.mins.y)}, Vector2{(std::max)(a.maxs.x, b.maxs.x), (std::max)(a.maxs.y, b.maxs.y)}};
+}
+
+[[nodiscard]] float Perimeter(const AABB2& a) noexcept {
+    return 2.0f * ((a.maxs.x - a.mins.x) + (a.maxs.y - a.mins.y));
+}
+
+[[nodiscard]] bool Contains(const AABB2& outer, const AABB2& inner) noexcept {
+    return outer.mins.x <= inner.mins.x && outer.mins.y <= inner.mins.y && inner.maxs.x <= outer.maxs.x && inner.maxs.y <= outer.maxs.y;
+}
+
+} // namespace
+
+bool DynamicAABBTreeBroadPhase::Node::IsLeaf() const noexcept {
+    return child1 == null_node;
+}
+
+DynamicAABBTreeBroadPhase::DynamicAABBTreeBroadPhase(float margin /*= default_margin*/) noexcept
+: _margin{(std::max)(margin, 0.0f)} {
+    /* DO NOTHING */
+}
+
+BroadPhaseType DynamicAABBTreeBroadPhase::GetType() const noexcept {
+    return BroadPhaseType::DynamicAABBTree;
+}
+
+int DynamicAABBTreeBroadPhase::GetHeight() const noexcept {
+    return _root == null_node ? 0 : _nodes[_root].height;
+}
+
+const AABB2& DynamicAABBTreeBroadPhase::GetFatBounds(ProxyId proxy) const noexcept {
+    return _nodes[_proxies[proxy].index].bounds;
+}
+
+void DynamicAABBTreeBroadPhase::OnCreateProxy(ProxyId proxy) noexcept {
+    const auto leaf = AllocateNode();
+    auto& node = _nodes[leaf];
+    node.bounds = Fatten(_proxies[proxy].bounds);
+    node.height = 0;
+    node.proxy = proxy;
+    _proxies[proxy].index = leaf;
+    InsertLeaf(leaf);
+}
+
+void DynamicAABBTreeBroadPhase::OnDestroyProxy(ProxyId proxy) noexcept {
+    const auto leaf = _proxies[proxy].index;
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+}
+
+void DynamicAABBTreeBroadPhase::OnMoveProxy(ProxyId proxy) noexcept {
+    const auto leaf = _proxies[proxy].index;
+    const auto& bounds = _proxies[proxy].bounds;
+    if(Contains(_nodes[leaf].bounds, bounds)) {
+        return;
+    }
+    RemoveLeaf(leaf);
+    _nodes[leaf].bounds = Fatten(bounds);
+    InsertLeaf(leaf);
+}
+
+void DynamicAABBTreeBroadPhase::OnClear() noexcept {
+    _nodes.clear();
+    _root = null_node;
+    _free_list = null_node;
+}
+
+//Collides the tree with itself: every internal node queues its own subtrees and the pair of its children,
+//and a pair of subtrees is only split further while their fat bounds overlap. Pairs are decided on the tight bounds.
+void DynamicAABBTreeBroadPhase::CollectPairs(std::pmr::vector<Pair>& pairs) noexcept {
+    if(_root == null_node) {
+        return;
+    }
+    _stack.clear();
+    _stack.push_back(_root);
+    _stack.push_back(_root);
+    while(!_stack.empty()) {
+        const auto iB = _stack.back();
+        _stack.pop_back();
+        const auto iA = _stack.back();
+        _stack.pop_back();
+        const auto& a = _nodes[iA];
+        if(iA == iB) {
+            if(!a.IsLeaf()) {
+                _stack.insert(std::end(_stack), {a.child1, a.child1, a.child2, a.child2, a.child1, a.child2});
+            }
+            continue;
+        }
+        const auto& b = _nodes[iB];
+        if(!DoBoundsOverlap(a.bounds, b.bounds)) {
+            continue;
+        }
+        if(a.IsLeaf() && b.IsLeaf()) {
+            if(DoBoundsOverlap(_proxies[a.proxy].bounds, _proxies[b.proxy].bounds)) {
+                pairs.push_back(a.proxy < b.proxy ? Pair{a.proxy, b.proxy} : Pair{b.proxy, a.proxy});
+            }
+            continue;
+        }
+        //Split the taller subtree.
+        if(b.IsLeaf() || (!a.IsLeaf() && b.height <= a.height)) {
+            _stack.insert(std::end(_stack), {a.child1, iB, a.child2, iB});
+        } else {
+            _stack.insert(std::end(_stack), {iA, b.child1, iA, b.child2});
+        }
+    }
+}
+
+std::uint32_t DynamicAABBTreeBroadPhase::AllocateNode() noexcept {
+    if(_free_list == null_node) {
+        _nodes.emplace_back();
+        return static_cast<std::uint32_t>(_nodes.size() - 1u);
+    }
+    const auto node = _free_list;
+    _free_list = _nodes[node].parent;
+    _nodes[node] = Node{};
+    return node;
+}
+
+void DynamicAABBTreeBroadPhase::FreeNode(std::uint32_t node) noexcept {
+    _nodes[node] = Node{};
+    _nodes[node].parent = _free_list;
+    _free_list = node;
+}
+
+void DynamicAABBTreeBroadPhase::InsertLeaf(std::uint32_t leaf) noexcept {
+    if(_root == null_node) {
+        _root = leaf;
+        _nodes[leaf].parent = null_node;
+        return;
+    }
+
+    //Descend towards the sibling whose union with the leaf adds the least perimeter, counting the growth of every ancestor.
+    const auto leaf_bounds = _nodes[leaf].bounds;
+    auto index = _root;
+    while(!_nodes[index].IsLeaf()) {
+        const auto& node = _nodes[index];
+        const auto area = Perimeter(node.bounds);
+        const auto combined_area = Perimeter(Union(node.bounds, leaf_bounds));
+        //Cost of making a new parent for this node and the leaf, and the minimum cost pushed down to the children.
+        const auto cost = 2.0f * combined_area;
+        const auto inheritance_cost = 2.0f * (combined_area - area);
+        const auto child_cost = [&](std::uint32_t child) {
+            const auto& c = _nodes[child];
+            const auto union_area = Perimeter(Union(leaf_bounds, c.bounds));
+            return c.IsLeaf() ? union_area + inheritance_cost : union_area - Perimeter(c.bounds) + inheritance_cost;
+        };
+        const auto cost1 = child_cost(node.child1);
+        const auto cost2 = child_cost(node.child2);
+        if(cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const auto sibling = index;
+    const auto old_parent = _nodes[sibling].parent;
+    const auto new_parent = AllocateNode();
+    _nodes[new_parent].parent = old_parent;
+    _nodes[new_parent].bounds = Union(leaf_bounds, _nodes[sibling].bounds);
+    _nodes[new_parent].height = _nodes[sibling].height + 1;
+    _nodes[new_parent].child1 = sibling;
+    _nodes[new_parent].child2 = leaf;
+    _nodes[sibling].parent = new_parent;
+    _nodes[leaf].parent = new_parent;
+    if(old_parent == null_node) {
+        _root = new_parent;
+    } else if(_nodes[old_parent].child1 == sibling) {
+        _nodes[old_parent].child1 = new_parent;
+    } else {
+        _nodes[old_parent].child2 = new_parent;
+    }
+
+    //Refit and rebalance the ancestors.
+    for(index = _nodes[leaf].parent; index != null_node; index = _nodes[index].parent) {
+        index = Balance(index);
+        auto& node = _nodes[index];
+        const auto& c1 = _nodes[node.child1];
+        const auto& c2 = _nodes[node.child2];
+        node.height = 1 + (std::max)(c1.height, c2.height);
+        node.bounds = Union(c1.bounds, c2.bounds);
+    }
+}
+
+void DynamicAABBTreeBroadPhase::RemoveLeaf(std::uint32_t leaf) noexcept {
+    if(leaf == _root) {
+        _root = null_node;
+        return;
+    }
+    const auto parent = _nodes[leaf].parent;
+    const auto grand_parent = _nodes[parent].parent;
+    const auto sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+    FreeNode(parent);
+    if(grand_parent == null_node) {
+        _root = sibling;
+        _nodes[sibling].parent = null_node;
+        return;
+    }
+    if(_nodes[grand_parent].child1 == parent) {
+        _nodes[grand_parent].child1 = sibling;
+    } else {
+        _nodes[grand_parent].child2 = sibling;
+    }
+    _nodes[sibling].parent = grand_parent;
+    for(auto index = grand_parent; index != null_node; index = _nodes[index].parent) {
+        index = Balance(index);
+        auto& node = _nodes[index];
+        const auto& c1 = _nodes[node.child1];
+        const auto& c2 = _nodes[node.child2];
+        node.bounds = Union(c1.bounds, c2.bounds);
+        node.height = 1 + (std::max)(c1.height, c2.height);
+    }
+}
+
+//Rotates a's taller child up when the heights of a's children differ by more than one. Returns the subtree's new root.
+std::uint32_t DynamicAABBTreeBroadPhase::Balance(std::uint32_t iA) noexcept {
+    if(_nodes[iA].IsLeaf() || _nodes[iA].height < 2) {
+        return iA;
+    }
+    const auto iB = _nodes[iA].child1;
+    const auto iC = _nodes[iA].child2;
+    const auto balance = _nodes[iC].height - _nodes[iB].height;
+
+    const auto rotate_up = [this, iA](std::uint32_t iUp, std::uint32_t iOther) {
+        auto& a = _nodes[iA];
+        auto& up = _nodes[iUp];
+        const auto iF = up.child1;
+        const auto iG = up.child2;
+        auto& f = _nodes[iF];
+        auto& g = _nodes[iG];
+
+        up.child1 = iA;
+        up.parent = a.parent;
+        a.parent = iUp;
+        if(up.parent == null_node) {
+            _root = iUp;
+        } else if(_nodes[up.parent].child1 == iA) {
+            _nodes[up.parent].child1 = iUp;
+        } else {
+            _nodes[up.parent].child2 = iUp;
+        }
+
+        //Keep the taller grandchild under up, move the other one under a.
+        const auto keep_f = f.height > g.height;
+        const auto iKeep = keep_f ? iF : iG;
+        const auto iMove = keep_f ? iG : iF;
+        up.child2 = iKeep;
+        if(a.child1 == iUp) {
+            a.child1 = iMove;
+        } else {
+            a.child2 = iMove;
+        }
+        _nodes[iMove].parent = iA;
+        const auto& other = _nodes[iOther];
+        const auto& moved = _nodes[iMove];
+        const auto& kept = _nodes[iKeep];
+        a.bounds = Union(other.bounds, moved.bounds);
+        a.height = 1 + (std::max)(other.height, moved.height);
+        up.bounds = Union(a.bounds, kept.bounds);
+        up.height = 1 + (std::max)(a.height, kept.height);
+        return iUp;
+    };
+
+    if(balance > 1) {
+        return rotate_up(iC, iB);
+    }
+    if(balance < -1) {
+        return rotate_up(iB, iC);
+    }
+    return iA;
+}
+
+AABB2 DynamicAABBTreeBroadPhase::Fatten(const AABB2& bounds) const noexcept {
+    return AABB2{Vector2{bounds.mins.x - _margin, bounds.mins.y - _margin}, Vector2{bounds.maxs.x + _margin, bounds.maxs.y + _margin}};
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Engine/Physics/BroadPhase.hpp"
+
+#include <cstdint>
+#include <vector>
+
+//Dynamic bounding volume hierarchy.
+//Each proxy is a leaf holding its bounds fattened by a margin; a proxy that moves within its fattened bounds
+//does not touch the tree, otherwise its leaf is removed and reinserted. Leaves are inserted next to the sibling
+//that grows the total perimeter the least and the tree is kept balanced with AVL-style rotations.
+//Nodes live in one flat array with an intrusive free list.
+//    Dynamic AABB tree - Erin Catto, Box2D (b2DynamicTree)
+class DynamicAABBTreeBroadPhase : public BroadPhase {
+public:
+    static constexpr float default_margin = 2.0f;
+
+    explicit DynamicAABBTreeBroadPhase(float margin = default_margin) noexcept;
+    virtual ~DynamicAABBTreeBroadPhase() noexcept = default;
+
+    [[nodiscard]] BroadPhaseType GetType() const noexcept override;
+
+    [[nodiscard]] int GetHeight() const noexcept;
+    [[nodiscard]] const AABB2& GetFatBounds(ProxyId proxy) const noexcept;
+
+protected:
+    void OnCreateProxy(ProxyId proxy) noexcept override;
+    void OnDestroyProxy(ProxyId proxy) noexcept override;
+    void OnMoveProxy(ProxyId proxy) noexcept override;
+    void OnClear() noexcept override;
+    void CollectPairs(std::pmr::vector<Pair>& pairs) noexcept override;
+
+private:
+    static constexpr std::uint32_t null_node = (std::numeric_limits<std::uint32_t>::max)();
+
+    struct Node {
+        AABB2 bounds{};
+        //Parent while in the tree, next free node while on the free list.
+        std::uint32_t parent = null_node;
+        std::uint32_t child1 = null_node;
+        std::uint32_t child2 = null_node;
+        //Leaf = 0, free = -1.
+        int height = -1;
+        ProxyId proxy = null_proxy;
+        [[nodiscard]] bool IsLeaf() const noexcept;
+    };
+
+    [[nodiscard]] std::uint32_t AllocateNode() noexcept;
+    void FreeNode(std::uint32_t node) noexcept;
+    void InsertLeaf(std::uint32_t leaf) noexcept;
+    void RemoveLeaf(std::uint32_t leaf) noexcept;
+    [[nodiscard]] std::uint32_t Balance(std::uint32_t a) noexcept;
+    [[nodiscard]] AABB2 Fatten(const AABB2& bounds) const noexcept;
+
+    std::vector<Node> _nodes{};
+    std::vector<std::uint32_t> _stack{};
+    std::uint32_t _root = null_node;
+    std::uint32_t _free_list = null_node;
+    float _margin = default_margin;
+};
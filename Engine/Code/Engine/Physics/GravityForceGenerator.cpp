@@ -14,7 +14,10 @@ void GravityForceGenerator::notify([[maybe_unused]] TimeUtils::FPSeconds deltaSe
         return;
     }
     for(auto* body : _observers) {
-        body->ApplyForce(g, deltaSeconds);
+        //Applying a force wakes the body, so sleeping bodies are left alone.
+        if(body->IsAwake()) {
+            body->ApplyForce(g, deltaSeconds);
+        }
     }
 }
 
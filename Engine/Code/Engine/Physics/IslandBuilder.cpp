@@ -0,0 +1,74 @@
+#include "Engine/Physics/IslandBuilder.hpp"
+
+#include <numeric>
+#include <utility>
+
+void IslandBuilder::Reset(std::size_t body_count) noexcept {
+    _parents.resize(body_count);
+    std::iota(std::begin(_parents), std::end(_parents), std::uint32_t{0u});
+    _sizes.assign(body_count, 1u);
+    _islands.clear();
+    _offsets.assign(1u, 0u);
+    _bodies.clear();
+}
+
+void IslandBuilder::Link(std::size_t a, std::size_t b) noexcept {
+    auto root_a = FindRoot(static_cast<std::uint32_t>(a));
+    auto root_b = FindRoot(static_cast<std::uint32_t>(b));
+    if(root_a == root_b) {
+        return;
+    }
+    //Union by size keeps the trees shallow.
+    if(_sizes[root_a] < _sizes[root_b]) {
+        std::swap(root_a, root_b);
+    }
+    _parents[root_b] = root_a;
+    _sizes[root_a] += _sizes[root_b];
+}
+
+std::size_t IslandBuilder::Build() noexcept {
+    const auto body_count = _parents.size();
+    static constexpr auto unnumbered = std::uint32_t(-1);
+    //Reuse _sizes to map each root to its island number.
+    _sizes.assign(body_count, unnumbered);
+    _islands.resize(body_count);
+    _offsets.assign(1u, 0u);
+    for(std::uint32_t body = 0u; body < body_count; ++body) {
+        const auto root = FindRoot(body);
+        if(_sizes[root] == unnumbered) {
+            _sizes[root] = static_cast<std::uint32_t>(_offsets.size() - 1u);
+            _offsets.push_back(0u);
+        }
+        _islands[body] = _sizes[root];
+        ++_offsets[_islands[body] + 1u];
+    }
+    std::partial_sum(std::begin(_offsets), std::end(_offsets), std::begin(_offsets));
+    //Counting sort by island; walking bodies in order keeps each island ascending.
+    _bodies.resize(body_count);
+    auto next = std::vector<std::uint32_t>(std::begin(_offsets), std::end(_offsets) - 1);
+    for(std::uint32_t body = 0u; body < body_count; ++body) {
+        _bodies[next[_islands[body]]++] = body;
+    }
+    return GetIslandCount();
+}
+
+std::size_t IslandBuilder::GetIslandCount() const noexcept {
+    return _offsets.size() - 1u;
+}
+
+std::size_t IslandBuilder::GetIsland(std::size_t body) const noexcept {
+    return _islands[body];
+}
+
+std::size_t IslandBuilder::GetBodyCount(std::size_t island) const noexcept {
+    return _offsets[island + 1u] - _offsets[island];
+}
+
+std::uint32_t IslandBuilder::FindRoot(std::uint32_t body) noexcept {
+    //Path halving: point every other node on the way up at its grandparent.
+    while(_parents[body] != body) {
+        _parents[body] = _parents[_parents[body]];
+        body = _parents[body];
+    }
+    return body;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Groups bodies connected by contacts or joints so each group can fall asleep and wake up as a unit.
+//Bodies are identified by index; link them, then Build numbers the connected groups.
+class IslandBuilder {
+public:
+    void Reset(std::size_t body_count) noexcept;
+    void Link(std::size_t a, std::size_t b) noexcept;
+    //Islands are numbered in order of their lowest body index. Returns the island count.
+    std::size_t Build() noexcept;
+
+    [[nodiscard]] std::size_t GetIslandCount() const noexcept;
+    [[nodiscard]] std::size_t GetIsland(std::size_t body) const noexcept;
+    [[nodiscard]] std::size_t GetBodyCount(std::size_t island) const noexcept;
+
+    //Calls fn(body_index) for every body of an island in ascending order.
+    template<typename F>
+    void ForEachBody(std::size_t island, F&& fn) const noexcept;
+
+protected:
+private:
+    [[nodiscard]] std::uint32_t FindRoot(std::uint32_t body) noexcept;
+
+    std::vector<std::uint32_t> _parents{};
+    std::vector<std::uint32_t> _sizes{};
+    std::vector<std::uint32_t> _islands{};
+    //Bodies grouped by island; island i owns [_offsets[i], _offsets[i + 1]).
+    std::vector<std::uint32_t> _offsets{};
+    std::vector<std::uint32_t> _bodies{};
+};
+
+template<typename F>
+void IslandBuilder::ForEachBody(std::size_t island, F&& fn) const noexcept {
+    for(auto i = _offsets[island]; i != _offsets[island + 1u]; ++i) {
+        fn(static_cast<std::size_t>(_bodies[i]));
+    }
+}
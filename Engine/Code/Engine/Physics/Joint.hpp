@@ -3,6 +3,8 @@
 #include "Engine/Core/TimeUtils.hpp"
 #include "Engine/Math/Vector2.hpp"
 
+#include <optional>
+
 class RigidBody;
 class Renderer;
 
@@ -23,6 +25,12 @@ struct JointDef {
 
 class Joint {
 public:
+    struct DistanceConstraint {
+        float length{};
+        //Cables may be shorter than their length and only ever pull.
+        bool can_slacken{false};
+    };
+
     Joint() = default;
     Joint(const Joint& other) = default;
     Joint(Joint&& other) = default;
@@ -47,9 +55,11 @@ public:
 
 protected:
 private:
-    [[nodiscard]] virtual bool ConstraintViolated() const noexcept = 0;
-    [[nodiscard]] virtual void SolvePositionConstraint() const noexcept = 0;
-    [[nodiscard]] virtual void SolveVelocityConstraint() const noexcept = 0;
+    //Joints that return a constraint are solved by PhysicsSystem together with the contacts; the rest act through Notify.
+    [[nodiscard]] virtual std::optional<DistanceConstraint> GetDistanceConstraint() const noexcept = 0;
+
+    //Accumulated impulse from the previous step, used to warm start the solver.
+    float _solver_impulse{};
 
     friend class PhysicsSystem;
 };
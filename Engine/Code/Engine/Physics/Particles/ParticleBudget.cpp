@@ -0,0 +1,82 @@
+#include "Engine/Physics/Particles/ParticleBudget.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ParticleBudget::ParticleBudget(const Settings& settings) noexcept
+: _settings(settings) {
+    /* DO NOTHING */
+}
+
+void ParticleBudget::SetSettings(const Settings& settings) noexcept {
+    _settings = settings;
+}
+
+const ParticleBudget::Settings& ParticleBudget::GetSettings() const noexcept {
+    return _settings;
+}
+
+void ParticleBudget::Allocate(const ParticleView& view, const std::vector<Request>& requests, std::vector<ParticleLod>& lods) noexcept {
+    lods.assign(requests.size(), ParticleLod{});
+    _order.clear();
+    _distances.assign(requests.size(), 0.0f);
+    const auto falloff = (std::max)(_settings.min_rate_distance - _settings.full_rate_distance, 0.0001f);
+    const auto max_interval = (std::max)(_settings.max_update_interval, 1u);
+    for(std::size_t i = 0u; i < requests.size(); ++i) {
+        auto& lod = lods[i];
+        const auto& request = requests[i];
+        lod.is_visible = IsInView(view, request.bounds);
+        if(!lod.is_visible) {
+            continue;
+        }
+        const auto distance = MathUtils::CalcDistance(view.position, MathUtils::CalcClosestPoint(view.position, request.bounds));
+        const auto t = std::clamp((distance - _settings.full_rate_distance) / falloff, 0.0f, 1.0f);
+        lod.update_interval = 1u + static_cast<unsigned int>(std::lround(t * static_cast<float>(max_interval - 1u)));
+        lod.spawn_scale = 1.0f + (_settings.min_spawn_scale - 1.0f) * t;
+        _distances[i] = distance;
+        _order.push_back(i);
+    }
+    //Culled effects keep their particles but are not counted: nothing of theirs is simulated or drawn.
+    std::stable_sort(std::begin(_order), std::end(_order), [&](std::size_t a, std::size_t b) {
+        if(requests[a].priority != requests[b].priority) {
+            return requests[b].priority < requests[a].priority;
+        }
+        return _distances[a] < _distances[b];
+    });
+    auto remaining = _settings.max_particles;
+    for(const auto i : _order) {
+        lods[i].max_particles = remaining;
+        remaining -= (std::min)(remaining, requests[i].particle_count);
+    }
+}
+
+bool ParticleBudget::IsInView(const ParticleView& view, const AABB3& bounds) noexcept {
+    if(view.vfov_degrees <= 0.0f || view.far_distance <= view.near_distance) {
+        return true;
+    }
+    const auto tan_v = std::tan(MathUtils::ConvertDegreesToRadians(view.vfov_degrees * 0.5f));
+    const auto tan_h = tan_v * view.aspect_ratio;
+    struct Side {
+        Vector3 point;
+        Vector3 normal;
+    };
+    //Inward-facing sides of the frustum; the side normals need not be unit length for a sign test.
+    const Side sides[] = {
+    Side{view.position + view.forward * view.near_distance, view.forward},
+    Side{view.position + view.forward * view.far_distance, -view.forward},
+    Side{view.position, view.forward * tan_h + view.right},
+    Side{view.position, view.forward * tan_h - view.right},
+    Side{view.position, view.forward * tan_v + view.up},
+    Side{view.position, view.forward * tan_v - view.up},
+    };
+    for(const auto& side : sides) {
+        //The corner farthest along the normal; if even that one is behind, the whole box is.
+        const auto corner = Vector3{side.normal.x < 0.0f ? bounds.mins.x : bounds.maxs.x, side.normal.y < 0.0f ? bounds.mins.y : bounds.maxs.y, side.normal.z < 0.0f ? bounds.mins.z : bounds.maxs.z};
+        if(MathUtils::DotProduct(corner - side.point, side.normal) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Engine/Math/AABB3.hpp"
+
+#include "Engine/Physics/Particles/ParticleView.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+//How one effect is simulated this frame, as decided by ParticleBudget.
+struct ParticleLod {
+    //Offscreen effects are neither simulated nor drawn; the time they miss is fast-forwarded when they return.
+    bool is_visible{true};
+    //Simulate once every this many frames, stepping over all of their time at once.
+    unsigned int update_interval{1u};
+    //Fraction of each emitter's spawn rate.
+    float spawn_scale{1.0f};
+    //Spawning stops while the effect has this many particles alive.
+    std::size_t max_particles{(std::numeric_limits<std::size_t>::max)()};
+};
+
+//Shares one particle budget between every effect in a scene and scales their work down with distance.
+//Effects whose bounds are wholly outside the view frustum are culled. Visible effects run at full rate up to
+//full_rate_distance and fall off linearly to the lowest update rate and spawn rate at min_rate_distance.
+//The budget is handed out by priority, highest first, nearest first among equals: each effect may grow into
+//whatever the effects before it have not already used, so low-priority effects stop spawning first.
+class ParticleBudget {
+public:
+    struct Settings {
+        std::size_t max_particles{200000u};
+        float full_rate_distance{30.0f};
+        float min_rate_distance{200.0f};
+        unsigned int max_update_interval{4u};
+        float min_spawn_scale{0.25f};
+    };
+
+    //What the budget knows about one effect.
+    struct Request {
+        AABB3 bounds{};
+        std::size_t particle_count{0u};
+        int priority{0};
+    };
+
+    ParticleBudget() noexcept = default;
+    explicit ParticleBudget(const Settings& settings) noexcept;
+
+    void SetSettings(const Settings& settings) noexcept;
+    [[nodiscard]] const Settings& GetSettings() const noexcept;
+
+    //Writes one ParticleLod per request, in the same order.
+    void Allocate(const ParticleView& view, const std::vector<Request>& requests, std::vector<ParticleLod>& lods) noexcept;
+
+    //True unless bounds is entirely outside the view's frustum.
+    [[nodiscard]] static bool IsInView(const ParticleView& view, const AABB3& bounds) noexcept;
+
+protected:
+private:
+    Settings _settings{};
+    std::vector<std::size_t> _order{};
+    std::vector<float> _distances{};
+};
@@ -0,0 +1,129 @@
+#include "Engine/Physics/Particles/ParticleDrawOrder.hpp"
+
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace {
+
+using Histogram = std::array<std::size_t, 256u>;
+
+//Turns bucket counts into the first output slot of each bucket.
+void MakeOffsets(Histogram& histogram) noexcept {
+    std::exclusive_scan(std::cbegin(histogram), std::cend(histogram), std::begin(histogram), std::size_t{0u});
+}
+
+} // namespace
+
+void ParticleDrawOrder::Sort(const ParticlePool& pool, const Vector3& viewPosition, const Vector3& viewForward) noexcept {
+    const auto count = pool.size();
+    RepairOrder(count);
+    if(count < 2u) {
+        _last_method = SortMethod::None;
+        return;
+    }
+    pool.CalcViewDepths(viewPosition, viewForward, _depths);
+    CalcEntries();
+    //About one slot of movement per particle is still cheaper than the radix passes.
+    if(InsertionSort(count)) {
+        _last_method = SortMethod::Insertion;
+    } else {
+        RadixSort();
+        _last_method = SortMethod::Radix;
+    }
+    std::transform(std::cbegin(_entries), std::cend(_entries), std::begin(_order), [](std::uint64_t entry) { return static_cast<std::uint32_t>(entry); });
+}
+
+void ParticleDrawOrder::Clear() noexcept {
+    _order.clear();
+    _last_method = SortMethod::None;
+}
+
+const std::vector<std::uint32_t>& ParticleDrawOrder::GetOrder() const noexcept {
+    return _order;
+}
+
+ParticleDrawOrder::SortMethod ParticleDrawOrder::GetLastSortMethod() const noexcept {
+    return _last_method;
+}
+
+void ParticleDrawOrder::RepairOrder(std::size_t count) noexcept {
+    _seen.assign(count, std::uint8_t{0u});
+    const auto is_stale = [this, count](std::uint32_t index) {
+        if(count <= index || _seen[index]) {
+            return true;
+        }
+        _seen[index] = std::uint8_t{1u};
+        return false;
+    };
+    _order.erase(std::remove_if(std::begin(_order), std::end(_order), is_stale), std::end(_order));
+    //Particles spawned or moved by swap-removal since last frame start at the end and sort in from there.
+    _order.reserve(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        if(!_seen[i]) {
+            _order.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+void ParticleDrawOrder::CalcEntries() noexcept {
+    auto nearest = _depths.front();
+    auto farthest = _depths.front();
+    for(const auto depth : _depths) {
+        nearest = (std::min)(nearest, depth);
+        farthest = (std::max)(farthest, depth);
+    }
+    //Key zero is the farthest particle so an ascending sort draws back to front.
+    const auto range = farthest - nearest;
+    const auto scale = 0.0f < range ? 65535.0f / range : 0.0f;
+    _entries.resize(_order.size());
+    for(std::size_t i = 0u; i < _order.size(); ++i) {
+        const auto key = static_cast<std::uint64_t>((std::min)((farthest - _depths[_order[i]]) * scale, 65535.0f));
+        _entries[i] = (key << 32u) | _order[i];
+    }
+}
+
+bool ParticleDrawOrder::InsertionSort(std::size_t maxMoves) noexcept {
+    std::size_t moves = 0u;
+    for(std::size_t i = 1u; i < _entries.size(); ++i) {
+        const auto entry = _entries[i];
+        const auto key = entry >> 32u;
+        auto j = i;
+        for(; j > 0u && key < (_entries[j - 1u] >> 32u); --j) {
+            _entries[j] = _entries[j - 1u];
+        }
+        _entries[j] = entry;
+        //Stopping here still leaves a permutation of every index for the radix sort to finish.
+        moves += i - j;
+        if(maxMoves < moves) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ParticleDrawOrder::RadixSort() noexcept {
+    const auto count = _entries.size();
+    Histogram low{};
+    Histogram high{};
+    for(const auto entry : _entries) {
+        ++low[(entry >> 32u) & 0xFFu];
+        ++high[(entry >> 40u) & 0xFFu];
+    }
+    _scratch.resize(count);
+    //Least significant byte first; each pass is a stable scatter, and a pass where every key shares a byte is skipped.
+    const auto scatter = [this, count](Histogram& offsets, unsigned int shift) {
+        if(std::find(std::cbegin(offsets), std::cend(offsets), count) != std::cend(offsets)) {
+            return;
+        }
+        MakeOffsets(offsets);
+        for(const auto entry : _entries) {
+            _scratch[offsets[(entry >> shift) & 0xFFu]++] = entry;
+        }
+        _entries.swap(_scratch);
+    };
+    scatter(low, 32u);
+    scatter(high, 40u);
+}
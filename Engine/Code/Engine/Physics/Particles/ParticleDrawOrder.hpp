@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Engine/Math/Vector3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ParticlePool;
+
+//Back-to-front draw order for one emitter's particles, kept separate from the pool so simulation never pays for it.
+//Depths are quantised to 16-bit keys. The previous frame's order is the starting point: particles rarely change
+//places between frames, so a bounded insertion sort usually finishes it and a two-pass radix sort takes over when
+//too much has moved. Both sorts are stable, so particles at equal depth keep their order and do not flicker.
+class ParticleDrawOrder {
+public:
+    enum class SortMethod : std::uint8_t {
+        None,
+        Insertion,
+        Radix,
+    };
+
+    //Orders the pool's particles from farthest to nearest along viewForward.
+    void Sort(const ParticlePool& pool, const Vector3& viewPosition, const Vector3& viewForward) noexcept;
+    //Forgets the previous order; used when the pool's contents are replaced wholesale.
+    void Clear() noexcept;
+
+    [[nodiscard]] const std::vector<std::uint32_t>& GetOrder() const noexcept;
+    [[nodiscard]] SortMethod GetLastSortMethod() const noexcept;
+
+protected:
+private:
+    void RepairOrder(std::size_t count) noexcept;
+    void CalcEntries() noexcept;
+    [[nodiscard]] bool InsertionSort(std::size_t maxMoves) noexcept;
+    void RadixSort() noexcept;
+
+    //Pool indices; swap-removal can leave stale or missing entries, which RepairOrder fixes before sorting.
+    std::vector<std::uint32_t> _order{};
+    //Depth key in the upper 32 bits and pool index in the lower, so both sorts move a single word per particle.
+    std::vector<std::uint64_t> _entries{};
+    std::vector<std::uint64_t> _scratch{};
+    std::vector<float> _depths{};
+    std::vector<std::uint8_t> _seen{};
+    SortMethod _last_method{SortMethod::None};
+};
@@ -5,7 +5,13 @@
 #include "Engine/Physics/Particles/ParticleEmitterDefinition.hpp"
 #include "Engine/Physics/Particles/ParticleEffectDefinition.hpp"
 
+#include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IJobSystemService.hpp"
+#include "Engine/Services/IRendererService.hpp"
+
 #include <algorithm>
+#include <numeric>
+#include <utility>
 
 ParticleEffect::ParticleEffect(const XMLElement& element) noexcept
 {
@@ -24,6 +30,83 @@ ParticleEffect::ParticleEffect(std::string definitionName) noexcept
     }
 }
 
+ParticleEffect::ParticleEffect(const ParticleEffect& other) noexcept
+    : position{other.position}
+    , velocity{other.velocity}
+    , _definitionName{other._definitionName}
+    , _emitters{other._emitters}
+    , _view{other._view}
+    , _lod{other._lod}
+    , _bounds{other._bounds}
+    , _bounds_position{other._bounds_position}
+    , _update_time{other._update_time}
+    , _update_delta_seconds{other._update_delta_seconds}
+    , _pending_seconds{other._pending_seconds}
+    , _frames_since_update{other._frames_since_update}
+    , _priority{other._priority}
+    , _has_bounds{other._has_bounds}
+    , _was_culled{other._was_culled}
+    , _has_new_vertices{other._has_new_vertices}
+    , _is_playing{other._is_playing}
+    , _destroy_on_finish{other._destroy_on_finish}
+{
+    GUARANTEE_OR_DIE(!other._update_job, "ParticleEffect: Cannot copy an effect while it is updating.");
+    AdoptEmitters();
+}
+
+ParticleEffect& ParticleEffect::operator=(const ParticleEffect& rhs) noexcept {
+    if(this != &rhs) {
+        *this = ParticleEffect{rhs};
+    }
+    return *this;
+}
+
+ParticleEffect::ParticleEffect(ParticleEffect&& other) noexcept
+    : ParticleEffect()
+{
+    *this = std::move(other);
+}
+
+ParticleEffect& ParticleEffect::operator=(ParticleEffect&& rhs) noexcept {
+    if(this == &rhs) {
+        return *this;
+    }
+    //Both jobs reference their own effect, so neither may outlive the move.
+    EndUpdate();
+    rhs.EndUpdate();
+    position = rhs.position;
+    velocity = rhs.velocity;
+    _definitionName = std::move(rhs._definitionName);
+    _emitters = std::move(rhs._emitters);
+    _view = rhs._view;
+    _lod = rhs._lod;
+    _bounds = rhs._bounds;
+    _bounds_position = rhs._bounds_position;
+    _update_time = rhs._update_time;
+    _update_delta_seconds = rhs._update_delta_seconds;
+    _pending_seconds = rhs._pending_seconds;
+    _frames_since_update = rhs._frames_since_update;
+    _priority = rhs._priority;
+    _has_bounds = rhs._has_bounds;
+    _was_culled = rhs._was_culled;
+    _has_new_vertices = rhs._has_new_vertices;
+    _is_playing = rhs._is_playing;
+    _destroy_on_finish = rhs._destroy_on_finish;
+    AdoptEmitters();
+    return *this;
+}
+
+ParticleEffect::~ParticleEffect() noexcept {
+    //The job still references this effect.
+    EndUpdate();
+}
+
+void ParticleEffect::AdoptEmitters() {
+    for(auto& emitter : _emitters) {
+        emitter.parent_effect = this;
+    }
+}
+
 void ParticleEffect::PlayOnce(bool value) {
     _destroy_on_finish = value;
     SetPlay(true);
@@ -58,24 +141,109 @@ void ParticleEffect::BeginFrame() {
 }
 
 void ParticleEffect::Update(float time, float deltaSeconds) {
+    EndUpdate();
+    CaptureView();
+    Simulate(time, deltaSeconds);
+    SwapBuffers();
+}
+
+void ParticleEffect::BeginUpdate(float time, float deltaSeconds) {
+    EndUpdate();
+    CaptureView();
+    _update_time = time;
+    _update_delta_seconds = deltaSeconds;
+    auto& jobs = ServiceLocator::get<IJobSystemService>();
+    _update_job = jobs.Create(JobType::Generic, [this](void*) { Simulate(_update_time, _update_delta_seconds); }, nullptr);
+    jobs.Dispatch(_update_job);
+}
+
+void ParticleEffect::EndUpdate() {
+    if(!_update_job) {
+        return;
+    }
+    ServiceLocator::get<IJobSystemService>().WaitAndRelease(_update_job);
+    _update_job = nullptr;
+    SwapBuffers();
+}
+
+void ParticleEffect::SwapBuffers() {
+    //Updates that did not simulate left the back buffers as they were.
+    if(!std::exchange(_has_new_vertices, false)) {
+        return;
+    }
+    for(auto& emitter : _emitters) {
+        emitter.SwapBuffers();
+    }
+}
+
+void ParticleEffect::CaptureView() {
+    _view = ParticleView::CreateFromCamera(ServiceLocator::get<IRendererService>().GetCamera());
+    for(auto& emitter : _emitters) {
+        emitter.ResolveMaterial();
+    }
+}
+
+void ParticleEffect::Simulate(float time, float deltaSeconds) {
     position += velocity * deltaSeconds;
+    _pending_seconds += deltaSeconds;
+    if(!_lod.is_visible) {
+        _was_culled = true;
+        return;
+    }
+    //Coming back into view catches up straight away rather than waiting out the update interval.
+    if(!_was_culled && ++_frames_since_update < _lod.update_interval) {
+        return;
+    }
+    _was_culled = false;
+    _frames_since_update = 0u;
+    const auto elapsed = std::exchange(_pending_seconds, 0.0f);
+    if(_is_playing) {
+        Advance(time, elapsed);
+    }
     for(auto& emitter : _emitters) {
-        if(_is_playing) {
-            emitter.Update(time, deltaSeconds);
-        }
+        emitter.BuildVertices(_view);
     }
+    _has_new_vertices = true;
+    _bounds = CalcBounds();
+    _bounds_position = position;
+    _has_bounds = true;
     if(IsFinished()) {
         SetPlay(false);
     }
 }
 
+void ParticleEffect::Advance(float time, float elapsedSeconds) {
+    //Short enough that catching up still spreads spawns and motion over several steps.
+    static constexpr auto max_step_seconds = 1.0f / 30.0f;
+    //Particles from before the last particle lifetime have all died, so only that much time is simulated;
+    //anything earlier just ages the emitters.
+    const auto simulated = (std::min)(elapsedSeconds, (std::max)(GetLongestParticleLifetime(), max_step_seconds));
+    if(simulated < elapsedSeconds) {
+        for(auto& emitter : _emitters) {
+            emitter.AdvanceAge(elapsedSeconds - simulated);
+        }
+    }
+    auto remaining = simulated;
+    while(0.0f < remaining) {
+        const auto step = (std::min)(remaining, max_step_seconds);
+        remaining -= step;
+        for(auto& emitter : _emitters) {
+            emitter.Update(time - remaining, step);
+        }
+    }
+}
+
 void ParticleEffect::Render() const {
+    if(!_lod.is_visible) {
+        return;
+    }
     for(auto& emitter : _emitters) {
         emitter.Render();
     }
 }
 
 void ParticleEffect::EndFrame() {
+    EndUpdate();
     for(auto& emitter : _emitters) {
         emitter.EndFrame();
     }
@@ -93,6 +261,50 @@ const std::string& ParticleEffect::GetName() const {
     return _definitionName;
 }
 
+void ParticleEffect::SetPriority(int priority) {
+    _priority = priority;
+}
+
+int ParticleEffect::GetPriority() const {
+    return _priority;
+}
+
+void ParticleEffect::SetLod(const ParticleLod& lod) {
+    _lod = lod;
+    //Split evenly between the emitters; a share one of them leaves unused is not passed on.
+    const auto per_emitter = lod.max_particles / (std::max)(_emitters.size(), std::size_t{1u});
+    for(auto& emitter : _emitters) {
+        emitter.SetSpawnScale(lod.spawn_scale);
+        emitter.SetMaxParticles(per_emitter);
+    }
+}
+
+const ParticleLod& ParticleEffect::GetLod() const {
+    return _lod;
+}
+
+AABB3 ParticleEffect::GetBounds() const {
+    if(!_has_bounds) {
+        return CalcBounds();
+    }
+    const auto moved = position - _bounds_position;
+    return AABB3{_bounds.mins + moved, _bounds.maxs + moved};
+}
+
+std::size_t ParticleEffect::GetParticleCount() const {
+    return std::accumulate(std::cbegin(_emitters), std::cend(_emitters), std::size_t{0u}, [](std::size_t count, const ParticleEmitter& emitter) { return count + emitter.GetParticleCount(); });
+}
+
+AABB3 ParticleEffect::CalcBounds() const {
+    auto bounds = AABB3{position, position};
+    for(const auto& emitter : _emitters) {
+        const auto emitter_bounds = emitter.CalcBounds();
+        bounds.StretchToIncludePoint(emitter_bounds.mins);
+        bounds.StretchToIncludePoint(emitter_bounds.maxs);
+    }
+    return bounds;
+}
+
 const std::vector<ParticleEmitter>& ParticleEffect::GetEmitters() const {
     return _emitters;
 }
@@ -137,6 +349,14 @@ float ParticleEffect::GetLongestLifetime() const {
     return 0.0f;
 }
 
+float ParticleEffect::GetLongestParticleLifetime() const {
+    float longest = 0.0f;
+    for(const auto& emitter : _emitters) {
+        longest = (std::max)(longest, emitter.GetParticleLifetime());
+    }
+    return longest;
+}
+
 void ParticleEffect::SetPlay(bool value) {
     _is_playing = value;
     if(_is_playing) {
@@ -1,21 +1,31 @@
 #pragma once
 
 #include "Engine/Core/DataUtils.hpp"
+#include "Engine/Math/AABB3.hpp"
+
+#include "Engine/Physics/Particles/ParticleBudget.hpp"
 #include "Engine/Physics/Particles/ParticleEmitter.hpp"
 
 #include <string>
 #include <vector>
 
+class Job;
+
+//Update simulates and builds vertices on the calling thread. BeginUpdate/EndUpdate do the same work on a
+//generic job so it overlaps the rest of the frame; Render only submits the vertices of the last finished update.
+//A ParticleLod from ParticleBudget can cull the effect or thin out its updates; time it skips is caught up
+//on its next update, and vertices are only rebuilt when it simulates.
 class ParticleEffect {
 public:
     explicit ParticleEffect(std::string definitionName) noexcept;
     explicit ParticleEffect(const XMLElement& element) noexcept;
     ParticleEffect() noexcept = default;
-    ParticleEffect(const ParticleEffect& other) noexcept = default;
-    ParticleEffect& operator=(const ParticleEffect& rhs) noexcept = default;
-    ParticleEffect(ParticleEffect&& other) noexcept = default;
-    ParticleEffect& operator=(ParticleEffect&& rhs) noexcept = default;
-    ~ParticleEffect() noexcept = default;
+    //Copies and moves finish any pending update first and never carry the job over; a copy's source must not be mid-update.
+    ParticleEffect(const ParticleEffect& other) noexcept;
+    ParticleEffect& operator=(const ParticleEffect& rhs) noexcept;
+    ParticleEffect(ParticleEffect&& other) noexcept;
+    ParticleEffect& operator=(ParticleEffect&& rhs) noexcept;
+    ~ParticleEffect() noexcept;
 
     bool PlayOnce() const;
     void PlayOnce(bool value);
@@ -27,11 +37,24 @@ public:
     void Stop();
     void BeginFrame();
     void Update(float time, float deltaSeconds);
+    //Nothing but Render may touch the effect between BeginUpdate and EndUpdate.
+    void BeginUpdate(float time, float deltaSeconds);
+    void EndUpdate();
     void Render() const;
     void EndFrame();
 
     const std::string& GetName() const;
 
+    //Higher priorities are given their share of the particle budget first.
+    void SetPriority(int priority);
+    int GetPriority() const;
+    //Like BeginUpdate, only between updates.
+    void SetLod(const ParticleLod& lod);
+    const ParticleLod& GetLod() const;
+    //World-space box around everything drawn, as of the last update that simulated.
+    AABB3 GetBounds() const;
+    std::size_t GetParticleCount() const;
+
     const std::vector<ParticleEmitter>& GetEmitters() const;
     std::vector<ParticleEmitter>& GetEmitters();
 
@@ -42,9 +65,31 @@ protected:
 private:
     std::string _definitionName{};
     std::vector<ParticleEmitter> _emitters{};
+    ParticleView _view{};
+    Job* _update_job{nullptr};
+    ParticleLod _lod{};
+    AABB3 _bounds{};
+    //Where the effect was when _bounds was taken; drawing follows the effect when it moves.
+    Vector3 _bounds_position{Vector3::Zero};
+    float _update_time{0.0f};
+    float _update_delta_seconds{0.0f};
+    //Simulated time not yet stepped through, while culled or between reduced-rate updates.
+    float _pending_seconds{0.0f};
+    unsigned int _frames_since_update{0u};
+    int _priority{0};
+    bool _has_bounds{false};
+    bool _was_culled{false};
+    bool _has_new_vertices{false};
     bool _is_playing{false};
     bool _destroy_on_finish{false};
 
     void LoadFromXml(const XMLElement& element);
+    void AdoptEmitters();
+    void CaptureView();
+    void Simulate(float time, float deltaSeconds);
+    void Advance(float time, float elapsedSeconds);
+    void SwapBuffers();
+    AABB3 CalcBounds() const;
+    float GetLongestParticleLifetime() const;
     float GetLongestLifetime() const;
 };
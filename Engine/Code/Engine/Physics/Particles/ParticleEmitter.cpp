@@ -8,22 +8,92 @@
 #include "Engine/Physics/Particles/ParticleEmitterDefinition.hpp"
 
 #include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Renderer/Texture2D.hpp"
 
 #include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IJobSystemService.hpp"
 #include "Engine/Services/IRendererService.hpp"
 
 #include <algorithm>
 #include <numeric>
 
+namespace {
+//Appends one particle's quad or cube, centered on position and sized by scale, to the builder's current draw.
+//right, up and forward are the particle's axes: the world axes, or the camera's when billboarded.
+void AppendParticle(Mesh::Builder& builder, ParticleRenderState::ParticleShape shape, const Vector3& right, const Vector3& up, const Vector3& forward, const Vector3& position, const Vector3& scale, const Rgba& color) noexcept {
+    builder.SetColor(color);
+    const auto half_extents = scale * 0.5f;
+    switch(shape) {
+    case ParticleRenderState::ParticleShape::Quad: {
+        const auto l = right * -half_extents.x;
+        const auto r = right * half_extents.x;
+        const auto t = up * -half_extents.y;
+        const auto b = up * half_extents.y;
+
+        builder.SetNormal(forward);
+        builder.SetUV(Vector2(0.0f, 1.0f));
+        builder.AddVertex(position + l + b);
+        builder.SetUV(Vector2(0.0f, 0.0f));
+        builder.AddVertex(position + l + t);
+        builder.SetUV(Vector2(1.0f, 0.0f));
+        builder.AddVertex(position + r + t);
+        builder.SetUV(Vector2(1.0f, 1.0f));
+        builder.AddVertex(position + r + b);
+        builder.AddIndicies(Mesh::Builder::Primitive::Quad);
+        break;
+    }
+    case ParticleRenderState::ParticleShape::Cube: {
+        const auto l = right * -half_extents.x;
+        const auto r = right * half_extents.x;
+        const auto u = up * half_extents.y;
+        const auto d = up * -half_extents.y;
+        const auto f = forward * -half_extents.z;
+        const auto b = forward * half_extents.z;
+
+        const Vector3 v_ldf = position + l + d + f;
+        const Vector3 v_ldb = position + l + d + b;
+        const Vector3 v_luf = position + l + u + f;
+        const Vector3 v_lub = position + l + u + b;
+        const Vector3 v_ruf = position + r + u + f;
+        const Vector3 v_rub = position + r + u + b;
+        const Vector3 v_rdf = position + r + d + f;
+        const Vector3 v_rdb = position + r + d + b;
+
+        const auto add_face = [&builder](const Vector3& normal, const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d) {
+            builder.SetNormal(normal);
+            builder.AddVertex(a);
+            builder.AddVertex(b);
+            builder.AddVertex(c);
+            builder.AddVertex(d);
+            builder.AddIndicies(Mesh::Builder::Primitive::Quad);
+        };
+        add_face(-forward, v_rdf, v_ldf, v_luf, v_ruf);
+        add_face(forward, v_ldb, v_rdb, v_rub, v_lub);
+        add_face(-right, v_ldf, v_ldb, v_lub, v_luf);
+        add_face(right, v_rdb, v_rdf, v_ruf, v_rub);
+        add_face(up, v_ruf, v_luf, v_lub, v_rub);
+        add_face(-up, v_rdb, v_ldb, v_ldf, v_rdf);
+        break;
+    }
+    }
+}
+
+//A rate of zero or less spawns once per 60Hz frame.
+[[nodiscard]] float CalcSpawnInterval(float spawnPerSecond) noexcept {
+    return spawnPerSecond > 0.0f ? 1.0f / spawnPerSecond : 0.016f;
+}
+} // namespace
+
 ParticleEmitter::ParticleEmitter(const std::string& name) noexcept
 : _name(name) {
     const auto* definition = ParticleEmitterDefinition::GetParticleEmitterDefinition(_name);
-    if(definition->_spawnPerSecond > 0.0f) {
-        _spawnClock.SetFrequency(static_cast<unsigned int>(definition->_spawnPerSecond));
-    } else {
-        _spawnClock.SetSeconds(TimeUtils::FPSeconds{0.016f});
-    }
+    _spawnInterval = CalcSpawnInterval(definition->_spawnPerSecond);
+    const auto& render_state = definition->_particleRenderState;
+    _particles.SetColors(render_state.GetStartColor(), render_state.GetEndColor());
+    _particles.SetScales(render_state.GetStartScale(), render_state.GetEndScale());
+    _particles.SetAcceleration(definition->_acceleration);
 }
 
 void ParticleEmitter::Initialize() {
@@ -36,11 +106,9 @@ void ParticleEmitter::BeginFrame() {
 
 void ParticleEmitter::Prewarm(TimeUtils::FPSeconds secondsToWarm) {
     _isWarming = true;
-    Stopwatch oven;
-    oven.SetSeconds(secondsToWarm);
     float time = 0.0f;
     constexpr float deltaSeconds = 1.0f / 60.0f;
-    while(!oven.Check()) {
+    while(time < secondsToWarm.count()) {
         Update(time, deltaSeconds);
         time += deltaSeconds;
     }
@@ -95,38 +163,111 @@ void ParticleEmitter::Update(float time, float deltaSeconds) {
             break;
         }
 
-        Rgba c = definition->_particleRenderState.GetStartColor();
-        Rgba ec = definition->_particleRenderState.GetEndColor();
-        Vector3 s = definition->_particleRenderState.GetStartScale();
-        Vector3 es = definition->_particleRenderState.GetEndScale();
-        auto particle_count = _spawnClock.DecrementAll();
-        auto& renderer = ServiceLocator::get<IRendererService>();
-        for(unsigned int i = 0; i < particle_count; ++i) {
-            SpawnParticle(new_particle_position, new_particle_velocity, definition->_particleLifetime, c, ec, s, es, renderer.GetMaterial(definition->_materialName), definition->_mass);
+        _spawnSeconds += deltaSeconds * _spawnScale;
+        auto particle_count = static_cast<std::size_t>(_spawnSeconds / _spawnInterval);
+        _spawnSeconds -= static_cast<float>(particle_count) * _spawnInterval;
+        particle_count = (std::min)(particle_count, _maxParticles - (std::min)(_maxParticles, _particles.size()));
+        for(std::size_t i = 0u; i < particle_count; ++i) {
+            SpawnParticle(new_particle_position, new_particle_velocity, definition->_particleLifetime);
         }
     }
     UpdateParticles(time, deltaSeconds);
 }
 
-void ParticleEmitter::Render() const {
+void ParticleEmitter::ResolveMaterial() {
+    const auto* definition = ParticleEmitterDefinition::GetParticleEmitterDefinition(_name);
+    auto* material = ServiceLocator::get<IRendererService>().GetMaterial(definition->_materialName);
+    if(material == _material) {
+        return;
+    }
+    _material = material;
+    //Instances are expanded into camera-facing corners by the vertex shader, which has to read ParticleInstance.
+    //Any other material or a non-billboarded emitter keeps drawing expanded vertices.
+    const auto* shader = _material ? _material->GetShader() : nullptr;
+    const auto* program = shader ? shader->GetShaderProgram() : nullptr;
+    _isInstanced = definition->_isInstanced && definition->_isBillboarded && program && program->HasVSInput("INSTANCEPOSITION");
+}
+
+void ParticleEmitter::BuildVertices(const ParticleView& view) {
+    const auto* definition = ParticleEmitterDefinition::GetParticleEmitterDefinition(_name);
+    auto& buffer = _buffers[1u - _front];
     const auto p = Matrix4::CreateTranslationMatrix(parent_effect->position);
-    const auto t = Matrix4::CreateTranslationMatrix(ParticleEmitterDefinition::GetParticleEmitterDefinition(_name)->_position);
-    const auto s = Matrix4::I;
-    const auto r = Matrix4::I;
+    const auto t = Matrix4::CreateTranslationMatrix(definition->_position);
+    buffer.model = Matrix4::MakeRT(p, Matrix4::MakeSRT(Matrix4::I, Matrix4::I, t));
+
+    const auto shape = definition->_particleRenderState.GetShape();
+    const auto right = definition->_isBillboarded ? view.right : Vector3::X_Axis;
+    const auto up = definition->_isBillboarded ? view.up : Vector3::Y_Axis;
+    const auto forward = definition->_isBillboarded ? view.forward : Vector3::Z_Axis;
+    //Opaque particles are depth tested, so only blended ones need to be drawn back to front.
+    //The model matrix only translates, which shifts every particle's depth by the same amount.
+    const auto is_sorted = definition->_isSorted && _material && _material->IsTransparent();
+    if(is_sorted) {
+        _drawOrder.Sort(_particles, view.position, view.forward);
+    }
+    //Cubes have no instanced form and always use expanded vertices.
+    if(_isInstanced && shape == ParticleRenderState::ParticleShape::Quad) {
+        buffer.builder.Clear();
+        const std::vector<std::uint32_t> pool_order{};
+        _particles.WriteInstances(is_sorted ? _drawOrder.GetOrder() : pool_order, buffer.instances);
+        return;
+    }
+    buffer.instances.clear();
+    auto& builder = buffer.builder;
+    const auto append = [&](std::size_t i) {
+        //Fully transparent particles would draw nothing.
+        if(const auto& color = _particles.GetColor(i); _particles.IsAlive(i) && color.a != 0) {
+            AppendParticle(builder, shape, right, up, forward, _particles.GetPosition(i), _particles.GetScale(i), color);
+        }
+    };
+    builder.Clear();
+    builder.Begin(PrimitiveType::Triangles);
+    if(is_sorted) {
+        for(const auto i : _drawOrder.GetOrder()) {
+            append(i);
+        }
+    } else {
+        for(std::size_t i = 0u; i < _particles.size(); ++i) {
+            append(i);
+        }
+    }
+    builder.End(_material);
+}
 
-    const auto pointlight_model = Matrix4::MakeRT(p, Matrix4::MakeSRT(s, r, t));
+void ParticleEmitter::SwapBuffers() noexcept {
+    _front = 1u - _front;
+}
 
+void ParticleEmitter::Render() const {
+    const auto& buffer = _buffers[_front];
     auto& renderer = ServiceLocator::get<IRendererService>();
-    renderer.SetModelMatrix(pointlight_model);
-
-    for(auto& particle : _particles) {
-        particle.Render(_builder);
+    if(!buffer.instances.empty()) {
+        if(!_material) {
+            return;
+        }
+        renderer.SetModelMatrix(buffer.model);
+        renderer.SetMaterial(_material);
+        const auto cbs = _material->GetShader()->GetConstantBuffers();
+        const auto cb_size = cbs.size();
+        for(std::size_t i = 0u; i < cb_size; ++i) {
+            renderer.SetConstantBuffer(renderer.GetConstantBufferStartIndex() + static_cast<unsigned int>(i), &(cbs.begin() + i)->get());
+        }
+        //Four corners per instance, drawn as a strip.
+        renderer.DrawInstanced(PrimitiveType::TriangleStrip, buffer.instances, std::size_t{4u}, buffer.instances.size());
+        for(std::size_t i = 0u; i < cb_size; ++i) {
+            renderer.SetConstantBuffer(renderer.GetConstantBufferStartIndex() + static_cast<unsigned int>(i), nullptr);
+        }
+        return;
+    }
+    if(buffer.builder.verticies.empty()) {
+        return;
     }
-    Mesh::Render(_builder);
+    renderer.SetModelMatrix(buffer.model);
+    Mesh::Render(buffer.builder);
 }
 
 void ParticleEmitter::EndFrame() {
-    _particles.erase(std::remove_if(std::begin(_particles), std::end(_particles), [](const Particle& a) { return a.IsDead(); }), std::end(_particles));
+    DestroyDeadEntities();
 }
 
 float ParticleEmitter::GetAge() const {
@@ -137,6 +278,31 @@ float ParticleEmitter::GetLifetime() const {
     return ParticleEmitterDefinition::GetParticleEmitterDefinition(_name)->_lifetime;
 }
 
+float ParticleEmitter::GetParticleLifetime() const {
+    return ParticleEmitterDefinition::GetParticleEmitterDefinition(_name)->_particleLifetime;
+}
+
+void ParticleEmitter::AdvanceAge(float seconds) {
+    _age += seconds;
+}
+
+void ParticleEmitter::SetSpawnScale(float scale) noexcept {
+    _spawnScale = scale;
+}
+
+void ParticleEmitter::SetMaxParticles(std::size_t maxParticles) noexcept {
+    _maxParticles = maxParticles;
+}
+
+AABB3 ParticleEmitter::CalcBounds() const {
+    const auto* definition = ParticleEmitterDefinition::GetParticleEmitterDefinition(_name);
+    //Particles spawn here, and BuildVertices' model matrix moves them all by the same offset again when drawn.
+    const auto offset = parent_effect->position + definition->_position;
+    auto bounds = _particles.empty() ? AABB3{offset, offset} : _particles.CalcBounds();
+    bounds.StretchToIncludePoint(offset);
+    return AABB3{bounds.mins + offset, bounds.maxs + offset};
+}
+
 std::size_t ParticleEmitter::GetParticleCount() const {
     return _particles.size();
 }
@@ -148,7 +314,7 @@ bool ParticleEmitter::HasAliveParticles() const {
 void ParticleEmitter::LoadFromXML(const XMLElement& element) {
     DataUtils::ValidateXmlElement(element, "emitter", "", "name");
     const auto name = DataUtils::ParseXmlAttribute(element, "name", std::string{});
-    _spawnClock.SetFrequency(static_cast<unsigned int>(ParticleEmitterDefinition::GetParticleEmitterDefinition(name)->_spawnPerSecond));
+    _spawnInterval = CalcSpawnInterval(ParticleEmitterDefinition::GetParticleEmitterDefinition(name)->_spawnPerSecond);
 }
 
 bool ParticleEmitter::IsDead() const {
@@ -164,48 +330,30 @@ void ParticleEmitter::Kill() {
 
 void ParticleEmitter::MakeAlive() {
     _age = 0.0f;
-    _spawnClock.Reset();
+    _spawnSeconds = 0.0f;
 }
 
 Mesh::Builder& ParticleEmitter::GetMeshBuilder() noexcept {
-    return _builder;
+    return _buffers[_front].builder;
 }
 
-void ParticleEmitter::UpdateParticles(float time, float deltaSeconds) {
-    std::sort(std::begin(_particles), std::end(_particles));
-    auto* definition = ParticleEmitterDefinition::GetParticleEmitterDefinition(_name);
-    const auto loc = Matrix4::CreateTranslationMatrix(definition->_position);
-    auto& renderer = ServiceLocator::get<IRendererService>();
-    const auto billboard = definition->_isBillboarded ? renderer.GetCamera().GetInverseViewMatrix() : Matrix4::I;
-    const auto result = Matrix4::MakeRT(billboard, loc);
-    for(Particle& p : _particles) {
-        renderer.AppendModelMatrix(result);
-        p.Update(time, deltaSeconds);
-    }
+void ParticleEmitter::UpdateParticles([[maybe_unused]] float time, float deltaSeconds) {
+    //Whole batches of SIMD lanes per job; dead particles are only swap-removed once every batch is done.
+    static constexpr auto particles_per_batch = std::size_t{4096u};
+    static_assert(particles_per_batch % ParticlePool::simd_width == 0u, "Particle batches must be a whole number of SIMD lanes.");
+    const auto batch_count = (_particles.size() + particles_per_batch - 1u) / particles_per_batch;
+    auto& jobs = ServiceLocator::get<IJobSystemService>();
+    jobs.ParallelFor(std::size_t{0u}, batch_count, std::size_t{1u}, [this, deltaSeconds](std::size_t batch) {
+        const auto first = batch * particles_per_batch;
+        _particles.Update(deltaSeconds, first, (std::min)(first + particles_per_batch, _particles.size()));
+    });
+    _particles.RemoveDead();
 }
 
-void ParticleEmitter::SpawnParticle(const Vector3& initialPosition, const Vector3& initialVelocity, float ttl, const Rgba& color /*= Rgba::WHITE*/, const Rgba& endColor /*= Rgba::WHITE*/, const Vector3& scale /*= Vector3::ONE*/, const Vector3& endScale /*= Vector3::ONE*/, Material* initialMaterial /*= nullptr*/, float initialMass /*= 1.0f*/) {
-    ParticleState initialState;
-    initialState.mass = initialMass;
-    initialState.position = initialPosition;
-    initialState.velocity = initialVelocity;
-    initialState.acceleration = Vector3::Zero;
-
-    ParticleRenderState initialRender;
-    initialRender.SetColors(color, endColor);
-    initialRender.SetScales(scale, endScale);
-    initialRender.SetLifetime(ttl);
-    initialRender.SetMaterial(initialMaterial);
-    initialRender.SetBillboarding(ParticleEmitterDefinition::GetParticleEmitterDefinition(_name)->_isBillboarded);
-
-    _particles.emplace_back(initialRender, initialState);
+void ParticleEmitter::SpawnParticle(const Vector3& initialPosition, const Vector3& initialVelocity, float ttl) {
+    _particles.Spawn(initialPosition, initialVelocity, ttl);
 }
 
 void ParticleEmitter::DestroyDeadEntities() {
-    if(_particles.empty()) {
-        return;
-    }
-
-    _particles.erase(
-    std::remove_if(_particles.begin(), _particles.end(), [](const Particle& p) { return p.IsDead(); }), _particles.end());
+    _particles.RemoveDead();
 }
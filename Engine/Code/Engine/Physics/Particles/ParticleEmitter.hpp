@@ -1,16 +1,22 @@
 #pragma once
 
 #include "Engine/Core/DataUtils.hpp"
-#include "Engine/Core/Stopwatch.hpp"
 #include "Engine/Core/TimeUtils.hpp"
 
+#include "Engine/Math/Matrix4.hpp"
+
 #include "Engine/Renderer/Mesh.hpp"
 
 #include "Engine/Physics/Particles/Particle.hpp"
+#include "Engine/Physics/Particles/ParticleDrawOrder.hpp"
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+#include "Engine/Physics/Particles/ParticleView.hpp"
 
+#include <limits>
 #include <string>
 #include <vector>
 
+class Material;
 class ParticleEmitterDefinition;
 class Texture2D;
 class ParticleEffect;
@@ -30,11 +36,28 @@ public:
     void BeginFrame();
     void Prewarm(TimeUtils::FPSeconds secondsToWarm);
     void Update(float time, float deltaSeconds);
+    //Looks up the definition's material; main thread only, since the renderer may load it.
+    void ResolveMaterial();
+    //Writes this frame's vertices into the back buffer. Touches no renderer state, so it can run on a job.
+    //Instanced quad emitters pack one ParticleInstance per particle instead.
+    void BuildVertices(const ParticleView& view);
+    //Makes the most recently built vertices the ones Render submits.
+    void SwapBuffers() noexcept;
+    //Submits the front buffer as it was built; no particle is visited here.
     void Render() const;
     void EndFrame();
 
     float GetAge() const;
     float GetLifetime() const;
+    float GetParticleLifetime() const;
+    //Ages the emitter without simulating, for time an offscreen effect is not fast-forwarded through.
+    void AdvanceAge(float seconds);
+
+    //Set from the effect's ParticleLod: scales the spawn rate and stops spawning at maxParticles.
+    void SetSpawnScale(float scale) noexcept;
+    void SetMaxParticles(std::size_t maxParticles) noexcept;
+    //World-space box around the particles as drawn, including where the next one spawns.
+    AABB3 CalcBounds() const;
 
     std::size_t GetParticleCount() const;
     bool HasAliveParticles() const;
@@ -51,14 +74,33 @@ protected:
 private:
     void LoadFromXML(const XMLElement& element);
 
-    void SpawnParticle(const Vector3& initialPosition, const Vector3& initialVelocity, float ttl, const Rgba& color /*= Rgba::WHITE*/, const Rgba& endColor /*= Rgba::WHITE*/, const Vector3& scale /*= Vector3::ONE*/, const Vector3& endScale /*= Vector3::ONE*/, Material* initialMaterial /*= nullptr*/, float initialMass /*= 1.0f*/);
+    void SpawnParticle(const Vector3& initialPosition, const Vector3& initialVelocity, float ttl);
     void UpdateParticles(float time, float deltaSeconds);
     void DestroyDeadEntities();
 
     std::string _name{};
-    Stopwatch _spawnClock{};
-    std::vector<Particle> _particles{};
-    mutable Mesh::Builder _builder{};
+    //Colors, scales and acceleration come from the definition and are shared by every particle of the emitter.
+    ParticlePool _particles{};
+    struct RenderBuffer {
+        Mesh::Builder builder{};
+        //Filled instead of builder when the emitter draws instanced quads.
+        std::vector<ParticleInstance> instances{};
+        Matrix4 model{};
+    };
+
+    //Only sorted for transparent materials; the previous frame's order seeds the next sort.
+    ParticleDrawOrder _drawOrder{};
+    //BuildVertices fills the back buffer while Render submits the front one.
+    RenderBuffer _buffers[2]{};
+    std::size_t _front{0u};
+    Material* _material{nullptr};
+    std::size_t _maxParticles{(std::numeric_limits<std::size_t>::max)()};
+    //Spawning follows simulated time, so steps longer than a frame spawn everything they cover.
+    float _spawnInterval{0.016f};
+    float _spawnSeconds{0.0f};
+    float _spawnScale{1.0f};
     float _age{0.0f};
     bool _isWarming{false};
+    //The definition asks for instanced quads and _material can draw them.
+    bool _isInstanced{false};
 };
@@ -9,7 +9,7 @@
 #include "Engine/Services/IRendererService.hpp"
 
 ParticleEmitterDefinition::ParticleEmitterDefinition(const XMLElement& element) noexcept {
-    DataUtils::ValidateXmlElement(element, "emitter", "", "name", "lifetime,position,velocity,acceleration,initial_burst,per_second,particle_lifetime,color,scale,prewarm,material");
+    DataUtils::ValidateXmlElement(element, "emitter", "", "name", "lifetime,position,velocity,acceleration,initial_burst,per_second,particle_lifetime,color,scale,prewarm,sorted,instanced,material");
 
     _name = DataUtils::ParseXmlAttribute(element, "name", std::string{"UNNAMED_PARTICLE_EMITTER"});
 
@@ -141,6 +141,16 @@ ParticleEmitterDefinition::ParticleEmitterDefinition(const XMLElement& element)
         _isPrewarmed = DataUtils::ParseXmlElementText(*xml_prewarm, _isPrewarmed);
     }
 
+    if(auto* xml_sorted = element.FirstChildElement("sorted"); xml_sorted) {
+        DataUtils::ValidateXmlElement(*xml_sorted, "sorted", "", "");
+        _isSorted = DataUtils::ParseXmlElementText(*xml_sorted, _isSorted);
+    }
+
+    if(auto* xml_instanced = element.FirstChildElement("instanced"); xml_instanced) {
+        DataUtils::ValidateXmlElement(*xml_instanced, "instanced", "", "");
+        _isInstanced = DataUtils::ParseXmlElementText(*xml_instanced, _isInstanced);
+    }
+
     if(auto* xml_material = element.FirstChildElement("material"); xml_material) {
         DataUtils::ValidateXmlElement(*xml_material, "material", "", "src");
         std::string material_src = DataUtils::ParseXmlAttribute(*xml_material, "src", std::string{"__2D"});
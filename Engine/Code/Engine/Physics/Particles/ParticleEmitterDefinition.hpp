@@ -68,6 +68,9 @@ private:
     bool _isPrewarmed{false};
     bool _isBillboarded{true};
     bool _isSorted{true};
+    //Billboarded quads are drawn as one compact instance each instead of four expanded vertices.
+    //Needs a material whose vertex shader reads ParticleInstance, such as "__particle"; other materials keep the expanded vertices.
+    bool _isInstanced{false};
 
     friend class ParticleEmitter;
     friend class ParticleEffectDefinition;
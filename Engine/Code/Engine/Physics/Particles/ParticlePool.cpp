@@ -0,0 +1,293 @@
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+static_assert(sizeof(Rgba) == sizeof(std::uint32_t), "ParticlePool writes four packed color channels per particle.");
+
+[[nodiscard]] float CalcLifeLeft(float age, float inverse_lifetime) noexcept {
+    return (std::min)((std::max)(age * inverse_lifetime, 0.0f), 1.0f);
+}
+
+//Rounds a channel already in [0, 255]; the SIMD path adds one half and truncates the same way.
+[[nodiscard]] unsigned char ToChannel(float value) noexcept {
+    return static_cast<unsigned char>(static_cast<int>(value + 0.5f));
+}
+
+} // namespace
+
+void ParticlePool::SetAcceleration(const Vector3& acceleration) noexcept {
+    _acceleration = acceleration;
+}
+
+void ParticlePool::SetColors(const Rgba& start, const Rgba& end) noexcept {
+    _start_color = start;
+    const unsigned char starts[] = {start.r, start.g, start.b, start.a};
+    const unsigned char ends[] = {end.r, end.g, end.b, end.a};
+    for(std::size_t i = 0u; i < 4u; ++i) {
+        _end_color[i] = static_cast<float>(ends[i]);
+        _color_delta[i] = static_cast<float>(starts[i]) - _end_color[i];
+    }
+}
+
+void ParticlePool::SetScales(const Vector3& start, const Vector3& end) noexcept {
+    _start_scale = start;
+    _end_scale = end;
+    _scale_delta = start - end;
+}
+
+const Vector3& ParticlePool::GetAcceleration() const noexcept {
+    return _acceleration;
+}
+
+void ParticlePool::Spawn(const Vector3& position, const Vector3& velocity, float lifetimeSeconds) noexcept {
+    _position_x.push_back(position.x);
+    _position_y.push_back(position.y);
+    _position_z.push_back(position.z);
+    _velocity_x.push_back(velocity.x);
+    _velocity_y.push_back(velocity.y);
+    _velocity_z.push_back(velocity.z);
+    _scale_x.push_back(_start_scale.x);
+    _scale_y.push_back(_start_scale.y);
+    _scale_z.push_back(_start_scale.z);
+    _age.push_back(lifetimeSeconds);
+    _inverse_lifetime.push_back(0.0f < lifetimeSeconds ? 1.0f / lifetimeSeconds : 0.0f);
+    _colors.push_back(_start_color);
+}
+
+void ParticlePool::Reserve(std::size_t count) noexcept {
+    _position_x.reserve(count);
+    _position_y.reserve(count);
+    _position_z.reserve(count);
+    _velocity_x.reserve(count);
+    _velocity_y.reserve(count);
+    _velocity_z.reserve(count);
+    _scale_x.reserve(count);
+    _scale_y.reserve(count);
+    _scale_z.reserve(count);
+    _age.reserve(count);
+    _inverse_lifetime.reserve(count);
+    _colors.reserve(count);
+}
+
+void ParticlePool::Clear() noexcept {
+    _position_x.clear();
+    _position_y.clear();
+    _position_z.clear();
+    _velocity_x.clear();
+    _velocity_y.clear();
+    _velocity_z.clear();
+    _scale_x.clear();
+    _scale_y.clear();
+    _scale_z.clear();
+    _age.clear();
+    _inverse_lifetime.clear();
+    _colors.clear();
+}
+
+void ParticlePool::Step(ParticleState& state, float deltaSeconds) const noexcept {
+    //One lane of the SSE loop in Update: acceleration is scaled by deltaSeconds before it is added, and color and
+    //scale use the same clamped life fraction and rounding, so a tail particle ages exactly like one in a batch.
+    state.age -= deltaSeconds;
+    state.velocity.x += _acceleration.x * deltaSeconds;
+    state.velocity.y += _acceleration.y * deltaSeconds;
+    state.velocity.z += _acceleration.z * deltaSeconds;
+    state.position.x += state.velocity.x * deltaSeconds;
+    state.position.y += state.velocity.y * deltaSeconds;
+    state.position.z += state.velocity.z * deltaSeconds;
+    const auto t = CalcLifeLeft(state.age, state.inverse_lifetime);
+    state.scale.x = _end_scale.x + _scale_delta.x * t;
+    state.scale.y = _end_scale.y + _scale_delta.y * t;
+    state.scale.z = _end_scale.z + _scale_delta.z * t;
+    state.color.r = ToChannel(_end_color[0] + _color_delta[0] * t);
+    state.color.g = ToChannel(_end_color[1] + _color_delta[1] * t);
+    state.color.b = ToChannel(_end_color[2] + _color_delta[2] * t);
+    state.color.a = ToChannel(_end_color[3] + _color_delta[3] * t);
+}
+
+void ParticlePool::Update(float deltaSeconds) noexcept {
+    Update(deltaSeconds, 0u, size());
+    RemoveDead();
+}
+
+void ParticlePool::Update(float deltaSeconds, std::size_t first, std::size_t last) noexcept {
+    auto i = first;
+#if defined(_M_X64) || defined(__SSE2__)
+    const auto dt = _mm_set1_ps(deltaSeconds);
+    const auto ax = _mm_set1_ps(_acceleration.x * deltaSeconds);
+    const auto ay = _mm_set1_ps(_acceleration.y * deltaSeconds);
+    const auto az = _mm_set1_ps(_acceleration.z * deltaSeconds);
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto half = _mm_set1_ps(0.5f);
+    const auto interpolate = [](float end, float delta, __m128 t) { return _mm_add_ps(_mm_set1_ps(end), _mm_mul_ps(_mm_set1_ps(delta), t)); };
+    const auto to_channel = [half](__m128 value) { return _mm_cvttps_epi32(_mm_add_ps(value, half)); };
+    for(; i + simd_width <= last; i += simd_width) {
+        const auto age = _mm_sub_ps(_mm_loadu_ps(&_age[i]), dt);
+        _mm_storeu_ps(&_age[i], age);
+
+        const auto vx = _mm_add_ps(_mm_loadu_ps(&_velocity_x[i]), ax);
+        const auto vy = _mm_add_ps(_mm_loadu_ps(&_velocity_y[i]), ay);
+        const auto vz = _mm_add_ps(_mm_loadu_ps(&_velocity_z[i]), az);
+        _mm_storeu_ps(&_velocity_x[i], vx);
+        _mm_storeu_ps(&_velocity_y[i], vy);
+        _mm_storeu_ps(&_velocity_z[i], vz);
+        _mm_storeu_ps(&_position_x[i], _mm_add_ps(_mm_loadu_ps(&_position_x[i]), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(&_position_y[i], _mm_add_ps(_mm_loadu_ps(&_position_y[i]), _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(&_position_z[i], _mm_add_ps(_mm_loadu_ps(&_position_z[i]), _mm_mul_ps(vz, dt)));
+
+        const auto t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(age, _mm_loadu_ps(&_inverse_lifetime[i])), zero), one);
+        _mm_storeu_ps(&_scale_x[i], interpolate(_end_scale.x, _scale_delta.x, t));
+        _mm_storeu_ps(&_scale_y[i], interpolate(_end_scale.y, _scale_delta.y, t));
+        _mm_storeu_ps(&_scale_z[i], interpolate(_end_scale.z, _scale_delta.z, t));
+
+        //Channels land in memory as r, g, b, a, the layout of Rgba.
+        const auto r = to_channel(interpolate(_end_color[0], _color_delta[0], t));
+        const auto g = to_channel(interpolate(_end_color[1], _color_delta[1], t));
+        const auto b = to_channel(interpolate(_end_color[2], _color_delta[2], t));
+        const auto a = to_channel(interpolate(_end_color[3], _color_delta[3], t));
+        const auto rgba = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&_colors[i]), rgba);
+    }
+#endif
+    for(; i < last; ++i) {
+        UpdateScalar(i, deltaSeconds);
+    }
+}
+
+void ParticlePool::UpdateScalar(std::size_t index, float deltaSeconds) noexcept {
+    auto state = GetState(index);
+    Step(state, deltaSeconds);
+    _position_x[index] = state.position.x;
+    _position_y[index] = state.position.y;
+    _position_z[index] = state.position.z;
+    _velocity_x[index] = state.velocity.x;
+    _velocity_y[index] = state.velocity.y;
+    _velocity_z[index] = state.velocity.z;
+    _scale_x[index] = state.scale.x;
+    _scale_y[index] = state.scale.y;
+    _scale_z[index] = state.scale.z;
+    _age[index] = state.age;
+    _colors[index] = state.color;
+}
+
+void ParticlePool::RemoveDead() noexcept {
+    const auto move_last = [](auto& field, std::size_t index) {
+        field[index] = field.back();
+        field.pop_back();
+    };
+    std::size_t i = 0u;
+    while(i < _age.size()) {
+        if(0.0f < _age[i]) {
+            ++i;
+            continue;
+        }
+        //Fill the hole with the last particle and test that one next.
+        move_last(_position_x, i);
+        move_last(_position_y, i);
+        move_last(_position_z, i);
+        move_last(_velocity_x, i);
+        move_last(_velocity_y, i);
+        move_last(_velocity_z, i);
+        move_last(_scale_x, i);
+        move_last(_scale_y, i);
+        move_last(_scale_z, i);
+        move_last(_age, i);
+        move_last(_inverse_lifetime, i);
+        move_last(_colors, i);
+    }
+}
+
+ParticlePool::ParticleState ParticlePool::GetState(std::size_t index) const noexcept {
+    ParticleState state{};
+    state.position = GetPosition(index);
+    state.velocity = GetVelocity(index);
+    state.scale = GetScale(index);
+    state.age = _age[index];
+    state.inverse_lifetime = _inverse_lifetime[index];
+    state.color = _colors[index];
+    return state;
+}
+
+Vector3 ParticlePool::GetPosition(std::size_t index) const noexcept {
+    return Vector3{_position_x[index], _position_y[index], _position_z[index]};
+}
+
+Vector3 ParticlePool::GetVelocity(std::size_t index) const noexcept {
+    return Vector3{_velocity_x[index], _velocity_y[index], _velocity_z[index]};
+}
+
+Vector3 ParticlePool::GetScale(std::size_t index) const noexcept {
+    return Vector3{_scale_x[index], _scale_y[index], _scale_z[index]};
+}
+
+float ParticlePool::GetAge(std::size_t index) const noexcept {
+    return _age[index];
+}
+
+const Rgba& ParticlePool::GetColor(std::size_t index) const noexcept {
+    return _colors[index];
+}
+
+bool ParticlePool::IsAlive(std::size_t index) const noexcept {
+    return 0.0f < _age[index];
+}
+
+void ParticlePool::CalcViewDepths(const Vector3& viewPosition, const Vector3& viewForward, std::vector<float>& depths) const noexcept {
+    depths.resize(size());
+    //dot(p - v, f) as dot(p, f) - dot(v, f) so the loop over the position arrays stays a plain multiply-add.
+    const auto offset = viewPosition.x * viewForward.x + viewPosition.y * viewForward.y + viewPosition.z * viewForward.z;
+    for(std::size_t i = 0u; i < depths.size(); ++i) {
+        depths[i] = _position_x[i] * viewForward.x + _position_y[i] * viewForward.y + _position_z[i] * viewForward.z - offset;
+    }
+}
+
+void ParticlePool::WriteInstances(const std::vector<std::uint32_t>& order, std::vector<ParticleInstance>& instances) const noexcept {
+    instances.resize(size());
+    std::size_t written = 0u;
+    const auto write = [&](std::size_t index) {
+        //Fully transparent particles would draw nothing.
+        if(!IsAlive(index) || _colors[index].a == 0) {
+            return;
+        }
+        auto& instance = instances[written++];
+        instance.position = Vector3{_position_x[index], _position_y[index], _position_z[index]};
+        instance.scale = Vector2{_scale_x[index], _scale_y[index]};
+        instance.color = _colors[index];
+    };
+    if(order.empty()) {
+        for(std::size_t i = 0u; i < size(); ++i) {
+            write(i);
+        }
+    } else {
+        for(const auto i : order) {
+            write(i);
+        }
+    }
+    instances.resize(written);
+}
+
+AABB3 ParticlePool::CalcBounds() const noexcept {
+    if(empty()) {
+        return AABB3{};
+    }
+    const auto [min_x, max_x] = std::minmax_element(std::cbegin(_position_x), std::cend(_position_x));
+    const auto [min_y, max_y] = std::minmax_element(std::cbegin(_position_y), std::cend(_position_y));
+    const auto [min_z, max_z] = std::minmax_element(std::cbegin(_position_z), std::cend(_position_z));
+    const auto largest = (std::max)({*std::max_element(std::cbegin(_scale_x), std::cend(_scale_x)), *std::max_element(std::cbegin(_scale_y), std::cend(_scale_y)), *std::max_element(std::cbegin(_scale_z), std::cend(_scale_z))});
+    const auto padding = (std::max)(largest, 0.0f) * 0.5f;
+    return AABB3{*min_x - padding, *min_y - padding, *min_z - padding, *max_x + padding, *max_y + padding, *max_z + padding};
+}
+
+std::size_t ParticlePool::size() const noexcept {
+    return _age.size();
+}
+
+bool ParticlePool::empty() const noexcept {
+    return _age.empty();
+}
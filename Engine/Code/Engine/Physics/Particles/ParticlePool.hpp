@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+#include "Engine/Renderer/ParticleInstance.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Structure-of-arrays storage for one emitter's particles.
+//Each field lives in its own contiguous array so Update can step several particles per SIMD instruction.
+//Acceleration and the start and end colors and scales are shared by the whole pool; the color and scale
+//of each particle are interpolated from how much of its lifetime is left.
+//Dead particles are swap-removed, so indices are only stable until the next RemoveDead.
+class ParticlePool {
+public:
+    //Particles stepped per SIMD instruction; ranges starting at multiples of this stay on the SIMD path.
+    static constexpr std::size_t simd_width = 4u;
+
+    struct ParticleState {
+        Vector3 position{};
+        Vector3 velocity{};
+        Vector3 scale{Vector3::One};
+        //Seconds left to live; the particle is dead at zero.
+        float age = 0.0f;
+        float inverse_lifetime = 0.0f;
+        Rgba color{Rgba::White};
+    };
+
+    void SetAcceleration(const Vector3& acceleration) noexcept;
+    void SetColors(const Rgba& start, const Rgba& end) noexcept;
+    void SetScales(const Vector3& start, const Vector3& end) noexcept;
+    [[nodiscard]] const Vector3& GetAcceleration() const noexcept;
+
+    void Spawn(const Vector3& position, const Vector3& velocity, float lifetimeSeconds) noexcept;
+    void Reserve(std::size_t count) noexcept;
+    void Clear() noexcept;
+
+    //One step of a single particle; Update computes exactly this for every particle.
+    void Step(ParticleState& state, float deltaSeconds) const noexcept;
+    //Ages, moves and recolors every particle, then swap-removes the dead ones.
+    void Update(float deltaSeconds) noexcept;
+    //Steps the particles at [first, last) without removing any, so the work can be split across threads.
+    void Update(float deltaSeconds, std::size_t first, std::size_t last) noexcept;
+    void RemoveDead() noexcept;
+
+    [[nodiscard]] ParticleState GetState(std::size_t index) const noexcept;
+    [[nodiscard]] Vector3 GetPosition(std::size_t index) const noexcept;
+    [[nodiscard]] Vector3 GetVelocity(std::size_t index) const noexcept;
+    [[nodiscard]] Vector3 GetScale(std::size_t index) const noexcept;
+    [[nodiscard]] float GetAge(std::size_t index) const noexcept;
+    [[nodiscard]] const Rgba& GetColor(std::size_t index) const noexcept;
+    [[nodiscard]] bool IsAlive(std::size_t index) const noexcept;
+    //Writes how far in front of viewPosition each particle is along viewForward; depths is resized to size().
+    void CalcViewDepths(const Vector3& viewPosition, const Vector3& viewForward, std::vector<float>& depths) const noexcept;
+    //Packs one instance per live, visible particle, visiting them in order, or in pool order when order is empty.
+    //instances is resized to the number written.
+    void WriteInstances(const std::vector<std::uint32_t>& order, std::vector<ParticleInstance>& instances) const noexcept;
+    //Box around every particle's center, grown by half the largest particle; zero-sized at the origin when empty.
+    [[nodiscard]] AABB3 CalcBounds() const noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+protected:
+private:
+    void UpdateScalar(std::size_t index, float deltaSeconds) noexcept;
+
+    Vector3 _acceleration{};
+    Vector3 _start_scale{Vector3::One};
+    Vector3 _end_scale{Vector3::One};
+    //Start minus end, so a particle's value is end + delta * (age / lifetime).
+    Vector3 _scale_delta{};
+    Rgba _start_color{Rgba::White};
+    float _end_color[4]{255.0f, 255.0f, 255.0f, 255.0f};
+    float _color_delta[4]{};
+    std::vector<float> _position_x{};
+    std::vector<float> _position_y{};
+    std::vector<float> _position_z{};
+    std::vector<float> _velocity_x{};
+    std::vector<float> _velocity_y{};
+    std::vector<float> _velocity_z{};
+    std::vector<float> _scale_x{};
+    std::vector<float> _scale_y{};
+    std::vector<float> _scale_z{};
+    std::vector<float> _age{};
+    std::vector<float> _inverse_lifetime{};
+    std::vector<Rgba> _colors{};
+};
@@ -4,7 +4,12 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/FileUtils.hpp"
 
+#include "Engine/Physics/Particles/ParticleEffect.hpp"
 #include "Engine/Physics/Particles/ParticleEffectDefinition.hpp"
+#include "Engine/Physics/Particles/ParticleView.hpp"
+
+#include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IRendererService.hpp"
 
 #include <filesystem>
 #include <iostream>
@@ -51,3 +56,22 @@ bool ParticleSystem::RegisterEffectFromFile(const std::filesystem::path& filepat
     return success;
 }
 
+
+void ParticleSystem::ApplyBudget(const std::vector<ParticleEffect*>& effects) {
+    _requests.resize(effects.size());
+    for(std::size_t i = 0u; i < effects.size(); ++i) {
+        auto& request = _requests[i];
+        request.bounds = effects[i]->GetBounds();
+        request.particle_count = effects[i]->GetParticleCount();
+        request.priority = effects[i]->GetPriority();
+    }
+    const auto view = ParticleView::CreateFromCamera(ServiceLocator::get<IRendererService>().GetCamera());
+    _budget.Allocate(view, _requests, _lods);
+    for(std::size_t i = 0u; i < effects.size(); ++i) {
+        effects[i]->SetLod(_lods[i]);
+    }
+}
+
+ParticleBudget& ParticleSystem::GetBudget() noexcept {
+    return _budget;
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "Engine/Physics/Particles/ParticleBudget.hpp"
+
 #include <filesystem>
 #include <string>
+#include <vector>
 
 class ParticleEffect;
 class ParticleEffectDefinition;
@@ -12,6 +15,14 @@ public:
     void RegisterEffectsFromFolder(std::filesystem::path folderpath, bool recursive = false);
     bool RegisterEffectFromFile(const std::filesystem::path& filepath);
 
+    //Culls, LODs and shares the particle budget between effects against the renderer's current camera.
+    //Call once a frame, after the effects' EndUpdate and before they update again.
+    void ApplyBudget(const std::vector<ParticleEffect*>& effects);
+    ParticleBudget& GetBudget() noexcept;
+
 protected:
 private:
+    ParticleBudget _budget{};
+    std::vector<ParticleBudget::Request> _requests{};
+    std::vector<ParticleLod> _lods{};
 };
@@ -0,0 +1,16 @@
+#include "Engine/Physics/Particles/ParticleView.hpp"
+
+#include "Engine/Renderer/Camera3D.hpp"
+
+ParticleView ParticleView::CreateFromCamera(const Camera3D& camera) noexcept {
+    ParticleView view{};
+    view.position = camera.GetPosition();
+    view.right = camera.GetRight();
+    view.up = camera.GetUp();
+    view.forward = camera.GetForward();
+    view.aspect_ratio = camera.GetAspectRatio();
+    view.vfov_degrees = camera.CalcFovYDegrees();
+    view.near_distance = camera.GetNearDistance();
+    view.far_distance = camera.GetFarDistance();
+    return view;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Engine/Math/Vector3.hpp"
+
+class Camera3D;
+
+//The camera as seen when vertices are built, captured on the main thread so jobs never call into the renderer.
+struct ParticleView {
+    [[nodiscard]] static ParticleView CreateFromCamera(const Camera3D& camera) noexcept;
+
+    Vector3 position{Vector3::Zero};
+    Vector3 right{Vector3::X_Axis};
+    Vector3 up{Vector3::Y_Axis};
+    Vector3 forward{Vector3::Z_Axis};
+    //Perspective projection; a zero field of view means none is known and nothing is culled.
+    float aspect_ratio{1.0f};
+    float vfov_degrees{0.0f};
+    float near_distance{0.0f};
+    float far_distance{0.0f};
+};
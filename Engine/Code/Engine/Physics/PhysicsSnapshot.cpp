@@ -0,0 +1,129 @@
+#include "Engine/Physics/PhysicsSnapshot.hpp"
+
+#include <algorithm>
+
+namespace {
+void WriteVarint(std::vector<std::uint8_t>& buffer, std::size_t value) noexcept {
+    while(0x80u <= value) {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80u));
+        value >>= 7u;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+[[nodiscard]] bool ReadVarint(const std::vector<std::uint8_t>& buffer, std::size_t& offset, std::size_t& value) noexcept {
+    value = 0u;
+    for(auto shift = 0u; shift < sizeof(std::size_t) * 8u; shift += 7u) {
+        if(offset == buffer.size()) {
+            return false;
+        }
+        const auto byte = buffer[offset++];
+        value |= static_cast<std::size_t>(byte & 0x7Fu) << shift;
+        if(!(byte & 0x80u)) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+PhysicsSnapshot::Reader::Reader(const PhysicsSnapshot& snapshot) noexcept
+: _snapshot{&snapshot} {
+    /* DO NOTHING */
+}
+
+bool PhysicsSnapshot::Reader::IsAtEnd() const noexcept {
+    return _offset == _snapshot->size();
+}
+
+void PhysicsSnapshot::Clear() noexcept {
+    _data.clear();
+}
+
+std::size_t PhysicsSnapshot::size() const noexcept {
+    return _data.size();
+}
+
+bool PhysicsSnapshot::empty() const noexcept {
+    return _data.empty();
+}
+
+const std::uint8_t* PhysicsSnapshot::data() const noexcept {
+    return _data.data();
+}
+
+std::uint64_t PhysicsSnapshot::CalcHash() const noexcept {
+    static constexpr auto offset_basis = std::uint64_t{14695981039346656037ull};
+    static constexpr auto prime = std::uint64_t{1099511628211ull};
+    //Mixing in eight bytes per multiply instead of one keeps hashing every step cheap for large worlds.
+    auto hash = offset_basis ^ static_cast<std::uint64_t>(_data.size());
+    const auto word_count = _data.size() / sizeof(std::uint64_t);
+    for(std::size_t i = 0u; i < word_count; ++i) {
+        auto word = std::uint64_t{};
+        std::memcpy(&word, _data.data() + i * sizeof(std::uint64_t), sizeof(std::uint64_t));
+        hash = (hash ^ word) * prime;
+    }
+    for(auto i = word_count * sizeof(std::uint64_t); i < _data.size(); ++i) {
+        hash = (hash ^ _data[i]) * prime;
+    }
+    return hash;
+}
+
+//Layout: the snapshot size, then pairs of (unchanged byte count, changed byte count, changed bytes) until the end.
+//Bytes past the end of base are always sent as changed, so a valid size is never more than base's plus the delta's.
+void PhysicsSnapshot::EncodeDelta(const PhysicsSnapshot& base, std::vector<std::uint8_t>& delta) const noexcept {
+    delta.clear();
+    WriteVarint(delta, _data.size());
+    const auto is_unchanged = [this, &base](std::size_t i) { return i < base._data.size() && _data[i] == base._data[i]; };
+    const auto common_size = (std::min)(_data.size(), base._data.size());
+    std::size_t i = 0u;
+    while(i < _data.size()) {
+        const auto unchanged_start = i;
+        //Most of a snapshot is unchanged, so skip it a word at a time.
+        while(i + sizeof(std::uint64_t) <= common_size && !std::memcmp(_data.data() + i, base._data.data() + i, sizeof(std::uint64_t))) {
+            i += sizeof(std::uint64_t);
+        }
+        while(i < _data.size() && is_unchanged(i)) {
+            ++i;
+        }
+        const auto changed_start = i;
+        while(i < _data.size() && !is_unchanged(i)) {
+            ++i;
+        }
+        WriteVarint(delta, changed_start - unchanged_start);
+        WriteVarint(delta, i - changed_start);
+        delta.insert(std::end(delta), std::cbegin(_data) + changed_start, std::cbegin(_data) + i);
+    }
+}
+
+bool PhysicsSnapshot::DecodeDelta(const PhysicsSnapshot& base, const std::vector<std::uint8_t>& delta) noexcept {
+    std::size_t offset = 0u;
+    std::size_t size = 0u;
+    if(!ReadVarint(delta, offset, size)) {
+        return false;
+    }
+    //Checked before allocating anything, since the size comes from the delta.
+    if(base._data.size() + (delta.size() - offset) < size) {
+        return false;
+    }
+    //Built to the side so a malformed delta leaves this snapshot untouched, even when it is also the base.
+    _decoded.assign(std::cbegin(base._data), std::cbegin(base._data) + (std::min)(size, base._data.size()));
+    _decoded.resize(size, std::uint8_t{0u});
+    std::size_t i = 0u;
+    while(offset < delta.size()) {
+        std::size_t unchanged = 0u;
+        std::size_t changed = 0u;
+        if(!ReadVarint(delta, offset, unchanged) || !ReadVarint(delta, offset, changed)) {
+            return false;
+        }
+        if(size - i < unchanged || size - i - unchanged < changed || delta.size() - offset < changed) {
+            return false;
+        }
+        i += unchanged;
+        std::copy_n(std::cbegin(delta) + offset, changed, std::begin(_decoded) + i);
+        i += changed;
+        offset += changed;
+    }
+    _data.swap(_decoded);
+    return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+//One contiguous buffer of raw simulation state, written and read back in the same order.
+//Snapshots of the same world line up byte for byte, so consecutive ones delta-compress well and hash cheaply.
+class PhysicsSnapshot {
+public:
+    //Reads values back in the order they were written; every read fails once the buffer runs out.
+    class Reader {
+    public:
+        explicit Reader(const PhysicsSnapshot& snapshot) noexcept;
+
+        template<typename T>
+        [[nodiscard]] bool Read(T& value) noexcept;
+        template<typename T>
+        [[nodiscard]] bool Read(T* values, std::size_t count) noexcept;
+        [[nodiscard]] bool IsAtEnd() const noexcept;
+
+    protected:
+    private:
+        const PhysicsSnapshot* _snapshot = nullptr;
+        std::size_t _offset = 0u;
+    };
+
+    void Clear() noexcept;
+
+    template<typename T>
+    void Write(const T& value) noexcept;
+    template<typename T>
+    void Write(const T* values, std::size_t count) noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] const std::uint8_t* data() const noexcept;
+
+    //64-bit FNV-1a taken a word at a time; equal worlds hash equal, so peers and replays can compare one number per step.
+    [[nodiscard]] std::uint64_t CalcHash() const noexcept;
+
+    //Encodes this snapshot as runs of bytes that differ from base, which may be empty or a different size.
+    //Bodies that did not move cost a couple of bytes, so the delta is usually far smaller than the snapshot.
+    void EncodeDelta(const PhysicsSnapshot& base, std::vector<std::uint8_t>& delta) const noexcept;
+    //Rebuilds the snapshot EncodeDelta was called on from the same base.
+    //Returns false and leaves the snapshot as it was if delta is malformed.
+    [[nodiscard]] bool DecodeDelta(const PhysicsSnapshot& base, const std::vector<std::uint8_t>& delta) noexcept;
+
+protected:
+private:
+    std::vector<std::uint8_t> _data{};
+    //DecodeDelta builds into this and swaps it with _data on success, so each keeps its capacity.
+    std::vector<std::uint8_t> _decoded{};
+};
+
+template<typename T>
+void PhysicsSnapshot::Write(const T& value) noexcept {
+    Write(&value, 1u);
+}
+
+template<typename T>
+void PhysicsSnapshot::Write(const T* values, std::size_t count) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshots only hold trivially copyable values.");
+    if(!count) {
+        return;
+    }
+    const auto offset = _data.size();
+    _data.resize(offset + sizeof(T) * count);
+    std::memcpy(_data.data() + offset, values, sizeof(T) * count);
+}
+
+template<typename T>
+bool PhysicsSnapshot::Reader::Read(T& value) noexcept {
+    return Read(&value, 1u);
+}
+
+template<typename T>
+bool PhysicsSnapshot::Reader::Read(T* values, std::size_t count) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshots only hold trivially copyable values.");
+    const auto bytes = sizeof(T) * count;
+    if(_snapshot->size() - _offset < bytes) {
+        _offset = _snapshot->size();
+        return false;
+    }
+    if(bytes) {
+        std::memcpy(values, _snapshot->data() + _offset, bytes);
+    }
+    _offset += bytes;
+    return true;
+}
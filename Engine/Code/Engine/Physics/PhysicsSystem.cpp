@@ -1,13 +1,54 @@
 #include "Engine/Physics/PhysicsSystem.hpp"
 
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Plane2.hpp"
 #include "Engine/Physics/PhysicsUtils.hpp"
 
 #include "Engine/Services/ServiceLocator.hpp"
+#include "Engine/Services/IJobSystemService.hpp"
 #include "Engine/Services/IRendererService.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <mutex>
+#include <optional>
+
+namespace {
+//Identifies physics snapshots; bump the version whenever WriteSimulationState changes what it writes.
+constexpr auto snapshot_magic = std::uint32_t{0x50485953u};
+constexpr auto snapshot_version = std::uint32_t{1u};
+
+//AABB2(const OBB2&) ignores the orientation; the broad phase needs bounds that contain the rotated box.
+[[nodiscard]] AABB2 CalcBroadPhaseBounds(const RigidBody& body) noexcept {
+    const auto obb = body.GetBounds();
+    const auto c = std::abs(MathUtils::CosDegrees(obb.orientationDegrees));
+    const auto s = std::abs(MathUtils::SinDegrees(obb.orientationDegrees));
+    const auto half_extents = Vector2{c * obb.half_extents.x + s * obb.half_extents.y, s * obb.half_extents.x + c * obb.half_extents.y};
+    return AABB2{obb.position - half_extents, obb.position + half_extents};
+}
+
+//Bounds covering the body everywhere along a sweep whose ends are given relative to its current position.
+[[nodiscard]] AABB2 CalcSweptBounds(const AABB2& bounds, const Vector2& start_offset, const Vector2& end_offset) noexcept {
+    const auto mins = Vector2{(std::min)(start_offset.x, end_offset.x), (std::min)(start_offset.y, end_offset.y)};
+    const auto maxs = Vector2{(std::max)(start_offset.x, end_offset.x), (std::max)(start_offset.y, end_offset.y)};
+    return AABB2{bounds.mins + mins, bounds.maxs + maxs};
+}
+
+//Bodies that integration can move; only these join islands and fall asleep.
+[[nodiscard]] bool CanSleep(const RigidBody& body) noexcept {
+    return body.IsDynamic() && body.IsPhysicsEnabled() && !MathUtils::IsEquivalentToZero(body.GetInverseMass());
+}
+
+[[nodiscard]] bool IsJointAsleep(const Joint& joint) noexcept {
+    const auto is_simulated = [](const RigidBody* body) { return body && body->IsSimulated(); };
+    return !is_simulated(joint.GetBodyA()) && !is_simulated(joint.GetBodyB());
+}
+
+[[nodiscard]] float CalcAngleDifferenceDegrees(float a, float b) noexcept {
+    const auto difference = std::abs(a - b);
+    return (std::min)(difference, 360.0f - difference);
+}
+} // namespace
 
 void PhysicsSystem::Enable(bool enable) {
     _is_running = enable;
@@ -38,10 +79,16 @@ const PhysicsSystemDesc& PhysicsSystem::GetWorldDescription() const noexcept {
 }
 
 void PhysicsSystem::SetWorldDescription(const PhysicsSystemDesc& new_desc) {
+    const auto broad_phase_changed = new_desc.broad_phase != _desc.broad_phase || new_desc.broad_phase_margin != _desc.broad_phase_margin;
     _desc = new_desc;
+    if(broad_phase_changed) {
+        CreateBroadPhase();
+    }
     _gravityFG.SetGravity(_desc.gravity);
     _dragFG.SetCoefficients(_desc.dragK1K2);
-    //_world_partition.SetWorldBounds(_desc.world_bounds);
+    _world_partition.SetWorldBounds(_desc.world_bounds);
+    _timestep.SetStepsPerSecond(_desc.steps_per_second);
+    _timestep.SetMaxStepsPerFrame(_desc.max_steps_per_frame);
 }
 
 void PhysicsSystem::EnablePhysics(bool isPhysicsEnabled) noexcept {
@@ -72,13 +119,17 @@ void PhysicsSystem::EnableDrag(bool isGravityEnabled) noexcept {
 
 PhysicsSystem::PhysicsSystem(const PhysicsSystemDesc& desc /*= PhysicsSystemDesc{}*/)
 : _desc(desc)
-//, _world_partition(_desc.world_bounds)
-{
-    /* DO NOTHING */
+, _world_partition(_desc.world_bounds)
+, _timestep(_desc.steps_per_second, _desc.max_steps_per_frame) {
+    CreateBroadPhase();
 }
 
 PhysicsSystem::~PhysicsSystem() {
     _is_running = false;
+    //Bodies usually outlive the system; give them back their state before _body_store goes away.
+    for(auto* body : _rigidBodies) {
+        body->linear_state.Unbind();
+    }
 }
 
 void PhysicsSystem::Initialize() noexcept {
@@ -95,11 +146,12 @@ void PhysicsSystem::BeginFrame() noexcept {
     //_rigidBodies.reserve(_rigidBodies.size() + _pending_addition.size());
     for(auto* a : _pending_addition) {
         _rigidBodies.emplace_back(a);
+        a->linear_state.Bind(_body_store);
+        const auto bounds = CalcBroadPhaseBounds(*a);
+        _body_handles[a] = BodyHandles{_broad_phase->CreateProxy(bounds, a), _world_partition.Add(a, bounds)};
     }
     _pending_addition.clear();
     _pending_addition.shrink_to_fit();
-    //_world_partition.Clear();
-    //_world_partition.Add(_rigidBodies);
 
     for(auto* body : _rigidBodies) {
         const auto is_gravity_enabled = body->IsGravityEnabled();
@@ -114,39 +166,192 @@ void PhysicsSystem::Update(TimeUtils::FPSeconds deltaSeconds) noexcept {
     if(!this->_is_running) {
         return;
     }
-    _deltaSeconds = deltaSeconds;
-    _accumulatedTime += _deltaSeconds;
-    if(_accumulatedTime >= _targetFrameRate) {
-        _accumulatedTime -= _targetFrameRate;
-        return;
+    //The simulation always advances in whole fixed steps so it behaves the same at any frame rate.
+    for(auto steps = _timestep.Advance(deltaSeconds); steps > 0; --steps) {
+        Step(_timestep.GetStepDuration());
     }
-    ApplyGravityAndDrag(_targetFrameRate);
-    ApplyCustomAndJointForces(_targetFrameRate);
     auto& renderer = ServiceLocator::get<IRendererService>();
     const auto camera_position = Vector2(renderer.GetCamera().GetPosition());
     const auto half_extents = Vector2(renderer.GetOutput()->GetDimensions()) * 0.5f;
     const auto query_area = AABB2(camera_position - half_extents, camera_position + half_extents);
-    const auto potential_collisions = BroadPhaseCollision(query_area);
-    const auto actual_collisions = NarrowPhaseCollision(potential_collisions, PhysicsUtils::GJK, PhysicsUtils::EPA);
-    SolveCollision(actual_collisions);
-    SolveConstraints();
-    UpdateBodiesInBounds(_targetFrameRate);
-    SolveConstraints();
+    UpdateVisibleBodies(query_area);
 }
 
-void PhysicsSystem::UpdateBodiesInBounds(TimeUtils::FPSeconds deltaSeconds) noexcept {
+void PhysicsSystem::Step(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::Step");
+    for(std::size_t i = 0u; i < _rigidBodies.size(); ++i) {
+        _rigidBodies[i]->system_index = static_cast<std::uint32_t>(i);
+        _rigidBodies[i]->BeginStep();
+    }
+    ApplyGravityAndDrag(deltaSeconds);
+    ApplyCustomAndJointForces(deltaSeconds);
+    const auto potential_collisions = BroadPhaseCollision();
+    const auto actual_collisions = NarrowPhaseCollision(potential_collisions, PhysicsUtils::Collide);
+    UpdateBodiesInBounds(deltaSeconds, actual_collisions);
+    SolveContinuousCollisions(deltaSeconds);
+    UpdateIslands(deltaSeconds, actual_collisions);
+    ++_step_count;
+    if(_desc.check_determinism) {
+        _step_snapshot.Clear();
+        WriteSimulationState(_step_snapshot);
+        _step_hash = _step_snapshot.CalcHash();
+    }
+}
+
+float PhysicsSystem::GetInterpolationAlpha() const noexcept {
+    return _timestep.GetAlpha();
+}
+
+void PhysicsSystem::SaveSnapshot(PhysicsSnapshot& snapshot) const noexcept {
+    PROFILE_SCOPE("PhysicsSystem::SaveSnapshot");
+    snapshot.Clear();
+    snapshot.Write(snapshot_magic);
+    snapshot.Write(snapshot_version);
+    snapshot.Write(_step_count);
+    snapshot.Write(_timestep.GetAccumulatedTime().count());
+    WriteSimulationState(snapshot);
+}
+
+//Fixed-size records come first and variable-length ones last, so a change in one body's timed forces
+//does not shift every body after it and blow up the delta against the previous snapshot.
+void PhysicsSystem::WriteSimulationState(PhysicsSnapshot& snapshot) const noexcept {
+    static_assert(sizeof(RigidBody::SnapshotState) == 22u * sizeof(float), "RigidBody::SnapshotState must not contain padding.");
+    static_assert(sizeof(WarmStart) == 6u * sizeof(float), "PhysicsSystem::WarmStart must not contain padding.");
+    snapshot.Write(_next_sleep_island);
+    snapshot.Write(static_cast<std::uint32_t>(_rigidBodies.size()));
+    for(const auto* body : _rigidBodies) {
+        snapshot.Write(body->GetSnapshotState());
+    }
+    for(const auto* body : _rigidBodies) {
+        snapshot.Write(static_cast<std::uint32_t>(body->timed_forces.size()));
+    }
+    for(const auto* body : _rigidBodies) {
+        snapshot.Write(body->timed_forces.data(), body->timed_forces.size());
+    }
+    snapshot.Write(static_cast<std::uint32_t>(_joints.size()));
+    for(const auto& joint : _joints) {
+        snapshot.Write(joint->_solver_impulse);
+    }
+    snapshot.Write(static_cast<std::uint32_t>(_warm_starts.size()));
+    snapshot.Write(_warm_starts.data(), _warm_starts.size());
+}
+
+bool PhysicsSystem::RestoreSnapshot(const PhysicsSnapshot& snapshot) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::RestoreSnapshot");
+    auto reader = PhysicsSnapshot::Reader{snapshot};
+    auto magic = std::uint32_t{};
+    auto version = std::uint32_t{};
+    auto step_count = std::uint64_t{};
+    auto accumulated = 0.0f;
+    auto next_sleep_island = std::uint32_t{};
+    auto body_count = std::uint32_t{};
+    if(!reader.Read(magic) || magic != snapshot_magic || !reader.Read(version) || version != snapshot_version) {
+        return false;
+    }
+    if(!reader.Read(step_count) || !reader.Read(accumulated) || !reader.Read(next_sleep_island)) {
+        return false;
+    }
+    if(!reader.Read(body_count) || body_count != _rigidBodies.size()) {
+        return false;
+    }
+    _restore_bodies.resize(body_count);
+    _restore_timed_force_counts.resize(body_count);
+    if(!reader.Read(_restore_bodies.data(), body_count) || !reader.Read(_restore_timed_force_counts.data(), body_count)) {
+        return false;
+    }
+    auto timed_force_count = std::size_t{0u};
+    for(const auto count : _restore_timed_force_counts) {
+        timed_force_count += count;
+    }
+    if(snapshot.size() < timed_force_count * sizeof(RigidBody::TimedForce)) {
+        return false;
+    }
+    _restore_timed_forces.resize(timed_force_count);
+    auto joint_count = std::uint32_t{};
+    if(!reader.Read(_restore_timed_forces.data(), timed_force_count) || !reader.Read(joint_count) || joint_count != _joints.size()) {
+        return false;
+    }
+    _restore_joint_impulses.resize(joint_count);
+    auto warm_start_count = std::uint32_t{};
+    if(!reader.Read(_restore_joint_impulses.data(), joint_count) || !reader.Read(warm_start_count) || snapshot.size() < warm_start_count * sizeof(WarmStart)) {
+        return false;
+    }
+    _restore_warm_starts.resize(warm_start_count);
+    if(!reader.Read(_restore_warm_starts.data(), warm_start_count) || !reader.IsAtEnd()) {
+        return false;
+    }
+
+    _step_count = step_count;
+    _timestep.SetAccumulatedTime(TimeUtils::FPSeconds{accumulated});
+    _next_sleep_island = next_sleep_island;
+    auto timed_force = std::cbegin(_restore_timed_forces);
+    for(std::size_t i = 0u; i < _rigidBodies.size(); ++i) {
+        auto* body = _rigidBodies[i];
+        body->SetSnapshotState(_restore_bodies[i]);
+        body->timed_forces.assign(timed_force, timed_force + _restore_timed_force_counts[i]);
+        timed_force += _restore_timed_force_counts[i];
+    }
+    for(std::size_t i = 0u; i < _joints.size(); ++i) {
+        _joints[i]->_solver_impulse = _restore_joint_impulses[i];
+    }
+    _warm_starts.swap(_restore_warm_starts);
+    //BroadPhaseCollision skips sleeping bodies, so every proxy is moved here; pairs only depend on the bounds they end up with.
     for(auto* body : _rigidBodies) {
+        if(const auto found = _body_handles.find(body); found != std::end(_body_handles)) {
+            const auto bounds = CalcBroadPhaseBounds(*body);
+            _broad_phase->MoveProxy(found->second.proxy, bounds);
+            _world_partition.Update(found->second.partition, bounds);
+        }
+    }
+    return true;
+}
+
+std::uint64_t PhysicsSystem::GetStepHash() const noexcept {
+    return _step_hash;
+}
+
+std::uint64_t PhysicsSystem::GetStepCount() const noexcept {
+    return _step_count;
+}
+
+void PhysicsSystem::UpdateBodiesInBounds(TimeUtils::FPSeconds deltaSeconds, const CollisionDataList& actual_collisions) noexcept {
+    //Bodies only write their own state so each pass can run in parallel.
+    //The linear integration in between steps the whole store in SIMD batches instead of body by body.
+    //Contacts and joints correct the new velocities before they move anything, then push apart whatever still overlaps.
+    static constexpr auto bodies_per_job = std::size_t{64u};
+    static constexpr auto bodies_per_batch = std::size_t{256u};
+    static_assert(bodies_per_batch % RigidBodyStore::simd_width == 0u, "Integration batches must be a whole number of SIMD lanes.");
+    auto& jobs = ServiceLocator::get<IJobSystemService>();
+    jobs.ParallelFor(std::size_t{0u}, _rigidBodies.size(), bodies_per_job, [this, deltaSeconds](std::size_t index) {
+        if(auto* body = _rigidBodies[index]; body) {
+            body->PrepareIntegration(deltaSeconds);
+        }
+    });
+    const auto batch_count = (_body_store.size() + bodies_per_batch - 1u) / bodies_per_batch;
+    jobs.ParallelFor(std::size_t{0u}, batch_count, std::size_t{1u}, [this, deltaSeconds](std::size_t batch) {
+        const auto first = batch * bodies_per_batch;
+        _body_store.IntegrateVelocities(deltaSeconds.count(), first, (std::min)(first + bodies_per_batch, _body_store.size()));
+    });
+    PrepareConstraints(actual_collisions);
+    SolveVelocityConstraints();
+    jobs.ParallelFor(std::size_t{0u}, batch_count, std::size_t{1u}, [this, deltaSeconds](std::size_t batch) {
+        const auto first = batch * bodies_per_batch;
+        _body_store.IntegratePositions(deltaSeconds.count(), first, (std::min)(first + bodies_per_batch, _body_store.size()));
+    });
+    SolvePositionConstraints();
+    jobs.ParallelFor(std::size_t{0u}, _rigidBodies.size(), bodies_per_job, [this, deltaSeconds](std::size_t index) {
+        auto* body = _rigidBodies[index];
         if(!body) {
-            continue;
+            return;
         }
-        body->Update(deltaSeconds);
+        body->FinishIntegration(deltaSeconds);
         //if(!MathUtils::DoOBBsOverlap(OBB2(_desc.world_bounds), body->GetBounds())) {
         //    body->FellOutOfWorld();
         //}
         //if(MathUtils::IsPointInFrontOfPlane(body->GetPosition(), Plane2(Vector2::Y_AXIS, _desc.kill_plane_distance))) {
         //    body->FellOutOfWorld();
         //}
-    }
+    });
 }
 
 void PhysicsSystem::ApplyCustomAndJointForces(TimeUtils::FPSeconds deltaSeconds) noexcept {
@@ -154,7 +359,9 @@ void PhysicsSystem::ApplyCustomAndJointForces(TimeUtils::FPSeconds deltaSeconds)
         fg->notify(deltaSeconds);
     }
     for(auto&& joint : _joints) {
-        joint->Notify(deltaSeconds);
+        if(!IsJointAsleep(*joint)) {
+            joint->Notify(deltaSeconds);
+        }
     }
 }
 
@@ -163,80 +370,293 @@ void PhysicsSystem::ApplyGravityAndDrag(TimeUtils::FPSeconds deltaSeconds) noexc
     _dragFG.notify(deltaSeconds);
 }
 
-std::vector<RigidBody*> PhysicsSystem::BroadPhaseCollision(const AABB2& /*query_area*/) noexcept {
-    std::vector<RigidBody*> potential_collisions{};
-    for(auto iterA = std::begin(_rigidBodies); iterA != std::end(_rigidBodies); ++iterA) {
-        for(auto iterB = iterA + 1; iterB != std::end(_rigidBodies); ++iterB) {
-            auto* bodyA = *iterA;
-            auto* bodyB = *iterB;
-            if(!bodyA || !bodyB) {
-                continue;
+void PhysicsSystem::CreateBroadPhase() noexcept {
+    _broad_phase = BroadPhase::Create(_desc.broad_phase, _desc.broad_phase_margin);
+    //Cached contacts are keyed by the old proxy ids.
+    _warm_starts.clear();
+    //In insertion order so every run hands out the same proxy ids.
+    for(auto* body : _rigidBodies) {
+        if(const auto found = _body_handles.find(body); found != std::end(_body_handles)) {
+            found->second.proxy = _broad_phase->CreateProxy(CalcBroadPhaseBounds(*body), body);
+        }
+    }
+}
+
+std::pmr::vector<BroadPhase::Pair> PhysicsSystem::BroadPhaseCollision() noexcept {
+    //Every body is tested so collisions keep happening off screen; the world partition follows along for area queries.
+    //Moved in insertion order so tree rebalancing, and with it the pair order, is the same on every run.
+    for(auto* body : _rigidBodies) {
+        //Sleeping bodies have not moved since they fell asleep.
+        if(body->IsDynamic() && !body->IsAwake()) {
+            continue;
+        }
+        if(const auto found = _body_handles.find(body); found != std::end(_body_handles)) {
+            const auto bounds = CalcBroadPhaseBounds(*body);
+            _broad_phase->MoveProxy(found->second.proxy, bounds);
+            _world_partition.Update(found->second.partition, bounds);
+        }
+    }
+    std::pmr::vector<BroadPhase::Pair> potential_collisions{FrameArena::Current()};
+    _broad_phase->FindPairs(potential_collisions);
+    return potential_collisions;
+}
+
+void PhysicsSystem::UpdateVisibleBodies(const AABB2& query_area) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::UpdateVisibleBodies");
+    _visible_bodies.clear();
+    _world_partition.Query(query_area, [this](RigidBody* body) { _visible_bodies.push_back(body); });
+}
+
+void PhysicsSystem::UpdateIslands(TimeUtils::FPSeconds deltaSeconds, const CollisionDataList& actual_collisions) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::UpdateIslands");
+    const auto body_count = _rigidBodies.size();
+    const auto link = [this](const RigidBody* a, const RigidBody* b) {
+        if(IsAdded(a) && IsAdded(b) && CanSleep(*a) && CanSleep(*b)) {
+            _islands.Link(a->system_index, b->system_index);
+        }
+    };
+    _islands.Reset(body_count);
+    for(const auto& collision : actual_collisions) {
+        link(collision.a, collision.b);
+    }
+    for(const auto& joint : _joints) {
+        link(joint->GetBodyA(), joint->GetBodyB());
+    }
+    const auto island_count = _islands.Build();
+
+    //Motion is measured across the whole step, after contacts and joints pushed bodies back, so bodies held in place read as resting.
+    const auto max_distance = _desc.sleep_linear_speed * deltaSeconds.count();
+    const auto max_rotation = _desc.sleep_angular_speed * deltaSeconds.count();
+    for(auto* body : _rigidBodies) {
+        if(!body->IsSimulated()) {
+            continue;
+        }
+        const auto position = body->GetPosition();
+        const auto orientation = body->GetOrientationDegrees();
+        const auto moved = max_distance * max_distance < (position - body->rest_position).CalcLengthSquared() || max_rotation < CalcAngleDifferenceDegrees(orientation, body->rest_orientationDegrees);
+        body->time_since_last_move = moved ? TimeUtils::FPSeconds::zero() : body->time_since_last_move + deltaSeconds;
+        body->rest_position = position;
+        body->rest_orientationDegrees = orientation;
+    }
+
+    //An island sleeps once all of its bodies have rested long enough and wakes as a whole when any of them is disturbed.
+    _islands_to_wake.clear();
+    for(std::size_t island = 0u; island < island_count; ++island) {
+        auto has_awake_body = false;
+        auto is_resting = true;
+        _islands.ForEachBody(island, [&](std::size_t index) {
+            if(const auto* body = _rigidBodies[index]; body->IsSimulated()) {
+                has_awake_body = true;
+                is_resting = is_resting && _desc.time_to_sleep <= body->time_since_last_move;
+            }
+        });
+        if(!has_awake_body) {
+            continue;
+        }
+        const auto sleep_island = _next_sleep_island;
+        if(is_resting && ++_next_sleep_island == RigidBody::not_sleeping) {
+            _next_sleep_island = 0u;
+        }
+        _islands.ForEachBody(island, [&](std::size_t index) {
+            auto* body = _rigidBodies[index];
+            if(!CanSleep(*body)) {
+                return;
             }
-            const auto bodyABoundsAsAABB2 = AABB2{bodyA->GetBounds()};
-            const auto bodyBBoundsAsAABB2 = AABB2{bodyB->GetBounds()};
-            //if(!MathUtils::DoAABBsOverlap(query_area, bodyBoundsAsAABB2)) {
-            //    continue;
-            //}
-            if(MathUtils::DoAABBsOverlap(bodyABoundsAsAABB2, bodyBBoundsAsAABB2)) {
-                //const auto queried_bodies = _world_partition.Query(query_area);
-                //for(auto* query : queried_bodies) {
-                //potential_collisions.push_back(query);
-                //}
-                potential_collisions.push_back(bodyA);
-                potential_collisions.push_back(bodyB);
+            if(is_resting) {
+                body->Sleep();
+                body->SetVelocity(Vector2::Zero);
+                body->SetAcceleration(Vector2::Zero);
+                body->sleep_island = sleep_island;
+            } else if(body->sleep_island != RigidBody::not_sleeping) {
+                _islands_to_wake.push_back(body->sleep_island);
             }
+        });
+    }
+    if(_islands_to_wake.empty()) {
+        return;
+    }
+    //Contacts between sleeping bodies are not tested, so bodies that fell asleep together are woken together.
+    std::sort(std::begin(_islands_to_wake), std::end(_islands_to_wake));
+    for(auto* body : _rigidBodies) {
+        if(body->sleep_island != RigidBody::not_sleeping && std::binary_search(std::cbegin(_islands_to_wake), std::cend(_islands_to_wake), body->sleep_island)) {
+            body->Wake();
+            body->sleep_island = RigidBody::not_sleeping;
+            body->time_since_last_move = TimeUtils::FPSeconds::zero();
+            body->rest_position = body->GetPosition();
+            body->rest_orientationDegrees = body->GetOrientationDegrees();
         }
     }
-    return potential_collisions;
 }
 
-void PhysicsSystem::SolveCollision(const PhysicsSystem::CollisionDataSet& actual_collisions) noexcept {
-    for(auto& collision : actual_collisions) {
-        auto* a = collision.a;
-        auto* b = collision.b;
-        const auto& aPos = a->GetPosition();
-        const auto& bPos = b->GetPosition();
-        const auto& aMass = a->GetMass();
-        const auto& bMass = b->GetMass();
-        const auto massSum = aMass + bMass;
-        const auto aNormal = Vector2{-collision.normal};
-        const auto bNormal = Vector2{collision.normal};
-        const auto aDeltaContribution = (aMass / massSum);
-        const auto bDeltaContribution = (bMass / massSum);
-        const auto aForceContribution = aNormal * aDeltaContribution;
-        const auto bForceContribution = bNormal * bDeltaContribution;
-        const auto aDistanceContribution = collision.distance * aDeltaContribution;
-        const auto bDistanceContribution = collision.distance * bDeltaContribution;
-        a->SetPosition(aPos + aDistanceContribution * aNormal);
-        b->SetPosition(bPos + bDistanceContribution * bNormal);
-        //collision.a->ApplyForceAt(aPos, aForceContribution, TimeUtils::FPSeconds::zero());
-        //collision.b->ApplyForceAt(bPos, bForceContribution, TimeUtils::FPSeconds::zero());
-        collision.a->ApplyImpulseAt(aPos, aForceContribution);
-        collision.b->ApplyImpulseAt(bPos, bForceContribution);
+bool PhysicsSystem::IsAdded(const RigidBody* body) const noexcept {
+    return body && body->system_index < _rigidBodies.size() && _rigidBodies[body->system_index] == body;
+}
+
+void PhysicsSystem::PrepareConstraints(const CollisionDataList& actual_collisions) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::PrepareConstraints");
+    auto settings = ConstraintSolver::Settings{};
+    settings.linear_slop = _desc.contact_slop;
+    settings.restitution_threshold = _desc.restitution_threshold;
+    _solver.Reset(settings);
+    _solver_bodies.assign(_rigidBodies.size(), null_solver_body);
+    _solver_contacts.clear();
+    _solver_joints.clear();
+    //Bodies that are not simulated this step still hold others up but are never moved themselves.
+    const auto add_body = [this](const RigidBody* body) {
+        auto& index = _solver_bodies[body->system_index];
+        if(index == null_solver_body) {
+            index = _solver.AddBody(body->GetPosition(), body->GetVelocity(), body->IsSimulated() ? body->GetInverseMass() : 0.0f);
+        }
+        return index;
+    };
+    const auto forget = [](WarmStart& entry) {
+        entry.normal_impulse = 0.0f;
+        entry.tangent_impulse = 0.0f;
+    };
+    //Contacts come out of the narrow phase in pair order, so they find their cache entries in one pass.
+    //Pairs that stopped touching drop their impulses so they do not warm start a later contact.
+    auto entry = std::begin(_warm_starts);
+    for(const auto& collision : actual_collisions) {
+        const auto found = std::find_if(entry, std::end(_warm_starts), [&](const WarmStart& e) {
+            return _broad_phase->GetBody(e.pair.a) == collision.a && _broad_phase->GetBody(e.pair.b) == collision.b;
+        });
+        const auto& material_a = collision.a->rigidbodyDesc.physicsMaterial;
+        const auto& material_b = collision.b->rigidbodyDesc.physicsMaterial;
+        const auto friction = std::sqrt(material_a.friction * material_b.friction);
+        const auto restitution = (std::max)(material_a.restitution, material_b.restitution);
+        //Every contact should have come from a cached pair; one that did not is solved cold rather than ending the pass.
+        if(found == std::end(_warm_starts)) {
+            _solver.AddContact(add_body(collision.a), add_body(collision.b), Vector2{collision.normal}, collision.distance, friction, restitution, 0.0f, 0.0f);
+            _solver_contacts.push_back(null_warm_start);
+            continue;
+        }
+        std::for_each(entry, found, forget);
+        entry = found;
+        _solver.AddContact(add_body(collision.a), add_body(collision.b), Vector2{collision.normal}, collision.distance, friction, restitution, entry->normal_impulse, entry->tangent_impulse);
+        _solver_contacts.push_back(static_cast<std::size_t>(std::distance(std::begin(_warm_starts), entry)));
+        ++entry;
+    }
+    std::for_each(entry, std::end(_warm_starts), forget);
+    for(auto&& joint : _joints) {
+        const auto constraint = joint->GetDistanceConstraint();
+        if(!constraint || IsJointAsleep(*joint)) {
+            continue;
+        }
+        //Anchors without an added body are fixed points in the world.
+        const auto anchor_a = joint->GetAnchorA();
+        const auto anchor_b = joint->GetAnchorB();
+        const auto* body_a = joint->GetBodyA();
+        const auto* body_b = joint->GetBodyB();
+        const auto a = IsAdded(body_a) ? add_body(body_a) : _solver.AddBody(anchor_a, Vector2::Zero, 0.0f);
+        const auto b = IsAdded(body_b) ? add_body(body_b) : _solver.AddBody(anchor_b, Vector2::Zero, 0.0f);
+        _solver.AddDistance(a, b, anchor_a, anchor_b, constraint->length, constraint->can_slacken, joint->_solver_impulse);
+        _solver_joints.push_back(joint.get());
     }
 }
 
-void PhysicsSystem::SolveConstraints() const noexcept {
-    for(int i = 0; i < _desc.position_solver_iterations; ++i) {
-        SolvePositionConstraints();
+void PhysicsSystem::SolveVelocityConstraints() noexcept {
+    PROFILE_SCOPE("PhysicsSystem::SolveVelocityConstraints");
+    _solver.SolveVelocities(_desc.velocity_solver_iterations);
+    for(std::size_t i = 0u; i < _rigidBodies.size(); ++i) {
+        if(auto* body = _rigidBodies[i]; _solver_bodies[i] != null_solver_body && body->IsSimulated()) {
+            body->linear_state.SetVelocity(_solver.GetVelocity(_solver_bodies[i]));
+        }
     }
-    for(int i = 0; i < _desc.velocity_solver_iterations; ++i) {
-        SolveVelocityConstraints();
+    for(std::size_t i = 0u; i < _solver_contacts.size(); ++i) {
+        if(_solver_contacts[i] == null_warm_start) {
+            continue;
+        }
+        auto& entry = _warm_starts[_solver_contacts[i]];
+        entry.normal_impulse = _solver.GetNormalImpulse(i);
+        entry.tangent_impulse = _solver.GetTangentImpulse(i);
+    }
+    for(std::size_t i = 0u; i < _solver_joints.size(); ++i) {
+        _solver_joints[i]->_solver_impulse = _solver.GetNormalImpulse(_solver_contacts.size() + i);
     }
 }
 
-void PhysicsSystem::SolvePositionConstraints() const noexcept {
-    for(auto&& joint : _joints) {
-        if(joint->ConstraintViolated()) {
-            joint->SolvePositionConstraint();
+void PhysicsSystem::SolvePositionConstraints() noexcept {
+    PROFILE_SCOPE("PhysicsSystem::SolvePositionConstraints");
+    if(_solver.GetConstraintCount() == 0u) {
+        return;
+    }
+    for(std::size_t i = 0u; i < _rigidBodies.size(); ++i) {
+        if(const auto* body = _rigidBodies[i]; _solver_bodies[i] != null_solver_body && body->IsSimulated()) {
+            _solver.SetPosition(_solver_bodies[i], body->GetPosition());
+        }
+    }
+    (void)_solver.SolvePositions(_desc.position_solver_iterations);
+    for(std::size_t i = 0u; i < _rigidBodies.size(); ++i) {
+        if(auto* body = _rigidBodies[i]; _solver_bodies[i] != null_solver_body && body->IsSimulated()) {
+            body->linear_state.SetPosition(_solver.GetPosition(_solver_bodies[i]));
         }
     }
 }
 
-void PhysicsSystem::SolveVelocityConstraints() const noexcept {
-    for(auto&& joint : _joints) {
-        if(joint->ConstraintViolated()) {
-            joint->SolveVelocityConstraint();
+void PhysicsSystem::SolveContinuousCollisions(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::SolveContinuousCollisions");
+    for(auto* body : _rigidBodies) {
+        const auto* collider = body->GetCollider();
+        if(!collider || !body->IsContinuousCollisionEnabled() || !body->IsSimulated()) {
+            continue;
+        }
+        //Discrete contacts already catch anything a body moves into by less than its own half size per step.
+        const auto half_extents = collider->GetHalfExtents();
+        const auto min_half_extent = (std::min)(half_extents.x, half_extents.y);
+        const auto position = body->GetPosition();
+        const auto bounds = CalcBroadPhaseBounds(*body);
+        const auto inverse_mass = body->GetInverseMass();
+        auto start = body->step_start_position;
+        auto end = position;
+        auto velocity = body->GetVelocity();
+        auto time_left = deltaSeconds.count();
+        auto was_hit = false;
+        for(int substep = 0; substep < _desc.max_continuous_substeps; ++substep) {
+            const auto displacement = end - start;
+            if(displacement.CalcLengthSquared() <= min_half_extent * min_half_extent) {
+                break;
+            }
+            //Every other body has finished its step and is tested where it ended up.
+            const auto sweep = Sweep{start - position, displacement};
+            auto first_hit = std::optional<TOIResult>{};
+            RigidBody* obstacle = nullptr;
+            _world_partition.Query(CalcSweptBounds(bounds, start - position, end - position), [&](RigidBody* other) {
+                const auto* other_collider = other->GetCollider();
+                if(other == body || !other_collider) {
+                    return;
+                }
+                if(const auto toi = PhysicsUtils::CalcTimeOfImpact(*collider, sweep, *other_collider, Sweep{}, _desc.contact_slop); toi && (!first_hit || toi->time < first_hit->time)) {
+                    first_hit = toi;
+                    obstacle = other;
+                }
+            });
+            if(!first_hit) {
+                break;
+            }
+            was_hit = true;
+            start += displacement * first_hit->time;
+            time_left -= time_left * first_hit->time;
+            if(!obstacle->IsAwake() && CanSleep(*obstacle)) {
+                obstacle->Wake();
+                obstacle->time_since_last_move = TimeUtils::FPSeconds::zero();
+            }
+            //Take out the velocity into the obstacle as a contact would, sharing the impulse by mass when the obstacle can move.
+            const auto& normal = first_hit->normal;
+            const auto obstacle_inverse_mass = obstacle->IsSimulated() ? obstacle->GetInverseMass() : 0.0f;
+            const auto obstacle_velocity = obstacle->IsSimulated() ? obstacle->GetVelocity() : Vector2::Zero;
+            if(const auto closing_speed = MathUtils::DotProduct(velocity - obstacle_velocity, normal); 0.0f < closing_speed) {
+                const auto restitution = (std::max)(body->rigidbodyDesc.physicsMaterial.restitution, obstacle->rigidbodyDesc.physicsMaterial.restitution);
+                const auto impulse = (1.0f + restitution) * closing_speed / (inverse_mass + obstacle_inverse_mass);
+                velocity -= normal * (impulse * inverse_mass);
+                if(0.0f < obstacle_inverse_mass) {
+                    obstacle->linear_state.SetVelocity(obstacle_velocity + normal * (impulse * obstacle_inverse_mass));
+                }
+            }
+            //Out of sub-steps: stay at the impact rather than risk passing through something on the last leg.
+            end = substep + 1 < _desc.max_continuous_substeps ? start + velocity * time_left : start;
+        }
+        if(was_hit) {
+            body->SetSweptState(end, velocity);
         }
     }
 }
@@ -244,8 +664,8 @@ void PhysicsSystem::SolveVelocityConstraints() const noexcept {
 void PhysicsSystem::Render() const noexcept {
     auto& renderer = ServiceLocator::get<IRendererService>();
     if(_show_colliders) {
-        for(const auto& body : _rigidBodies) {
-            body->DebugRender();
+        for(const auto& body : _visible_bodies) {
+            body->DebugRender(_timestep.GetAlpha());
         }
     }
     if(_show_joints) {
@@ -254,7 +674,11 @@ void PhysicsSystem::Render() const noexcept {
         }
     }
     if(_show_world_partition) {
-        _world_partition.DebugRender();
+        renderer.SetModelMatrix(Matrix4::I);
+        renderer.SetMaterial(renderer.GetMaterial("__2D"));
+        _world_partition.VisitNodes([&renderer](const AABB2& bounds, std::size_t /*depth*/, std::size_t /*elementCount*/) {
+            renderer.DrawAABB2(bounds, Rgba::Green, Rgba::NoAlpha);
+        });
     }
     if(_show_contacts) {
         renderer.SetModelMatrix(Matrix4::I);
@@ -268,6 +692,16 @@ void PhysicsSystem::EndFrame() noexcept {
     }
     for(auto* r : _pending_removal) {
         _rigidBodies.erase(std::remove_if(std::begin(_rigidBodies), std::end(_rigidBodies), [this, r](const RigidBody* b) { return b == r; }), std::end(_rigidBodies));
+        _visible_bodies.erase(std::remove(std::begin(_visible_bodies), std::end(_visible_bodies), r), std::end(_visible_bodies));
+        if(const auto found = _body_handles.find(r); found != std::end(_body_handles)) {
+            //A body added later may reuse the proxy id and must not inherit this one's cached contacts.
+            const auto proxy = found->second.proxy;
+            _warm_starts.erase(std::remove_if(std::begin(_warm_starts), std::end(_warm_starts), [proxy](const WarmStart& entry) { return entry.pair.a == proxy || entry.pair.b == proxy; }), std::end(_warm_starts));
+            _broad_phase->DestroyProxy(proxy);
+            _world_partition.Remove(found->second.partition);
+            _body_handles.erase(found);
+            r->linear_state.Unbind();
+        }
         _gravityFG.detach(r);
         _dragFG.detach(r);
         for(auto&& fg : _forceGenerators) {
@@ -288,7 +722,6 @@ bool PhysicsSystem::ProcessSystemMessage([[maybe_unused]] const EngineMessage& m
 
 void PhysicsSystem::AddObject(RigidBody* body) {
     _pending_addition.push_back(body);
-    //_world_partition.Add(body);
 }
 
 void PhysicsSystem::AddObjects(std::vector<RigidBody*> bodies) {
@@ -309,8 +742,19 @@ void PhysicsSystem::RemoveAllObjects() noexcept {
 }
 
 void PhysicsSystem::RemoveAllObjectsImmediately() noexcept {
+    for(auto* body : _rigidBodies) {
+        body->linear_state.Unbind();
+    }
+    _body_store.Clear();
+    _islands.Reset(0u);
+    _islands_to_wake.clear();
     _rigidBodies.clear();
     _rigidBodies.shrink_to_fit();
+    _broad_phase->Clear();
+    _world_partition.Clear();
+    _body_handles.clear();
+    _visible_bodies.clear();
+    _warm_starts.clear();
     _gravityFG.detach_all();
     _dragFG.detach_all();
     for(auto&& fg : _forceGenerators) {
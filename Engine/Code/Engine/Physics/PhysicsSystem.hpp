@@ -1,27 +1,42 @@
 #pragma once
 
+#include "Engine/Core/FixedTimestep.hpp"
 #include "Engine/Core/TimeUtils.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Vector2.hpp"
+#include "Engine/Memory/FrameArena.hpp"
+#include "Engine/Physics/BroadPhase.hpp"
 #include "Engine/Physics/CableJoint.hpp"
+#include "Engine/Physics/ConstraintSolver.hpp"
+#include "Engine/Physics/DynamicAABBTreeBroadPhase.hpp"
 #include "Engine/Physics/DragForceGenerator.hpp"
 #include "Engine/Physics/ForceGenerator.hpp"
 #include "Engine/Physics/GravityForceGenerator.hpp"
+#include "Engine/Physics/IslandBuilder.hpp"
 #include "Engine/Physics/Joint.hpp"
+#include "Engine/Physics/PhysicsSnapshot.hpp"
 #include "Engine/Physics/PhysicsTypes.hpp"
 #include "Engine/Physics/RigidBody.hpp"
+#include "Engine/Physics/RigidBodyStore.hpp"
 #include "Engine/Physics/RodJoint.hpp"
 #include "Engine/Physics/SpringJoint.hpp"
 #include "Engine/Physics/QuadTree.hpp"
 #include "Engine/Profiling/ProfileLogScope.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
+#include "Engine/Services/IJobSystemService.hpp"
 #include "Engine/Services/IPhysicsService.hpp"
+#include "Engine/Services/ServiceLocator.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
 #include <queue>
-#include <set>
+#include <unordered_map>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -36,6 +51,26 @@ struct PhysicsSystemDesc {
     float kill_plane_distance{10000.0f};
     int position_solver_iterations{6};
     int velocity_solver_iterations{8};
+    //Contacts may overlap this much before position correction pushes them apart; keeps resting contacts from jittering.
+    float contact_slop{0.005f};
+    //Contacts closing slower than this do not bounce.
+    float restitution_threshold{1.0f};
+    //Most times per step a continuous collision body is stopped at an impact and swept on with its new velocity.
+    int max_continuous_substeps{4};
+    BroadPhaseType broad_phase{BroadPhaseType::SweepAndPrune};
+    //How far past its bounds a body can move before the AABB tree broad phase has to reinsert it.
+    float broad_phase_margin{DynamicAABBTreeBroadPhase::default_margin};
+    //Bodies moving slower than this, in world units and degrees per second, count as resting.
+    float sleep_linear_speed{1.0f};
+    float sleep_angular_speed{2.0f};
+    //How long every body of an island has to rest before the whole island goes to sleep.
+    TimeUtils::FPSeconds time_to_sleep{0.5f};
+    //The simulation advances in fixed steps of 1 / steps_per_second, running at most max_steps_per_frame per Update.
+    float steps_per_second{60.0f};
+    int max_steps_per_frame{4};
+    //Hashes the world after every step so replays and network peers can find the first step they disagree on.
+    //Costs a snapshot of the world per step.
+    bool check_determinism{false};
 };
 
 class PhysicsSystem : public EngineSubsystem, public IPhysicsService {
@@ -82,6 +117,12 @@ public:
     void EnableGravity(bool isGravityEnabled) noexcept override;
     void EnableDrag(bool isDragEnabled) noexcept override;
     void EnablePhysics(bool isPhysicsEnabled) noexcept override;
+    [[nodiscard]] float GetInterpolationAlpha() const noexcept override;
+
+    void SaveSnapshot(PhysicsSnapshot& snapshot) const noexcept override;
+    [[nodiscard]] bool RestoreSnapshot(const PhysicsSnapshot& snapshot) noexcept override;
+    [[nodiscard]] std::uint64_t GetStepHash() const noexcept override;
+    [[nodiscard]] std::uint64_t GetStepCount() const noexcept override;
 
     [[nodiscard]] const std::vector<std::unique_ptr<Joint>>& Debug_GetJoints() const noexcept override;
     [[nodiscard]] const std::vector<RigidBody*>& Debug_GetBodies() const noexcept override;
@@ -97,32 +138,86 @@ public:
 
 protected:
 private:
-    void UpdateBodiesInBounds(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void Step(TimeUtils::FPSeconds deltaSeconds) noexcept;
     void ApplyCustomAndJointForces(TimeUtils::FPSeconds deltaSeconds) noexcept;
     void ApplyGravityAndDrag(TimeUtils::FPSeconds deltaSeconds) noexcept;
-    [[nodiscard]] std::vector<RigidBody*> BroadPhaseCollision(const AABB2& query_area) noexcept;
+    void CreateBroadPhase() noexcept;
+    [[nodiscard]] std::pmr::vector<BroadPhase::Pair> BroadPhaseCollision() noexcept;
+    void UpdateVisibleBodies(const AABB2& query_area) noexcept;
 
-    using CollisionDataSet = std::set<CollisionData>;
-    template<typename CollisionDetectionFunction, typename CollisionResolutionFunction>
-    [[nodiscard]] CollisionDataSet NarrowPhaseCollision(const std::vector<RigidBody*>& potential_collisions, CollisionDetectionFunction&& cd, CollisionResolutionFunction&& cr) noexcept;
+    //In broad phase pair order.
+    using CollisionDataList = std::pmr::vector<CollisionData>;
+    //collide(a, b, warm_start_direction) returns the contact between two colliders, if any; see PhysicsUtils::Collide.
+    template<typename CollisionFunction>
+    [[nodiscard]] CollisionDataList NarrowPhaseCollision(const std::pmr::vector<BroadPhase::Pair>& potential_collisions, CollisionFunction&& collide) noexcept;
 
-    void SolveCollision(const CollisionDataSet& actual_collisions) noexcept;
-    void SolveConstraints() const noexcept;
-    void SolvePositionConstraints() const noexcept;
-    void SolveVelocityConstraints() const noexcept;
+    void UpdateBodiesInBounds(TimeUtils::FPSeconds deltaSeconds, const CollisionDataList& actual_collisions) noexcept;
+    //Loads this step's contacts and distance joints into _solver, warm started with the impulses they ended last step with.
+    void PrepareConstraints(const CollisionDataList& actual_collisions) noexcept;
+    void SolveVelocityConstraints() noexcept;
+    void SolvePositionConstraints() noexcept;
+    //Sweeps bodies with continuous collision enabled from where they started the step and stops them at the first thing they hit.
+    void SolveContinuousCollisions(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    //Groups bodies touching through contacts or joints and puts islands to sleep or wakes them.
+    void UpdateIslands(TimeUtils::FPSeconds deltaSeconds, const CollisionDataList& actual_collisions) noexcept;
+    //Writes the state a step depends on, leaving out the frame timing so the determinism hash is independent of frame rate.
+    void WriteSimulationState(PhysicsSnapshot& snapshot) const noexcept;
+    //Joints can reference bodies that were never added.
+    [[nodiscard]] bool IsAdded(const RigidBody* body) const noexcept;
 
     PhysicsSystemDesc _desc{};
     bool _is_running = false;
     std::vector<RigidBody*> _rigidBodies{};
     std::deque<CollisionData> _contacts{};
+    //One per narrow phase job, kept between frames so their capacity is reused.
+    std::vector<std::vector<CollisionData>> _contact_buffers{};
+    struct WarmStart {
+        BroadPhase::Pair pair{};
+        Vector2 direction{};
+        float normal_impulse{};
+        float tangent_impulse{};
+    };
+    //Last step's GJK directions and contact impulses sorted by pair, and the buffer the current step fills in.
+    std::vector<WarmStart> _warm_starts{};
+    std::vector<WarmStart> _next_warm_starts{};
     std::vector<RigidBody*> _pending_removal{};
     std::vector<RigidBody*> _pending_addition{};
     GravityForceGenerator _gravityFG{Vector2::Zero};
     DragForceGenerator _dragFG{Vector2::Zero};
     QuadTree<RigidBody> _world_partition{};
-    TimeUtils::FPSeconds _deltaSeconds = TimeUtils::FPSeconds::zero();
-    TimeUtils::FPSeconds _accumulatedTime = TimeUtils::FPSeconds::zero();
-    TimeUtils::FPFrames _targetFrameRate = TimeUtils::FPFrames{1};
+    //Linear state of every added body, integrated in batches by UpdateBodiesInBounds.
+    RigidBodyStore _body_store{};
+    ConstraintSolver _solver{};
+    static constexpr auto null_solver_body = (std::numeric_limits<ConstraintSolver::BodyIndex>::max)();
+    //Solver body of each entry in _rigidBodies, or null_solver_body when nothing constrains it this step.
+    std::vector<ConstraintSolver::BodyIndex> _solver_bodies{};
+    static constexpr auto null_warm_start = (std::numeric_limits<std::size_t>::max)();
+    //Warm start entry of each contact and the joint of each distance constraint, in the order they were added to _solver.
+    //A contact whose pair has no entry maps to null_warm_start.
+    std::vector<std::size_t> _solver_contacts{};
+    std::vector<Joint*> _solver_joints{};
+    IslandBuilder _islands{};
+    //Ids of sleeping islands that a body woke up from this step.
+    std::vector<std::uint32_t> _islands_to_wake{};
+    std::uint32_t _next_sleep_island = 0u;
+    std::unique_ptr<BroadPhase> _broad_phase{};
+    struct BodyHandles {
+        BroadPhase::ProxyId proxy = BroadPhase::null_proxy;
+        QuadTree<RigidBody>::Handle partition = QuadTree<RigidBody>::null_handle;
+    };
+    std::unordered_map<RigidBody*, BodyHandles> _body_handles{};
+    //Bodies overlapping the camera as of the last Update.
+    std::vector<RigidBody*> _visible_bodies{};
+    FixedTimestep _timestep{};
+    std::uint64_t _step_count = 0u;
+    std::uint64_t _step_hash = 0u;
+    PhysicsSnapshot _step_snapshot{};
+    //Scratch space RestoreSnapshot reads into, so a bad snapshot is rejected before anything is changed.
+    std::vector<RigidBody::SnapshotState> _restore_bodies{};
+    std::vector<std::uint32_t> _restore_timed_force_counts{};
+    std::vector<RigidBody::TimedForce> _restore_timed_forces{};
+    std::vector<float> _restore_joint_impulses{};
+    std::vector<WarmStart> _restore_warm_starts{};
     bool _show_colliders = false;
     bool _show_object_bounds = false;
     bool _show_world_partition = false;
@@ -130,37 +225,50 @@ private:
     bool _show_joints = false;
 };
 
-template<typename CollisionDetectionFunction, typename CollisionResolutionFunction>
-PhysicsSystem::CollisionDataSet PhysicsSystem::NarrowPhaseCollision(const std::vector<RigidBody*>& potential_collisions, CollisionDetectionFunction&& cd, CollisionResolutionFunction&& cr) noexcept {
-    CollisionDataSet result{};
-    if(potential_collisions.size() < 2) {
+template<typename CollisionFunction>
+PhysicsSystem::CollisionDataList PhysicsSystem::NarrowPhaseCollision(const std::pmr::vector<BroadPhase::Pair>& potential_collisions, CollisionFunction&& collide) noexcept {
+    PROFILE_SCOPE("PhysicsSystem::NarrowPhaseCollision");
+    //Collision tests only read the colliders and each job writes its own warm start entries, so pairs can be tested
+    //in parallel; gathering in pair order keeps the contacts identical to a serial run no matter how the jobs were scheduled.
+    static constexpr auto pairs_per_job = std::size_t{32u};
+    CollisionDataList result{FrameArena::Current()};
+    if(potential_collisions.empty()) {
         _contacts.clear();
-        return {};
+        _warm_starts.clear();
+        return result;
+    }
+    //Both lists are sorted by pair, so last step's directions are matched up in one pass.
+    _next_warm_starts.resize(potential_collisions.size());
+    auto previous = std::cbegin(_warm_starts);
+    for(std::size_t i = 0u; i < potential_collisions.size(); ++i) {
+        const auto& pair = potential_collisions[i];
+        while(previous != std::cend(_warm_starts) && previous->pair < pair) {
+            ++previous;
+        }
+        const auto found = previous != std::cend(_warm_starts) && previous->pair == pair;
+        _next_warm_starts[i] = found ? *previous : WarmStart{pair};
     }
-    for(auto iter_a = std::begin(potential_collisions); iter_a != std::end(potential_collisions); ++iter_a) {
-        for(auto iter_b = iter_a + 1; iter_b != std::end(potential_collisions); ++iter_b) {
-            auto* const cur_body = *iter_a;
-            auto* const next_body = *iter_b;
-            if(cur_body == next_body) {
-                continue;
-            }
-            const auto cdResult = std::invoke(cd, *cur_body->GetCollider(), *next_body->GetCollider());
-            if(cdResult.collides) {
-                static unsigned int i = 0u;
-                DebuggerPrintf("cdResult.collides calls: %i\n", (++i));
-                const auto crResult = std::invoke(cr, cdResult, *cur_body->GetCollider(), *next_body->GetCollider());
-                const auto contact = CollisionData{cur_body, next_body, crResult.distance, crResult.normal};
-                const auto&& [_, was_inserted] = result.insert(contact);
-                if(!was_inserted) {
-                    DebuggerPrintf("Physics System: Attempting to insert already existing element.");
-                } else {
-                    while(_contacts.size() >= 10) {
-                        _contacts.pop_front();
-                    }
-                    _contacts.push_back(contact);
-                }
-            }
+    auto& jobs = ServiceLocator::get<IJobSystemService>();
+    jobs.ParallelGather(std::size_t{0u}, potential_collisions.size(), pairs_per_job, _contact_buffers, result, [&](std::size_t index, std::vector<CollisionData>& contacts) {
+        const auto& pair = potential_collisions[index];
+        auto* const cur_body = _broad_phase->GetBody(pair.a);
+        auto* const next_body = _broad_phase->GetBody(pair.b);
+        //Sleeping bodies resting on each other or on static bodies are not tested until something wakes them.
+        if(!cur_body->IsSimulated() && !next_body->IsSimulated()) {
+            return;
+        }
+        if(const auto contact = std::invoke(collide, *cur_body->GetCollider(), *next_body->GetCollider(), _next_warm_starts[index].direction)) {
+            contacts.emplace_back(cur_body, next_body, contact->distance, contact->normal);
+        }
+    });
+    _warm_starts.swap(_next_warm_starts);
+    static constexpr auto max_debug_contacts = std::size_t{10u};
+    const auto first_debug_contact = std::cbegin(result) + (result.size() - (std::min)(result.size(), max_debug_contacts));
+    for(auto iter = first_debug_contact; iter != std::cend(result); ++iter) {
+        while(_contacts.size() >= max_debug_contacts) {
+            _contacts.pop_front();
         }
+        _contacts.push_back(*iter);
     }
     return result;
 }
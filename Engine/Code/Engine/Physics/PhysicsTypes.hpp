@@ -3,6 +3,8 @@
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
 
+#include <array>
+#include <cstddef>
 #include <vector>
 
 class RigidBody;
@@ -22,6 +24,7 @@ struct PhysicsDesc {
     bool enableGravity = true; //Should gravity be applied.
     bool enableDrag = true;    //Should drag be applied.
     bool enablePhysics = true; //Should object be subject to physics calculations.
+    bool enableContinuousCollision = false; //Should fast motion be swept so the object cannot pass through thin colliders.
     bool startAwake = true;    //Should the object be awake on creation.
 };
 
@@ -87,7 +90,11 @@ private:
 
 struct GJKResult {
     bool collides{false};
-    std::vector<Vector3> simplex{};
+    //Only the first simplex_size points are used, newest first.
+    std::array<Vector2, 3> simplex{};
+    std::size_t simplex_size{0u};
+    //The last search direction; a separating axis when the shapes do not collide.
+    Vector2 direction{};
 };
 
 struct EPAResult {
@@ -95,6 +102,19 @@ struct EPAResult {
     Vector3 normal{};
 };
 
+//Straight line motion over a step, relative to where the collider currently is: it starts offset from there and moves by displacement.
+struct Sweep {
+    Vector2 offset{};
+    Vector2 displacement{};
+};
+
+struct TOIResult {
+    //Fraction of the sweep completed at impact.
+    float time{1.0f};
+    //From the first collider to the second.
+    Vector2 normal{};
+};
+
 struct CollisionData {
     RigidBody* const a = nullptr;
     RigidBody* const b = nullptr;
@@ -4,154 +4,317 @@
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Physics/Collider.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 Vector2 MathUtils::CalcClosestPoint(const Vector2& p, const Collider& collider) {
     return collider.Support((p - collider.CalcCenter()).GetNormalize());
 }
 
-static constexpr int maxGJKIterations = 25;
+namespace {
 
-bool PhysicsUtils::GJKIntersect(const Collider& a, const Collider& b) {
-    return GJK(a, b).collides;
+constexpr int maxGJKIterations = 25;
+constexpr std::size_t maxEPAVertices = 32u;
+constexpr int maxTOIIterations = 20;
+//GJK distance stops once the lower and upper bounds agree to this fraction.
+constexpr float separationTolerance = 0.0001f;
+//Added to every penetration depth so resolved pairs end up just apart instead of touching.
+constexpr float contactSlop = 0.0001f;
+
+[[nodiscard]] Vector2 CalcMinkowskiSupport(const Collider& a, const Collider& b, const Vector2& direction) noexcept {
+    return a.Support(direction) - b.Support(-direction);
 }
 
-//TODO: Multi-collision causes large simplex.
-GJKResult PhysicsUtils::GJK(const Collider& a, const Collider& b) {
-    using Simplex = std::vector<Vector3>;
-    const auto calcMinkowskiDiff = [](const Vector2& direction, const Collider& a) { return a.Support(direction); };
-    const auto support = [&](const Vector2& direction) { return calcMinkowskiDiff(direction, a) - calcMinkowskiDiff(-direction, b); };
-    const auto initialDisplacement = b.CalcCenter() - a.CalcCenter();
-    const auto initialDirection = initialDisplacement.GetNormalize();
-    auto A = support(Vector2::X_Axis);
-    Simplex simplex{Vector3{A}};
-    auto D = Vector3{-A};
-    const auto doSimplexLine = [&](Simplex& simplex, Vector3& D) {
-        const auto& pointA = simplex[0];
-        const auto& pointB = simplex[1];
-        const auto lineAB = pointB - pointA;
-        const auto lineAO = -pointA;
-        if(MathUtils::DotProduct(lineAB, lineAO) > 0.0f) {
-            D = MathUtils::TripleProductVector(lineAB, lineAO, lineAB);
+//Perpendicular to edge, pointing away from the side point is on.
+[[nodiscard]] Vector2 CalcPerpendicularAwayFrom(const Vector2& edge, const Vector2& point) noexcept {
+    const auto perpendicular = Vector2{-edge.y, edge.x};
+    return MathUtils::DotProduct(perpendicular, point) > 0.0f ? -perpendicular : perpendicular;
+}
+
+//Reduces the simplex to the feature closest to the origin and points direction at the origin from it.
+//Returns true when the simplex is a triangle containing the origin.
+[[nodiscard]] bool DoSimplex(GJKResult& gjk) noexcept {
+    auto& simplex = gjk.simplex;
+    const auto A = simplex[0];
+    const auto AO = -A;
+    if(gjk.simplex_size == 2u) {
+        const auto AB = simplex[1] - A;
+        if(MathUtils::DotProduct(AB, AO) > 0.0f) {
+            const auto perpendicular = Vector2{-AB.y, AB.x};
+            gjk.direction = MathUtils::DotProduct(perpendicular, AO) < 0.0f ? -perpendicular : perpendicular;
         } else {
-            D = lineAO;
-            simplex = Simplex{Vector3{A}};
+            gjk.simplex_size = 1u;
+            gjk.direction = AO;
         }
         return false;
-    };
-    const auto doSimplexTriangle = [&](Simplex& simplex, Vector3& D) {
-        const auto& pointA = simplex[0];
-        const auto& pointB = simplex[1];
-        const auto& pointC = simplex[2];
-        const auto lineAB = pointB - pointA;
-        const auto lineAC = pointC - pointA;
-        const auto lineAO = (-pointA);
-        const auto abc = MathUtils::CrossProduct(lineAB, lineAC);
-
-        if(MathUtils::DotProduct(MathUtils::CrossProduct(abc, lineAC), lineAO) > 0.0f) {
-            if(MathUtils::DotProduct(lineAC, lineAO) > 0.0f) {
-                simplex = {pointA, pointC};
-                D = MathUtils::TripleProductVector(lineAC, lineAO, lineAC);
-            } else {
-                simplex = {pointA, pointB};
-                return doSimplexLine(simplex, D);
-            }
-        } else {
-            if(MathUtils::DotProduct(MathUtils::CrossProduct(lineAB, abc), lineAO) > 0.0f) {
-                simplex = {pointA, pointB};
-                return doSimplexLine(simplex, D);
-            } else {
-                if(MathUtils::DotProduct(abc, lineAO) > 0.0f) {
-                    D = abc;
-                } else {
-                    simplex = {pointA, pointC, pointB};
-                    D = -abc;
-                }
-                return true;
-            }
-        }
+    }
+    const auto AB = simplex[1] - A;
+    const auto AC = simplex[2] - A;
+    const auto abPerpendicular = CalcPerpendicularAwayFrom(AB, AC);
+    if(MathUtils::DotProduct(abPerpendicular, AO) > 0.0f) {
+        gjk.simplex_size = 2u;
+        gjk.direction = abPerpendicular;
+        return false;
+    }
+    const auto acPerpendicular = CalcPerpendicularAwayFrom(AC, AB);
+    if(MathUtils::DotProduct(acPerpendicular, AO) > 0.0f) {
+        simplex[1] = simplex[2];
+        gjk.simplex_size = 2u;
+        gjk.direction = acPerpendicular;
         return false;
+    }
+    return true;
+}
+
+struct Box {
+    Vector2 center{};
+    Vector2 half_extents{};
+    Vector2 right{Vector2::X_Axis};
+    Vector2 up{Vector2::Y_Axis};
+};
+
+[[nodiscard]] Box MakeBox(const Collider& collider) noexcept {
+    if(collider.GetShape() == ColliderShape::OBB) {
+        const auto obb = collider.GetBounds();
+        const auto right = obb.GetRight();
+        return Box{obb.position, obb.half_extents, right, Vector2{right.y, -right.x}};
+    }
+    return Box{collider.CalcCenter(), collider.GetHalfExtents()};
+}
+
+[[nodiscard]] bool IsBox(const Collider& collider) noexcept {
+    const auto shape = collider.GetShape();
+    return shape == ColliderShape::AABB || shape == ColliderShape::OBB;
+}
+
+[[nodiscard]] std::optional<EPAResult> CollideCircles(const Collider& a, const Collider& b) noexcept {
+    const auto displacement = b.CalcCenter() - a.CalcCenter();
+    const auto radii = a.GetHalfExtents().x + b.GetHalfExtents().x;
+    const auto distanceSquared = displacement.CalcLengthSquared();
+    if(!(distanceSquared < radii * radii)) {
+        return {};
+    }
+    const auto distance = std::sqrt(distanceSquared);
+    const auto normal = distance > 0.0f ? displacement / distance : Vector2::X_Axis;
+    return EPAResult{radii - distance + contactSlop, Vector3{normal}};
+}
+
+//Separating axis test over both boxes' face normals.
+[[nodiscard]] std::optional<EPAResult> CollideBoxes(const Collider& a, const Collider& b) noexcept {
+    const auto boxA = MakeBox(a);
+    const auto boxB = MakeBox(b);
+    const auto displacement = boxB.center - boxA.center;
+    const auto calcRadius = [](const Box& box, const Vector2& axis) {
+        return box.half_extents.x * std::abs(MathUtils::DotProduct(box.right, axis)) + box.half_extents.y * std::abs(MathUtils::DotProduct(box.up, axis));
     };
-    const auto doSimplex = [&](Simplex& simplex, Vector3& D) {
-        const auto S = simplex.size();
-        switch(S) {
-        case 2:
-            return doSimplexLine(simplex, D);
-        case 3:
-            return doSimplexTriangle(simplex, D);
-        default:
-            return false;
+    const std::array<Vector2, 4> axes{boxA.right, boxA.up, boxB.right, boxB.up};
+    //Two axis-aligned boxes share their axes.
+    const auto axis_count = a.GetShape() == ColliderShape::AABB && b.GetShape() == ColliderShape::AABB ? std::size_t{2u} : axes.size();
+    auto minOverlap = std::numeric_limits<float>::infinity();
+    auto minNormal = Vector2::X_Axis;
+    for(std::size_t i = 0u; i < axis_count; ++i) {
+        const auto& axis = axes[i];
+        const auto distance = MathUtils::DotProduct(displacement, axis);
+        const auto overlap = calcRadius(boxA, axis) + calcRadius(boxB, axis) - std::abs(distance);
+        if(!(overlap > 0.0f)) {
+            return {};
         }
-    };
-    const auto result = [&](Simplex& simplex, Vector3& D) {
-        for(;;) {
-            A = support(Vector2{D});
-            if(MathUtils::DotProduct(A, Vector2{D}) <= 0.0f) {
-                return false;
-            }
-            simplex.insert(std::begin(simplex), Vector3{A});
-            const auto no_new_point = [&]() -> bool {
-                if(simplex.size() < 2)
-                    return false;
-                const Vector3 previous1 = *simplex.rbegin();
-                const Vector3 previous2 = *(simplex.rbegin() + 1);
-                return MathUtils::IsEquivalent(previous1, previous2);
-            }();
-            if(no_new_point) {
-                return false;
-            }
-            if(doSimplex(simplex, D)) {
-                return true;
-            }
+        if(overlap < minOverlap) {
+            minOverlap = overlap;
+            minNormal = distance < 0.0f ? -axis : axis;
         }
-    }(simplex, D); //IIIL
-    return GJKResult{result, simplex};
+    }
+    return EPAResult{minOverlap + contactSlop, Vector3{minNormal}};
 }
 
-EPAResult PhysicsUtils::EPA(GJKResult gjk, const Collider& a, const Collider& b) {
-    if(!gjk.collides) {
-        return {};
+[[nodiscard]] Vector2 CalcClosestPointOnSegment(const Vector2& a, const Vector2& b, float& t) noexcept {
+    const auto ab = b - a;
+    const auto lengthSquared = ab.CalcLengthSquared();
+    t = lengthSquared > 0.0f ? std::clamp(-MathUtils::DotProduct(a, ab) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+    return a + ab * t;
+}
+
+//Closest point of the simplex to the origin. The simplex is reduced to the feature that point lies on;
+//a full triangle is left only when it contains the origin.
+[[nodiscard]] Vector2 ReduceToClosestPoint(std::array<Vector2, 3>& simplex, std::size_t& size) noexcept {
+    if(size == 1u) {
+        return simplex[0];
+    }
+    if(size == 2u) {
+        auto t = 0.0f;
+        const auto closest = CalcClosestPointOnSegment(simplex[0], simplex[1], t);
+        if(t <= 0.0f || t >= 1.0f) {
+            simplex[0] = t <= 0.0f ? simplex[0] : simplex[1];
+            size = 1u;
+        }
+        return closest;
+    }
+    const auto area = MathUtils::CrossProduct(simplex[1] - simplex[0], simplex[2] - simplex[0]);
+    if(area != 0.0f) {
+        const auto is_inside_edge = [&](const Vector2& from, const Vector2& to) { return 0.0f <= MathUtils::CrossProduct(to - from, -from) * area; };
+        if(is_inside_edge(simplex[0], simplex[1]) && is_inside_edge(simplex[1], simplex[2]) && is_inside_edge(simplex[2], simplex[0])) {
+            return Vector2::Zero;
+        }
+    }
+    std::array<Vector2, 3> best{};
+    std::size_t bestSize = 0u;
+    auto bestPoint = Vector2::Zero;
+    auto bestDistance = std::numeric_limits<float>::infinity();
+    for(std::size_t i = 0u; i < 3u; ++i) {
+        std::array<Vector2, 3> edge{simplex[i], simplex[(i + 1u) % 3u]};
+        std::size_t edgeSize = 2u;
+        const auto point = ReduceToClosestPoint(edge, edgeSize);
+        if(const auto distance = point.CalcLengthSquared(); distance < bestDistance) {
+            bestDistance = distance;
+            bestPoint = point;
+            best = edge;
+            bestSize = edgeSize;
+        }
     }
+    simplex = best;
+    size = bestSize;
+    return bestPoint;
+}
 
-    const auto calcMinkowskiDiff = [](const Vector3& direction, const Collider& a) { return a.Support(Vector2{direction}); };
-    const auto support = [&](const Vector3& direction) { return calcMinkowskiDiff(direction, a) - calcMinkowskiDiff(-direction, b); };
+//GJK distance between a and b with a moved by offset.
+[[nodiscard]] float CalcSeparation(const Collider& a, const Collider& b, const Vector2& offset, Vector2& normal) noexcept {
+    const auto support = [&](const Vector2& direction) { return CalcMinkowskiSupport(a, b, direction) + offset; };
+    const auto start_direction = b.CalcCenter() - (a.CalcCenter() + offset);
+    std::array<Vector2, 3> simplex{support(start_direction == Vector2::Zero ? Vector2::X_Axis : start_direction)};
+    std::size_t size = 1u;
+    auto v = simplex[0];
+    auto w = v;
+    for(int i = 0; i < maxGJKIterations; ++i) {
+        const auto lengthSquared = v.CalcLengthSquared();
+        if(lengthSquared <= 0.0f) {
+            return 0.0f;
+        }
+        w = support(-v);
+        //Nothing in a - b is nearer the origin along v than w, so the two bounds on the distance have met.
+        if(lengthSquared - MathUtils::DotProduct(v, w) <= separationTolerance * lengthSquared) {
+            break;
+        }
+        simplex[size++] = w;
+        v = ReduceToClosestPoint(simplex, size);
+        if(size == 3u) {
+            return 0.0f;
+        }
+    }
+    const auto length = v.CalcLength();
+    if(length <= 0.0f) {
+        return 0.0f;
+    }
+    normal = -v / length;
+    return (std::max)(0.0f, MathUtils::DotProduct(v, w) / length);
+}
 
-    std::size_t minIndex = 0u;
-    constexpr auto infinity = std::numeric_limits<float>::infinity();
-    auto minDistance = infinity;
-    auto minNormal = Vector2::Zero;
-    constexpr float epsilon = 0.0001f;
+} // namespace
 
-    while(minDistance == std::numeric_limits<float>::infinity()) {
-        for(std::size_t i = 0u; i < gjk.simplex.size(); ++i) {
-            std::size_t j = (i + 1u) % gjk.simplex.size();
+bool PhysicsUtils::GJKIntersect(const Collider& a, const Collider& b) {
+    return GJK(a, b).collides;
+}
 
-            auto vertexI = Vector2(gjk.simplex[i]);
-            auto vertexJ = Vector2(gjk.simplex[j]);
+GJKResult PhysicsUtils::GJK(const Collider& a, const Collider& b) {
+    return GJK(a, b, b.CalcCenter() - a.CalcCenter());
+}
 
-            auto ij = vertexJ - vertexI;
-            auto normal = Vector2(ij.y, -ij.x).GetNormalize();
-            auto distance = MathUtils::DotProduct(normal, vertexI);
+GJKResult PhysicsUtils::GJK(const Collider& a, const Collider& b, const Vector2& initial_direction) {
+    GJKResult result{};
+    const auto start_direction = initial_direction == Vector2::Zero ? Vector2::X_Axis : initial_direction;
+    result.simplex[0] = CalcMinkowskiSupport(a, b, start_direction);
+    result.simplex_size = 1u;
+    result.direction = -result.simplex[0];
+    for(int i = 0; i < maxGJKIterations; ++i) {
+        //The origin lies on the simplex: the shapes only touch.
+        if(result.direction == Vector2::Zero) {
+            result.direction = start_direction;
+            return result;
+        }
+        const auto A = CalcMinkowskiSupport(a, b, result.direction);
+        if(MathUtils::DotProduct(A, result.direction) <= 0.0f) {
+            return result;
+        }
+        //Newest point first.
+        for(auto j = result.simplex_size; j > 0u; --j) {
+            result.simplex[j] = result.simplex[j - 1u];
+        }
+        result.simplex[0] = A;
+        ++result.simplex_size;
+        if(DoSimplex(result)) {
+            result.collides = true;
+            return result;
+        }
+    }
+    return result;
+}
 
-            if(distance < 0.0f) {
-                distance = -distance;
-                normal = -normal;
+EPAResult PhysicsUtils::EPA(const GJKResult& gjk, const Collider& a, const Collider& b) {
+    if(!gjk.collides || gjk.simplex_size != 3u) {
+        return {};
+    }
+    std::array<Vector2, maxEPAVertices> polytope{gjk.simplex[0], gjk.simplex[1], gjk.simplex[2]};
+    std::size_t count = 3u;
+    //Wind counter-clockwise so every edge's outward normal is (edge.y, -edge.x).
+    if(MathUtils::CrossProduct(polytope[1] - polytope[0], polytope[2] - polytope[0]) < 0.0f) {
+        std::swap(polytope[1], polytope[2]);
+    }
+    for(;;) {
+        std::size_t minIndex = 0u;
+        auto minDistance = std::numeric_limits<float>::infinity();
+        auto minNormal = Vector2::X_Axis;
+        for(std::size_t i = 0u; i < count; ++i) {
+            const auto j = (i + 1u) % count;
+            const auto edge = polytope[j] - polytope[i];
+            const auto length = edge.CalcLength();
+            if(length <= 0.0f) {
+                continue;
             }
+            const auto normal = Vector2{edge.y, -edge.x} / length;
+            const auto distance = MathUtils::DotProduct(normal, polytope[i]);
             if(distance < minDistance) {
                 minDistance = distance;
                 minNormal = normal;
                 minIndex = j;
             }
         }
-
-        const auto supportValue = support(Vector3{minNormal});
-        const auto sDistance = MathUtils::DotProduct(minNormal, supportValue);
-
-        if(std::abs(sDistance - minDistance) > epsilon) {
-            minDistance = infinity;
-            gjk.simplex.insert(std::begin(gjk.simplex) + minIndex, Vector3{supportValue});
+        const auto supportValue = CalcMinkowskiSupport(a, b, minNormal);
+        const auto supportDistance = MathUtils::DotProduct(minNormal, supportValue);
+        if(supportDistance - minDistance <= contactSlop || count == polytope.size()) {
+            return {minDistance + contactSlop, Vector3{minNormal}};
+        }
+        for(auto k = count; k > minIndex; --k) {
+            polytope[k] = polytope[k - 1u];
         }
+        polytope[minIndex] = supportValue;
+        ++count;
     }
+}
 
-    return {minDistance + epsilon, Vector3{minNormal}};
+bool PhysicsUtils::CollideClosedForm(const Collider& a, const Collider& b, std::optional<EPAResult>& result) noexcept {
+    if(a.GetShape() == ColliderShape::Circle && b.GetShape() == ColliderShape::Circle) {
+        result = CollideCircles(a, b);
+        return true;
+    }
+    if(IsBox(a) && IsBox(b)) {
+        result = CollideBoxes(a, b);
+        return true;
+    }
+    return false;
+}
+
+std::optional<EPAResult> PhysicsUtils::Collide(const Collider& a, const Collider& b, Vector2& warm_start_direction) {
+    if(std::optional<EPAResult> result{}; CollideClosedForm(a, b, result)) {
+        return result;
+    }
+    const auto gjk = GJK(a, b, warm_start_direction == Vector2::Zero ? b.CalcCenter() - a.CalcCenter() : warm_start_direction);
+    warm_start_direction = gjk.direction;
+    if(!gjk.collides) {
+        return {};
+    }
+    return EPA(gjk, a, b);
 }
 
 bool PhysicsUtils::SAT(const Collider& a, const Collider& b) {
@@ -162,3 +325,35 @@ bool PhysicsUtils::SAT(const Collider& a, const Collider& b) {
     }
     return MathUtils::DoPolygonsOverlap(polyA->GetPolygon(), polyB->GetPolygon());
 }
+
+float PhysicsUtils::CalcSeparation(const Collider& a, const Collider& b, Vector2& normal) noexcept {
+    return ::CalcSeparation(a, b, Vector2::Zero, normal);
+}
+
+std::optional<TOIResult> PhysicsUtils::CalcTimeOfImpact(const Collider& a, const Sweep& sweep_a, const Collider& b, const Sweep& sweep_b, float target_separation) noexcept {
+    //The distance never drops below the separation along the last normal, which changes linearly with time,
+    //so advancing to where that reaches the target cannot step past the first contact.
+    const auto tolerance = (std::max)(0.25f * target_separation, separationTolerance);
+    const auto start = sweep_a.offset - sweep_b.offset;
+    const auto motion = sweep_a.displacement - sweep_b.displacement;
+    auto normal = Vector2::X_Axis;
+    auto t = 0.0f;
+    for(int i = 0; i < maxTOIIterations; ++i) {
+        const auto separation = ::CalcSeparation(a, b, start + motion * t, normal);
+        if(separation <= target_separation + tolerance) {
+            if(t <= 0.0f) {
+                return {};
+            }
+            return TOIResult{t, normal};
+        }
+        const auto closing_distance = MathUtils::DotProduct(motion, normal);
+        if(closing_distance <= 0.0f) {
+            return {};
+        }
+        t += (separation - target_separation) / closing_distance;
+        if(1.0f < t) {
+            return {};
+        }
+    }
+    return TOIResult{t, normal};
+}
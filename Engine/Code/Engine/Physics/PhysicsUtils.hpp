@@ -2,14 +2,30 @@
 
 #include "Engine/Physics/PhysicsTypes.hpp"
 
+#include <optional>
+
 class Collider;
 
 namespace PhysicsUtils {
 [[nodiscard]] GJKResult GJK(const Collider& a, const Collider& b);
+//Starts searching along initial_direction, e.g. the direction GJK ended with for the same pair last frame.
+[[nodiscard]] GJKResult GJK(const Collider& a, const Collider& b, const Vector2& initial_direction);
 [[nodiscard]] bool GJKIntersect(const Collider& a, const Collider& b);
 
-[[nodiscard]] EPAResult EPA(GJKResult gjk, const Collider& a, const Collider& b);
+[[nodiscard]] EPAResult EPA(const GJKResult& gjk, const Collider& a, const Collider& b);
 [[nodiscard]] bool SAT(const Collider& a, const Collider& b);
+
+//Exact tests for circle-circle and box-box pairs. Returns false, leaving result untouched, when either collider has no closed form.
+[[nodiscard]] bool CollideClosedForm(const Collider& a, const Collider& b, std::optional<EPAResult>& result) noexcept;
+//Uses the closed form when there is one, otherwise GJK and EPA warm started from warm_start_direction.
+//warm_start_direction is updated for the next call with the same pair; a zero vector means no history.
+[[nodiscard]] std::optional<EPAResult> Collide(const Collider& a, const Collider& b, Vector2& warm_start_direction);
+
+//Lower bound on the distance between two colliders, zero when they touch, and the unit normal from a to b it was measured along.
+[[nodiscard]] float CalcSeparation(const Collider& a, const Collider& b, Vector2& normal) noexcept;
+//Conservative advancement along both sweeps: the first time at which the colliders come within target_separation of each other.
+//Nothing when they never do, or when they already are at the start of the sweeps.
+[[nodiscard]] std::optional<TOIResult> CalcTimeOfImpact(const Collider& a, const Sweep& sweep_a, const Collider& b, const Sweep& sweep_b, float target_separation) noexcept;
 } // namespace PhysicsUtils
 
 namespace MathUtils {
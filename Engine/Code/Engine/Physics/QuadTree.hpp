@@ -1,454 +1,423 @@
 #pragma once
 
-#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vector2.hpp"
-#include "Engine/Profiling/ProfileLogScope.hpp"
-
-#include "Engine/Services/ServiceLocator.hpp"
-#include "Engine/Services/IRendererService.hpp"
-#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include <algorithm>
 #include <array>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 #include <vector>
 
+//Region quadtree over axis-aligned bounds.
+//Each element lives in the deepest node whose bounds fully contain it, so an element is stored exactly once and
+//elements that straddle a split stay in the parent. Elements outside the world bounds are kept in the root.
+//A leaf splits once it holds more than the per-node limit and four sibling leaves merge back into their parent once
+//they are nearly empty, so moving elements never requires a rebuild.
+//Nodes and elements live in flat arrays with free lists; after warm-up Add, Update, Remove and Query do not allocate.
+//Elements are only referenced, never dereferenced.
 template<typename T>
 class QuadTree {
 public:
-    QuadTree() = default;
-    explicit QuadTree(const AABB2& bounds);
-    QuadTree(const QuadTree& other) = delete;
-    QuadTree(QuadTree&& other) = default;
-    QuadTree& operator=(const QuadTree& other) = delete;
-    QuadTree& operator=(QuadTree&& other) = default;
-    ~QuadTree() = default;
-
-    void Add(std::add_pointer_t<T> new_element);
-    void Add(std::vector<std::add_pointer_t<T>> new_elements);
-    void Clear();
-    void DebugRender() const;
-
+    using Handle = std::uint32_t;
+    static constexpr Handle null_handle = (std::numeric_limits<Handle>::max)();
+
+    QuadTree() noexcept;
+    explicit QuadTree(const AABB2& bounds, std::size_t maxElementsPerNode = 8u, std::size_t maxDepth = 8u) noexcept;
+    QuadTree(const QuadTree& other) = default;
+    QuadTree(QuadTree&& other) noexcept = default;
+    QuadTree& operator=(const QuadTree& other) = default;
+    QuadTree& operator=(QuadTree&& other) noexcept = default;
+    ~QuadTree() noexcept = default;
+
+    [[nodiscard]] Handle Add(std::add_pointer_t<T> element, const AABB2& bounds) noexcept;
+    //Only moves the element between nodes when it no longer belongs in the node it is in.
+    void Update(Handle handle, const AABB2& bounds) noexcept;
+    void Remove(Handle handle) noexcept;
+    void Clear() noexcept;
+
+    //Reinserts every element into a tree covering the new bounds; handles stay valid.
     void SetWorldBounds(const AABB2& bounds) noexcept;
-    [[nodiscard]] std::vector<std::add_pointer_t<T>> Query(const AABB2& area) noexcept;
+    [[nodiscard]] const AABB2& GetWorldBounds() const noexcept;
+
+    //Calls visitor(element) for every element whose bounds overlap area.
+    template<typename Visitor>
+    void Query(const AABB2& area, Visitor&& visitor) const noexcept;
+    //Calls visitor(bounds, depth, elementCount) for every node, parents before children.
+    template<typename Visitor>
+    void VisitNodes(Visitor&& visitor) const noexcept;
+
+    [[nodiscard]] std::add_pointer_t<T> GetElement(Handle handle) const noexcept;
+    [[nodiscard]] const AABB2& GetBounds(Handle handle) const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::size_t GetNodeCount() const noexcept;
 
 protected:
 private:
-    explicit QuadTree(QuadTree<T>* parent, const AABB2& bounds);
-    explicit QuadTree(QuadTree<T>* parent, const AABB2& bounds, const std::vector<T>& elements);
-    // clang-format off
-    enum class ChildID {
-        BottomLeft
-        , TopLeft
-        , TopRight
-        , BottomRight
+    static constexpr std::uint32_t null_index = (std::numeric_limits<std::uint32_t>::max)();
+    static constexpr std::size_t child_count = 4u;
+    //Bounds the traversal stacks: each level pushes at most three nodes more than it pops.
+    static constexpr std::size_t max_depth_limit = 32u;
+    using Stack = std::array<std::uint32_t, 3u * max_depth_limit + 1u>;
+
+    struct Node {
+        AABB2 bounds{};
+        std::uint32_t parent = null_index;
+        //The four children are allocated together starting here; on the free list, the next free block.
+        std::uint32_t first_child = null_index;
+        std::uint32_t first_element = null_index;
+        std::uint32_t element_count = 0u;
+        std::uint32_t depth = 0u;
+        [[nodiscard]] bool IsLeaf() const noexcept;
     };
-    // clang-format off
-    void DebugRender_helper() const;
-    [[nodiscard]] bool IsParent(const QuadTree<T>* node) const;
-    [[nodiscard]] bool IsChild(const QuadTree<T>* node) const;
-    [[nodiscard]] bool IsLeaf(const QuadTree<T>* node) const;
-    [[nodiscard]] bool IsParent() const;
-    [[nodiscard]] bool IsChild() const;
-    [[nodiscard]] bool IsLeaf() const;
-    [[nodiscard]] bool IsElementIntersectingMe(std::add_pointer_t<T> new_element) const;
-    [[nodiscard]] bool NeedsSubdivide() const;
-    [[nodiscard]] bool NeedsUnSubdivide() const;
-    void Subdivide();
-    void UnSubdivide();
-    void MakeChildren();
-    void ClearChildren();
-    void AddElement(std::add_pointer_t<T> old_element);
-    void GiveElementsToChildren();
-    void TakeElementsFromChildren();
-    [[nodiscard]] const QuadTree<T>* GetChild(const ChildID& id) const;
-    [[nodiscard]] QuadTree<T>* GetChild(const ChildID& id);
-    void CreateChild(const ChildID& id);
-    void DeleteChild(const ChildID& id);
-    void SetChild(const ChildID& id, std::unique_ptr<QuadTree<T>> child);
-
-    [[nodiscard]] const std::size_t ChildIdToIndex(const ChildID& id) const;
-    [[nodiscard]] bool IsLeaf(const QuadTree<T>& node) const;
-    [[nodiscard]] AABB2 GetBounds() const;
-    [[nodiscard]] AABB2 GetParentBounds() const;
-    [[nodiscard]] std::vector<QuadTree<T>*> GetNodesByElement(const T& object) const noexcept;
-
-    QuadTree<T>* m_parent = nullptr;
-    Vector2 m_half_extents = Vector2::One;
-    AABB2 m_bounds = AABB2{-m_half_extents, m_half_extents};
-    std::array<std::unique_ptr<QuadTree>, 4> m_children{};
-    const int m_maxElementsBeforeSubdivide = 2;
-    const int m_maxChildren = 4;
-    const int m_maxDepth = 8;
-    std::vector<std::add_pointer_t<T>> m_elements{};
-};
 
-template<typename T>
-std::vector<std::add_pointer_t<T>> QuadTree<T>::Query(const AABB2& area) noexcept {
-    std::vector<std::add_pointer_t<T>> result{};
-    if(MathUtils::DoAABBsOverlap(area, m_bounds)) {
-        if(!IsLeaf(*this)) {
-            for(const auto& c : m_children) {
-                if(c) {
-                    auto inner_result = c->Query(area);
-                    result.insert(std::end(result), std::begin(inner_result), std::end(inner_result));
-                }
-            }
-        } else {
-            for(auto* elem : m_elements) {
-                if(elem) {
-                    if(MathUtils::DoOBBsOverlap(OBB2(area), elem->GetBounds())) {
-                        result.push_back(elem);
-                    }
-                }
-            }
-        }
-    }
-    return result;
-}
+    struct Entry {
+        AABB2 bounds{};
+        std::add_pointer_t<T> element = nullptr;
+        std::uint32_t node = null_index;
+        //Neighbours in the node's element list; next doubles as the free list link.
+        std::uint32_t prev = null_index;
+        std::uint32_t next = null_index;
+    };
+
+    void Insert(std::uint32_t entry, std::uint32_t start_node) noexcept;
+    void Link(std::uint32_t entry, std::uint32_t node) noexcept;
+    void Unlink(std::uint32_t entry) noexcept;
+    void Split(std::uint32_t node) noexcept;
+    void TryMerge(std::uint32_t node) noexcept;
+    [[nodiscard]] std::uint32_t FindChildContaining(const Node& node, const AABB2& bounds) const noexcept;
+    [[nodiscard]] bool BelongsIn(std::uint32_t node, const AABB2& bounds) const noexcept;
+    [[nodiscard]] std::uint32_t AllocateChildren() noexcept;
+    void FreeChildren(std::uint32_t first_child) noexcept;
+
+    std::vector<Node> _nodes{};
+    std::vector<Entry> _entries{};
+    std::uint32_t _free_nodes = null_index;
+    std::uint32_t _free_entries = null_index;
+    std::size_t _size = 0u;
+    std::size_t _max_elements_per_node = 8u;
+    std::size_t _max_depth = 8u;
+};
 
 template<typename T>
-AABB2 QuadTree<T>::GetParentBounds() const {
-    return m_parent ? m_parent->m_bounds : AABB2{};
+bool QuadTree<T>::Node::IsLeaf() const noexcept {
+    return first_child == null_index;
 }
 
 template<typename T>
-bool QuadTree<T>::IsLeaf(const QuadTree<T>* node) const {
-    return node ? node->m_children[0] == nullptr : false;
+QuadTree<T>::QuadTree() noexcept
+: QuadTree(AABB2{Vector2{-1.0f, -1.0f}, Vector2{1.0f, 1.0f}}) {
+    /* DO NOTHING */
 }
 
 template<typename T>
-bool QuadTree<T>::IsChild(const QuadTree<T>* node) const {
-    return node ? node->m_parent != nullptr : false;
+QuadTree<T>::QuadTree(const AABB2& bounds, std::size_t maxElementsPerNode /*= 8u*/, std::size_t maxDepth /*= 8u*/) noexcept
+: _max_elements_per_node{(std::max)(maxElementsPerNode, std::size_t{1u})}
+, _max_depth{(std::min)(maxDepth, max_depth_limit)} {
+    _nodes.emplace_back().bounds = bounds;
 }
 
 template<typename T>
-bool QuadTree<T>::IsParent(const QuadTree<T>* node) const {
-    return node ? node->m_children[0] != nullptr : false;
+typename QuadTree<T>::Handle QuadTree<T>::Add(std::add_pointer_t<T> element, const AABB2& bounds) noexcept {
+    auto entry = _free_entries;
+    if(entry == null_index) {
+        entry = static_cast<std::uint32_t>(_entries.size());
+        _entries.emplace_back();
+    } else {
+        _free_entries = _entries[entry].next;
+    }
+    _entries[entry] = Entry{bounds, element};
+    ++_size;
+    Insert(entry, 0u);
+    return entry;
 }
 
 template<typename T>
-bool QuadTree<T>::IsLeaf() const {
-    return m_children[0] == nullptr;
+void QuadTree<T>::Update(Handle handle, const AABB2& bounds) noexcept {
+    auto& entry = _entries[handle];
+    entry.bounds = bounds;
+    const auto old_node = entry.node;
+    if(BelongsIn(old_node, bounds)) {
+        return;
+    }
+    //Climb to the first ancestor that still contains the element, then sink from there.
+    auto start = _nodes[old_node].parent;
+    while(start != null_index && _nodes[start].parent != null_index && !MathUtils::Contains(_nodes[start].bounds, bounds)) {
+        start = _nodes[start].parent;
+    }
+    Unlink(handle);
+    Insert(handle, start == null_index ? 0u : start);
+    TryMerge(old_node);
 }
 
 template<typename T>
-bool QuadTree<T>::IsChild() const {
-    return m_parent != nullptr;
+void QuadTree<T>::Remove(Handle handle) noexcept {
+    if(handle >= _entries.size() || _entries[handle].node == null_index) {
+        return;
+    }
+    const auto node = _entries[handle].node;
+    Unlink(handle);
+    _entries[handle] = Entry{};
+    _entries[handle].next = _free_entries;
+    _free_entries = handle;
+    --_size;
+    TryMerge(node);
 }
 
 template<typename T>
-bool QuadTree<T>::IsParent() const {
-    return m_children[0] != nullptr;
+void QuadTree<T>::Clear() noexcept {
+    const auto bounds = _nodes[0].bounds;
+    _nodes.clear();
+    _nodes.emplace_back().bounds = bounds;
+    _entries.clear();
+    _free_nodes = null_index;
+    _free_entries = null_index;
+    _size = 0u;
 }
 
 template<typename T>
 void QuadTree<T>::SetWorldBounds(const AABB2& bounds) noexcept {
-    m_bounds = bounds;
-    m_half_extents = m_bounds.CalcDimensions() * 0.5f;
-    if(IsParent()) {
-        auto* bl = GetChild(ChildID::BottomLeft);
-        bl->m_half_extents = m_half_extents * 0.5f;
-        bl->m_bounds.mins = -m_half_extents;
-        bl->m_bounds.maxs = m_half_extents;
-        bl->m_bounds.Translate(GetParentBounds().CalcCenter() + Vector2{-m_half_extents.x, +m_half_extents.y});
-        auto* tl = GetChild(ChildID::TopLeft);
-        tl->m_half_extents = m_half_extents * 0.5f;
-        tl->m_bounds.mins = -m_half_extents;
-        tl->m_bounds.maxs = m_half_extents;
-        tl->m_bounds.Translate(GetParentBounds().CalcCenter() + Vector2{-m_half_extents.x, -m_half_extents.y});
-        auto* tr = GetChild(ChildID::TopRight);
-        tr->m_half_extents = m_half_extents * 0.5f;
-        tr->m_bounds.mins = -m_half_extents;
-        tr->m_bounds.maxs = m_half_extents;
-        tr->m_bounds.Translate(GetParentBounds().CalcCenter() + Vector2{+m_half_extents.x, -m_half_extents.y});
-        auto* br = GetChild(ChildID::BottomRight);
-        br->m_half_extents = m_half_extents * 0.5f;
-        br->m_bounds.mins = -m_half_extents;
-        br->m_bounds.maxs = m_half_extents;
-        br->m_bounds.Translate(GetParentBounds().CalcCenter() + Vector2{+m_half_extents.x, +m_half_extents.y});
-        for(auto& child : m_children) {
-            if(child) {
-                child->SetWorldBounds(child->m_bounds);
-            }
+    _nodes.clear();
+    _nodes.emplace_back().bounds = bounds;
+    _free_nodes = null_index;
+    for(auto& entry : _entries) {
+        if(entry.node != null_index) {
+            entry.node = null_index;
+            entry.prev = null_index;
+            entry.next = null_index;
+        }
+    }
+    for(std::uint32_t entry = 0u; entry < _entries.size(); ++entry) {
+        if(_entries[entry].element) {
+            Insert(entry, 0u);
         }
     }
 }
 
 template<typename T>
-void QuadTree<T>::Clear() {
-    for(auto& child : m_children) {
-        if(child) {
-            child->Clear();
-        }
-    }
-    m_elements.clear();
-    for(auto& child : m_children) {
-        child.reset(nullptr);
-    }
+const AABB2& QuadTree<T>::GetWorldBounds() const noexcept {
+    return _nodes[0].bounds;
 }
 
 template<typename T>
-void QuadTree<T>::Add(std::add_pointer_t<T> new_element) {
-    if(!IsElementIntersectingMe(new_element)) {
-        return;
-    }
-    PROFILE_LOG_SCOPE_FUNCTION();
-    if(!IsLeaf(*this)) {
-        for(auto& child : m_children) {
-            if(child) {
-                child->Add(new_element);
+template<typename Visitor>
+void QuadTree<T>::Query(const AABB2& area, Visitor&& visitor) const noexcept {
+    Stack stack{};
+    std::size_t top = 0u;
+    stack[top++] = 0u;
+    while(top) {
+        const auto& node = _nodes[stack[--top]];
+        if(!MathUtils::DoAABBsOverlap(node.bounds, area)) {
+            continue;
+        }
+        //Below the root every element is inside its node, so a node inside the area needs no per-element test.
+        const auto contains_node = node.parent != null_index && MathUtils::Contains(area, node.bounds);
+        for(auto entry = node.first_element; entry != null_index; entry = _entries[entry].next) {
+            if(contains_node || MathUtils::DoAABBsOverlap(_entries[entry].bounds, area)) {
+                visitor(_entries[entry].element);
+            }
+        }
+        if(!node.IsLeaf()) {
+            for(std::uint32_t i = 0u; i < child_count; ++i) {
+                stack[top++] = node.first_child + i;
             }
         }
-        return;
     }
-    m_elements.push_back(new_element);
-    Subdivide();
 }
 
 template<typename T>
-void QuadTree<T>::Add(std::vector<std::add_pointer_t<T>> new_elements) {
-    m_elements.reserve(m_elements.size() + new_elements.size());
-    for(const auto& elem : new_elements) {
-        Add(elem);
+template<typename Visitor>
+void QuadTree<T>::VisitNodes(Visitor&& visitor) const noexcept {
+    Stack stack{};
+    std::size_t top = 0u;
+    stack[top++] = 0u;
+    while(top) {
+        const auto& node = _nodes[stack[--top]];
+        visitor(node.bounds, static_cast<std::size_t>(node.depth), static_cast<std::size_t>(node.element_count));
+        if(!node.IsLeaf()) {
+            for(std::uint32_t i = 0u; i < child_count; ++i) {
+                stack[top++] = node.first_child + i;
+            }
+        }
     }
 }
 
 template<typename T>
-bool QuadTree<T>::IsLeaf(const QuadTree<T>& node) const {
-    return node.m_children[0] == nullptr;
+std::add_pointer_t<T> QuadTree<T>::GetElement(Handle handle) const noexcept {
+    return handle < _entries.size() ? _entries[handle].element : nullptr;
 }
 
 template<typename T>
-AABB2 QuadTree<T>::GetBounds() const {
-    return m_bounds;
+const AABB2& QuadTree<T>::GetBounds(Handle handle) const noexcept {
+    return _entries[handle].bounds;
 }
 
 template<typename T>
-void QuadTree<T>::AddElement(std::add_pointer_t<T> new_element) {
-    m_elements.push_back(new_element);
+std::size_t QuadTree<T>::size() const noexcept {
+    return _size;
 }
 
 template<typename T>
-void QuadTree<T>::DebugRender() const {
-    auto& renderer = ServiceLocator::get<IRendererService>();
-    renderer.SetMaterial(renderer.GetMaterial("__2D"));
-    renderer.SetModelMatrix(Matrix4::I);
-    DebugRender_helper();
+std::size_t QuadTree<T>::GetNodeCount() const noexcept {
+    std::size_t count = 0u;
+    VisitNodes([&count](const AABB2& /*bounds*/, std::size_t /*depth*/, std::size_t /*elementCount*/) { ++count; });
+    return count;
 }
 
 template<typename T>
-const std::size_t QuadTree<T>::ChildIdToIndex(const ChildID& id) const {
-    switch(id) {
-    case ChildID::BottomLeft: return 0;
-    case ChildID::BottomRight: return 1;
-    case ChildID::TopLeft: return 2;
-    case ChildID::TopRight: return 3;
-    default:
-        ERROR_AND_DIE("QuadTree: ChildToIndex invalid index.")
+void QuadTree<T>::Insert(std::uint32_t entry, std::uint32_t start_node) noexcept {
+    const auto bounds = _entries[entry].bounds;
+    auto node = start_node;
+    while(!_nodes[node].IsLeaf()) {
+        const auto child = FindChildContaining(_nodes[node], bounds);
+        if(child == null_index) {
+            break;
+        }
+        node = child;
+    }
+    Link(entry, node);
+    if(_nodes[node].IsLeaf() && _max_elements_per_node < _nodes[node].element_count && _nodes[node].depth < _max_depth) {
+        Split(node);
     }
 }
 
 template<typename T>
-const QuadTree<T>* QuadTree<T>::GetChild(const ChildID& id) const {
-    const auto index = ChildIdToIndex(id);
-    return m_children[index].get();
-}
-
-template<typename T>
-QuadTree<T>* QuadTree<T>::GetChild(const ChildID& id) {
-    const auto index = ChildIdToIndex(id);
-    return m_children[index].get();
+void QuadTree<T>::Link(std::uint32_t entry, std::uint32_t node) noexcept {
+    auto& e = _entries[entry];
+    auto& n = _nodes[node];
+    e.node = node;
+    e.prev = null_index;
+    e.next = n.first_element;
+    if(n.first_element != null_index) {
+        _entries[n.first_element].prev = entry;
+    }
+    n.first_element = entry;
+    ++n.element_count;
 }
 
 template<typename T>
-void QuadTree<T>::CreateChild(const ChildID& id) {
-    const auto index = ChildIdToIndex(id);
-
-    auto bounds = m_bounds;
-    bounds.ScalePadding(0.50f, 0.50f);
-    switch(id) {
-    case ChildID::BottomLeft: {
-        const auto tl_corner = m_bounds.CalcCenter() + Vector2(-m_half_extents.x, 0.0f);
-        const auto pos = tl_corner + Vector2(m_half_extents.x, m_half_extents.y) * 0.5f;
-        bounds.SetPosition(pos);
-        m_children[index] = std::move(std::unique_ptr<QuadTree<T>>(new QuadTree<T>(this, bounds)));
-        break;
-    }
-    case ChildID::BottomRight: {
-        const auto tl_corner = m_bounds.CalcCenter();
-        const auto pos = tl_corner + m_half_extents * 0.50f;
-        bounds.SetPosition(pos);
-        m_children[index] = std::move(std::unique_ptr<QuadTree<T>>(new QuadTree<T>(this, bounds)));
-        break;
-    }
-    case ChildID::TopLeft: {
-        //bounds defaults to TopLeft by virtue of scale padding.
-        m_children[index] = std::move(std::unique_ptr<QuadTree<T>>(new QuadTree<T>(this, bounds)));
-        break;
+void QuadTree<T>::Unlink(std::uint32_t entry) noexcept {
+    auto& e = _entries[entry];
+    auto& n = _nodes[e.node];
+    if(e.prev != null_index) {
+        _entries[e.prev].next = e.next;
+    } else {
+        n.first_element = e.next;
     }
-    case ChildID::TopRight: {
-        const auto tl_corner = m_bounds.CalcCenter() + Vector2(0.0f, -m_half_extents.y);
-        const auto pos = tl_corner + m_half_extents * 0.50f;
-        bounds.SetPosition(pos);
-        m_children[index] = std::move(std::unique_ptr<QuadTree<T>>(new QuadTree<T>(this, bounds)));
-        break;
+    if(e.next != null_index) {
+        _entries[e.next].prev = e.prev;
     }
-    default:
-        ERROR_AND_DIE("QuadTree Child ID has changed.");
+    --n.element_count;
+    e.node = null_index;
+    e.prev = null_index;
+    e.next = null_index;
+}
+
+template<typename T>
+void QuadTree<T>::Split(std::uint32_t node) noexcept {
+    PROFILE_SCOPE("QuadTree::Split");
+    const auto first_child = AllocateChildren();
+    const auto bounds = _nodes[node].bounds;
+    const auto center = bounds.CalcCenter();
+    const std::array<AABB2, child_count> child_bounds{
+    AABB2{bounds.mins, center},
+    AABB2{Vector2{center.x, bounds.mins.y}, Vector2{bounds.maxs.x, center.y}},
+    AABB2{Vector2{bounds.mins.x, center.y}, Vector2{center.x, bounds.maxs.y}},
+    AABB2{center, bounds.maxs}};
+    for(std::uint32_t i = 0u; i < child_count; ++i) {
+        auto& child = _nodes[first_child + i];
+        child = Node{};
+        child.bounds = child_bounds[i];
+        child.parent = node;
+        child.depth = _nodes[node].depth + 1u;
     }
-}
-
-template<typename T>
-void QuadTree<T>::DeleteChild(const ChildID& id) {
-    const auto index = ChildIdToIndex(id);
-    m_children[index].reset(nullptr);
-}
-
-template<typename T>
-void QuadTree<T>::SetChild(const ChildID& id, std::unique_ptr<QuadTree<T>> child) {
-    const auto index = ChildIdToIndex(id);
-    return m_children[index].get();
-}
-
-template<typename T>
-QuadTree<T>::QuadTree(const AABB2& bounds)
-: m_half_extents{bounds.CalcDimensions() * 0.5f}
-, m_bounds{bounds} {
-    /* DO NOTHING */
-}
-
-template<typename T>
-QuadTree<T>::QuadTree(QuadTree<T>* parent, const AABB2& bounds)
-: m_parent(parent)
-, m_half_extents(bounds.CalcDimensions() * 0.5f)
-, m_bounds(bounds) {
-    /* DO NOTHING */
-}
-
-template<typename T>
-QuadTree<T>::QuadTree(QuadTree<T>* parent, const AABB2& bounds, const std::vector<T>& elements)
-: m_parent(parent)
-, m_half_extents(bounds.CalcDimensions() * 0.5f)
-, m_bounds(bounds)
-, m_elements(elements) {
-    /* DO NOTHING */
-}
-
-template<typename T>
-void QuadTree<T>::Subdivide() {
-    if(NeedsSubdivide()) {
-        PROFILE_LOG_SCOPE("Subdivide after needs to.");
-        MakeChildren();
-        GiveElementsToChildren();
-    }
-}
-
-template<typename T>
-void QuadTree<T>::UnSubdivide() {
-    if(NeedsUnSubdivide()) {
-        PROFILE_LOG_SCOPE("UnSubdivide after needs to.");
-        TakeElementsFromChildren();
-        ClearChildren();
+    _nodes[node].first_child = first_child;
+    //Push down every element that fits entirely inside one child.
+    for(auto entry = _nodes[node].first_element; entry != null_index;) {
+        const auto next = _entries[entry].next;
+        const auto child = FindChildContaining(_nodes[node], _entries[entry].bounds);
+        if(child != null_index) {
+            Unlink(entry);
+            Link(entry, child);
+        }
+        entry = next;
     }
 }
 
 template<typename T>
-void QuadTree<T>::MakeChildren() {
-    CreateChild(ChildID::BottomLeft);
-    CreateChild(ChildID::TopLeft);
-    CreateChild(ChildID::TopRight);
-    CreateChild(ChildID::BottomRight);
-}
-
-template<typename T>
-void QuadTree<T>::ClearChildren() {
-    DeleteChild(ChildID::BottomLeft);
-    DeleteChild(ChildID::TopLeft);
-    DeleteChild(ChildID::TopRight);
-    DeleteChild(ChildID::BottomRight);
-}
-
-template<typename T>
-void QuadTree<T>::GiveElementsToChildren() {
-    PROFILE_LOG_SCOPE_FUNCTION();
-    for(auto& elem : m_elements) {
-        for(auto& child : m_children) {
-            if(child) {
-                if(MathUtils::Contains(child->GetBounds(), elem->GetBounds())) {
-                    child->AddElement(elem);
-                    elem = nullptr;
-                    break;
-                }
+void QuadTree<T>::TryMerge(std::uint32_t node) noexcept {
+    //Walk up while a parent's children are all empty-ish leaves; merging at half the split limit avoids split/merge thrash.
+    for(auto parent = _nodes[node].parent; parent != null_index; parent = _nodes[parent].parent) {
+        const auto first_child = _nodes[parent].first_child;
+        std::size_t count = _nodes[parent].element_count;
+        for(std::uint32_t i = 0u; i < child_count; ++i) {
+            const auto& child = _nodes[first_child + i];
+            if(!child.IsLeaf()) {
+                return;
             }
+            count += child.element_count;
         }
-    }
-    m_elements.erase(std::remove_if(std::begin(m_elements), std::end(m_elements), [](const T* a) { return a == nullptr; }), std::end(m_elements));
-    for(auto& child : m_children) {
-        if(child) {
-            child->Subdivide();
+        if(_max_elements_per_node / 2u < count) {
+            return;
+        }
+        PROFILE_SCOPE("QuadTree::Merge");
+        for(std::uint32_t i = 0u; i < child_count; ++i) {
+            while(_nodes[first_child + i].first_element != null_index) {
+                const auto entry = _nodes[first_child + i].first_element;
+                Unlink(entry);
+                Link(entry, parent);
+            }
         }
+        _nodes[parent].first_child = null_index;
+        FreeChildren(first_child);
     }
 }
 
 template<typename T>
-void QuadTree<T>::TakeElementsFromChildren() {
-    PROFILE_LOG_SCOPE_FUNCTION();
-    const auto max_elems = std::size_t{0};
-    for(auto& child : m_children) {
-        max_elems += child->m_elements.size();
-    }
-    m_elements.reserve(max_elems);
-    for(auto& child : m_children) {
-        std::merge(std::begin(child->m_elements), std::end(child->m_elements), std::begin(m_elements), std::end(m_elements), std::back_inserter(m_elements));
+std::uint32_t QuadTree<T>::FindChildContaining(const Node& node, const AABB2& bounds) const noexcept {
+    //Children split at the center, so the quadrant is decided by which side of it the bounds are on.
+    const auto center = node.bounds.CalcCenter();
+    const auto left = bounds.maxs.x < center.x;
+    const auto right = center.x <= bounds.mins.x;
+    const auto bottom = bounds.maxs.y < center.y;
+    const auto top = center.y <= bounds.mins.y;
+    if(!(left || right) || !(bottom || top)) {
+        return null_index;
     }
+    const auto child = node.first_child + (right ? 1u : 0u) + (top ? 2u : 0u);
+    return MathUtils::Contains(_nodes[child].bounds, bounds) ? child : null_index;
 }
 
 template<typename T>
-void QuadTree<T>::DebugRender_helper() const {
-    auto& renderer = ServiceLocator::get<IRendererService>();
-    renderer.DrawAABB2(m_bounds, Rgba::Green, Rgba::NoAlpha);
-    for(const auto& child : m_children) {
-        if(child) {
-            child->DebugRender_helper();
-        }
+bool QuadTree<T>::BelongsIn(std::uint32_t node, const AABB2& bounds) const noexcept {
+    const auto& n = _nodes[node];
+    if(n.parent != null_index && !MathUtils::Contains(n.bounds, bounds)) {
+        return false;
     }
+    return n.IsLeaf() || FindChildContaining(n, bounds) == null_index;
 }
 
 template<typename T>
-bool QuadTree<T>::NeedsSubdivide() const {
-    return !((std::min)(m_half_extents.x, m_half_extents.y) < 0.5) && m_maxElementsBeforeSubdivide < m_elements.size();
-}
-
-template<typename T>
-bool QuadTree<T>::NeedsUnSubdivide() const {
-    return !(m_maxElementsBeforeSubdivide < m_elements.size());
-}
-
-template<typename T>
-bool QuadTree<T>::IsElementIntersectingMe(std::add_pointer_t<T> new_element) const {
-    if(new_element) {
-        return MathUtils::DoOBBsOverlap(OBB2(GetBounds()), OBB2(new_element->GetBounds()));
+std::uint32_t QuadTree<T>::AllocateChildren() noexcept {
+    if(_free_nodes == null_index) {
+        const auto first_child = static_cast<std::uint32_t>(_nodes.size());
+        _nodes.resize(_nodes.size() + child_count);
+        return first_child;
     }
-    return false;
+    const auto first_child = _free_nodes;
+    _free_nodes = _nodes[first_child].first_child;
+    return first_child;
 }
 
 template<typename T>
-std::vector<QuadTree<T>*> QuadTree<T>::GetNodesByElement(const T& object) const noexcept {
-    std::vector<QuadTree<T>*> result{};
-    if(std::end(m_elements) != std::find(std::begin(m_elements), std::end(m_elements), &object)) {
-        result.push_back(this);
-    }
-    if(IsParent()) {
-        for(const auto* c : m_children) {
-            const auto& child_result = c->GetNodesByElement(object);
-            for(const auto* c : child_result) {
-                result.push_back(c);
-            }
-        }
+void QuadTree<T>::FreeChildren(std::uint32_t first_child) noexcept {
+    for(std::uint32_t i = 0u; i < child_count; ++i) {
+        _nodes[first_child + i] = Node{};
     }
-    return result;
+    _nodes[first_child].first_child = _free_nodes;
+    _free_nodes = first_child;
 }
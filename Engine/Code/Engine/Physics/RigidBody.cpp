@@ -10,15 +10,14 @@
 #include "Engine/Services/IRendererService.hpp"
 #include "Engine/Services/IPhysicsService.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <numeric>
-#include <type_traits>
 
 RigidBody::RigidBody(const RigidBodyDesc& desc /*= RigidBodyDesc{}*/)
 : rigidbodyDesc(desc)
-, velocity(rigidbodyDesc.initialVelocity)
-, position(rigidbodyDesc.initialPosition)
-, acceleration(rigidbodyDesc.initialAcceleration) {
+, linear_state(RigidBodyStore::BodyState{rigidbodyDesc.initialPosition.Get(), rigidbodyDesc.initialVelocity.Get(), rigidbodyDesc.initialAcceleration.Get()})
+, step_start_position(rigidbodyDesc.initialPosition.Get())
+, rest_position(rigidbodyDesc.initialPosition.Get()) {
     const auto area = rigidbodyDesc.collider->CalcArea();
     if(MathUtils::IsEquivalentToZero(rigidbodyDesc.physicsMaterial.density) || MathUtils::IsEquivalentToZero(area)) {
         rigidbodyDesc.physicsDesc.mass = 0.0f;
@@ -32,89 +31,50 @@ RigidBody::RigidBody(const RigidBodyDesc& desc /*= RigidBodyDesc{}*/)
 }
 
 void RigidBody::BeginFrame() {
-    static constexpr auto pred = [](const auto& force) { return force.second.count() <= 0.0f; };
-    if(!linear_forces.empty()) {
-        linear_forces.erase(std::remove_if(linear_forces.begin(), linear_forces.end(), pred), linear_forces.end());
-    }
-    if(!angular_forces.empty()) {
-        angular_forces.erase(std::remove_if(angular_forces.begin(), angular_forces.end(), pred), angular_forces.end());
+    if(!timed_forces.empty()) {
+        timed_forces.erase(std::remove_if(timed_forces.begin(), timed_forces.end(), [](const TimedForce& force) { return force.remaining.count() <= 0.0f; }), timed_forces.end());
     }
 }
 
 void RigidBody::Update(TimeUtils::FPSeconds deltaSeconds) {
-    if(!IsPhysicsEnabled() || !IsDynamic() || !IsAwake() || MathUtils::IsEquivalentToZero(GetInverseMass())) {
-        linear_impulses.clear();
-        angular_impulses.clear();
-        linear_forces.clear();
-        angular_forces.clear();
+    PrepareIntegration(deltaSeconds);
+    linear_state.Integrate(deltaSeconds.count());
+    FinishIntegration(deltaSeconds);
+}
+
+void RigidBody::PrepareIntegration(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    is_integrating = IsSimulated();
+    linear_state.SetActive(is_integrating);
+    if(!is_integrating) {
+        linear_impulse = Vector2::Zero;
+        angular_impulse = 0.0f;
+        timed_forces.clear();
         return;
     }
     const auto inv_mass = GetInverseMass();
-    const auto linear_impulse_sum = std::accumulate(std::begin(linear_impulses), std::end(linear_impulses), Vector2::Zero);
-    const auto angular_impulse_sum = std::accumulate(std::begin(angular_impulses), std::end(angular_impulses), 0.0f);
-    linear_impulses.clear();
-    angular_impulses.clear();
-
-    using LinearForceType = typename std::decay<decltype(*linear_forces.begin())>::type;
-    const auto linear_acc = [](const LinearForceType& a, const LinearForceType& b) { return std::make_pair(a.first + b.first, TimeUtils::FPSeconds::zero()); };
-    const auto linear_force_sum = std::accumulate(std::begin(linear_forces), std::end(linear_forces), std::make_pair(Vector2::Zero, TimeUtils::FPSeconds::zero()), linear_acc);
-
-    using AngularForceType = typename std::decay<decltype(*angular_forces.begin())>::type;
-    const auto angular_acc = [](const AngularForceType& a, const AngularForceType& b) { return std::make_pair(a.first + b.first, TimeUtils::FPSeconds::zero()); };
-    const auto angular_force_sum = std::accumulate(std::begin(angular_forces), std::end(angular_forces), std::make_pair(0.0f, TimeUtils::FPSeconds::zero()), angular_acc);
-
-    //https://en.wikipedia.org/wiki/Verlet_integration#Velocity_Verlet
-
-    const auto new_angular_acceleration = (angular_impulse_sum + angular_force_sum.first) * inv_mass;
-    const auto t = deltaSeconds.count();
+    auto angular_force_sum = angular_impulse;
+    for(const auto& force : timed_forces) {
+        angular_force_sum += force.angular;
+    }
+    //Impulses act as a force for a single step.
+    linear_state.AddForce(CalcForceVector());
+    linear_state.SetInverseMass(inv_mass);
+    linear_state.SetLinearDamping(rigidbodyDesc.physicsDesc.linearDamping);
+    linear_impulse = Vector2::Zero;
+    angular_impulse = 0.0f;
+    angular_acceleration = angular_force_sum * inv_mass;
     dt = deltaSeconds;
+}
 
-    auto new_position = GetPosition() + GetVelocity() * dt.count() + GetAcceleration() * (dt.count() * dt.count() * 0.5f);
-    auto new_acceleration = (linear_impulse_sum + linear_force_sum.first) * inv_mass;
-    auto new_velocity = GetVelocity() + (GetAcceleration() + new_acceleration) * (dt.count() * 0.5f);
-    new_velocity *= rigidbodyDesc.physicsDesc.linearDamping;
-
-    {
-        const bool is_near_zero = MathUtils::IsEquivalentToZero(new_position);
-        const bool is_inf = (std::isinf(new_position.x) || std::isinf(new_position.y));
-        const bool is_nan = (std::isnan(new_position.x) || std::isnan(new_position.y));
-        const bool should_clamp = is_near_zero || is_nan || is_inf;
-        if(should_clamp) {
-            new_position = Vector2::Zero;
-        }
-    }
-    {
-        const bool is_near_zero = MathUtils::IsEquivalentToZero(new_acceleration);
-        const bool is_inf = (std::isinf(new_acceleration.x) || std::isinf(new_acceleration.y));
-        const bool is_nan = (std::isnan(new_acceleration.x) || std::isnan(new_acceleration.y));
-        const bool should_clamp = is_near_zero || is_nan || is_inf;
-        if(should_clamp) {
-            new_acceleration = Vector2::Zero;
-        }
-    }
-    {
-        const bool is_near_zero = MathUtils::IsEquivalentToZero(new_velocity);
-        const bool is_inf = (std::isinf(new_velocity.x) || std::isinf(new_velocity.y));
-        const bool is_nan = (std::isnan(new_velocity.x) || std::isnan(new_velocity.y));
-        const bool should_clamp = is_near_zero || is_nan || is_inf;
-        if(should_clamp) {
-            new_velocity = Vector2::Zero;
-        }
+void RigidBody::FinishIntegration(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    if(!is_integrating) {
+        return;
     }
-
-    auto deltaPosition = position - new_position;
-    auto deltaOrientation = orientationDegrees - prev_orientationDegrees;
-    if(MathUtils::IsEquivalentToZero(deltaPosition)
-       && MathUtils::IsEquivalentToZero(deltaOrientation)) {
-        time_since_last_move += dt;
-    } else {
-        time_since_last_move = TimeUtils::FPSeconds{0.0f};
+    const auto t = deltaSeconds.count();
+    const auto position = GetPosition();
+    if(MathUtils::IsEquivalentToZero(GetVelocity())) {
+        SetVelocity(Vector2::Zero);
     }
-    is_awake = time_since_last_move < TimeUtils::FPSeconds{1.0f};
-
-    SetPosition(new_position);
-    SetVelocity(new_velocity);
-    SetAcceleration(new_acceleration);
 
     const auto& maxAngularSpeed = rigidbodyDesc.physicsDesc.maxAngularSpeed;
     auto new_angular_velocity = std::clamp((2.0f * orientationDegrees - prev_orientationDegrees) / dt.count(), -maxAngularSpeed, maxAngularSpeed);
@@ -129,49 +89,113 @@ void RigidBody::Update(TimeUtils::FPSeconds deltaSeconds) {
             new_angular_velocity = 0.0f;
         }
     }
-    const auto new_orientationDegrees = MathUtils::Wrap(new_angular_velocity + new_angular_acceleration * t * t, 0.0f, 360.0f);
+    const auto new_orientationDegrees = MathUtils::Wrap(new_angular_velocity + angular_acceleration * t * t, 0.0f, 360.0f);
     prev_orientationDegrees = orientationDegrees;
     orientationDegrees = new_orientationDegrees;
 
     if(auto* const collider = GetCollider(); collider != nullptr) {
-        const auto S = Matrix4::CreateScaleMatrix(collider->GetHalfExtents());
-        const auto R = Matrix4::Create2DRotationDegreesMatrix(orientationDegrees);
-        const auto T = Matrix4::CreateTranslationMatrix(position);
-        const auto M = Matrix4::MakeSRT(S, R, T);
-        auto new_transform = Matrix4::I;
-        if(!parent) {
-            new_transform = M;
-        } else {
-            auto p = parent;
-            while(p) {
-                new_transform = Matrix4::MakeRT(p->GetParentTransform(), M);
-                p = p->parent;
-            }
-        }
-        transform = new_transform;
+        transform = CalcTransform(position, orientationDegrees);
         collider->SetPosition(position);
         collider->SetOrientationDegrees(orientationDegrees);
     }
 
-    for(auto& force : linear_forces) {
-        force.second -= deltaSeconds;
+    for(auto& force : timed_forces) {
+        force.remaining -= deltaSeconds;
     }
-    for(auto& force : angular_forces) {
-        force.second -= deltaSeconds;
+    //Several fixed steps can run per frame, so expired forces are dropped here rather than only in BeginFrame.
+    timed_forces.erase(std::remove_if(timed_forces.begin(), timed_forces.end(), [](const TimedForce& force) { return force.remaining.count() <= 0.0f; }), timed_forces.end());
+}
+
+void RigidBody::BeginStep() noexcept {
+    step_start_position = GetPosition();
+    step_start_orientationDegrees = orientationDegrees;
+}
+
+Matrix4 RigidBody::CalcTransform(const Vector2& position, float orientation) const noexcept {
+    const auto* const collider = GetCollider();
+    if(!collider) {
+        return Matrix4::I;
+    }
+    const auto S = Matrix4::CreateScaleMatrix(collider->GetHalfExtents());
+    const auto R = Matrix4::Create2DRotationDegreesMatrix(orientation);
+    const auto T = Matrix4::CreateTranslationMatrix(position);
+    const auto M = Matrix4::MakeSRT(S, R, T);
+    auto new_transform = M;
+    auto p = parent;
+    while(p) {
+        new_transform = Matrix4::MakeRT(p->GetParentTransform(), M);
+        p = p->parent;
+    }
+    return new_transform;
+}
+
+void RigidBody::SetSweptState(const Vector2& position, const Vector2& velocity) noexcept {
+    linear_state.SetPosition(position);
+    linear_state.SetVelocity(velocity);
+    if(auto* const collider = GetCollider(); collider != nullptr) {
+        transform = CalcTransform(position, orientationDegrees);
+        collider->SetPosition(position);
+    }
+}
+
+RigidBody::SnapshotState RigidBody::GetSnapshotState() const noexcept {
+    SnapshotState state{};
+    const auto linear = linear_state.Get();
+    state.position = linear.position;
+    state.velocity = linear.velocity;
+    state.acceleration = linear.acceleration;
+    state.step_start_position = step_start_position;
+    state.rest_position = rest_position;
+    state.linear_impulse = linear_impulse;
+    state.orientationDegrees = orientationDegrees;
+    state.prev_orientationDegrees = prev_orientationDegrees;
+    state.step_start_orientationDegrees = step_start_orientationDegrees;
+    state.rest_orientationDegrees = rest_orientationDegrees;
+    state.angular_acceleration = angular_acceleration;
+    state.angular_impulse = angular_impulse;
+    state.dt = dt.count();
+    state.time_since_last_move = time_since_last_move.count();
+    state.sleep_island = sleep_island;
+    state.is_awake = is_awake ? 1u : 0u;
+    return state;
+}
+
+void RigidBody::SetSnapshotState(const SnapshotState& state) noexcept {
+    linear_state.SetPosition(state.position);
+    linear_state.SetVelocity(state.velocity);
+    linear_state.SetAcceleration(state.acceleration);
+    step_start_position = state.step_start_position;
+    rest_position = state.rest_position;
+    linear_impulse = state.linear_impulse;
+    orientationDegrees = state.orientationDegrees;
+    prev_orientationDegrees = state.prev_orientationDegrees;
+    step_start_orientationDegrees = state.step_start_orientationDegrees;
+    rest_orientationDegrees = state.rest_orientationDegrees;
+    angular_acceleration = state.angular_acceleration;
+    angular_impulse = state.angular_impulse;
+    dt = TimeUtils::FPSeconds{state.dt};
+    time_since_last_move = TimeUtils::FPSeconds{state.time_since_last_move};
+    sleep_island = state.sleep_island;
+    is_awake = state.is_awake != 0u;
+    if(auto* const collider = GetCollider(); collider != nullptr) {
+        transform = CalcTransform(state.position, orientationDegrees);
+        collider->SetPosition(state.position);
+        collider->SetOrientationDegrees(orientationDegrees);
     }
 }
 
-void RigidBody::DebugRender() const {
+void RigidBody::DebugRender(float interpolation /*= 1.0f*/) const {
     auto& renderer = ServiceLocator::get<IRendererService>();
     if(auto* const collider = GetCollider(); collider != nullptr) {
+        const auto orientation = GetInterpolatedOrientationDegrees(interpolation);
         const auto he = this->GetBounds().half_extents * 2.0f;
         const auto S = Matrix4::CreateScaleMatrix(he);
-        const auto R = Matrix4::Create2DRotationDegreesMatrix(GetOrientationDegrees());
-        const auto T = Matrix4::CreateTranslationMatrix(GetPosition());
+        const auto R = Matrix4::Create2DRotationDegreesMatrix(orientation);
+        const auto T = Matrix4::CreateTranslationMatrix(GetInterpolatedPosition(interpolation));
         const auto M = Matrix4::MakeSRT(S, R, T);
         renderer.SetModelMatrix(M);
         collider->DebugRender();
-        renderer.DrawOBB2(GetOrientationDegrees(), Rgba::Green);
+        renderer.DrawOBB2(orientation, Rgba::Green);
     }
 }
 
@@ -194,6 +218,10 @@ void RigidBody::EnableDrag(bool enabled) {
     rigidbodyDesc.physicsDesc.enableDrag = IsDynamic() && enabled;
 }
 
+void RigidBody::EnableContinuousCollision(bool enabled) {
+    rigidbodyDesc.physicsDesc.enableContinuousCollision = IsDynamic() && enabled;
+}
+
 bool RigidBody::IsPhysicsEnabled() const {
     return rigidbodyDesc.physicsDesc.enablePhysics;
 }
@@ -206,6 +234,10 @@ bool RigidBody::IsDragEnabled() const {
     return IsDynamic() && rigidbodyDesc.physicsDesc.enableDrag;
 }
 
+bool RigidBody::IsContinuousCollisionEnabled() const {
+    return IsDynamic() && rigidbodyDesc.physicsDesc.enableContinuousCollision;
+}
+
 bool RigidBody::IsDynamic() const noexcept {
     return rigidbodyDesc.collider != nullptr;
 }
@@ -226,6 +258,10 @@ bool RigidBody::IsAwake() const {
     return IsDynamic() && is_awake;
 }
 
+bool RigidBody::IsSimulated() const noexcept {
+    return IsPhysicsEnabled() && IsAwake() && !MathUtils::IsEquivalentToZero(GetInverseMass());
+}
+
 float RigidBody::GetMass() const {
     return rigidbodyDesc.physicsDesc.mass;
 }
@@ -246,7 +282,7 @@ Matrix4 RigidBody::GetParentTransform() const {
 
 void RigidBody::ApplyImpulse(const Vector2& impulse) {
     SetAwake(true);
-    linear_impulses.push_back(impulse);
+    linear_impulse += impulse;
 }
 
 void RigidBody::ApplyImpulse(const Vector2& direction, float magnitude) {
@@ -255,7 +291,7 @@ void RigidBody::ApplyImpulse(const Vector2& direction, float magnitude) {
 
 void RigidBody::ApplyForce(const Vector2& force, const TimeUtils::FPSeconds& duration) {
     SetAwake(true);
-    linear_forces.push_back(std::make_pair(force, duration));
+    timed_forces.push_back(TimedForce{force, 0.0f, duration});
 }
 
 void RigidBody::ApplyForce(const Vector2& direction, float magnitude, const TimeUtils::FPSeconds& duration) {
@@ -266,9 +302,9 @@ void RigidBody::ApplyTorque(float force, const TimeUtils::FPSeconds& duration) {
     SetAwake(true);
     if(!IsRotationLocked()) {
         if(duration == TimeUtils::FPSeconds::zero()) {
-            angular_impulses.push_back(force);
+            angular_impulse += force;
         } else {
-            angular_forces.push_back(std::make_pair(force, duration));
+            timed_forces.push_back(TimedForce{Vector2::Zero, force, duration});
         }
     }
 }
@@ -280,14 +316,14 @@ void RigidBody::ApplyTorqueAt(const Vector2& position_on_object, const Vector2&
 void RigidBody::ApplyTorqueAt(const Vector2& position_on_object, const Vector2& force, const TimeUtils::FPSeconds& duration) {
     if(auto* const collider = GetCollider(); collider != nullptr) {
         const auto point_of_collision = MathUtils::CalcClosestPoint(position_on_object, *collider);
-        const auto r = position - point_of_collision;
+        const auto r = GetPosition() - point_of_collision;
         const auto torque = MathUtils::CrossProduct(force, r);
         ApplyTorque(torque, duration);
     }
 }
 
 void RigidBody::ApplyTorque(const Vector2& direction, float magnitude, const TimeUtils::FPSeconds& duration) {
-    ApplyTorqueAt(position, direction * magnitude, duration);
+    ApplyTorqueAt(GetPosition(), direction * magnitude, duration);
 }
 
 void RigidBody::ApplyForceAt(const Vector2& position_on_object, const Vector2& direction, float magnitude, const TimeUtils::FPSeconds& duration) {
@@ -297,9 +333,9 @@ void RigidBody::ApplyForceAt(const Vector2& position_on_object, const Vector2& d
 void RigidBody::ApplyForceAt(const Vector2& position_on_object, const Vector2& force, const TimeUtils::FPSeconds& duration) {
     if(auto* const collider = GetCollider(); collider != nullptr) {
         const auto point_of_collision = MathUtils::CalcClosestPoint(position_on_object, *collider);
-        auto r = position - point_of_collision;
+        auto r = GetPosition() - point_of_collision;
         if(MathUtils::IsEquivalentToZero(r)) {
-            r = position;
+            r = GetPosition();
         }
         const auto&& [parallel, perpendicular] = MathUtils::DivideIntoProjectAndReject(force, r);
         const auto angular_result = force - parallel;
@@ -316,7 +352,7 @@ void RigidBody::ApplyImpulseAt(const Vector2& position_on_object, const Vector2&
 void RigidBody::ApplyImpulseAt(const Vector2& position_on_object, const Vector2& force) {
     if(auto* const collider = GetCollider(); collider != nullptr) {
         const auto point_of_collision = MathUtils::CalcClosestPoint(position_on_object, *collider);
-        const auto r = position - point_of_collision;
+        const auto r = GetPosition() - point_of_collision;
         const auto&& [parallel, perpendicular] = MathUtils::DivideIntoProjectAndReject(force, r);
         const auto angular_result = force - parallel;
         const auto linear_result = force - perpendicular;
@@ -326,7 +362,7 @@ void RigidBody::ApplyImpulseAt(const Vector2& position_on_object, const Vector2&
 }
 
 const OBB2 RigidBody::GetBounds() const {
-    const auto& center = GetPosition();
+    const auto center = GetPosition();
     const auto dims = CalcDimensions();
     const auto orientation = GetOrientationDegrees();
     return OBB2(center, dims * 0.5f, orientation);
@@ -334,27 +370,27 @@ const OBB2 RigidBody::GetBounds() const {
 
 void RigidBody::SetPosition(const Vector2& newPosition, bool teleport /*= false*/) noexcept {
     if(teleport) {
-        position = newPosition;
+        step_start_position = newPosition;
     } else {
         Wake();
-        position = newPosition;
     }
+    linear_state.SetPosition(newPosition);
 }
 
-const Vector2& RigidBody::GetPosition() const {
-    return position;
+Vector2 RigidBody::GetPosition() const {
+    return linear_state.GetPosition();
 }
 
 void RigidBody::SetVelocity(const Vector2& newVelocity) noexcept {
-    velocity = newVelocity;
+    linear_state.SetVelocity(newVelocity);
 }
 
-const Vector2& RigidBody::GetVelocity() const {
-    return velocity;
+Vector2 RigidBody::GetVelocity() const {
+    return linear_state.GetVelocity();
 }
 
-const Vector2& RigidBody::GetAcceleration() const {
-    return acceleration;
+Vector2 RigidBody::GetAcceleration() const {
+    return linear_state.GetAcceleration();
 }
 
 Vector2 RigidBody::CalcDimensions() const {
@@ -376,6 +412,25 @@ float RigidBody::GetAngularAccelerationDegrees() const {
     return angular_acceleration;
 }
 
+Vector2 RigidBody::GetInterpolatedPosition(float alpha) const noexcept {
+    return MathUtils::Interpolate(step_start_position, GetPosition(), alpha);
+}
+
+float RigidBody::GetInterpolatedOrientationDegrees(float alpha) const noexcept {
+    //Blend along the short way around so 359 to 1 degrees does not spin backwards.
+    auto difference = orientationDegrees - step_start_orientationDegrees;
+    if(180.0f < difference) {
+        difference -= 360.0f;
+    } else if(difference < -180.0f) {
+        difference += 360.0f;
+    }
+    return MathUtils::Wrap(step_start_orientationDegrees + difference * alpha, 0.0f, 360.0f);
+}
+
+Matrix4 RigidBody::CalcInterpolatedTransform(float alpha) const noexcept {
+    return CalcTransform(GetInterpolatedPosition(alpha), GetInterpolatedOrientationDegrees(alpha));
+}
+
 const Collider* RigidBody::GetCollider() const noexcept {
     return rigidbodyDesc.collider;
 }
@@ -401,16 +456,13 @@ void RigidBody::LockRotation(bool shouldLockRotation) noexcept {
 }
 
 void RigidBody::SetAcceleration(const Vector2& newAccleration) noexcept {
-    acceleration = newAccleration;
+    linear_state.SetAcceleration(newAccleration);
 }
 
 Vector2 RigidBody::CalcForceVector() noexcept {
-    const auto inv_mass = GetInverseMass();
-    const auto linear_impulse_sum = std::accumulate(std::begin(linear_impulses), std::end(linear_impulses), Vector2::Zero);
-
-    using LinearForceType = typename std::decay<decltype(*linear_forces.begin())>::type;
-    const auto linear_acc = [](const LinearForceType& a, const LinearForceType& b) { return std::make_pair(a.first + b.first, TimeUtils::FPSeconds::zero()); };
-    const auto linear_force_sum = std::accumulate(std::begin(linear_forces), std::end(linear_forces), std::make_pair(Vector2::Zero, TimeUtils::FPSeconds::zero()), linear_acc);
-
-    return linear_impulse_sum + linear_force_sum.first;
+    auto force_sum = linear_impulse;
+    for(const auto& force : timed_forces) {
+        force_sum += force.linear;
+    }
+    return force_sum;
 }
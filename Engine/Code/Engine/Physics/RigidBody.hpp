@@ -4,7 +4,9 @@
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Physics/Collider.hpp"
 #include "Engine/Physics/PhysicsTypes.hpp"
+#include "Engine/Physics/RigidBodyStore.hpp"
 
+#include <cstdint>
 #include <memory>
 
 struct RigidBodyDesc {
@@ -95,21 +97,27 @@ public:
 
     void BeginFrame();
     void Update(TimeUtils::FPSeconds deltaSeconds);
-    void DebugRender() const;
+    //interpolation blends from the previous physics step's pose (0) to the current one (1).
+    void DebugRender(float interpolation = 1.0f) const;
     void Endframe();
 
     void EnablePhysics(bool enabled);
     void EnableGravity(bool enabled);
     void EnableDrag(bool enabled);
+    //Fast bodies are swept along their motion each step so they cannot pass through thin colliders; costs a time of impact search per nearby body.
+    void EnableContinuousCollision(bool enabled);
     [[nodiscard]] bool IsPhysicsEnabled() const;
     [[nodiscard]] bool IsGravityEnabled() const;
     [[nodiscard]] bool IsDragEnabled() const;
+    [[nodiscard]] bool IsContinuousCollisionEnabled() const;
     [[nodiscard]] bool IsDynamic() const noexcept;
 
     void SetAwake(bool awake) noexcept;
     void Wake() noexcept;
     void Sleep() noexcept;
     [[nodiscard]] bool IsAwake() const;
+    //Awake, physics enabled and with finite mass, i.e. moved by integration this step.
+    [[nodiscard]] bool IsSimulated() const noexcept;
 
     [[nodiscard]] float GetMass() const;
     [[nodiscard]] float GetInverseMass() const;
@@ -139,17 +147,22 @@ public:
     [[nodiscard]] const OBB2 GetBounds() const;
 
     void SetPosition(const Vector2& newPosition, bool teleport = false) noexcept;
-    [[nodiscard]] const Vector2& GetPosition() const;
+    [[nodiscard]] Vector2 GetPosition() const;
 
     void SetVelocity(const Vector2& newVelocity) noexcept;
-    [[nodiscard]] const Vector2& GetVelocity() const;
+    [[nodiscard]] Vector2 GetVelocity() const;
 
-    [[nodiscard]] const Vector2& GetAcceleration() const;
+    [[nodiscard]] Vector2 GetAcceleration() const;
     [[nodiscard]] Vector2 CalcDimensions() const;
     [[nodiscard]] float GetOrientationDegrees() const;
     [[nodiscard]] float GetAngularVelocityDegrees() const;
     [[nodiscard]] float GetAngularAccelerationDegrees() const;
 
+    //Pose blended between the start and end of the last physics step; see IPhysicsService::GetInterpolationAlpha.
+    [[nodiscard]] Vector2 GetInterpolatedPosition(float alpha) const noexcept;
+    [[nodiscard]] float GetInterpolatedOrientationDegrees(float alpha) const noexcept;
+    [[nodiscard]] Matrix4 CalcInterpolatedTransform(float alpha) const noexcept;
+
     [[nodiscard]] const Collider* GetCollider() const noexcept;
     [[nodiscard]] Collider* GetCollider() noexcept;
 
@@ -160,24 +173,67 @@ public:
 
 protected:
 private:
+    struct TimedForce {
+        Vector2 linear{};
+        float angular = 0.0f;
+        TimeUtils::FPSeconds remaining{};
+    };
+    //Everything a physics step reads or changes, laid out without padding so PhysicsSystem can snapshot it as raw bytes.
+    struct SnapshotState {
+        Vector2 position{};
+        Vector2 velocity{};
+        Vector2 acceleration{};
+        Vector2 step_start_position{};
+        Vector2 rest_position{};
+        Vector2 linear_impulse{};
+        float orientationDegrees = 0.0f;
+        float prev_orientationDegrees = 0.0f;
+        float step_start_orientationDegrees = 0.0f;
+        float rest_orientationDegrees = 0.0f;
+        float angular_acceleration = 0.0f;
+        float angular_impulse = 0.0f;
+        float dt = 0.0f;
+        float time_since_last_move = 0.0f;
+        std::uint32_t sleep_island = 0u;
+        std::uint32_t is_awake = 0u;
+    };
+
     void SetAcceleration(const Vector2& newAccleration) noexcept;
+    //Update is split around the linear integration so PhysicsSystem can step every body's linear state in SIMD batches.
+    void PrepareIntegration(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void FinishIntegration(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    //Remembers the current pose as the start of the next fixed step for interpolation.
+    void BeginStep() noexcept;
+    [[nodiscard]] Matrix4 CalcTransform(const Vector2& position, float orientation) const noexcept;
+    //Moves the body back to where its sweep hit something, with the velocity it leaves the impact with.
+    void SetSweptState(const Vector2& position, const Vector2& velocity) noexcept;
+    [[nodiscard]] SnapshotState GetSnapshotState() const noexcept;
+    //Puts the body back in a saved state; the collider and transform follow. Timed forces are restored separately.
+    void SetSnapshotState(const SnapshotState& state) noexcept;
 
     RigidBodyDesc rigidbodyDesc{};
     RigidBody* parent = nullptr;
     std::vector<RigidBody*> children{};
-    Vector2 position{};
-    Vector2 velocity{};
-    Vector2 acceleration{};
+    //Position, velocity and acceleration; lives in PhysicsSystem's RigidBodyStore while the body is added to it.
+    RigidBodyState linear_state{};
+    Vector2 step_start_position{};
+    float step_start_orientationDegrees = 0.0f;
     float prev_orientationDegrees = 0.0f;
     float orientationDegrees = 0.0f;
     float angular_acceleration = 0.0f;
     TimeUtils::FPSeconds dt{};
+    //Sleep bookkeeping, owned by PhysicsSystem's island pass.
+    static constexpr std::uint32_t not_sleeping = static_cast<std::uint32_t>(-1);
     TimeUtils::FPSeconds time_since_last_move{};
-    std::vector<std::pair<Vector2, TimeUtils::FPSeconds>> linear_forces{};
-    std::vector<Vector2> linear_impulses{};
-    std::vector<std::pair<float, TimeUtils::FPSeconds>> angular_forces{};
-    std::vector<float> angular_impulses{};
+    Vector2 rest_position{};
+    float rest_orientationDegrees = 0.0f;
+    std::uint32_t system_index = 0u;
+    std::uint32_t sleep_island = not_sleeping;
+    std::vector<TimedForce> timed_forces{};
+    Vector2 linear_impulse{};
+    float angular_impulse = 0.0f;
     bool is_colliding = false;
+    bool is_integrating = false;
     bool is_awake = true;
     bool should_kill = false;
     bool should_lock_rotation = false;
@@ -0,0 +1,449 @@
+#include "Engine/Physics/RigidBodyStore.hpp"
+
+#include <utility>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+//NaN and infinity are the only values for which v - v is not zero.
+[[nodiscard]] float ZeroIfNotFinite(float value) noexcept {
+    return value - value == 0.0f ? value : 0.0f;
+}
+
+#if defined(_M_X64) || defined(__SSE2__)
+[[nodiscard]] __m128 ZeroIfNotFinite(__m128 value) noexcept {
+    return _mm_and_ps(value, _mm_cmpeq_ps(_mm_sub_ps(value, value), _mm_setzero_ps()));
+}
+
+[[nodiscard]] __m128 Select(__m128 mask, __m128 if_set, __m128 if_clear) noexcept {
+    return _mm_or_ps(_mm_and_ps(mask, if_set), _mm_andnot_ps(mask, if_clear));
+}
+#endif
+
+} // namespace
+
+void RigidBodyStore::Step(BodyState& state, const Vector2& force, float deltaSeconds) noexcept {
+    //Same operations in the same order as the SIMD path so both produce identical results.
+    const auto ax = force.x * state.inverse_mass;
+    const auto ay = force.y * state.inverse_mass;
+    const auto vx = (state.velocity.x + ax * deltaSeconds) * state.linear_damping;
+    const auto vy = (state.velocity.y + ay * deltaSeconds) * state.linear_damping;
+    const auto px = state.position.x + vx * deltaSeconds;
+    const auto py = state.position.y + vy * deltaSeconds;
+    state.acceleration = Vector2{ZeroIfNotFinite(ax), ZeroIfNotFinite(ay)};
+    state.velocity = Vector2{ZeroIfNotFinite(vx), ZeroIfNotFinite(vy)};
+    state.position = Vector2{ZeroIfNotFinite(px), ZeroIfNotFinite(py)};
+}
+
+RigidBodyStore::Handle RigidBodyStore::Add(const BodyState& state) noexcept {
+    const auto index = static_cast<std::uint32_t>(_handles.size());
+    auto handle = null_handle;
+    if(_free_handles.empty()) {
+        handle = static_cast<Handle>(_indices.size());
+        _indices.push_back(index);
+    } else {
+        handle = _free_handles.back();
+        _free_handles.pop_back();
+        _indices[handle] = index;
+    }
+    _handles.push_back(handle);
+    _position_x.push_back(state.position.x);
+    _position_y.push_back(state.position.y);
+    _velocity_x.push_back(state.velocity.x);
+    _velocity_y.push_back(state.velocity.y);
+    _acceleration_x.push_back(state.acceleration.x);
+    _acceleration_y.push_back(state.acceleration.y);
+    _force_x.push_back(0.0f);
+    _force_y.push_back(0.0f);
+    _inverse_mass.push_back(state.inverse_mass);
+    _linear_damping.push_back(state.linear_damping);
+    _active.push_back(0xFFFFFFFFu);
+    return handle;
+}
+
+void RigidBodyStore::Remove(Handle handle) noexcept {
+    const auto index = _indices[handle];
+    const auto last = _handles.size() - 1u;
+    const auto move_last = [index, last](auto& field) {
+        field[index] = field[last];
+        field.pop_back();
+    };
+    move_last(_position_x);
+    move_last(_position_y);
+    move_last(_velocity_x);
+    move_last(_velocity_y);
+    move_last(_acceleration_x);
+    move_last(_acceleration_y);
+    move_last(_force_x);
+    move_last(_force_y);
+    move_last(_inverse_mass);
+    move_last(_linear_damping);
+    move_last(_active);
+    move_last(_handles);
+    if(index != last) {
+        _indices[_handles[index]] = index;
+    }
+    _indices[handle] = static_cast<std::uint32_t>(-1);
+    _free_handles.push_back(handle);
+}
+
+void RigidBodyStore::Clear() noexcept {
+    _position_x.clear();
+    _position_y.clear();
+    _velocity_x.clear();
+    _velocity_y.clear();
+    _acceleration_x.clear();
+    _acceleration_y.clear();
+    _force_x.clear();
+    _force_y.clear();
+    _inverse_mass.clear();
+    _linear_damping.clear();
+    _active.clear();
+    _handles.clear();
+    _indices.clear();
+    _free_handles.clear();
+}
+
+RigidBodyStore::BodyState RigidBodyStore::GetState(Handle handle) const noexcept {
+    const auto index = _indices[handle];
+    BodyState state{};
+    state.position = Vector2{_position_x[index], _position_y[index]};
+    state.velocity = Vector2{_velocity_x[index], _velocity_y[index]};
+    state.acceleration = Vector2{_acceleration_x[index], _acceleration_y[index]};
+    state.inverse_mass = _inverse_mass[index];
+    state.linear_damping = _linear_damping[index];
+    return state;
+}
+
+Vector2 RigidBodyStore::GetPosition(Handle handle) const noexcept {
+    const auto index = _indices[handle];
+    return Vector2{_position_x[index], _position_y[index]};
+}
+
+void RigidBodyStore::SetPosition(Handle handle, const Vector2& position) noexcept {
+    const auto index = _indices[handle];
+    _position_x[index] = position.x;
+    _position_y[index] = position.y;
+}
+
+Vector2 RigidBodyStore::GetVelocity(Handle handle) const noexcept {
+    const auto index = _indices[handle];
+    return Vector2{_velocity_x[index], _velocity_y[index]};
+}
+
+void RigidBodyStore::SetVelocity(Handle handle, const Vector2& velocity) noexcept {
+    const auto index = _indices[handle];
+    _velocity_x[index] = velocity.x;
+    _velocity_y[index] = velocity.y;
+}
+
+Vector2 RigidBodyStore::GetAcceleration(Handle handle) const noexcept {
+    const auto index = _indices[handle];
+    return Vector2{_acceleration_x[index], _acceleration_y[index]};
+}
+
+void RigidBodyStore::SetAcceleration(Handle handle, const Vector2& acceleration) noexcept {
+    const auto index = _indices[handle];
+    _acceleration_x[index] = acceleration.x;
+    _acceleration_y[index] = acceleration.y;
+}
+
+void RigidBodyStore::SetInverseMass(Handle handle, float inverse_mass) noexcept {
+    _inverse_mass[_indices[handle]] = inverse_mass;
+}
+
+void RigidBodyStore::SetLinearDamping(Handle handle, float linear_damping) noexcept {
+    _linear_damping[_indices[handle]] = linear_damping;
+}
+
+void RigidBodyStore::SetActive(Handle handle, bool active) noexcept {
+    _active[_indices[handle]] = active ? 0xFFFFFFFFu : 0u;
+}
+
+void RigidBodyStore::AddForce(Handle handle, const Vector2& force) noexcept {
+    const auto index = _indices[handle];
+    _force_x[index] += force.x;
+    _force_y[index] += force.y;
+}
+
+void RigidBodyStore::Integrate(float deltaSeconds) noexcept {
+    Integrate(deltaSeconds, 0u, size());
+}
+
+void RigidBodyStore::Integrate(float deltaSeconds, std::size_t first, std::size_t last) noexcept {
+    auto i = first;
+#if defined(_M_X64) || defined(__SSE2__)
+    const auto dt = _mm_set1_ps(deltaSeconds);
+    const auto zero = _mm_setzero_ps();
+    for(; i + simd_width <= last; i += simd_width) {
+        const auto active = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_active.data() + i)));
+        const auto inverse_mass = _mm_loadu_ps(_inverse_mass.data() + i);
+        const auto damping = _mm_loadu_ps(_linear_damping.data() + i);
+        const auto ax = _mm_mul_ps(_mm_loadu_ps(_force_x.data() + i), inverse_mass);
+        const auto ay = _mm_mul_ps(_mm_loadu_ps(_force_y.data() + i), inverse_mass);
+        const auto old_vx = _mm_loadu_ps(_velocity_x.data() + i);
+        const auto old_vy = _mm_loadu_ps(_velocity_y.data() + i);
+        const auto vx = _mm_mul_ps(_mm_add_ps(old_vx, _mm_mul_ps(ax, dt)), damping);
+        const auto vy = _mm_mul_ps(_mm_add_ps(old_vy, _mm_mul_ps(ay, dt)), damping);
+        const auto old_px = _mm_loadu_ps(_position_x.data() + i);
+        const auto old_py = _mm_loadu_ps(_position_y.data() + i);
+        const auto px = _mm_add_ps(old_px, _mm_mul_ps(vx, dt));
+        const auto py = _mm_add_ps(old_py, _mm_mul_ps(vy, dt));
+        _mm_storeu_ps(_acceleration_x.data() + i, Select(active, ZeroIfNotFinite(ax), _mm_loadu_ps(_acceleration_x.data() + i)));
+        _mm_storeu_ps(_acceleration_y.data() + i, Select(active, ZeroIfNotFinite(ay), _mm_loadu_ps(_acceleration_y.data() + i)));
+        _mm_storeu_ps(_velocity_x.data() + i, Select(active, ZeroIfNotFinite(vx), old_vx));
+        _mm_storeu_ps(_velocity_y.data() + i, Select(active, ZeroIfNotFinite(vy), old_vy));
+        _mm_storeu_ps(_position_x.data() + i, Select(active, ZeroIfNotFinite(px), old_px));
+        _mm_storeu_ps(_position_y.data() + i, Select(active, ZeroIfNotFinite(py), old_py));
+        _mm_storeu_ps(_force_x.data() + i, zero);
+        _mm_storeu_ps(_force_y.data() + i, zero);
+    }
+#endif
+    for(; i < last; ++i) {
+        IntegrateScalar(i, deltaSeconds);
+    }
+}
+
+void RigidBodyStore::IntegrateBody(Handle handle, float deltaSeconds) noexcept {
+    IntegrateScalar(_indices[handle], deltaSeconds);
+}
+
+void RigidBodyStore::IntegrateVelocities(float deltaSeconds, std::size_t first, std::size_t last) noexcept {
+    auto i = first;
+#if defined(_M_X64) || defined(__SSE2__)
+    const auto dt = _mm_set1_ps(deltaSeconds);
+    const auto zero = _mm_setzero_ps();
+    for(; i + simd_width <= last; i += simd_width) {
+        const auto active = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_active.data() + i)));
+        const auto inverse_mass = _mm_loadu_ps(_inverse_mass.data() + i);
+        const auto damping = _mm_loadu_ps(_linear_damping.data() + i);
+        const auto ax = _mm_mul_ps(_mm_loadu_ps(_force_x.data() + i), inverse_mass);
+        const auto ay = _mm_mul_ps(_mm_loadu_ps(_force_y.data() + i), inverse_mass);
+        const auto old_vx = _mm_loadu_ps(_velocity_x.data() + i);
+        const auto old_vy = _mm_loadu_ps(_velocity_y.data() + i);
+        const auto vx = _mm_mul_ps(_mm_add_ps(old_vx, _mm_mul_ps(ax, dt)), damping);
+        const auto vy = _mm_mul_ps(_mm_add_ps(old_vy, _mm_mul_ps(ay, dt)), damping);
+        _mm_storeu_ps(_acceleration_x.data() + i, Select(active, ZeroIfNotFinite(ax), _mm_loadu_ps(_acceleration_x.data() + i)));
+        _mm_storeu_ps(_acceleration_y.data() + i, Select(active, ZeroIfNotFinite(ay), _mm_loadu_ps(_acceleration_y.data() + i)));
+        _mm_storeu_ps(_velocity_x.data() + i, Select(active, ZeroIfNotFinite(vx), old_vx));
+        _mm_storeu_ps(_velocity_y.data() + i, Select(active, ZeroIfNotFinite(vy), old_vy));
+        _mm_storeu_ps(_force_x.data() + i, zero);
+        _mm_storeu_ps(_force_y.data() + i, zero);
+    }
+#endif
+    for(; i < last; ++i) {
+        if(_active[i]) {
+            const auto ax = _force_x[i] * _inverse_mass[i];
+            const auto ay = _force_y[i] * _inverse_mass[i];
+            const auto vx = (_velocity_x[i] + ax * deltaSeconds) * _linear_damping[i];
+            const auto vy = (_velocity_y[i] + ay * deltaSeconds) * _linear_damping[i];
+            _acceleration_x[i] = ZeroIfNotFinite(ax);
+            _acceleration_y[i] = ZeroIfNotFinite(ay);
+            _velocity_x[i] = ZeroIfNotFinite(vx);
+            _velocity_y[i] = ZeroIfNotFinite(vy);
+        }
+        _force_x[i] = 0.0f;
+        _force_y[i] = 0.0f;
+    }
+}
+
+void RigidBodyStore::IntegratePositions(float deltaSeconds, std::size_t first, std::size_t last) noexcept {
+    auto i = first;
+#if defined(_M_X64) || defined(__SSE2__)
+    const auto dt = _mm_set1_ps(deltaSeconds);
+    for(; i + simd_width <= last; i += simd_width) {
+        const auto active = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_active.data() + i)));
+        const auto old_px = _mm_loadu_ps(_position_x.data() + i);
+        const auto old_py = _mm_loadu_ps(_position_y.data() + i);
+        const auto px = _mm_add_ps(old_px, _mm_mul_ps(_mm_loadu_ps(_velocity_x.data() + i), dt));
+        const auto py = _mm_add_ps(old_py, _mm_mul_ps(_mm_loadu_ps(_velocity_y.data() + i), dt));
+        _mm_storeu_ps(_position_x.data() + i, Select(active, ZeroIfNotFinite(px), old_px));
+        _mm_storeu_ps(_position_y.data() + i, Select(active, ZeroIfNotFinite(py), old_py));
+    }
+#endif
+    for(; i < last; ++i) {
+        if(_active[i]) {
+            _position_x[i] = ZeroIfNotFinite(_position_x[i] + _velocity_x[i] * deltaSeconds);
+            _position_y[i] = ZeroIfNotFinite(_position_y[i] + _velocity_y[i] * deltaSeconds);
+        }
+    }
+}
+
+void RigidBodyStore::IntegrateScalar(std::size_t index, float deltaSeconds) noexcept {
+    if(_active[index]) {
+        BodyState state{};
+        state.position = Vector2{_position_x[index], _position_y[index]};
+        state.velocity = Vector2{_velocity_x[index], _velocity_y[index]};
+        state.inverse_mass = _inverse_mass[index];
+        state.linear_damping = _linear_damping[index];
+        Step(state, Vector2{_force_x[index], _force_y[index]}, deltaSeconds);
+        _position_x[index] = state.position.x;
+        _position_y[index] = state.position.y;
+        _velocity_x[index] = state.velocity.x;
+        _velocity_y[index] = state.velocity.y;
+        _acceleration_x[index] = state.acceleration.x;
+        _acceleration_y[index] = state.acceleration.y;
+    }
+    _force_x[index] = 0.0f;
+    _force_y[index] = 0.0f;
+}
+
+std::size_t RigidBodyStore::size() const noexcept {
+    return _handles.size();
+}
+
+RigidBodyState::RigidBodyState(const RigidBodyStore::BodyState& state) noexcept
+: _detached{state} {
+    /* DO NOTHING */
+}
+
+RigidBodyState::RigidBodyState(const RigidBodyState& other) noexcept
+: _detached{other.Get()}
+, _detached_active{other._detached_active} {
+    /* DO NOTHING */
+}
+
+RigidBodyState::RigidBodyState(RigidBodyState&& other) noexcept
+: _store{std::exchange(other._store, nullptr)}
+, _handle{std::exchange(other._handle, RigidBodyStore::null_handle)}
+, _detached{other._detached}
+, _detached_force{other._detached_force}
+, _detached_active{other._detached_active} {
+    /* DO NOTHING */
+}
+
+RigidBodyState& RigidBodyState::operator=(const RigidBodyState& rhs) noexcept {
+    if(this == &rhs) {
+        return *this;
+    }
+    const auto state = rhs.Get();
+    Unbind();
+    _detached = state;
+    _detached_force = Vector2::Zero;
+    _detached_active = rhs._detached_active;
+    return *this;
+}
+
+RigidBodyState& RigidBodyState::operator=(RigidBodyState&& rhs) noexcept {
+    if(this == &rhs) {
+        return *this;
+    }
+    Unbind();
+    _store = std::exchange(rhs._store, nullptr);
+    _handle = std::exchange(rhs._handle, RigidBodyStore::null_handle);
+    _detached = rhs._detached;
+    _detached_force = rhs._detached_force;
+    _detached_active = rhs._detached_active;
+    return *this;
+}
+
+void RigidBodyState::Bind(RigidBodyStore& store) noexcept {
+    if(_store == &store) {
+        return;
+    }
+    Unbind();
+    _handle = store.Add(_detached);
+    _store = &store;
+    _store->AddForce(_handle, _detached_force);
+    _store->SetActive(_handle, _detached_active);
+    _detached_force = Vector2::Zero;
+}
+
+void RigidBodyState::Unbind() noexcept {
+    if(!_store) {
+        return;
+    }
+    _detached = _store->GetState(_handle);
+    _store->Remove(_handle);
+    _store = nullptr;
+    _handle = RigidBodyStore::null_handle;
+}
+
+bool RigidBodyState::IsBound() const noexcept {
+    return _store != nullptr;
+}
+
+RigidBodyStore::BodyState RigidBodyState::Get() const noexcept {
+    return _store ? _store->GetState(_handle) : _detached;
+}
+
+Vector2 RigidBodyState::GetPosition() const noexcept {
+    return _store ? _store->GetPosition(_handle) : _detached.position;
+}
+
+void RigidBodyState::SetPosition(const Vector2& position) noexcept {
+    if(_store) {
+        _store->SetPosition(_handle, position);
+    } else {
+        _detached.position = position;
+    }
+}
+
+Vector2 RigidBodyState::GetVelocity() const noexcept {
+    return _store ? _store->GetVelocity(_handle) : _detached.velocity;
+}
+
+void RigidBodyState::SetVelocity(const Vector2& velocity) noexcept {
+    if(_store) {
+        _store->SetVelocity(_handle, velocity);
+    } else {
+        _detached.velocity = velocity;
+    }
+}
+
+Vector2 RigidBodyState::GetAcceleration() const noexcept {
+    return _store ? _store->GetAcceleration(_handle) : _detached.acceleration;
+}
+
+void RigidBodyState::SetAcceleration(const Vector2& acceleration) noexcept {
+    if(_store) {
+        _store->SetAcceleration(_handle, acceleration);
+    } else {
+        _detached.acceleration = acceleration;
+    }
+}
+
+void RigidBodyState::SetInverseMass(float inverse_mass) noexcept {
+    if(_store) {
+        _store->SetInverseMass(_handle, inverse_mass);
+    } else {
+        _detached.inverse_mass = inverse_mass;
+    }
+}
+
+void RigidBodyState::SetLinearDamping(float linear_damping) noexcept {
+    if(_store) {
+        _store->SetLinearDamping(_handle, linear_damping);
+    } else {
+        _detached.linear_damping = linear_damping;
+    }
+}
+
+void RigidBodyState::SetActive(bool active) noexcept {
+    _detached_active = active;
+    if(_store) {
+        _store->SetActive(_handle, active);
+    }
+}
+
+void RigidBodyState::AddForce(const Vector2& force) noexcept {
+    if(_store) {
+        _store->AddForce(_handle, force);
+    } else {
+        _detached_force += force;
+    }
+}
+
+void RigidBodyState::Integrate(float deltaSeconds) noexcept {
+    if(_store) {
+        _store->IntegrateBody(_handle, deltaSeconds);
+        return;
+    }
+    if(_detached_active) {
+        RigidBodyStore::Step(_detached, _detached_force, deltaSeconds);
+    }
+    _detached_force = Vector2::Zero;
+}
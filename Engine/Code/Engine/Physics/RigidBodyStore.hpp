@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Engine/Math/Vector2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//Structure-of-arrays storage for the linear state of every simulated body.
+//Each field lives in its own contiguous array so Integrate can step several bodies per SIMD instruction.
+//Bodies are packed: removing one moves the last body into its slot, so handles stay stable but indices do not.
+class RigidBodyStore {
+public:
+    using Handle = std::uint32_t;
+    static constexpr Handle null_handle = (std::numeric_limits<Handle>::max)();
+    //Bodies stepped per SIMD instruction; batch boundaries that are multiples of this keep every batch on the SIMD path.
+    static constexpr std::size_t simd_width = 4u;
+
+    struct BodyState {
+        Vector2 position{};
+        Vector2 velocity{};
+        Vector2 acceleration{};
+        float inverse_mass = 0.0f;
+        float linear_damping = 1.0f;
+    };
+
+    //One semi-implicit Euler step; Integrate computes exactly this for every active body.
+    static void Step(BodyState& state, const Vector2& force, float deltaSeconds) noexcept;
+
+    [[nodiscard]] Handle Add(const BodyState& state) noexcept;
+    void Remove(Handle handle) noexcept;
+    void Clear() noexcept;
+
+    [[nodiscard]] BodyState GetState(Handle handle) const noexcept;
+    [[nodiscard]] Vector2 GetPosition(Handle handle) const noexcept;
+    void SetPosition(Handle handle, const Vector2& position) noexcept;
+    [[nodiscard]] Vector2 GetVelocity(Handle handle) const noexcept;
+    void SetVelocity(Handle handle, const Vector2& velocity) noexcept;
+    [[nodiscard]] Vector2 GetAcceleration(Handle handle) const noexcept;
+    void SetAcceleration(Handle handle, const Vector2& acceleration) noexcept;
+    void SetInverseMass(Handle handle, float inverse_mass) noexcept;
+    void SetLinearDamping(Handle handle, float linear_damping) noexcept;
+    //Inactive bodies keep their state when integrated.
+    void SetActive(Handle handle, bool active) noexcept;
+    //Accumulates until the body is next integrated.
+    void AddForce(Handle handle, const Vector2& force) noexcept;
+
+    //Steps every active body and clears all accumulated forces.
+    void Integrate(float deltaSeconds) noexcept;
+    //Steps the bodies packed at [first, last) so the work can be split across threads.
+    void Integrate(float deltaSeconds, std::size_t first, std::size_t last) noexcept;
+    void IntegrateBody(Handle handle, float deltaSeconds) noexcept;
+    //Integrate split in two so a solver can adjust velocities in between. Running both gives the same result as Integrate.
+    //IntegrateVelocities clears the accumulated forces of [first, last).
+    void IntegrateVelocities(float deltaSeconds, std::size_t first, std::size_t last) noexcept;
+    void IntegratePositions(float deltaSeconds, std::size_t first, std::size_t last) noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+
+protected:
+private:
+    void IntegrateScalar(std::size_t index, float deltaSeconds) noexcept;
+
+    std::vector<float> _position_x{};
+    std::vector<float> _position_y{};
+    std::vector<float> _velocity_x{};
+    std::vector<float> _velocity_y{};
+    std::vector<float> _acceleration_x{};
+    std::vector<float> _acceleration_y{};
+    std::vector<float> _force_x{};
+    std::vector<float> _force_y{};
+    std::vector<float> _inverse_mass{};
+    std::vector<float> _linear_damping{};
+    //All bits set for active bodies so the SIMD path can use it as a blend mask.
+    std::vector<std::uint32_t> _active{};
+    std::vector<Handle> _handles{};
+    std::vector<std::uint32_t> _indices{};
+    std::vector<Handle> _free_handles{};
+};
+
+//A body's linear state: kept inline until Bind moves it into a store, after which this only refers to the store's slot.
+//Copies are never bound; they get a detached copy of the current state. Unbind before the store goes away.
+class RigidBodyState {
+public:
+    RigidBodyState() noexcept = default;
+    explicit RigidBodyState(const RigidBodyStore::BodyState& state) noexcept;
+    RigidBodyState(const RigidBodyState& other) noexcept;
+    RigidBodyState(RigidBodyState&& other) noexcept;
+    RigidBodyState& operator=(const RigidBodyState& rhs) noexcept;
+    RigidBodyState& operator=(RigidBodyState&& rhs) noexcept;
+    ~RigidBodyState() noexcept = default;
+
+    void Bind(RigidBodyStore& store) noexcept;
+    void Unbind() noexcept;
+    [[nodiscard]] bool IsBound() const noexcept;
+
+    [[nodiscard]] RigidBodyStore::BodyState Get() const noexcept;
+    [[nodiscard]] Vector2 GetPosition() const noexcept;
+    void SetPosition(const Vector2& position) noexcept;
+    [[nodiscard]] Vector2 GetVelocity() const noexcept;
+    void SetVelocity(const Vector2& velocity) noexcept;
+    [[nodiscard]] Vector2 GetAcceleration() const noexcept;
+    void SetAcceleration(const Vector2& acceleration) noexcept;
+    void SetInverseMass(float inverse_mass) noexcept;
+    void SetLinearDamping(float linear_damping) noexcept;
+    void SetActive(bool active) noexcept;
+    void AddForce(const Vector2& force) noexcept;
+    //Steps only this body; bound bodies are normally stepped in batches by RigidBodyStore::Integrate.
+    void Integrate(float deltaSeconds) noexcept;
+
+protected:
+private:
+    RigidBodyStore* _store = nullptr;
+    RigidBodyStore::Handle _handle = RigidBodyStore::null_handle;
+    RigidBodyStore::BodyState _detached{};
+    Vector2 _detached_force{};
+    bool _detached_active = true;
+};
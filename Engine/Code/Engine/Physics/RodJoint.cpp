@@ -32,41 +32,7 @@ RodJoint::RodJoint(const RodJointDef& def) noexcept {
 }
 
 void RodJoint::Notify([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
-    auto* first_body = _def.rigidBodyA;
-    auto* second_body = _def.rigidBodyB;
-    if(first_body == nullptr && second_body == nullptr) {
-        return;
-    }
-
-    const auto fb_pos = _def.worldAnchorA;
-    const auto sb_pos = _def.worldAnchorB;
-
-    const auto distance = MathUtils::CalcDistance(fb_pos, sb_pos);
-    const auto displacement_towards_first = fb_pos - sb_pos;
-    const auto displacement_towards_second = sb_pos - fb_pos;
-    const auto direction_to_first = displacement_towards_first.GetNormalize();
-    const auto direction_to_second = displacement_towards_second.GetNormalize();
-    const auto m1 = (first_body ? first_body->GetMass() : 0.0f);
-    const auto m2 = (second_body ? second_body->GetMass() : 0.0f);
-    const auto mass_sum = m1 + m2;
-    const auto mass1_ratio = m1 / mass_sum;
-    const auto mass2_ratio = m2 / mass_sum;
-    const auto length = _def.length;
-    if(distance < length) { //Compression
-        if(first_body) {
-            first_body->ApplyImpulse(direction_to_first * mass1_ratio);
-        }
-        if(second_body) {
-            second_body->ApplyImpulse(direction_to_second * mass2_ratio);
-        }
-    } else if(length < distance) { //Extension
-        if(first_body) {
-            first_body->ApplyImpulse(direction_to_second * mass1_ratio);
-        }
-        if(second_body) {
-            second_body->ApplyImpulse(direction_to_first * mass2_ratio);
-        }
-    }
+    /* DO NOTHING */
 }
 
 void RodJoint::DebugRender() const noexcept {
@@ -134,102 +100,6 @@ float RodJoint::GetMassB() const noexcept {
     return _def.rigidBodyB ? _def.rigidBodyB->GetMass() : 0.0f;
 }
 
-bool RodJoint::ConstraintViolated() const noexcept {
-    const bool violated = [this]() -> const bool {
-        const auto distance = MathUtils::CalcDistance(GetAnchorA(), GetAnchorB());
-        return distance < _def.length || _def.length < distance;
-    }();
-    return violated;
-}
-
-void RodJoint::SolvePositionConstraint() const noexcept {
-    auto* first_body = GetBodyA();
-    auto* second_body = GetBodyB();
-    if(first_body == nullptr && second_body == nullptr) {
-        return;
-    }
-    const auto posA = GetAnchorA();
-    const auto posB = GetAnchorB();
-
-    const auto distance = MathUtils::CalcDistance(posA, posB);
-    const auto direction = (posA - posB).GetNormalize();
-    const auto m1 = (first_body ? first_body->GetMass() : 0.0f);
-    const auto m2 = (second_body ? second_body->GetMass() : 0.0f);
-    const auto mass_sum = m1 + m2;
-    const auto mass1_ratio = m1 / mass_sum;
-    const auto mass2_ratio = m2 / mass_sum;
-    auto newPosition1 = posA;
-    auto newPosition2 = posB;
-    const auto length = _def.length;
-    const auto difference_from_length = std::abs(length - distance);
-    const auto displacement = direction * difference_from_length;
-    if(distance < length) { //Compression
-        if(first_body) {
-            const auto newDisplacement = mass1_ratio * displacement;
-            const auto newPosition = first_body->GetPosition() + newDisplacement;
-            newPosition1 = newPosition;
-        }
-        if(second_body) {
-            const auto newDisplacement = mass2_ratio * -displacement;
-            const auto newPosition = second_body->GetPosition() + newDisplacement;
-            newPosition2 = newPosition;
-        }
-    } else if(length < distance) { //Extension
-        if(first_body) {
-            const auto newDisplacement = mass1_ratio * -displacement;
-            const auto newPosition = first_body->GetPosition() + newDisplacement;
-            newPosition1 = newPosition;
-        }
-        if(second_body) {
-            const auto newDisplacement = mass2_ratio * displacement;
-            const auto newPosition = second_body->GetPosition() + newDisplacement;
-            newPosition2 = newPosition;
-        }
-    }
-    if(first_body) {
-        first_body->SetPosition(newPosition1, true);
-    }
-    if(second_body) {
-        second_body->SetPosition(newPosition2, true);
-    }
-}
-
-void RodJoint::SolveVelocityConstraint() const noexcept {
-    auto* first_body = GetBodyA();
-    auto* second_body = GetBodyB();
-    if(first_body == nullptr && second_body == nullptr) {
-        return;
-    }
-
-    const auto fb_pos = GetAnchorA();
-    const auto sb_pos = GetAnchorB();
-
-    const auto distance = MathUtils::CalcDistance(fb_pos, sb_pos);
-    const auto displacement_towards_first = fb_pos - sb_pos;
-    const auto displacement_towards_second = sb_pos - fb_pos;
-    const auto direction_to_first = displacement_towards_first.GetNormalize();
-    const auto direction_to_second = displacement_towards_second.GetNormalize();
-    const auto m1 = (first_body ? first_body->GetMass() : 0.0f);
-    const auto m2 = (second_body ? second_body->GetMass() : 0.0f);
-    const auto mass_sum = m1 + m2;
-    const auto mass1_ratio = m1 / mass_sum;
-    const auto mass2_ratio = m2 / mass_sum;
-    auto v1 = first_body ? first_body->GetVelocity() : Vector2::Zero;
-    auto v2 = second_body ? second_body->GetVelocity() : Vector2::Zero;
-    auto newVelocity1 = v1;
-    auto newVelocity2 = v2;
-    const auto length = _def.length;
-    if(distance < length) { //Compression
-        newVelocity1 = mass1_ratio * MathUtils::Reject(v1, direction_to_first);
-        newVelocity2 = mass2_ratio * MathUtils::Reject(v2, direction_to_second);
-    } else if(length < distance) { //Extension
-        newVelocity1 = mass1_ratio * MathUtils::Reject(v1, direction_to_second);
-        newVelocity2 = mass2_ratio * MathUtils::Reject(v2, direction_to_first);
-    }
-    if(first_body) {
-        first_body->SetVelocity(newVelocity1);
-    }
-    if(second_body) {
-        second_body->SetVelocity(newVelocity2);
-    }
+std::optional<Joint::DistanceConstraint> RodJoint::GetDistanceConstraint() const noexcept {
+    return DistanceConstraint{_def.length, false};
 }
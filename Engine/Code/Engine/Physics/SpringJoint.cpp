@@ -120,14 +120,6 @@ float SpringJoint::GetMassB() const noexcept {
     return _def.rigidBodyB ? _def.rigidBodyB->GetMass() : 0.0f;
 }
 
-bool SpringJoint::ConstraintViolated() const noexcept {
-    return false;
-}
-
-void SpringJoint::SolvePositionConstraint() const noexcept {
-    /* DO NOTHING */
-}
-
-void SpringJoint::SolveVelocityConstraint() const noexcept {
-    /* DO NOTHING */
+std::optional<Joint::DistanceConstraint> SpringJoint::GetDistanceConstraint() const noexcept {
+    return std::nullopt;
 }
@@ -43,9 +43,7 @@ protected:
 private:
     SpringJointDef _def{};
 
-    [[nodiscard]] bool ConstraintViolated() const noexcept override;
-    void SolvePositionConstraint() const noexcept override;
-    void SolveVelocityConstraint() const noexcept override;
+    [[nodiscard]] std::optional<DistanceConstraint> GetDistanceConstraint() const noexcept override;
 
     friend class PhysicsSystem;
 };
@@ -0,0 +1,114 @@
+#include "Engine/Physics/SweepAndPruneBroadPhase.hpp"
+
+#include <algorithm>
+
+namespace {
+//Appending more than this many proxies between steps is cheaper to fix with a full sort than an insertion sort.
+constexpr std::size_t max_insertion_sorted_additions = 32u;
+//The sweep axis only changes once the other axis is clearly better, so bodies moving around do not make it flip every step.
+constexpr double axis_switch_ratio = 2.0;
+} // namespace
+
+BroadPhaseType SweepAndPruneBroadPhase::GetType() const noexcept {
+    return BroadPhaseType::SweepAndPrune;
+}
+
+void SweepAndPruneBroadPhase::OnCreateProxy(ProxyId proxy) noexcept {
+    _proxies[proxy].index = static_cast<std::uint32_t>(_entries.size());
+    _entries.push_back(Entry{0.0f, 0.0f, 0.0f, 0.0f, proxy});
+    ++_unsorted_count;
+}
+
+void SweepAndPruneBroadPhase::OnDestroyProxy(ProxyId proxy) noexcept {
+    //Removed lazily so destroying many proxies does not shift the array once per proxy.
+    _entries[_proxies[proxy].index].proxy = null_proxy;
+    ++_removed_count;
+}
+
+void SweepAndPruneBroadPhase::OnMoveProxy(ProxyId /*proxy*/) noexcept {
+    /* DO NOTHING */
+}
+
+void SweepAndPruneBroadPhase::OnClear() noexcept {
+    _entries.clear();
+    _removed_count = 0u;
+    _unsorted_count = 0u;
+}
+
+void SweepAndPruneBroadPhase::RefreshEntries() noexcept {
+    if(_removed_count) {
+        _entries.erase(std::remove_if(std::begin(_entries), std::end(_entries), [](const Entry& e) { return e.proxy == null_proxy; }), std::end(_entries));
+        _removed_count = 0u;
+    }
+    if(_entries.empty()) {
+        return;
+    }
+    //Pick the axis along which the proxy centers are spread out the most.
+    const auto inv_count = 1.0 / static_cast<double>(_entries.size());
+    double sum[2]{};
+    double sum_sq[2]{};
+    for(const auto& entry : _entries) {
+        const auto& bounds = _proxies[entry.proxy].bounds;
+        const double center[2]{(bounds.mins.x + bounds.maxs.x) * 0.5, (bounds.mins.y + bounds.maxs.y) * 0.5};
+        for(int axis = 0; axis < 2; ++axis) {
+            sum[axis] += center[axis];
+            sum_sq[axis] += center[axis] * center[axis];
+        }
+    }
+    const double variance[2]{sum_sq[0] * inv_count - sum[0] * sum[0] * inv_count * inv_count, sum_sq[1] * inv_count - sum[1] * sum[1] * inv_count * inv_count};
+    const auto other_axis = 1 - _axis;
+    if(variance[other_axis] > variance[_axis] * axis_switch_ratio) {
+        _axis = other_axis;
+        _unsorted_count = _entries.size();
+    }
+    for(auto& entry : _entries) {
+        const auto& bounds = _proxies[entry.proxy].bounds;
+        if(_axis == 0) {
+            entry.min = bounds.mins.x;
+            entry.max = bounds.maxs.x;
+            entry.other_min = bounds.mins.y;
+            entry.other_max = bounds.maxs.y;
+        } else {
+            entry.min = bounds.mins.y;
+            entry.max = bounds.maxs.y;
+            entry.other_min = bounds.mins.x;
+            entry.other_max = bounds.maxs.x;
+        }
+    }
+}
+
+void SweepAndPruneBroadPhase::SortEntries() noexcept {
+    const auto by_min = [](const Entry& a, const Entry& b) { return a.min < b.min; };
+    if(_unsorted_count > max_insertion_sorted_additions) {
+        std::sort(std::begin(_entries), std::end(_entries), by_min);
+    } else {
+        for(std::size_t i = 1u; i < _entries.size(); ++i) {
+            const auto entry = _entries[i];
+            auto j = i;
+            for(; j > 0u && by_min(entry, _entries[j - 1u]); --j) {
+                _entries[j] = _entries[j - 1u];
+            }
+            _entries[j] = entry;
+        }
+    }
+    _unsorted_count = 0u;
+    for(std::size_t i = 0u; i < _entries.size(); ++i) {
+        _proxies[_entries[i].proxy].index = static_cast<std::uint32_t>(i);
+    }
+}
+
+void SweepAndPruneBroadPhase::CollectPairs(std::pmr::vector<Pair>& pairs) noexcept {
+    RefreshEntries();
+    SortEntries();
+    const auto count = _entries.size();
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto& a = _entries[i];
+        for(std::size_t j = i + 1u; j < count && !(a.max < _entries[j].min); ++j) {
+            const auto& b = _entries[j];
+            if(a.other_max < b.other_min || b.other_max < a.other_min) {
+                continue;
+            }
+            pairs.push_back(a.proxy < b.proxy ? Pair{a.proxy, b.proxy} : Pair{b.proxy, a.proxy});
+        }
+    }
+}
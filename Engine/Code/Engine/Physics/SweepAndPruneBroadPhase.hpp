@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Engine/Physics/BroadPhase.hpp"
+
+#include <vector>
+
+//Incremental sweep-and-prune along one axis.
+//Proxies are kept sorted by their lower bound on the sweep axis; because bodies move little between steps the
+//order from the previous step is nearly correct and an insertion sort restores it in close to linear time.
+//The sweep then only compares proxies whose intervals overlap on that axis.
+//The axis with the larger spread of proxy centers is used, so long thin worlds stay cheap on either orientation.
+class SweepAndPruneBroadPhase : public BroadPhase {
+public:
+    SweepAndPruneBroadPhase() noexcept = default;
+    virtual ~SweepAndPruneBroadPhase() noexcept = default;
+
+    [[nodiscard]] BroadPhaseType GetType() const noexcept override;
+
+protected:
+    void OnCreateProxy(ProxyId proxy) noexcept override;
+    void OnDestroyProxy(ProxyId proxy) noexcept override;
+    void OnMoveProxy(ProxyId proxy) noexcept override;
+    void OnClear() noexcept override;
+    void CollectPairs(std::pmr::vector<Pair>& pairs) noexcept override;
+
+private:
+    //Bounds are copied in so the sweep reads one contiguous array.
+    struct Entry {
+        float min = 0.0f;
+        float max = 0.0f;
+        float other_min = 0.0f;
+        float other_max = 0.0f;
+        ProxyId proxy = null_proxy;
+    };
+
+    void RefreshEntries() noexcept;
+    void SortEntries() noexcept;
+
+    std::vector<Entry> _entries{};
+    std::size_t _removed_count = 0u;
+    std::size_t _unsorted_count = 0u;
+    int _axis = 0;
+};
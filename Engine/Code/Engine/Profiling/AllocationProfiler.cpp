@@ -0,0 +1,320 @@
+#include "Engine/Profiling/AllocationProfiler.hpp"
+
+#include "Engine/Profiling/StackTrace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+constexpr std::size_t call_site_table_size = 4096u;
+constexpr std::size_t max_probe_count = 64u;
+constexpr std::size_t report_frames_per_site = 4u;
+
+//Zero-initialized static storage: usable from operator new before any dynamic initialization has run.
+struct CallSiteSlot {
+    std::atomic<std::uint32_t> hash{0u};
+    std::atomic<bool> ready{false};
+    std::size_t frame_count = 0u;
+    std::array<void*, AllocationProfiler::max_frames_per_site> frames{};
+    std::atomic<std::uint64_t> count{0u};
+    std::atomic<std::uint64_t> bytes{0u};
+    std::atomic<std::uint64_t> frame_allocations{0u};
+    std::atomic<std::uint64_t> frame_bytes{0u};
+    std::array<std::atomic<std::uint64_t>, AllocationProfiler::size_class_count> histogram{};
+};
+
+CallSiteSlot s_call_sites[call_site_table_size]{};
+std::array<std::atomic<std::uint64_t>, AllocationProfiler::size_class_count> s_histogram{};
+std::array<std::atomic<std::uint64_t>, AllocationProfiler::size_class_count> s_frame_histogram{};
+std::array<std::uint64_t, AllocationProfiler::size_class_count> s_last_frame_histogram{};
+std::atomic<std::uint64_t> s_dropped{0u};
+std::atomic<std::uint32_t> s_sample_interval{1u};
+std::atomic<bool> s_enabled{false};
+
+//Allocations made while building reports are the profiler's own and are not attributed.
+thread_local bool t_is_reporting = false;
+thread_local std::uint32_t t_sample_countdown = 0u;
+
+struct ReportingScope {
+    ReportingScope() noexcept
+    : was_reporting{t_is_reporting} {
+        t_is_reporting = true;
+    }
+    ~ReportingScope() noexcept {
+        t_is_reporting = was_reporting;
+    }
+    bool was_reporting = false;
+};
+
+std::vector<AllocationProfiler::CallSite>& GetLastFrameTop() noexcept {
+    static std::vector<AllocationProfiler::CallSite> last_frame_top{};
+    return last_frame_top;
+}
+
+void SortByBytes(std::vector<AllocationProfiler::CallSite>& sites, std::size_t count) noexcept {
+    const auto by_bytes = [](const AllocationProfiler::CallSite& a, const AllocationProfiler::CallSite& b) { return a.bytes > b.bytes; };
+    count = (std::min)(count, sites.size());
+    std::partial_sort(std::begin(sites), std::begin(sites) + count, std::end(sites), by_bytes);
+    sites.resize(count);
+}
+
+std::string FormatAddress(void* address) noexcept {
+    std::ostringstream ss;
+    ss << "0x" << std::hex << reinterpret_cast<std::uintptr_t>(address);
+    return ss.str();
+}
+
+//Symbolizes the frames of every site in one batch; unresolved frames fall back to their address.
+std::vector<std::vector<std::string>> DescribeCallSites(const std::vector<AllocationProfiler::CallSite>& sites, std::size_t framesPerSite) noexcept {
+    std::vector<void*> addresses{};
+    for(const auto& site : sites) {
+        const auto count = (std::min)(framesPerSite, site.frames.size());
+        addresses.insert(std::end(addresses), std::begin(site.frames), std::begin(site.frames) + count);
+    }
+    const auto descriptions = StackTrace::DescribeAddresses(addresses);
+    std::vector<std::vector<std::string>> result(sites.size());
+    auto next = std::size_t{0u};
+    for(std::size_t i = 0u; i < sites.size(); ++i) {
+        const auto count = (std::min)(framesPerSite, sites[i].frames.size());
+        for(std::size_t frame = 0u; frame < count; ++frame, ++next) {
+            result[i].push_back(descriptions[next].empty() ? FormatAddress(addresses[next]) : descriptions[next]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+void AllocationProfiler::Enable(bool enabled) noexcept {
+    s_enabled = enabled;
+}
+
+bool AllocationProfiler::IsEnabled() noexcept {
+    return s_enabled;
+}
+
+void AllocationProfiler::SetSampleInterval(std::uint32_t interval) noexcept {
+    s_sample_interval = (std::max)(interval, std::uint32_t{1u});
+}
+
+std::uint32_t AllocationProfiler::GetSampleInterval() noexcept {
+    return s_sample_interval;
+}
+
+void AllocationProfiler::RecordAllocation(std::size_t size) noexcept {
+    if(!s_enabled.load(std::memory_order_relaxed) || t_is_reporting) {
+        return;
+    }
+    if(t_sample_countdown > 1u) {
+        --t_sample_countdown;
+        return;
+    }
+    const auto interval = s_sample_interval.load(std::memory_order_relaxed);
+    t_sample_countdown = interval;
+    std::array<void*, max_frames_per_site> frames{};
+    unsigned long hash = 0ul;
+    //Skip this function, AllocationTracker::allocate and operator new.
+    const auto frame_count = StackTrace::Capture(3ul, static_cast<unsigned long>(frames.size()), frames.data(), &hash);
+    Record(size, frames.data(), frame_count, static_cast<std::uint32_t>(hash), interval);
+}
+
+void AllocationProfiler::RecordAllocation(std::size_t size, void* const* frames, std::size_t frame_count, std::uint32_t hash) noexcept {
+    if(!s_enabled.load(std::memory_order_relaxed) || t_is_reporting) {
+        return;
+    }
+    Record(size, frames, frame_count, hash, 1u);
+}
+
+void AllocationProfiler::Record(std::size_t size, void* const* frames, std::size_t frame_count, std::uint32_t hash, std::uint64_t weight) noexcept {
+    const auto size_class = GetSizeClass(size);
+    s_histogram[size_class].fetch_add(weight, std::memory_order_relaxed);
+    s_frame_histogram[size_class].fetch_add(weight, std::memory_order_relaxed);
+    //Zero marks an empty slot.
+    hash = hash ? hash : 1u;
+    const auto start = static_cast<std::size_t>(hash * 2654435761u) & (call_site_table_size - 1u);
+    for(std::size_t probe = 0u; probe < max_probe_count; ++probe) {
+        auto& slot = s_call_sites[(start + probe) & (call_site_table_size - 1u)];
+        auto slot_hash = slot.hash.load(std::memory_order_acquire);
+        if(slot_hash == 0u && slot.hash.compare_exchange_strong(slot_hash, hash, std::memory_order_acq_rel)) {
+            slot.frame_count = (std::min)(frame_count, max_frames_per_site);
+            std::copy(frames, frames + slot.frame_count, std::begin(slot.frames));
+            slot.ready.store(true, std::memory_order_release);
+            slot_hash = hash;
+        }
+        if(slot_hash == hash) {
+            slot.count.fetch_add(weight, std::memory_order_relaxed);
+            slot.bytes.fetch_add(size * weight, std::memory_order_relaxed);
+            slot.frame_allocations.fetch_add(weight, std::memory_order_relaxed);
+            slot.frame_bytes.fetch_add(size * weight, std::memory_order_relaxed);
+            slot.histogram[size_class].fetch_add(weight, std::memory_order_relaxed);
+            return;
+        }
+    }
+    s_dropped.fetch_add(weight, std::memory_order_relaxed);
+}
+
+void AllocationProfiler::EndFrame(std::size_t topCount /*= 10u*/) noexcept {
+    const auto reporting = ReportingScope{};
+    auto sites = CollectCallSites(true);
+    SortByBytes(sites, topCount);
+    GetLastFrameTop() = std::move(sites);
+    for(auto& slot : s_call_sites) {
+        slot.frame_allocations.store(0u, std::memory_order_relaxed);
+        slot.frame_bytes.store(0u, std::memory_order_relaxed);
+    }
+    for(std::size_t i = 0u; i < size_class_count; ++i) {
+        s_last_frame_histogram[i] = s_frame_histogram[i].exchange(0u, std::memory_order_relaxed);
+    }
+}
+
+void AllocationProfiler::Reset() noexcept {
+    for(auto& slot : s_call_sites) {
+        slot.count = 0u;
+        slot.bytes = 0u;
+        slot.frame_allocations = 0u;
+        slot.frame_bytes = 0u;
+        for(auto& bucket : slot.histogram) {
+            bucket = 0u;
+        }
+    }
+    for(std::size_t i = 0u; i < size_class_count; ++i) {
+        s_histogram[i] = 0u;
+        s_frame_histogram[i] = 0u;
+        s_last_frame_histogram[i] = 0u;
+    }
+    s_dropped = 0u;
+    GetLastFrameTop().clear();
+}
+
+std::size_t AllocationProfiler::GetSizeClass(std::size_t size) noexcept {
+    auto size_class = std::size_t{0u};
+    for(auto upper_bound = std::size_t{8u}; upper_bound < size && size_class + 1u < size_class_count; upper_bound <<= 1u) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+std::size_t AllocationProfiler::GetSizeClassUpperBound(std::size_t size_class) noexcept {
+    if(size_class + 1u >= size_class_count) {
+        return (std::numeric_limits<std::size_t>::max)();
+    }
+    return std::size_t{8u} << size_class;
+}
+
+std::vector<AllocationProfiler::CallSite> AllocationProfiler::CollectCallSites(bool frameOnly) noexcept {
+    std::vector<CallSite> sites{};
+    for(const auto& slot : s_call_sites) {
+        if(!slot.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        auto site = CallSite{};
+        site.hash = slot.hash.load(std::memory_order_relaxed);
+        site.count = (frameOnly ? slot.frame_allocations : slot.count).load(std::memory_order_relaxed);
+        site.bytes = (frameOnly ? slot.frame_bytes : slot.bytes).load(std::memory_order_relaxed);
+        if(!site.count) {
+            continue;
+        }
+        site.frames.assign(std::begin(slot.frames), std::begin(slot.frames) + slot.frame_count);
+        for(std::size_t i = 0u; i < size_class_count; ++i) {
+            site.histogram[i] = slot.histogram[i].load(std::memory_order_relaxed);
+        }
+        sites.push_back(std::move(site));
+    }
+    return sites;
+}
+
+std::vector<AllocationProfiler::CallSite> AllocationProfiler::GetTopCallSites(std::size_t count) noexcept {
+    const auto reporting = ReportingScope{};
+    auto sites = CollectCallSites(false);
+    SortByBytes(sites, count);
+    return sites;
+}
+
+const std::vector<AllocationProfiler::CallSite>& AllocationProfiler::GetLastFrameTopCallSites() noexcept {
+    return GetLastFrameTop();
+}
+
+std::array<std::uint64_t, AllocationProfiler::size_class_count> AllocationProfiler::GetHistogram() noexcept {
+    std::array<std::uint64_t, size_class_count> result{};
+    for(std::size_t i = 0u; i < size_class_count; ++i) {
+        result[i] = s_histogram[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+std::array<std::uint64_t, AllocationProfiler::size_class_count> AllocationProfiler::GetLastFrameHistogram() noexcept {
+    return s_last_frame_histogram;
+}
+
+std::uint64_t AllocationProfiler::GetDroppedCount() noexcept {
+    return s_dropped;
+}
+
+void AllocationProfiler::WriteCallSites(std::ostream& out, const std::vector<CallSite>& sites) noexcept {
+    const auto descriptions = DescribeCallSites(sites, report_frames_per_site);
+    for(std::size_t i = 0u; i < sites.size(); ++i) {
+        out << std::right << std::setw(12) << sites[i].count << std::setw(14) << sites[i].bytes << "  ";
+        for(std::size_t frame = 0u; frame < descriptions[i].size(); ++frame) {
+            out << (frame ? "\n                            <- " : "") << descriptions[i][frame];
+        }
+        out << '\n';
+    }
+}
+
+void AllocationProfiler::DumpReport(std::ostream& out, std::size_t topCount /*= 10u*/) noexcept {
+    const auto reporting = ReportingScope{};
+    const auto old_flags = out.flags();
+    out << "AllocationProfiler: sample interval " << GetSampleInterval() << ", unattributed " << GetDroppedCount() << '\n';
+    out << "Last frame size classes:";
+    const auto frame_histogram = GetLastFrameHistogram();
+    for(std::size_t i = 0u; i < size_class_count; ++i) {
+        if(frame_histogram[i]) {
+            const auto upper_bound = GetSizeClassUpperBound(i);
+            out << ' ';
+            if(upper_bound == (std::numeric_limits<std::size_t>::max)()) {
+                out << '>' << GetSizeClassUpperBound(i - 1u);
+            } else {
+                out << "<=" << upper_bound;
+            }
+            out << ':' << frame_histogram[i];
+        }
+    }
+    out << '\n';
+    out << "Top " << topCount << " call sites last frame:\n";
+    out << std::right << std::setw(12) << "allocs" << std::setw(14) << "bytes" << "  call site\n";
+    WriteCallSites(out, GetLastFrameTopCallSites());
+    out << "Top " << topCount << " call sites since reset:\n";
+    out << std::right << std::setw(12) << "allocs" << std::setw(14) << "bytes" << "  call site\n";
+    WriteCallSites(out, GetTopCallSites(topCount));
+    out.flags(old_flags);
+}
+
+bool AllocationProfiler::WriteToFile(const std::filesystem::path& filepath) noexcept {
+    const auto reporting = ReportingScope{};
+    auto sites = CollectCallSites(false);
+    SortByBytes(sites, sites.size());
+    const auto descriptions = DescribeCallSites(sites, max_frames_per_site);
+    std::ofstream file(filepath, std::ios_base::out | std::ios_base::trunc);
+    if(file) {
+        file << "#AllocationProfiler sample_interval=" << GetSampleInterval() << " unattributed=" << GetDroppedCount() << '\n';
+        file << "#count\tbytes\tsize_class_histogram\tcall_stack\n";
+        for(std::size_t i = 0u; i < sites.size(); ++i) {
+            file << sites[i].count << '\t' << sites[i].bytes << '\t';
+            for(std::size_t size_class = 0u; size_class < size_class_count; ++size_class) {
+                file << (size_class ? "," : "") << sites[i].histogram[size_class];
+            }
+            file << '\t';
+            for(std::size_t frame = 0u; frame < descriptions[i].size(); ++frame) {
+                file << (frame ? " | " : "") << descriptions[i][frame];
+            }
+            file << '\n';
+        }
+    }
+    const auto success = static_cast<bool>(file);
+    return success;
+}
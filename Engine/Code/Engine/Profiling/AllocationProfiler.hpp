@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//Attributes heap allocations to the call stacks that made them.
+//Every sampled allocation captures a StackTrace whose hash selects a slot in a fixed call-site table;
+//each call site counts allocations, bytes and a power-of-two size-class histogram, both in total and for the current frame.
+//With a sample interval of N only every Nth allocation on each thread is captured and reported figures are scaled by N,
+//which keeps the cost low enough to leave on in profile builds.
+//Recording never allocates, so it is safe to call from a replaced operator new. Frees are not attributed.
+class AllocationProfiler {
+public:
+    static constexpr std::size_t max_frames_per_site = 16u;
+    static constexpr std::size_t size_class_count = 24u;
+
+    struct CallSite {
+        std::uint32_t hash = 0u;
+        std::vector<void*> frames{};
+        std::uint64_t count = 0u;
+        std::uint64_t bytes = 0u;
+        //Covers the whole run even in per-frame results.
+        std::array<std::uint64_t, size_class_count> histogram{};
+    };
+
+    static void Enable(bool enabled) noexcept;
+    [[nodiscard]] static bool IsEnabled() noexcept;
+    static void SetSampleInterval(std::uint32_t interval) noexcept;
+    [[nodiscard]] static std::uint32_t GetSampleInterval() noexcept;
+
+    //Called for every allocation while enabled; captures the caller's stack when this allocation is sampled.
+    static void RecordAllocation(std::size_t size) noexcept;
+    //Records an allocation whose stack was captured by the caller. Not subject to sampling.
+    static void RecordAllocation(std::size_t size, void* const* frames, std::size_t frame_count, std::uint32_t hash) noexcept;
+
+    //Snapshots the top call sites of the frame that just ended, then starts a new frame.
+    static void EndFrame(std::size_t topCount = 10u) noexcept;
+    static void Reset() noexcept;
+
+    //Size class 0 holds allocations up to 8 bytes, class i those up to 8 << i bytes; the last class is open-ended.
+    [[nodiscard]] static std::size_t GetSizeClass(std::size_t size) noexcept;
+    [[nodiscard]] static std::size_t GetSizeClassUpperBound(std::size_t size_class) noexcept;
+
+    [[nodiscard]] static std::vector<CallSite> GetTopCallSites(std::size_t count) noexcept;
+    [[nodiscard]] static const std::vector<CallSite>& GetLastFrameTopCallSites() noexcept;
+    [[nodiscard]] static std::array<std::uint64_t, size_class_count> GetHistogram() noexcept;
+    [[nodiscard]] static std::array<std::uint64_t, size_class_count> GetLastFrameHistogram() noexcept;
+    //Allocations that could not be attributed because the call-site table was full.
+    [[nodiscard]] static std::uint64_t GetDroppedCount() noexcept;
+
+    //Human readable top-N of the last frame and of the whole run.
+    static void DumpReport(std::ostream& out, std::size_t topCount = 10u) noexcept;
+    //Writes every call site, resolved to symbols, sorted by bytes. Sites are keyed by their symbolized frames
+    //rather than addresses so dumps from different builds can be diffed.
+    [[nodiscard]] static bool WriteToFile(const std::filesystem::path& filepath) noexcept;
+
+protected:
+private:
+    static void Record(std::size_t size, void* const* frames, std::size_t frame_count, std::uint32_t hash, std::uint64_t weight) noexcept;
+    [[nodiscard]] static std::vector<CallSite> CollectCallSites(bool frameOnly) noexcept;
+    static void WriteCallSites(std::ostream& out, const std::vector<CallSite>& sites) noexcept;
+};
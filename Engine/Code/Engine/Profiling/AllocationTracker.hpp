@@ -5,7 +5,10 @@
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
+#include "Engine/Profiling/AllocationProfiler.hpp"
+
 #include <array>
+#include <atomic>
 #include <charconv>
 #include <cstring>
 #include <iostream>
@@ -84,14 +87,11 @@ public:
         if(is_enabled()) {
             ++frameCount;
             frameSize += n;
-            ++allocCount;
-            allocSize += n;
-            if(maxSize < allocSize) {
-                maxSize = allocSize;
-            }
-            if(maxCount < allocCount) {
-                maxCount = allocCount;
-            }
+            raise_to(maxCount, ++allocCount);
+            raise_to(maxSize, allocSize += n);
+        }
+        if(is_tracing()) {
+            AllocationProfiler::RecordAllocation(n);
         }
         return std::malloc(n);
     }
@@ -123,9 +123,19 @@ public:
 #endif
     }
 
+    //Attributes allocations to call sites through the AllocationProfiler.
     static void trace([[maybe_unused]] bool doTrace) noexcept {
 #ifdef TRACK_MEMORY
         _trace = doTrace;
+        AllocationProfiler::Enable(doTrace);
+#endif
+    }
+
+    [[nodiscard]] static bool is_tracing() noexcept {
+#ifdef TRACK_MEMORY
+        return _trace;
+#else
+        return false;
 #endif
     }
 
@@ -138,6 +148,9 @@ public:
             ++frameCounter;
             resetframecounters();
         }
+        if(is_tracing()) {
+            AllocationProfiler::EndFrame();
+        }
 #endif
     }
 
@@ -176,22 +189,30 @@ public:
         return {frameCounter, frameCount - framefreeCount, frameSize - framefreeSize};
     }
 
-    inline static std::size_t maxSize = 0u;
-    inline static std::size_t maxCount = 0u;
-    inline static std::size_t allocSize = 0u;
-    inline static std::size_t allocCount = 0u;
-    inline static std::size_t frameSize = 0u;
-    inline static std::size_t frameCount = 0u;
-    inline static std::size_t frameCounter = 0u;
-    inline static std::size_t freeCount = 0u;
-    inline static std::size_t freeSize = 0u;
-    inline static std::size_t framefreeCount = 0u;
-    inline static std::size_t framefreeSize = 0u;
+    //Atomic because every thread that allocates updates them.
+    inline static std::atomic<std::size_t> maxSize{0u};
+    inline static std::atomic<std::size_t> maxCount{0u};
+    inline static std::atomic<std::size_t> allocSize{0u};
+    inline static std::atomic<std::size_t> allocCount{0u};
+    inline static std::atomic<std::size_t> frameSize{0u};
+    inline static std::atomic<std::size_t> frameCount{0u};
+    inline static std::atomic<std::size_t> frameCounter{0u};
+    inline static std::atomic<std::size_t> freeCount{0u};
+    inline static std::atomic<std::size_t> freeSize{0u};
+    inline static std::atomic<std::size_t> framefreeCount{0u};
+    inline static std::atomic<std::size_t> framefreeSize{0u};
 
 protected:
 private:
-    inline static bool _active = false;
-    inline static bool _trace = false;
+    static void raise_to(std::atomic<std::size_t>& maximum, std::size_t value) noexcept {
+        auto current = maximum.load();
+        while(current < value && !maximum.compare_exchange_weak(current, value)) {
+            /* DO NOTHING */
+        }
+    }
+
+    inline static std::atomic<bool> _active{false};
+    inline static std::atomic<bool> _trace{false};
 };
 
 #ifdef TRACK_MEMORY
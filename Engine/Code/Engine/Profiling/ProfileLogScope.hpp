@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include <chrono>
 
+//Logs the duration of a single scope when it exits. Prefer PROFILE_SCOPE, which feeds the Profiler without logging.
 class ProfileLogScope {
 public:
     explicit ProfileLogScope(const char* scopeName) noexcept;
@@ -29,7 +31,7 @@ private:
 #endif
 #ifdef PROFILE_BUILD
     #define PROFILE_LOG_SCOPE(tag_str) ProfileLogScope TOKEN_PASTE(plscope_, __LINE__)(tag_str)
-    #define PROFILE_LOG_SCOPE_FUNCTION() PROFILE_LOG_SCOPE(__FUNCSIG__)
+    #define PROFILE_LOG_SCOPE_FUNCTION() PROFILE_LOG_SCOPE(PROFILE_FUNCTION_SIGNATURE)
 #else
     #define PROFILE_LOG_SCOPE(tag_str)
     #define PROFILE_LOG_SCOPE_FUNCTION()
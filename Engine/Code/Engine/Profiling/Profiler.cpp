@@ -0,0 +1,370 @@
+#include "Engine/Profiling/Profiler.hpp"
+
+#include "Engine/Core/LockFreeQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <intrin.h>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+//A null name marks the end of the innermost open scope.
+struct Event {
+    const char* name = nullptr;
+    std::uint64_t ticks = 0u;
+};
+
+struct OpenScope {
+    const char* name = nullptr;
+    std::uint64_t begin = 0u;
+    std::uint64_t children = 0u;
+};
+
+struct CapturedScope {
+    const char* name = nullptr;
+    std::uint32_t thread_id = 0u;
+    std::uint64_t begin = 0u;
+    std::uint64_t duration = 0u;
+};
+
+struct ThreadBuffer {
+    SpscQueue<Event, Profiler::events_per_thread> events{};
+    //Producer side: open scopes whose end event has a slot reserved.
+    std::uint32_t depth = 0u;
+    //Cleared when the owning thread exits so the buffer can be handed to a new thread once drained.
+    std::atomic<bool> in_use{true};
+    //Guarded by s_cs.
+    std::uint32_t thread_id = 0u;
+    std::string thread_name{};
+    std::vector<OpenScope> open{};
+};
+
+struct ScopeTotals {
+    std::uint64_t calls = 0u;
+    std::uint64_t inclusive = 0u;
+    std::uint64_t exclusive = 0u;
+    std::uint64_t max = 0u;
+};
+
+std::atomic<bool> s_enabled{false};
+std::atomic<std::uint64_t> s_dropped{0u};
+std::atomic<bool> s_is_capturing{false};
+
+std::mutex s_cs{};
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers{};
+std::uint32_t s_next_thread_id = 1u;
+std::vector<Profiler::ScopeStats> s_last_frame_stats{};
+std::uint64_t s_last_frame_end = 0u;
+std::uint64_t s_last_frame_ticks = 0u;
+std::size_t s_capture_frames_remaining = 0u;
+std::uint64_t s_capture_begin = 0u;
+std::vector<CapturedScope> s_capture{};
+std::vector<std::uint64_t> s_capture_frame_ends{};
+std::unordered_set<std::string> s_capture_names{};
+std::unordered_map<std::uint32_t, std::string> s_capture_thread_names{};
+
+//The time stamp counter is read instead of steady_clock: it costs a few cycles where QueryPerformanceCounter
+//costs tens of nanoseconds, which would be most of the per-scope budget. It is converted to time by
+//measuring it against steady_clock over the whole run.
+[[nodiscard]] std::uint64_t ReadTicks() noexcept {
+    return __rdtsc();
+}
+
+struct Calibration {
+    std::chrono::steady_clock::time_point time{std::chrono::steady_clock::now()};
+    std::uint64_t ticks{ReadTicks()};
+};
+
+const Calibration& GetCalibration() noexcept {
+    static const Calibration calibration{};
+    return calibration;
+}
+
+[[nodiscard]] double GetMillisecondsPerTick() noexcept {
+    const auto& calibration = GetCalibration();
+    const auto ticks = ReadTicks() - calibration.ticks;
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - calibration.time);
+    return ticks ? elapsed.count() / static_cast<double>(ticks) : 0.0;
+}
+
+void ReleaseThreadBuffer(ThreadBuffer* buffer) noexcept {
+    if(buffer) {
+        buffer->in_use.store(false, std::memory_order_release);
+    }
+}
+
+//Reuses the buffer of a thread that has exited once everything it recorded has been drained.
+ThreadBuffer* AcquireThreadBuffer() noexcept {
+    GetCalibration();
+    std::scoped_lock<std::mutex> lock(s_cs);
+    auto found = std::find_if(std::begin(s_buffers), std::end(s_buffers), [](const std::unique_ptr<ThreadBuffer>& buffer) {
+        return !buffer->in_use.load(std::memory_order_acquire) && buffer->events.empty();
+    });
+    if(found == std::end(s_buffers)) {
+        s_buffers.push_back(std::make_unique<ThreadBuffer>());
+        found = std::end(s_buffers) - 1;
+    }
+    auto* buffer = found->get();
+    buffer->in_use.store(true, std::memory_order_relaxed);
+    buffer->depth = 0u;
+    buffer->thread_id = s_next_thread_id++;
+    buffer->thread_name = "Thread " + std::to_string(buffer->thread_id);
+    buffer->open.clear();
+    return buffer;
+}
+
+ThreadBuffer& GetThreadBuffer() noexcept {
+    thread_local std::unique_ptr<ThreadBuffer, decltype(&ReleaseThreadBuffer)> t_buffer{AcquireThreadBuffer(), &ReleaseThreadBuffer};
+    return *t_buffer;
+}
+
+const char* InternName(const char* name) noexcept {
+    return s_capture_names.emplace(name).first->c_str();
+}
+
+void ClearCapture() noexcept {
+    s_capture.clear();
+    s_capture_frame_ends.clear();
+    s_capture_names.clear();
+    s_capture_thread_names.clear();
+}
+
+void DrainEvents(ThreadBuffer& buffer, std::unordered_map<std::string_view, ScopeTotals>& totals, bool capture) noexcept {
+    std::array<Event, 256> batch{};
+    while(const auto count = buffer.events.pop_bulk(std::begin(batch), batch.size())) {
+        for(std::size_t i = 0u; i < count; ++i) {
+            const auto& event = batch[i];
+            if(event.name) {
+                buffer.open.push_back(OpenScope{event.name, event.ticks, 0u});
+                continue;
+            }
+            if(buffer.open.empty()) {
+                continue;
+            }
+            const auto scope = buffer.open.back();
+            buffer.open.pop_back();
+            const auto duration = event.ticks - scope.begin;
+            if(!buffer.open.empty()) {
+                buffer.open.back().children += duration;
+            }
+            auto& scope_totals = totals[std::string_view{scope.name}];
+            ++scope_totals.calls;
+            scope_totals.inclusive += duration;
+            scope_totals.exclusive += duration - (std::min)(duration, scope.children);
+            scope_totals.max = (std::max)(scope_totals.max, duration);
+            if(capture) {
+                s_capture.push_back(CapturedScope{InternName(scope.name), buffer.thread_id, scope.begin, duration});
+            }
+        }
+    }
+    if(capture && s_capture_thread_names.find(buffer.thread_id) == std::end(s_capture_thread_names)) {
+        s_capture_thread_names.emplace(buffer.thread_id, buffer.thread_name);
+    }
+}
+
+void WriteJsonString(std::ostream& out, std::string_view str) noexcept {
+    out << '"';
+    for(const auto c : str) {
+        switch(c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if(static_cast<unsigned char>(c) < 0x20u) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+            } else {
+                out << c;
+            }
+            break;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+void Profiler::Enable(bool enabled) noexcept {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::IsEnabled() noexcept {
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const std::string& name) noexcept {
+    auto& buffer = GetThreadBuffer();
+    std::scoped_lock<std::mutex> lock(s_cs);
+    buffer.thread_name = name;
+}
+
+bool Profiler::BeginScope(const char* name) noexcept {
+    if(!s_enabled.load(std::memory_order_relaxed) || !name) {
+        return false;
+    }
+    auto& buffer = GetThreadBuffer();
+    //Keep a slot free for the end event of every open scope so a full ring never leaves a scope unterminated.
+    if(buffer.events.size() + buffer.depth + 2u > events_per_thread || !buffer.events.try_push(Event{name, ReadTicks()})) {
+        s_dropped.fetch_add(1u, std::memory_order_relaxed);
+        return false;
+    }
+    ++buffer.depth;
+    return true;
+}
+
+void Profiler::EndScope() noexcept {
+    const auto ticks = ReadTicks();
+    auto& buffer = GetThreadBuffer();
+    --buffer.depth;
+    (void)buffer.events.try_push(Event{nullptr, ticks});
+}
+
+bool Profiler::EndFrame() noexcept {
+    const auto frame_end = ReadTicks();
+    const auto ms_per_tick = GetMillisecondsPerTick();
+    std::scoped_lock<std::mutex> lock(s_cs);
+    const auto capture = s_capture_frames_remaining != 0u;
+    std::unordered_map<std::string_view, ScopeTotals> totals{};
+    for(auto& buffer : s_buffers) {
+        DrainEvents(*buffer, totals, capture);
+    }
+    s_last_frame_stats.clear();
+    s_last_frame_stats.reserve(totals.size());
+    for(const auto& [name, scope_totals] : totals) {
+        auto& stats = s_last_frame_stats.emplace_back();
+        stats.name = std::string{name};
+        stats.calls = scope_totals.calls;
+        stats.inclusive_ms = static_cast<double>(scope_totals.inclusive) * ms_per_tick;
+        stats.exclusive_ms = static_cast<double>(scope_totals.exclusive) * ms_per_tick;
+        stats.max_ms = static_cast<double>(scope_totals.max) * ms_per_tick;
+    }
+    std::sort(std::begin(s_last_frame_stats), std::end(s_last_frame_stats), [](const ScopeStats& a, const ScopeStats& b) { return a.exclusive_ms > b.exclusive_ms; });
+    s_last_frame_ticks = s_last_frame_end ? frame_end - s_last_frame_end : 0u;
+    s_last_frame_end = frame_end;
+    if(!capture) {
+        return false;
+    }
+    s_capture_frame_ends.push_back(frame_end);
+    if(--s_capture_frames_remaining == 0u) {
+        s_is_capturing.store(false, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void Profiler::Reset() noexcept {
+    std::scoped_lock<std::mutex> lock(s_cs);
+    for(auto& buffer : s_buffers) {
+        std::array<Event, 256> batch{};
+        while(buffer->events.pop_bulk(std::begin(batch), batch.size())) {
+            /* DO NOTHING */
+        }
+        buffer->open.clear();
+    }
+    s_last_frame_stats.clear();
+    s_last_frame_end = 0u;
+    s_last_frame_ticks = 0u;
+    s_capture_frames_remaining = 0u;
+    s_is_capturing.store(false, std::memory_order_relaxed);
+    ClearCapture();
+    s_dropped.store(0u, std::memory_order_relaxed);
+}
+
+void Profiler::StartCapture(std::size_t frameCount) noexcept {
+    std::scoped_lock<std::mutex> lock(s_cs);
+    ClearCapture();
+    s_capture_frames_remaining = frameCount;
+    s_capture_begin = ReadTicks();
+    s_is_capturing.store(frameCount != 0u, std::memory_order_relaxed);
+}
+
+bool Profiler::IsCapturing() noexcept {
+    return s_is_capturing.load(std::memory_order_relaxed);
+}
+
+std::size_t Profiler::GetCapturedScopeCount() noexcept {
+    std::scoped_lock<std::mutex> lock(s_cs);
+    return s_capture.size();
+}
+
+const std::vector<Profiler::ScopeStats>& Profiler::GetLastFrameStats() noexcept {
+    return s_last_frame_stats;
+}
+
+double Profiler::GetLastFrameMilliseconds() noexcept {
+    return static_cast<double>(s_last_frame_ticks) * GetMillisecondsPerTick();
+}
+
+std::uint64_t Profiler::GetDroppedCount() noexcept {
+    return s_dropped.load(std::memory_order_relaxed);
+}
+
+void Profiler::DumpReport(std::ostream& out, std::size_t topCount /*= 20u*/) noexcept {
+    const auto old_flags = out.flags();
+    const auto old_precision = out.precision();
+    const auto& stats = GetLastFrameStats();
+    out << std::fixed << std::setprecision(3);
+    out << "Profiler: last frame " << GetLastFrameMilliseconds() << " ms, " << stats.size() << " scopes, dropped " << GetDroppedCount() << '\n';
+    out << std::right << std::setw(8) << "calls" << std::setw(12) << "incl ms" << std::setw(12) << "excl ms" << std::setw(12) << "max ms" << "  scope\n";
+    const auto count = (std::min)(topCount, stats.size());
+    for(std::size_t i = 0u; i < count; ++i) {
+        out << std::setw(8) << stats[i].calls << std::setw(12) << stats[i].inclusive_ms << std::setw(12) << stats[i].exclusive_ms << std::setw(12) << stats[i].max_ms << "  " << stats[i].name << '\n';
+    }
+    out.flags(old_flags);
+    out.precision(old_precision);
+}
+
+void Profiler::WriteChromeTrace(std::ostream& out) noexcept {
+    std::scoped_lock<std::mutex> lock(s_cs);
+    const auto us_per_tick = GetMillisecondsPerTick() * 1000.0;
+    const auto to_us = [us_per_tick](std::uint64_t ticks) { return static_cast<double>(ticks) * us_per_tick; };
+    const auto old_flags = out.flags();
+    const auto old_precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    auto first = true;
+    const auto separator = [&first, &out]() {
+        out << (first ? "" : ",\n");
+        first = false;
+    };
+    for(const auto& [thread_id, thread_name] : s_capture_thread_names) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread_id << ",\"args\":{\"name\":";
+        WriteJsonString(out, thread_name);
+        out << "}}";
+    }
+    for(std::size_t i = 0u; i < s_capture_frame_ends.size(); ++i) {
+        separator();
+        out << "{\"name\":\"Frame " << i << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":" << to_us(s_capture_frame_ends[i] - s_capture_begin) << '}';
+    }
+    for(const auto& scope : s_capture) {
+        separator();
+        out << "{\"name\":";
+        WriteJsonString(out, scope.name);
+        //Scopes that began before the capture started are clamped to its start.
+        const auto begin = (std::max)(scope.begin, s_capture_begin);
+        const auto end = (std::max)(scope.begin + scope.duration, begin);
+        out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << scope.thread_id << ",\"ts\":" << to_us(begin - s_capture_begin) << ",\"dur\":" << to_us(end - begin) << '}';
+    }
+    out << "\n]}\n";
+    out.flags(old_flags);
+    out.precision(old_precision);
+}
+
+bool Profiler::WriteChromeTrace(const std::filesystem::path& filepath) noexcept {
+    std::ofstream file(filepath, std::ios_base::out | std::ios_base::trunc);
+    if(!file) {
+        return false;
+    }
+    WriteChromeTrace(file);
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Engine/Core/BuildConfig.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//Hierarchical instrumentation profiler.
+//Each thread writes begin/end events for nested scopes into its own lock-free ring buffer; recording a scope is two
+//timestamp reads and two ring pushes, with no locks and no allocation after the thread's first scope.
+//EndFrame drains every thread's ring on the calling thread, aggregates call counts and inclusive/exclusive time per
+//scope name for the frame that just ended and, while a capture is running, keeps the raw scopes for Chrome trace export.
+//Scope names are not copied when recorded: they must stay valid until the EndFrame that follows the scope.
+class Profiler {
+public:
+    static constexpr std::size_t events_per_thread = std::size_t{1u} << 16u;
+
+    struct ScopeStats {
+        std::string name{};
+        std::uint64_t calls = 0u;
+        double inclusive_ms = 0.0;
+        //Inclusive time minus the inclusive time of the scopes nested directly inside it.
+        double exclusive_ms = 0.0;
+        double max_ms = 0.0;
+    };
+
+    static void Enable(bool enabled) noexcept;
+    [[nodiscard]] static bool IsEnabled() noexcept;
+    //Names the calling thread in reports and exported traces.
+    static void SetThreadName(const std::string& name) noexcept;
+
+    //Returns false if the scope was not recorded, in which case EndScope must not be called for it.
+    [[nodiscard]] static bool BeginScope(const char* name) noexcept;
+    static void EndScope() noexcept;
+
+    //Drains every thread's events and aggregates them into the last frame's statistics.
+    //Returns true on the frame a capture started with StartCapture completes.
+    static bool EndFrame() noexcept;
+    //Discards statistics, captured scopes and anything still buffered.
+    static void Reset() noexcept;
+
+    //Records the raw scopes of the next frameCount frames.
+    static void StartCapture(std::size_t frameCount) noexcept;
+    [[nodiscard]] static bool IsCapturing() noexcept;
+    [[nodiscard]] static std::size_t GetCapturedScopeCount() noexcept;
+
+    //Sorted by exclusive time, most expensive first.
+    [[nodiscard]] static const std::vector<ScopeStats>& GetLastFrameStats() noexcept;
+    [[nodiscard]] static double GetLastFrameMilliseconds() noexcept;
+    //Scopes not recorded because a thread's ring buffer was full.
+    [[nodiscard]] static std::uint64_t GetDroppedCount() noexcept;
+
+    static void DumpReport(std::ostream& out, std::size_t topCount = 20u) noexcept;
+    //Writes the last completed capture in Chrome trace-event format (chrome://tracing, Perfetto, Speedscope).
+    static void WriteChromeTrace(std::ostream& out) noexcept;
+    [[nodiscard]] static bool WriteChromeTrace(const std::filesystem::path& filepath) noexcept;
+
+protected:
+private:
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* scopeName) noexcept
+    : _recorded(Profiler::BeginScope(scopeName)) {
+        /* DO NOTHING */
+    }
+    ~ProfileScope() noexcept {
+        if(_recorded) {
+            Profiler::EndScope();
+        }
+    }
+
+    ProfileScope() = delete;
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope(ProfileScope&&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    ProfileScope& operator=(ProfileScope&&) = delete;
+
+protected:
+private:
+    bool _recorded = false;
+};
+
+#if defined(_MSC_VER)
+    #define PROFILE_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+    #define PROFILE_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+#if defined PROFILE_SCOPE || defined PROFILE_SCOPE_FUNCTION
+    #undef PROFILE_SCOPE
+    #undef PROFILE_SCOPE_FUNCTION
+#endif
+#ifdef PROFILE_BUILD
+    #define PROFILE_SCOPE(tag_str) ProfileScope TOKEN_PASTE(pscope_, __LINE__)(tag_str)
+    #define PROFILE_SCOPE_FUNCTION() PROFILE_SCOPE(PROFILE_FUNCTION_SIGNATURE)
+#else
+    #define PROFILE_SCOPE(tag_str)
+    #define PROFILE_SCOPE_FUNCTION()
+#endif
@@ -184,6 +184,53 @@ void StackTrace::Shutdown() noexcept {
 #endif
 }
 
+unsigned long StackTrace::GetHash() const noexcept {
+    return hash;
+}
+
+unsigned long StackTrace::Capture([[maybe_unused]] unsigned long framesToSkip, [[maybe_unused]] unsigned long framesToCapture, [[maybe_unused]] void** frames, unsigned long* backTraceHash) noexcept {
+    if(backTraceHash) {
+        *backTraceHash = 0ul;
+    }
+#ifdef PROFILE_BUILD
+    const auto capture_count = (std::min)(framesToCapture, MAX_FRAMES_PER_CALLSTACK);
+    return ::CaptureStackBackTrace(1ul + framesToSkip, capture_count, frames, backTraceHash);
+#else
+    return 0ul;
+#endif
+}
+
+std::vector<std::string> StackTrace::DescribeAddresses(const std::vector<void*>& addresses) noexcept {
+    std::vector<std::string> result(addresses.size());
+#ifdef PROFILE_BUILD
+    if(!_refs) {
+        Initialize();
+    }
+    ++_refs;
+    IMAGEHLP_LINE64 line_info{};
+    line_info.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+    DWORD line_offset = 0;
+    for(std::size_t i = 0u; i < addresses.size(); ++i) {
+        const auto ptr = reinterpret_cast<DWORD64>(addresses[i]);
+        std::scoped_lock<std::shared_mutex> lock(_cs);
+        if(!LSymFromAddr(process, ptr, nullptr, symbol)) {
+            continue;
+        }
+        const auto name = std::string(symbol->Name, symbol->NameLen);
+        if(LSymGetLineFromAddr64(process, ptr, &line_offset, &line_info)) {
+            result[i] = std::string{line_info.FileName} + "(" + std::to_string(line_info.LineNumber) + "): " + name;
+        } else {
+            result[i] = "N/A(0): " + name;
+        }
+    }
+    --_refs;
+    if(!_refs) {
+        Shutdown();
+    }
+#endif
+    return result;
+}
+
 bool StackTrace::operator!=(const StackTrace& rhs) const noexcept {
     return !(*this == rhs);
 }
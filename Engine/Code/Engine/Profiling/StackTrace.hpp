@@ -16,6 +16,13 @@ public:
     ~StackTrace() noexcept;
     [[nodiscard]] bool operator==(const StackTrace& rhs) const noexcept;
     [[nodiscard]] bool operator!=(const StackTrace& rhs) const noexcept;
+    [[nodiscard]] unsigned long GetHash() const noexcept;
+
+    //Captures raw return addresses without symbol lookup or allocation, cheap enough for hot paths.
+    //Returns the number of frames written; always zero outside profile builds.
+    [[nodiscard]] static unsigned long Capture(unsigned long framesToSkip, unsigned long framesToCapture, void** frames, unsigned long* backTraceHash) noexcept;
+    //Resolves each address to "file(line): function". Outside profile builds every entry is empty.
+    [[nodiscard]] static std::vector<std::string> DescribeAddresses(const std::vector<void*>& addresses) noexcept;
 
 protected:
 private:
@@ -58,6 +58,10 @@ std::unique_ptr<VertexBufferInstanced> RHIDevice::CreateVertexBufferInstanced(co
     return std::make_unique<VertexBufferInstanced>(*this, vbio, usage, bindusage);
 }
 
+std::unique_ptr<ParticleInstanceBuffer> RHIDevice::CreateParticleInstanceBuffer(const ParticleInstanceBuffer::buffer_t& instances, const BufferUsage& usage, const BufferBindUsage& bindusage) const noexcept {
+    return std::make_unique<ParticleInstanceBuffer>(*this, instances, usage, bindusage);
+}
+
 std::unique_ptr<IndexBuffer> RHIDevice::CreateIndexBuffer(const IndexBuffer::buffer_t& ibo, const BufferUsage& usage, const BufferBindUsage& bindusage) const noexcept {
     return std::make_unique<IndexBuffer>(*this, ibo, usage, bindusage);
 }
@@ -85,6 +85,10 @@ ID3D11BlendState* BlendState::GetDxBlendState() noexcept {
     return _dx_state;
 }
 
+bool BlendState::IsBlendingEnabled() const noexcept {
+    return std::any_of(std::cbegin(_descs), std::cend(_descs), [](const BlendDesc& desc) { return desc.enable; });
+}
+
 BlendDesc::BlendDesc(const XMLElement& element) noexcept {
     DataUtils::ValidateXmlElement(element, "blend", "", "", "color,alpha,enablemask", "enable");
     enable = DataUtils::ParseXmlAttribute(element, "enable", enable);
@@ -30,6 +30,7 @@ public:
     ~BlendState() noexcept;
 
     [[nodiscard]] ID3D11BlendState* GetDxBlendState() noexcept;
+    [[nodiscard]] bool IsBlendingEnabled() const noexcept;
 
 protected:
     [[nodiscard]] bool CreateBlendState(const RHIDevice* device, BlendDesc render_target = BlendDesc{}) noexcept;
@@ -3,6 +3,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Platform/Win.hpp"
+#include "Engine/Renderer/Shader.hpp"
 
 #include "Engine/Services/IRendererService.hpp"
 #include "Engine/Services/ServiceLocator.hpp"
@@ -311,6 +312,13 @@ Vector3 Material::GetSpecGlossEmitFactors() const noexcept {
     return Vector3(GetSpecularIntensity(), GetGlossyFactor(), GetEmissiveFactor());
 }
 
+bool Material::IsTransparent() const noexcept {
+    if(const auto* blend_state = _shader ? _shader->GetBlendState() : nullptr; blend_state) {
+        return blend_state->IsBlendingEnabled();
+    }
+    return false;
+}
+
 void Material::SetFilepath(const std::filesystem::path& p) noexcept {
     _filepath = p;
 }
@@ -97,6 +97,8 @@ public:
     [[nodiscard]] float GetGlossyFactor() const noexcept;
     [[nodiscard]] float GetEmissiveFactor() const noexcept;
     [[nodiscard]] Vector3 GetSpecGlossEmitFactors() const noexcept;
+    //True when the shader blends with what is already drawn, so draw order matters.
+    [[nodiscard]] bool IsTransparent() const noexcept;
 
     void SetFilepath(const std::filesystem::path& p) noexcept;
     [[nodiscard]] const std::filesystem::path& GetFilepath() const noexcept;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Vector4.hpp"
+
+//One camera-facing particle quad, expanded to its four corners in view space by the vertex shader from SV_VertexID,
+//as the "__particle" shader program does. scale is the quad's full width and height.
+//Read as per-instance data with the semantics below; color is R8G8B8A8_UNORM.
+struct ParticleInstance {
+    Vector3 position = Vector3::Zero; //INSTANCEPOSITION
+    Vector2 scale = Vector2::One;     //INSTANCESCALE
+    Rgba color = Rgba::White;         //INSTANCECOLOR
+    //Texture coordinates of the top-left corner in xy and the bottom-right corner in zw.
+    Vector4 uv_rect = Vector4{0.0f, 0.0f, 1.0f, 1.0f}; //INSTANCEUVRECT
+};
+
+static_assert(sizeof(ParticleInstance) == 40u, "ParticleInstance must stay tightly packed; its layout is described to the input assembler byte for byte.");
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Engine/Renderer/ArrayBuffer.hpp"
+#include "Engine/Renderer/ParticleInstance.hpp"
+
+#include <vector>
+
+class RHIDevice;
+class RHIDeviceContext;
+
+class ParticleInstanceBuffer : public ArrayBuffer<ParticleInstance> {
+public:
+    ParticleInstanceBuffer(const RHIDevice& owner, const buffer_t& buffer, const BufferUsage& usage, const BufferBindUsage& bindUsage) noexcept;
+    virtual ~ParticleInstanceBuffer() noexcept;
+
+    void Update(RHIDeviceContext& context, const buffer_t& buffer) noexcept;
+
+protected:
+private:
+};
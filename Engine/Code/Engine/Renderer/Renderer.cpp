@@ -652,7 +652,7 @@ void Renderer::DrawWorldGridXZ(float radius /*= 500.0f*/, float major_gridsize /
     const float space_between_majors = std::floor(length * (major_gridsize / length));
     const float space_between_minors = std::floor(length * (minor_gridsize / length));
 
-    Mesh::Builder mesh_builder{};
+    auto& mesh_builder = GetScratchMeshBuilder();
     //MAJOR LINES
     mesh_builder.Begin(PrimitiveType::Lines);
     mesh_builder.SetColor(major_color);
@@ -702,8 +702,7 @@ void Renderer::DrawWorldGridXY(float radius /*= 500.0f*/, float major_gridsize /
     const float space_between_majors = std::floor(length * (major_gridsize / length));
     const float space_between_minors = std::floor(length * (minor_gridsize / length));
 
-    static Mesh::Builder mesh_builder{};
-    mesh_builder.Clear();
+    auto& mesh_builder = GetScratchMeshBuilder();
     //MAJOR LINES
     mesh_builder.Begin(PrimitiveType::Lines);
     mesh_builder.SetColor(major_color);
@@ -758,8 +757,7 @@ void Renderer::DrawWorldGrid2D(int width, int height, const Rgba& color /*= Rgba
     const auto x_last = width + 1;
     //const auto size = std::size_t{2u} + width + height;
 
-    static Mesh::Builder mesh_builder{};
-    mesh_builder.Clear();
+    auto& mesh_builder = GetScratchMeshBuilder();
     mesh_builder.Begin(PrimitiveType::Lines);
     mesh_builder.SetColor(color);
     for(int x = x_first; x < x_last; ++x) {
@@ -908,6 +906,28 @@ void Renderer::DrawInstanced(const PrimitiveType& topology, const std::vector<Ve
     DrawInstanced(topology, _temp_vbo.get(), _temp_vbio.get(), vertexCount, instanceCount, std::size_t{0u}, std::size_t{0u});
 }
 
+void Renderer::DrawInstanced(const PrimitiveType& topology, const std::vector<ParticleInstance>& instances, std::size_t vertexPerInstanceCount, std::size_t instanceCount) noexcept {
+    GUARANTEE_OR_DIE(_current_material, "Attempting to call Draw function without a material set!\n");
+    if(!instanceCount) {
+        return;
+    }
+    UpdateParticleInstances(instances);
+    auto* program = _current_material->GetShader()->GetShaderProgram();
+    auto* dx_context = _rhi_context->GetDxContext();
+    const auto* particle_layout = GetParticleInputLayout(program);
+    dx_context->IASetInputLayout(particle_layout ? particle_layout->GetDxInputLayout() : nullptr);
+    dx_context->IASetPrimitiveTopology(PrimitiveTypeToD3dTopology(topology));
+    //Slot 0 holds the instances themselves; there is no per-vertex buffer.
+    unsigned int stride = sizeof(ParticleInstanceBuffer::arraybuffer_t);
+    unsigned int offsets = 0;
+    ID3D11Buffer* const dx_buffers[] = {_temp_particle_instances->GetDxBuffer().Get()};
+    dx_context->IASetVertexBuffers(0, 1, dx_buffers, &stride, &offsets);
+    _rhi_context->DrawInstanced(vertexPerInstanceCount, instanceCount, 0, 0);
+    //Draws that follow without setting a material again expect its own per-vertex layout.
+    const auto* material_layout = program ? program->GetInputLayout() : nullptr;
+    dx_context->IASetInputLayout(material_layout ? material_layout->GetDxInputLayout() : nullptr);
+}
+
 void Renderer::DrawIndexedInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, const std::vector<unsigned int>& ibo, std::size_t instanceCount) noexcept {
     DrawIndexedInstanced(topology, vbo, vbio, ibo, instanceCount, 0, 0, 0);
 }
@@ -1481,7 +1501,7 @@ void Renderer::DrawTextLine(const KerningFont* font, const std::string& text, co
     auto texture_h = static_cast<float>(font->GetCommonDef().scale.y);
     std::size_t text_size = text.size();
 
-    Mesh::Builder builder;
+    auto& builder = GetScratchMeshBuilder();
     builder.verticies.reserve(text_size * 4);
     builder.indicies.reserve(text_size * 6);
 
@@ -1546,7 +1566,7 @@ void Renderer::DrawTextLine(const Matrix4& transform, const KerningFont* font, c
     auto texture_h = static_cast<float>(font->GetCommonDef().scale.y);
     std::size_t text_size = text.size();
 
-    Mesh::Builder builder;
+    auto& builder = GetScratchMeshBuilder();
     builder.verticies.reserve(text_size * 4);
     builder.indicies.reserve(text_size * 6);
 
@@ -1859,6 +1879,13 @@ void Renderer::SetFullscreen(bool isFullscreen) noexcept {
     }
 }
 
+Mesh::Builder& Renderer::GetScratchMeshBuilder() noexcept {
+    //The draw helpers only set color and UVs; color always, so reset the UV for the ones that never set it.
+    _scratch_builder.Clear();
+    _scratch_builder.SetUV(Vector2::Zero);
+    return _scratch_builder;
+}
+
 void Renderer::SetFullscreenMode() noexcept {
     if(auto* output = GetOutput()) {
         if(auto* window = output->GetWindow()) {
@@ -1905,6 +1932,10 @@ void Renderer::CreateAndRegisterDefaultShaderPrograms() noexcept {
     auto circle2d_sp = CreateDefaultCircle2DShaderProgram();
     name = circle2d_sp->GetName();
     RegisterShaderProgram(name, std::move(circle2d_sp));
+
+    auto particle_sp = CreateDefaultParticleShaderProgram();
+    name = particle_sp->GetName();
+    RegisterShaderProgram(name, std::move(particle_sp));
 }
 
 std::unique_ptr<ShaderProgram> Renderer::CreateDefaultShaderProgram() noexcept {
@@ -2637,6 +2668,75 @@ cbuffer time_cb : register(b1) {
     float g_SYSTEM_FRAME_TIME;
 }
 
+//Draws ParticleInstance data with DrawInstanced: four strip corners per instance from SV_VertexID, offset in view space so the quad faces the camera.
+//Compiled when the renderer starts instead of shipping as byte code.
+std::unique_ptr<ShaderProgram> Renderer::CreateDefaultParticleShaderProgram() noexcept {
+    const std::string program =
+    R"(
+
+cbuffer matrix_cb : register(b0) {
+    float4x4 g_MODEL;
+    float4x4 g_VIEW;
+    float4x4 g_PROJECTION;
+};
+
+struct vs_in_t {
+    float3 position : INSTANCEPOSITION;
+    float2 scale : INSTANCESCALE;
+    float4 color : INSTANCECOLOR;
+    float4 uv_rect : INSTANCEUVRECT;
+    uint corner_id : SV_VertexID;
+};
+
+struct ps_in_t {
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+    float2 uv : UV;
+};
+
+SamplerState sSampler : register(s0);
+
+Texture2D<float4> tDiffuse    : register(t0);
+
+ps_in_t VertexFunction(vs_in_t input_instance) {
+    ps_in_t output;
+
+    //Corners 0 to 3 are (-1, 1), (-1, -1), (1, 1), (1, -1). As in the expanded quads, y = -1 takes uv_rect's top edge.
+    float2 corner = float2((input_instance.corner_id & 2) ? 1.0f : -1.0f, (input_instance.corner_id & 1) ? -1.0f : 1.0f);
+
+    float4 local = float4(input_instance.position, 1.0f);
+    float4 world = mul(local, g_MODEL);
+    float4 view = mul(world, g_VIEW);
+    view.xy += corner * input_instance.scale * 0.5f;
+    float4 clip = mul(view, g_PROJECTION);
+
+    output.position = clip;
+    output.color = input_instance.color;
+    output.uv = lerp(input_instance.uv_rect.xy, input_instance.uv_rect.zw, corner * 0.5f + 0.5f);
+
+    return output;
+}
+
+float4 PixelFunction(ps_in_t input_pixel) : SV_Target0 {
+    float4 albedo = tDiffuse.Sample(sSampler, input_pixel.uv);
+    return albedo * input_pixel.color;
+}
+
+)";
+
+    ShaderProgramDesc desc{};
+    desc.name = "__particle";
+    if(auto* blob = RHIDevice::CompileShader(desc.name, program.data(), program.size(), "VertexFunction", PipelineStage::Vs)) {
+        _rhi_device->GetDxDevice()->CreateVertexShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &desc.vs);
+        desc.vs_bytecode = blob;
+    }
+    if(auto* blob = RHIDevice::CompileShader(desc.name, program.data(), program.size(), "PixelFunction", PipelineStage::Ps)) {
+        _rhi_device->GetDxDevice()->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &desc.ps);
+        desc.ps_bytecode = blob;
+    }
+    return std::make_unique<ShaderProgram>(std::move(desc));
+}
+
 struct light {
     float4 position;
     float4 color;
@@ -2785,6 +2885,10 @@ void Renderer::CreateAndRegisterDefaultMaterials() noexcept {
     auto mat_circle2d = CreateDefaultCircle2DMaterial();
     name = mat_circle2d->GetName();
     RegisterMaterial(name, std::move(mat_circle2d));
+
+    auto mat_particle = CreateDefaultParticleMaterial();
+    name = mat_particle->GetName();
+    RegisterMaterial(name, std::move(mat_particle));
 }
 
 std::unique_ptr<Material> Renderer::CreateDefaultMaterial() noexcept {
@@ -2902,6 +3006,22 @@ std::unique_ptr<Material> Renderer::CreateDefaultCircle2DMaterial() noexcept {
     return std::make_unique<Material>(*doc.RootElement());
 }
 
+std::unique_ptr<Material> Renderer::CreateDefaultParticleMaterial() noexcept {
+    std::string material =
+    R"(
+<material name="__particle">
+    <shader src="__particle" />
+</material>
+)";
+
+    tinyxml2::XMLDocument doc;
+    auto parse_result = doc.Parse(material.c_str(), material.size());
+    if(parse_result != tinyxml2::XML_SUCCESS) {
+        return nullptr;
+    }
+    return std::make_unique<Material>(*doc.RootElement());
+}
+
 std::unique_ptr<Material> Renderer::CreateMaterialFromFont(KerningFont* font) noexcept {
     if(font == nullptr) {
         return nullptr;
@@ -3643,6 +3763,10 @@ void Renderer::CreateAndRegisterDefaultShaders() noexcept {
     auto default_circle2d = CreateDefaultCircle2DShader();
     name = default_circle2d->GetName();
     RegisterShader(name, std::move(default_circle2d));
+
+    auto default_particle = CreateDefaultParticleShader();
+    name = default_particle->GetName();
+    RegisterShader(name, std::move(default_particle));
 }
 
 std::unique_ptr<Shader> Renderer::CreateDefaultShader() noexcept {
@@ -3744,6 +3868,35 @@ std::unique_ptr<Shader> Renderer::CreateDefault2DShader() noexcept {
     return std::make_unique<Shader>(*doc.RootElement());
 }
 
+std::unique_ptr<Shader> Renderer::CreateDefaultParticleShader() noexcept {
+    std::string shader =
+    R"(
+<shader name="__particle">
+    <shaderprogram src="__particle" />
+    <raster>
+        <fill>solid</fill>
+        <cull>none</cull>
+        <antialiasing>false</antialiasing>
+    </raster>
+    <sampler src="__default" />
+    <blends>
+        <blend enable="true">
+            <color src="src_alpha" dest="inv_src_alpha" op="add" />
+        </blend>
+    </blends>
+    <depth enable="true" writable="false" />
+    <stencil enable="false" readable="false" writable="false" />
+</shader>
+)";
+    tinyxml2::XMLDocument doc;
+    auto parse_result = doc.Parse(shader.c_str(), shader.size());
+    if(parse_result != tinyxml2::XML_SUCCESS) {
+        return nullptr;
+    }
+
+    return std::make_unique<Shader>(*doc.RootElement());
+}
+
 std::unique_ptr<Shader> Renderer::CreateDefaultNormalShader() noexcept {
     std::string shader =
     R"(
@@ -3960,6 +4113,32 @@ void Renderer::UpdateVbio(const VertexBufferInstanced::buffer_t& vbio) noexcept
     _temp_vbio->Update(*_rhi_context, vbio);
 }
 
+void Renderer::UpdateParticleInstances(const ParticleInstanceBuffer::buffer_t& instances) noexcept {
+    if(_current_particle_instances_size < instances.size()) {
+        _temp_particle_instances = std::move(_rhi_device->CreateParticleInstanceBuffer(instances, BufferUsage::Dynamic, BufferBindUsage::Vertex_Buffer));
+        _current_particle_instances_size = instances.size();
+    }
+    _temp_particle_instances->Update(*_rhi_context, instances);
+}
+
+InputLayoutInstanced* Renderer::GetParticleInputLayout(ShaderProgram* program) noexcept {
+    if(!program || !program->GetVSByteCode()) {
+        return nullptr;
+    }
+    if(auto* found = program->GetInputLayoutParticles()) {
+        return found;
+    }
+    auto layout = std::make_unique<InputLayoutInstanced>(*_rhi_device);
+    layout->AddElement(offsetof(ParticleInstance, position), ImageFormat::R32G32B32_Float, "INSTANCEPOSITION", 0u, false, 1u);
+    layout->AddElement(offsetof(ParticleInstance, scale), ImageFormat::R32G32_Float, "INSTANCESCALE", 0u, false, 1u);
+    layout->AddElement(offsetof(ParticleInstance, color), ImageFormat::R8G8B8A8_UNorm, "INSTANCECOLOR", 0u, false, 1u);
+    layout->AddElement(offsetof(ParticleInstance, uv_rect), ImageFormat::R32G32B32A32_Float, "INSTANCEUVRECT", 0u, false, 1u);
+    auto* byte_code = program->GetVSByteCode();
+    layout->CreateInputLayout(byte_code->GetBufferPointer(), byte_code->GetBufferSize());
+    program->SetInputLayoutParticles(std::move(layout));
+    return program->GetInputLayoutParticles();
+}
+
 void Renderer::UpdateIbo(const IndexBuffer::buffer_t& ibo) noexcept {
     if(_current_ibo_size < ibo.size()) {
         _temp_ibo = std::move(_rhi_device->CreateIndexBuffer(ibo, BufferUsage::Dynamic, BufferBindUsage::Index_Buffer));
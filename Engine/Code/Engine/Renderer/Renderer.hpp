@@ -16,6 +16,8 @@
 #include "Engine/Renderer/AnimatedSprite.hpp"
 #include "Engine/Renderer/Camera3D.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/Mesh.hpp"
+#include "Engine/Renderer/ParticleInstanceBuffer.hpp"
 #include "Engine/Renderer/RenderTargetStack.hpp"
 #include "Engine/Renderer/StructuredBuffer.hpp"
 #include "Engine/Renderer/VertexBuffer.hpp"
@@ -42,6 +44,7 @@ class Disc2;
 class Frustum;
 class FrameBuffer;
 class IndexBuffer;
+class InputLayoutInstanced;
 class IntVector3;
 class KerningFont;
 class Material;
@@ -327,6 +330,7 @@ public:
     void DrawIndexed(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo, std::size_t index_count, std::size_t startVertex = 0, std::size_t baseVertexLocation = 0) noexcept override;
     void DrawInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, std::size_t instanceCount) noexcept override;
     void DrawInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, std::size_t instanceCount, std::size_t vertexCount) noexcept override;
+    void DrawInstanced(const PrimitiveType& topology, const std::vector<ParticleInstance>& instances, std::size_t vertexPerInstanceCount, std::size_t instanceCount) noexcept override;
     void DrawIndexedInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, const std::vector<unsigned int>& ibo, std::size_t instanceCount) noexcept override;
     void DrawIndexedInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, const std::vector<unsigned int>& ibo, std::size_t instanceCount, std::size_t startIndexLocation, std::size_t baseVertexLocation, std::size_t startInstanceLocation) noexcept override;
 
@@ -515,6 +519,9 @@ private:
     void CreateWorkingVboAndIbo() noexcept;
     void UpdateVbo(const VertexBuffer::buffer_t& vbo) noexcept;
     void UpdateVbio(const VertexBufferInstanced::buffer_t& vbio) noexcept;
+    void UpdateParticleInstances(const ParticleInstanceBuffer::buffer_t& instances) noexcept;
+    //Per-instance layout for ParticleInstance, created against the program's vertex shader the first time it is drawn with and owned by the program.
+    [[nodiscard]] InputLayoutInstanced* GetParticleInputLayout(ShaderProgram* program) noexcept;
     void UpdateIbo(const IndexBuffer::buffer_t& ibo) noexcept;
 
     void Draw(const PrimitiveType& topology, VertexBuffer* vbo, std::size_t vertex_count) noexcept;
@@ -550,12 +557,14 @@ private:
     [[nodiscard]] std::unique_ptr<ShaderProgram> CreateDefaultNormalMapShaderProgram() noexcept;
     [[nodiscard]] std::unique_ptr<ShaderProgram> CreateDefaultFontShaderProgram() noexcept;
     [[nodiscard]] std::unique_ptr<ShaderProgram> CreateDefaultCircle2DShaderProgram() noexcept;
+    [[nodiscard]] std::unique_ptr<ShaderProgram> CreateDefaultParticleShaderProgram() noexcept;
 
     [[nodiscard]] void CreateAndRegisterDefaultShaders() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefaultShader() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefaultUnlitShader() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefault2DShader() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefaultCircle2DShader() noexcept;
+    [[nodiscard]] std::unique_ptr<Shader> CreateDefaultParticleShader() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefaultNormalShader() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefaultNormalMapShader() noexcept;
     [[nodiscard]] std::unique_ptr<Shader> CreateDefaultInvalidShader() noexcept;
@@ -570,6 +579,7 @@ private:
     [[nodiscard]] std::unique_ptr<Material> CreateDefaultNormalMapMaterial() noexcept;
     [[nodiscard]] std::unique_ptr<Material> CreateDefaultInvalidMaterial() noexcept;
     [[nodiscard]] std::unique_ptr<Material> CreateDefaultCircle2DMaterial() noexcept;
+    [[nodiscard]] std::unique_ptr<Material> CreateDefaultParticleMaterial() noexcept;
 
     void CreateAndRegisterDefaultEngineFonts() noexcept;
 
@@ -617,12 +627,16 @@ private:
 
     void FulfillScreenshotRequest() noexcept;
 
+    //Cleared builder for the immediate-mode draw calls, which each render their mesh before returning.
+    [[nodiscard]] Mesh::Builder& GetScratchMeshBuilder() noexcept;
+
     Camera3D _camera{};
     matrix_buffer_t _matrix_data{};
     time_buffer_t _time_data{};
     lighting_buffer_t _lighting_data{};
     std::size_t _current_vbo_size = 0;
     std::size_t _current_vbio_size = 0;
+    std::size_t _current_particle_instances_size = 0;
     std::size_t _current_ibo_size = 0;
     RHIInstance* _rhi_instance = nullptr;
     std::unique_ptr<RHIDevice> _rhi_device = nullptr;
@@ -639,7 +653,9 @@ private:
     RHIOutputMode _current_outputMode = RHIOutputMode::Windowed;
     std::unique_ptr<VertexBuffer> _temp_vbo = nullptr;
     std::unique_ptr<VertexBufferInstanced> _temp_vbio = nullptr;
+    std::unique_ptr<ParticleInstanceBuffer> _temp_particle_instances = nullptr;
     std::unique_ptr<IndexBuffer> _temp_ibo = nullptr;
+    Mesh::Builder _scratch_builder{};
     std::unique_ptr<ConstantBuffer> _matrix_cb = nullptr;
     std::unique_ptr<ConstantBuffer> _time_cb = nullptr;
     std::unique_ptr<ConstantBuffer> _lighting_cb = nullptr;
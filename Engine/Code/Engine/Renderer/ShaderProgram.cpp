@@ -1,5 +1,6 @@
 #include "Engine/Renderer/ShaderProgram.hpp"
 
+#include "Engine/Core/StringUtils.hpp"
 #include "Engine/Renderer/DirectX/DX11.hpp"
 #include "Engine/Renderer/InputLayout.hpp"
 #include "Engine/Renderer/InputLayoutInstanced.hpp"
@@ -53,6 +54,14 @@ InputLayoutInstanced* ShaderProgram::GetInputLayoutInstanced() const noexcept {
     return _desc.input_layout_instanced.get();
 }
 
+InputLayoutInstanced* ShaderProgram::GetInputLayoutParticles() const noexcept {
+    return _desc.input_layout_particles.get();
+}
+
+void ShaderProgram::SetInputLayoutParticles(std::unique_ptr<InputLayoutInstanced> layout) noexcept {
+    _desc.input_layout_particles = std::move(layout);
+}
+
 ID3D11VertexShader* ShaderProgram::GetVS() const noexcept {
     return _desc.vs;
 }
@@ -61,6 +70,27 @@ bool ShaderProgram::HasVS() const noexcept {
     return GetVS() != nullptr;
 }
 
+bool ShaderProgram::HasVSInput(std::string_view semanticName) const noexcept {
+    if(!_desc.vs_bytecode) {
+        return false;
+    }
+    Microsoft::WRL::ComPtr<ID3D11ShaderReflection> vertexReflection{};
+    if(FAILED(::D3DReflect(_desc.vs_bytecode->GetBufferPointer(), _desc.vs_bytecode->GetBufferSize(), IID_ID3D11ShaderReflection, reinterpret_cast<void**>(vertexReflection.GetAddressOf())))) {
+        return false;
+    }
+    const auto semantic = StringUtils::ToUpperCase(std::string{semanticName});
+    D3D11_SHADER_DESC desc{};
+    vertexReflection->GetDesc(&desc);
+    for(auto i = 0u; i < desc.InputParameters; ++i) {
+        D3D11_SIGNATURE_PARAMETER_DESC input_desc{};
+        vertexReflection->GetInputParameterDesc(i, &input_desc);
+        if(StringUtils::ToUpperCase(std::string{input_desc.SemanticName}) == semantic) {
+            return true;
+        }
+    }
+    return false;
+}
+
 ID3D11HullShader* ShaderProgram::GetHS() const noexcept {
     return _desc.hs;
 }
@@ -111,6 +141,9 @@ ShaderProgramDesc::ShaderProgramDesc(ShaderProgramDesc&& other) noexcept {
     input_layout_instanced = std::move(other.input_layout_instanced);
     other.input_layout_instanced = nullptr;
 
+    input_layout_particles = std::move(other.input_layout_particles);
+    other.input_layout_particles = nullptr;
+
     vs = other.vs;
     vs_bytecode = other.vs_bytecode;
     other.vs = nullptr;
@@ -152,6 +185,9 @@ ShaderProgramDesc& ShaderProgramDesc::operator=(ShaderProgramDesc&& other) noexc
     input_layout_instanced = std::move(other.input_layout_instanced);
     other.input_layout_instanced = nullptr;
 
+    input_layout_particles = std::move(other.input_layout_particles);
+    other.input_layout_particles = nullptr;
+
     vs = other.vs;
     vs_bytecode = other.vs_bytecode;
     other.vs = nullptr;
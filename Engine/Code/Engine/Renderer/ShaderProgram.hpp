@@ -3,6 +3,7 @@
 #include "Engine/Renderer/DirectX/DX11.hpp"
 
 #include <memory>
+#include <string_view>
 
 class InputLayout;
 class InputLayoutInstanced;
@@ -15,6 +16,8 @@ struct ShaderProgramDesc {
     ID3DBlob* ps_bytecode = nullptr;
     std::unique_ptr<InputLayout> input_layout = nullptr;
     std::unique_ptr<InputLayoutInstanced> input_layout_instanced = nullptr;
+    //Reads ParticleInstance data; created by the Renderer the first time the program draws particles.
+    std::unique_ptr<InputLayoutInstanced> input_layout_particles = nullptr;
     ID3D11HullShader* hs = nullptr;
     ID3DBlob* hs_bytecode = nullptr;
     ID3D11DomainShader* ds = nullptr;
@@ -52,7 +55,11 @@ public:
     [[nodiscard]] ID3DBlob* GetCSByteCode() const noexcept;
     [[nodiscard]] InputLayout* GetInputLayout() const noexcept;
     [[nodiscard]] InputLayoutInstanced* GetInputLayoutInstanced() const noexcept;
+    [[nodiscard]] InputLayoutInstanced* GetInputLayoutParticles() const noexcept;
+    void SetInputLayoutParticles(std::unique_ptr<InputLayoutInstanced> layout) noexcept;
     [[nodiscard]] ID3D11VertexShader* GetVS() const noexcept;
+    //Whether the vertex shader declares an input with this semantic, ignoring case as the input assembler does.
+    [[nodiscard]] bool HasVSInput(std::string_view semanticName) const noexcept;
     [[nodiscard]] bool HasVS() const noexcept;
     [[nodiscard]] ID3D11HullShader* GetHS() const noexcept;
     [[nodiscard]] bool HasHS() const noexcept;
@@ -2,11 +2,15 @@
 
 #include "Engine/Services/IService.hpp"
 
+#include "Engine/Core/JobTypes.hpp"
+
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
-
-enum class JobType : std::size_t;
-class Job;
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 class IJobSystemService : public IService {
 public:
@@ -16,18 +20,41 @@ public:
     virtual void Shutdown() noexcept = 0;
 
     virtual void SetCategorySignal(const JobType& category_id, std::condition_variable* signal) noexcept = 0;
-    [[nodiscard]] virtual Job* Create(const JobType& category, const std::function<void(void*)>& cb, void* user_data) noexcept = 0;
-    virtual void Run(const JobType& category, const std::function<void(void*)>& cb, void* user_data) noexcept = 0;
+    [[nodiscard]] virtual Job* Create(const JobType& category, JobCallback cb, void* user_data) noexcept = 0;
+    virtual void Run(const JobType& category, JobCallback cb, void* user_data) noexcept = 0;
     virtual void Dispatch(Job* job) noexcept = 0;
     virtual bool Release(Job* job) noexcept = 0;
     virtual void Wait(Job* job) noexcept = 0;
     virtual void DispatchAndRelease(Job* job) noexcept = 0;
     virtual void WaitAndRelease(Job* job) noexcept = 0;
+    //Runs one queued job the calling thread may run, for callers that wait on something other than a Job.
+    [[nodiscard]] virtual bool TryHelpWhileWaiting() noexcept = 0;
     [[nodiscard]] virtual bool IsRunning() const noexcept = 0;
     virtual void SetIsRunning(bool value = true) noexcept = 0;
 
     [[nodiscard]] virtual std::condition_variable* GetMainJobSignal() const noexcept = 0;
 
+    //Splits [begin, end) into chunks [begin + k * grain, begin + (k + 1) * grain) and runs them across the
+    //generic workers. The calling thread executes chunks too and returns when every chunk has finished.
+    virtual void ParallelForRange(std::size_t begin, std::size_t end, std::size_t grain, JobRangeCallback& cb) noexcept = 0;
+
+    //fn is either fn(std::size_t index) or fn(std::size_t first, std::size_t last).
+    template<typename F>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, F&& fn) noexcept;
+
+    //Each chunk folds map(index) into a copy of identity; the per-chunk results are combined in index order so the result does not depend on scheduling.
+    template<typename T, typename Map, typename Combine>
+    [[nodiscard]] T ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, Map&& map, Combine&& combine) noexcept;
+
+    //Each chunk clears its own buffer from buffers and fn(index, buffer) appends to it; the buffers are then appended to out
+    //in index order, so out matches what a serial loop would produce. buffers is kept by the caller so its capacity is reused.
+    template<typename Buffer, typename Output, typename F>
+    void ParallelGather(std::size_t begin, std::size_t end, std::size_t grain, std::vector<Buffer>& buffers, Output& out, F&& fn) noexcept;
+
+    //Sorts grain-sized runs in parallel then merges neighbouring runs pairwise.
+    template<typename RandomIt, typename Compare = std::less<>>
+    void ParallelSort(RandomIt first, RandomIt last, std::size_t grain, Compare comp = Compare{}) noexcept;
+
 protected:
 private:
 };
@@ -35,3 +62,92 @@ private:
 class NullJobSystemService : public IJobSystemService {
 
 };
+
+template<typename F>
+void IJobSystemService::ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, F&& fn) noexcept {
+    JobRangeCallback cb = [&fn](std::size_t first, std::size_t last) {
+        if constexpr(std::is_invocable_v<F&, std::size_t, std::size_t>) {
+            std::invoke(fn, first, last);
+        } else {
+            for(auto i = first; i != last; ++i) {
+                std::invoke(fn, i);
+            }
+        }
+    };
+    ParallelForRange(begin, end, grain, cb);
+}
+
+template<typename T, typename Map, typename Combine>
+T IJobSystemService::ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, Map&& map, Combine&& combine) noexcept {
+    if(end <= begin) {
+        return identity;
+    }
+    grain = (std::max)(grain, std::size_t{1u});
+    std::vector<T> partials((end - begin + grain - 1u) / grain, identity);
+    ParallelFor(begin, end, grain, [&](std::size_t first, std::size_t last) {
+        auto local = identity;
+        for(auto i = first; i != last; ++i) {
+            local = std::invoke(combine, std::move(local), std::invoke(map, i));
+        }
+        partials[(first - begin) / grain] = std::move(local);
+    });
+    auto result = std::move(identity);
+    for(auto& partial : partials) {
+        result = std::invoke(combine, std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+template<typename Buffer, typename Output, typename F>
+void IJobSystemService::ParallelGather(std::size_t begin, std::size_t end, std::size_t grain, std::vector<Buffer>& buffers, Output& out, F&& fn) noexcept {
+    if(end <= begin) {
+        return;
+    }
+    grain = (std::max)(grain, std::size_t{1u});
+    const auto chunk_count = (end - begin + grain - 1u) / grain;
+    if(buffers.size() < chunk_count) {
+        buffers.resize(chunk_count);
+    }
+    //Cleared up front so a chunk the callback never sees cannot leave the previous call's contents behind.
+    for(std::size_t chunk = 0u; chunk < chunk_count; ++chunk) {
+        buffers[chunk].clear();
+    }
+    ParallelFor(begin, end, grain, [&](std::size_t first, std::size_t last) {
+        auto& buffer = buffers[(first - begin) / grain];
+        for(auto i = first; i != last; ++i) {
+            std::invoke(fn, i, buffer);
+        }
+    });
+    std::size_t total = out.size();
+    for(std::size_t chunk = 0u; chunk < chunk_count; ++chunk) {
+        total += buffers[chunk].size();
+    }
+    out.reserve(total);
+    for(std::size_t chunk = 0u; chunk < chunk_count; ++chunk) {
+        std::copy(std::begin(buffers[chunk]), std::end(buffers[chunk]), std::back_inserter(out));
+    }
+}
+
+template<typename RandomIt, typename Compare>
+void IJobSystemService::ParallelSort(RandomIt first, RandomIt last, std::size_t grain, Compare comp /*= Compare{}*/) noexcept {
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    grain = (std::max)(grain, std::size_t{1u});
+    if(count <= grain) {
+        std::sort(first, last, comp);
+        return;
+    }
+    ParallelFor(std::size_t{0u}, count, grain, [first, &comp](std::size_t lo, std::size_t hi) {
+        std::sort(first + lo, first + hi, comp);
+    });
+    for(auto width = grain; width < count; width *= 2u) {
+        const auto span = width * 2u;
+        ParallelFor(std::size_t{0u}, (count + span - 1u) / span, std::size_t{1u}, [first, &comp, width, span, count](std::size_t pair) {
+            const auto lo = pair * span;
+            const auto mid = (std::min)(lo + width, count);
+            const auto hi = (std::min)(lo + span, count);
+            if(mid < hi) {
+                std::inplace_merge(first + lo, first + mid, first + hi, comp);
+            }
+        });
+    }
+}
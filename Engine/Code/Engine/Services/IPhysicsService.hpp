@@ -9,7 +9,10 @@
 #include "Engine/Physics/RodJoint.hpp"
 #include "Engine/Physics/CableJoint.hpp"
 
+#include <cstdint>
+
 struct PhysicsSystemDesc;
+class PhysicsSnapshot;
 
 class IPhysicsService : public IService {
 public:
@@ -33,6 +36,16 @@ public:
     virtual void EnableGravity(bool isGravityEnabled) noexcept = 0;
     virtual void EnableDrag(bool isDragEnabled) noexcept = 0;
     virtual void EnablePhysics(bool isPhysicsEnabled) noexcept = 0;
+    //How far the current frame is between the last two physics steps, in [0, 1); pass to RigidBody's interpolated getters.
+    virtual [[nodiscard]] float GetInterpolationAlpha() const noexcept = 0;
+
+    //Rollback and replay: a snapshot restores only into the world that saved it, with the same bodies and joints added in the same order.
+    virtual void SaveSnapshot(PhysicsSnapshot& snapshot) const noexcept = 0;
+    //Returns false and leaves the world untouched if the snapshot is malformed or came from a different world.
+    virtual [[nodiscard]] bool RestoreSnapshot(const PhysicsSnapshot& snapshot) noexcept = 0;
+    //Hash of the world after the last step; only computed while PhysicsSystemDesc::check_determinism is set.
+    virtual [[nodiscard]] std::uint64_t GetStepHash() const noexcept = 0;
+    virtual [[nodiscard]] std::uint64_t GetStepCount() const noexcept = 0;
 
     template<typename JointDefType>
     Joint* CreateJoint(const JointDefType& defType) noexcept;
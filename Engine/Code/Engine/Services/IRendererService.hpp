@@ -8,6 +8,7 @@
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/Sampler.hpp"
 #include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/ParticleInstance.hpp"
 #include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Renderer/RasterState.hpp"
 #include "Engine/Renderer/Vertex3D.hpp"
@@ -176,6 +177,8 @@ public:
     virtual void DrawInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, std::size_t instanceCount, std::size_t vertexCount) noexcept = 0;
     virtual void DrawIndexedInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, const std::vector<unsigned int>& ibo, std::size_t instanceCount) noexcept = 0;
     virtual void DrawIndexedInstanced(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<Vertex3DInstanced>& vbio, const std::vector<unsigned int>& ibo, std::size_t instanceCount, std::size_t startIndexLocation, std::size_t baseVertexLocation, std::size_t startInstanceLocation) noexcept = 0;
+    //No per-vertex data: the current material's vertex shader builds each instance's corners from SV_VertexID.
+    virtual void DrawInstanced(const PrimitiveType& topology, const std::vector<ParticleInstance>& instances, std::size_t vertexPerInstanceCount, std::size_t instanceCount) noexcept = 0;
 
     virtual void SetLightingEyePosition(const Vector3& position) noexcept = 0;
     virtual void SetAmbientLight(const Rgba& ambient) noexcept = 0;
@@ -477,6 +480,7 @@ public:
     void DrawInstanced([[maybe_unused]] const PrimitiveType& topology, [[maybe_unused]] const std::vector<Vertex3D>& vbo, [[maybe_unused]] const std::vector<Vertex3DInstanced>& vbio, [[maybe_unused]] std::size_t instanceCount, [[maybe_unused]] std::size_t vertexCount) noexcept override {};
     void DrawIndexedInstanced([[maybe_unused]] const PrimitiveType& topology, [[maybe_unused]] const std::vector<Vertex3D>& vbo, [[maybe_unused]] const std::vector<Vertex3DInstanced>& vbio, [[maybe_unused]] const std::vector<unsigned int>& ibo, [[maybe_unused]] std::size_t instanceCount) noexcept override {}
     void DrawIndexedInstanced([[maybe_unused]] const PrimitiveType& topology, [[maybe_unused]] const std::vector<Vertex3D>& vbo, [[maybe_unused]] const std::vector<Vertex3DInstanced>& vbio, [[maybe_unused]] const std::vector<unsigned int>& ibo, [[maybe_unused]] std::size_t instanceCount, [[maybe_unused]] std::size_t startIndexLocation, [[maybe_unused]] std::size_t baseVertexLocation, [[maybe_unused]] std::size_t startInstanceLocation) noexcept override {};
+    void DrawInstanced([[maybe_unused]] const PrimitiveType& topology, [[maybe_unused]] const std::vector<ParticleInstance>& instances, [[maybe_unused]] std::size_t vertexPerInstanceCount, [[maybe_unused]] std::size_t instanceCount) noexcept override {}
 
     void SetLightingEyePosition([[maybe_unused]] const Vector3& position) noexcept override {}
     void SetAmbientLight([[maybe_unused]] const Rgba& ambient) noexcept override {}
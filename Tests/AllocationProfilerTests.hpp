@@ -0,0 +1,136 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Profiling/AllocationProfiler.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AllocationProfilerTests {
+
+    //Fake call stacks so attribution can be checked without relying on symbols being available.
+    struct FakeCallSite {
+        std::array<void*, 3> frames{};
+        std::uint32_t hash = 0u;
+    };
+
+    [[nodiscard]] inline FakeCallSite MakeCallSite(std::uintptr_t base, std::uint32_t hash) {
+        FakeCallSite site{};
+        for(std::size_t i = 0u; i < site.frames.size(); ++i) {
+            site.frames[i] = reinterpret_cast<void*>(base + i * 0x10u);
+        }
+        site.hash = hash;
+        return site;
+    }
+
+    inline void Record(const FakeCallSite& site, std::size_t size, std::size_t times) {
+        for(std::size_t i = 0u; i < times; ++i) {
+            AllocationProfiler::RecordAllocation(size, site.frames.data(), site.frames.size(), site.hash);
+        }
+    }
+
+} // namespace AllocationProfilerTests
+
+TEST(AllocationProfiler, SizeClassesArePowersOfTwo) {
+    EXPECT_EQ(AllocationProfiler::GetSizeClass(0u), std::size_t{0u});
+    EXPECT_EQ(AllocationProfiler::GetSizeClass(8u), std::size_t{0u});
+    EXPECT_EQ(AllocationProfiler::GetSizeClass(9u), std::size_t{1u});
+    EXPECT_EQ(AllocationProfiler::GetSizeClass(16u), std::size_t{1u});
+    EXPECT_EQ(AllocationProfiler::GetSizeClass(4096u), std::size_t{9u});
+    EXPECT_EQ(AllocationProfiler::GetSizeClass(std::size_t{1u} << 40u), AllocationProfiler::size_class_count - 1u);
+    EXPECT_EQ(AllocationProfiler::GetSizeClassUpperBound(9u), std::size_t{4096u});
+}
+
+TEST(AllocationProfiler, AttributesAllocationsToCallSitesPerFrame) {
+    using namespace AllocationProfilerTests;
+    AllocationProfiler::Reset();
+    AllocationProfiler::Enable(true);
+    const auto small_site = MakeCallSite(0x1000u, 0xABCDu);
+    const auto large_site = MakeCallSite(0x2000u, 0x1234u);
+    Record(small_site, 16u, 100u);
+    Record(large_site, 1000u, 3u);
+    AllocationProfiler::EndFrame(1u);
+
+    const auto& frame_top = AllocationProfiler::GetLastFrameTopCallSites();
+    ASSERT_EQ(frame_top.size(), std::size_t{1u});
+    EXPECT_EQ(frame_top[0].hash, large_site.hash);
+    EXPECT_EQ(frame_top[0].count, std::uint64_t{3u});
+    EXPECT_EQ(frame_top[0].bytes, std::uint64_t{3000u});
+    EXPECT_EQ(frame_top[0].frames, std::vector<void*>(std::begin(large_site.frames), std::end(large_site.frames)));
+    EXPECT_EQ(AllocationProfiler::GetLastFrameHistogram()[AllocationProfiler::GetSizeClass(16u)], std::uint64_t{100u});
+
+    //The next frame only sees its own allocations; the totals keep both, ordered by bytes.
+    Record(small_site, 16u, 1u);
+    AllocationProfiler::EndFrame(10u);
+    ASSERT_EQ(AllocationProfiler::GetLastFrameTopCallSites().size(), std::size_t{1u});
+    EXPECT_EQ(AllocationProfiler::GetLastFrameTopCallSites()[0].hash, small_site.hash);
+    const auto totals = AllocationProfiler::GetTopCallSites(10u);
+    ASSERT_EQ(totals.size(), std::size_t{2u});
+    EXPECT_EQ(totals[0].hash, large_site.hash);
+    EXPECT_EQ(totals[1].hash, small_site.hash);
+    EXPECT_EQ(totals[1].count, std::uint64_t{101u});
+    EXPECT_EQ(totals[1].histogram[AllocationProfiler::GetSizeClass(16u)], std::uint64_t{101u});
+    EXPECT_EQ(AllocationProfiler::GetHistogram()[AllocationProfiler::GetSizeClass(1000u)], std::uint64_t{3u});
+    AllocationProfiler::Enable(false);
+}
+
+TEST(AllocationProfiler, ConcurrentRecordingAndDisabledIsIgnored) {
+    using namespace AllocationProfilerTests;
+    AllocationProfiler::Reset();
+    Record(MakeCallSite(0x3000u, 7u), 32u, 10u);
+    EXPECT_TRUE(AllocationProfiler::GetTopCallSites(10u).empty());
+    AllocationProfiler::Enable(true);
+    std::vector<std::thread> threads{};
+    for(std::uint32_t t = 0u; t < 4u; ++t) {
+        threads.emplace_back([t]() {
+            const auto shared = MakeCallSite(0x4000u, 42u);
+            const auto own = MakeCallSite(0x5000u + t * 0x100u, 100u + t);
+            for(int i = 0; i < 1000; ++i) {
+                Record(shared, 64u, 1u);
+                Record(own, 8u, 1u);
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    AllocationProfiler::Enable(false);
+    const auto totals = AllocationProfiler::GetTopCallSites(10u);
+    ASSERT_EQ(totals.size(), std::size_t{5u});
+    EXPECT_EQ(totals[0].hash, std::uint32_t{42u});
+    EXPECT_EQ(totals[0].count, std::uint64_t{4000u});
+    EXPECT_EQ(totals[0].bytes, std::uint64_t{4000u * 64u});
+    EXPECT_EQ(AllocationProfiler::GetDroppedCount(), std::uint64_t{0u});
+}
+
+TEST(AllocationProfiler, WritesDumpAndReport) {
+    using namespace AllocationProfilerTests;
+    AllocationProfiler::Reset();
+    AllocationProfiler::Enable(true);
+    Record(MakeCallSite(0x6000u, 9u), 24u, 5u);
+    AllocationProfiler::EndFrame();
+    AllocationProfiler::Enable(false);
+
+    std::ostringstream report{};
+    AllocationProfiler::DumpReport(report, 5u);
+    EXPECT_NE(report.str().find("<=32:5"), std::string::npos);
+
+    const auto path = std::filesystem::temp_directory_path() / "allocation_profiler_test.tsv";
+    ASSERT_TRUE(AllocationProfiler::WriteToFile(path));
+    std::ifstream file(path);
+    std::vector<std::string> lines{};
+    for(std::string line{}; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    file.close();
+    std::filesystem::remove(path);
+    ASSERT_EQ(lines.size(), std::size_t{3u});
+    EXPECT_EQ(lines[2].rfind("5\t120\t0,0,5,", 0), std::size_t{0u});
+}
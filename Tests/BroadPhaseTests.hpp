@@ -0,0 +1,166 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/BroadPhase.hpp"
+#include "Engine/Physics/DynamicAABBTreeBroadPhase.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace BroadPhaseTests {
+
+    constexpr std::array<BroadPhaseType, 3> all_types{BroadPhaseType::BruteForce, BroadPhaseType::SweepAndPrune, BroadPhaseType::DynamicAABBTree};
+
+    //Random boxes 1 to 3 units wide, spread so each overlaps a handful of others regardless of count.
+    struct Scene {
+        explicit Scene(std::size_t count, unsigned int seed = 1729u)
+        : random{seed}
+        , world_size{std::sqrt(static_cast<float>(count)) * 6.0f} {
+            bounds.reserve(count);
+            for(std::size_t i = 0u; i < count; ++i) {
+                bounds.push_back(RandomBox());
+            }
+        }
+
+        [[nodiscard]] AABB2 RandomBox() {
+            return random.Box(0.0f, world_size, 0.5f, 1.5f);
+        }
+
+        void Step(float max_distance) {
+            for(auto& box : bounds) {
+                box.Translate(random.Value2(-max_distance, max_distance));
+            }
+        }
+
+        TestUtils::Random random;
+        float world_size = 0.0f;
+        std::vector<AABB2> bounds{};
+    };
+
+    struct Instance {
+        explicit Instance(BroadPhaseType type)
+        : broad_phase{BroadPhase::Create(type, 0.5f)} {
+            /* DO NOTHING */
+        }
+        std::unique_ptr<BroadPhase> broad_phase{};
+        std::vector<BroadPhase::ProxyId> proxies{};
+        std::pmr::vector<BroadPhase::Pair> pairs{};
+    };
+
+} // namespace BroadPhaseTests
+
+TEST(BroadPhase, EveryTypeFindsTheSamePairs) {
+    using namespace BroadPhaseTests;
+    Scene scene{500u};
+    std::vector<Instance> instances{};
+    for(const auto type : all_types) {
+        auto& instance = instances.emplace_back(type);
+        for(const auto& box : scene.bounds) {
+            instance.proxies.push_back(instance.broad_phase->CreateProxy(box, nullptr));
+        }
+    }
+    for(int step = 0; step < 20; ++step) {
+        scene.Step(step < 10 ? 0.25f : 2.0f);
+        //Replace a few bodies every step so proxy ids get recycled.
+        for(std::size_t i = 0u; i < 5u; ++i) {
+            const auto index = (step * 37u + i * 101u) % scene.bounds.size();
+            scene.bounds[index] = scene.RandomBox();
+            for(auto& instance : instances) {
+                instance.broad_phase->DestroyProxy(instance.proxies[index]);
+                instance.proxies[index] = instance.broad_phase->CreateProxy(scene.bounds[index], nullptr);
+            }
+        }
+        for(auto& instance : instances) {
+            for(std::size_t i = 0u; i < scene.bounds.size(); ++i) {
+                instance.broad_phase->MoveProxy(instance.proxies[i], scene.bounds[i]);
+            }
+            instance.broad_phase->FindPairs(instance.pairs);
+        }
+        ASSERT_FALSE(instances[0].pairs.empty());
+        for(std::size_t i = 1u; i < instances.size(); ++i) {
+            ASSERT_EQ(instances[i].proxies, instances[0].proxies);
+            ASSERT_EQ(instances[i].pairs, instances[0].pairs) << "step " << step << ", type " << i;
+        }
+    }
+    for(const auto& pair : instances[0].pairs) {
+        EXPECT_LT(pair.a, pair.b);
+    }
+}
+
+TEST(BroadPhase, TreeStaysBalancedAndIgnoresSmallMoves) {
+    DynamicAABBTreeBroadPhase tree{1.0f};
+    //Inserting in sorted order degenerates an unbalanced tree into a list.
+    std::vector<BroadPhase::ProxyId> proxies{};
+    for(int i = 0; i < 1024; ++i) {
+        const auto x = static_cast<float>(i) * 3.0f;
+        proxies.push_back(tree.CreateProxy(AABB2{Vector2{x, 0.0f}, Vector2{x + 1.0f, 1.0f}}, nullptr));
+    }
+    EXPECT_EQ(tree.GetProxyCount(), std::size_t{1024u});
+    EXPECT_LE(tree.GetHeight(), 20);
+
+    const auto fat_before = tree.GetFatBounds(proxies[10]);
+    tree.MoveProxy(proxies[10], AABB2{Vector2{30.5f, 0.5f}, Vector2{31.5f, 1.5f}});
+    EXPECT_EQ(tree.GetFatBounds(proxies[10]).mins, fat_before.mins);
+    EXPECT_EQ(tree.GetFatBounds(proxies[10]).maxs, fat_before.maxs);
+    tree.MoveProxy(proxies[10], AABB2{Vector2{32.5f, 0.0f}, Vector2{33.5f, 1.0f}});
+    EXPECT_NE(tree.GetFatBounds(proxies[10]).mins, fat_before.mins);
+
+    std::pmr::vector<BroadPhase::Pair> pairs{};
+    tree.FindPairs(pairs);
+    ASSERT_EQ(pairs.size(), std::size_t{1u});
+    EXPECT_EQ(pairs[0], (BroadPhase::Pair{proxies[10], proxies[11]}));
+
+    for(const auto proxy : proxies) {
+        tree.DestroyProxy(proxy);
+    }
+    EXPECT_EQ(tree.GetProxyCount(), std::size_t{0u});
+    EXPECT_EQ(tree.GetHeight(), 0);
+    tree.FindPairs(pairs);
+    EXPECT_TRUE(pairs.empty());
+}
+
+TEST(BroadPhaseBenchmark, DISABLED_StepTimeByBodyCount) {
+    using namespace BroadPhaseTests;
+    constexpr std::array<const char*, 3> names{"brute force", "sweep and prune", "aabb tree"};
+    constexpr int steps = 10;
+    std::cout << std::setw(10) << "bodies" << std::setw(18) << names[0] << std::setw(18) << names[1] << std::setw(18) << names[2] << "   (ms per step)\n";
+    for(const std::size_t count : {1000u, 10000u, 50000u}) {
+        std::cout << std::setw(10) << count;
+        std::size_t expected_pairs = 0u;
+        for(const auto type : all_types) {
+            if(type == BroadPhaseType::BruteForce && count > 10000u) {
+                std::cout << std::setw(18) << "-";
+                continue;
+            }
+            Scene scene{count};
+            Instance instance{type};
+            for(const auto& box : scene.bounds) {
+                instance.proxies.push_back(instance.broad_phase->CreateProxy(box, nullptr));
+            }
+            instance.broad_phase->FindPairs(instance.pairs);
+            auto elapsed = std::chrono::duration<double, std::milli>::zero();
+            for(int step = 0; step < steps; ++step) {
+                scene.Step(0.1f);
+                const auto start = std::chrono::steady_clock::now();
+                for(std::size_t i = 0u; i < count; ++i) {
+                    instance.broad_phase->MoveProxy(instance.proxies[i], scene.bounds[i]);
+                }
+                instance.broad_phase->FindPairs(instance.pairs);
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+            if(expected_pairs) {
+                EXPECT_EQ(instance.pairs.size(), expected_pairs);
+            }
+            expected_pairs = instance.pairs.size();
+            std::cout << std::setw(18) << std::fixed << std::setprecision(3) << elapsed.count() / steps;
+        }
+        std::cout << '\n';
+    }
+}
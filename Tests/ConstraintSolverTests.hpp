@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Physics/ConstraintSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ConstraintSolverTests {
+
+    constexpr auto dt = 1.0f / 60.0f;
+    constexpr auto gravity = -10.0f;
+
+    struct StackResult {
+        float max_penetration = 0.0f;
+        float max_speed = 0.0f;
+    };
+
+    //A column of unit boxes resting on static ground, stepped the way PhysicsSystem drives the solver.
+    StackResult SimulateStack(std::size_t box_count, int iterations, bool warm_start, int steps) {
+        std::vector<float> y{-0.5f};
+        std::vector<float> vy{0.0f};
+        for(std::size_t i = 0u; i < box_count; ++i) {
+            y.push_back(static_cast<float>(i) + 0.5f);
+            vy.push_back(0.0f);
+        }
+        std::vector<float> cached(y.size(), 0.0f);
+        ConstraintSolver solver{};
+        StackResult result{};
+        for(int step = 0; step < steps; ++step) {
+            solver.Reset(ConstraintSolver::Settings{});
+            for(std::size_t i = 0u; i < y.size(); ++i) {
+                if(i) {
+                    vy[i] += gravity * dt;
+                }
+                (void)solver.AddBody(Vector2{0.0f, y[i]}, Vector2{0.0f, vy[i]}, i ? 1.0f : 0.0f);
+            }
+            std::vector<std::size_t> contacts(y.size(), static_cast<std::size_t>(-1));
+            for(std::size_t i = 1u; i < y.size(); ++i) {
+                const auto depth = 1.0f - (y[i] - y[i - 1u]);
+                if(0.0f <= depth) {
+                    const auto a = static_cast<ConstraintSolver::BodyIndex>(i - 1u);
+                    const auto b = static_cast<ConstraintSolver::BodyIndex>(i);
+                    contacts[i] = solver.AddContact(a, b, Vector2{0.0f, 1.0f}, depth, 0.5f, 0.0f, warm_start ? cached[i] : 0.0f);
+                } else {
+                    cached[i] = 0.0f;
+                }
+            }
+            solver.SolveVelocities(iterations);
+            for(std::size_t i = 1u; i < y.size(); ++i) {
+                vy[i] = solver.GetVelocity(static_cast<ConstraintSolver::BodyIndex>(i)).y;
+                y[i] += vy[i] * dt;
+                solver.SetPosition(static_cast<ConstraintSolver::BodyIndex>(i), Vector2{0.0f, y[i]});
+                if(contacts[i] != static_cast<std::size_t>(-1)) {
+                    cached[i] = solver.GetNormalImpulse(contacts[i]);
+                }
+            }
+            (void)solver.SolvePositions(iterations);
+            for(std::size_t i = 1u; i < y.size(); ++i) {
+                y[i] = solver.GetPosition(static_cast<ConstraintSolver::BodyIndex>(i)).y;
+            }
+        }
+        for(std::size_t i = 1u; i < y.size(); ++i) {
+            result.max_penetration = (std::max)(result.max_penetration, 1.0f - (y[i] - y[i - 1u]));
+            result.max_speed = (std::max)(result.max_speed, std::abs(vy[i]));
+        }
+        return result;
+    }
+
+} // namespace ConstraintSolverTests
+
+TEST(ConstraintSolver, WarmStartedStackSettles) {
+    using namespace ConstraintSolverTests;
+    const auto warm = SimulateStack(10u, 4, true, 180);
+    const auto cold = SimulateStack(10u, 4, false, 180);
+    EXPECT_LT(warm.max_penetration, 0.02f);
+    EXPECT_LT(warm.max_speed, 0.05f);
+    EXPECT_LT(warm.max_penetration, cold.max_penetration);
+}
+
+TEST(ConstraintSolver, RestitutionAndFriction) {
+    using namespace ConstraintSolverTests;
+    ConstraintSolver solver{};
+    solver.Reset(ConstraintSolver::Settings{});
+    const auto ground = solver.AddBody(Vector2{0.0f, -0.5f}, Vector2::Zero, 0.0f);
+    const auto ball = solver.AddBody(Vector2{0.0f, 0.5f}, Vector2{4.0f, -10.0f}, 1.0f);
+    const auto contact = solver.AddContact(ground, ball, Vector2{0.0f, 1.0f}, 0.0f, 0.1f, 0.5f);
+    solver.SolveVelocities(8);
+    EXPECT_NEAR(solver.GetVelocity(ball).y, 5.0f, 0.001f);
+    //Friction may remove at most its coefficient times the normal impulse from the sliding speed.
+    EXPECT_NEAR(solver.GetNormalImpulse(contact), 15.0f, 0.001f);
+    EXPECT_NEAR(std::abs(solver.GetTangentImpulse(contact)), 1.5f, 0.001f);
+    EXPECT_NEAR(solver.GetVelocity(ball).x, 2.5f, 0.001f);
+}
+
+TEST(ConstraintSolver, RodKeepsItsLength) {
+    using namespace ConstraintSolverTests;
+    ConstraintSolver solver{};
+    Vector2 position{2.0f, 0.0f};
+    Vector2 velocity{};
+    auto impulse = 0.0f;
+    for(int step = 0; step < 600; ++step) {
+        velocity.y += gravity * dt;
+        solver.Reset(ConstraintSolver::Settings{});
+        const auto anchor = solver.AddBody(Vector2::Zero, Vector2::Zero, 0.0f);
+        const auto bob = solver.AddBody(position, velocity, 1.0f);
+        const auto rod = solver.AddDistance(anchor, bob, Vector2::Zero, position, 2.0f, false, impulse);
+        solver.SolveVelocities(4);
+        impulse = solver.GetNormalImpulse(rod);
+        velocity = solver.GetVelocity(bob);
+        solver.SetPosition(bob, position + velocity * dt);
+        (void)solver.SolvePositions(4);
+        position = solver.GetPosition(bob);
+        ASSERT_NEAR(position.CalcLength(), 2.0f, 0.02f) << "step " << step;
+    }
+}
+
+TEST(ConstraintSolver, CableOnlyPulls) {
+    ConstraintSolver solver{};
+    solver.Reset(ConstraintSolver::Settings{});
+    const auto anchor = solver.AddBody(Vector2::Zero, Vector2::Zero, 0.0f);
+    const auto slack = solver.AddBody(Vector2{0.5f, 0.0f}, Vector2{3.0f, 0.0f}, 1.0f);
+    const auto taut = solver.AddBody(Vector2{0.0f, -1.0f}, Vector2{1.0f, -3.0f}, 1.0f);
+    const auto slack_cable = solver.AddDistance(anchor, slack, Vector2::Zero, Vector2{0.5f, 0.0f}, 1.0f, true, -5.0f);
+    const auto taut_cable = solver.AddDistance(anchor, taut, Vector2::Zero, Vector2{0.0f, -1.0f}, 1.0f, true);
+    solver.SolveVelocities(4);
+    //A slack cable drops its warm start impulse and leaves the body alone.
+    EXPECT_EQ(solver.GetVelocity(slack), Vector2(3.0f, 0.0f));
+    EXPECT_EQ(solver.GetNormalImpulse(slack_cable), 0.0f);
+    //A taut one stops the body moving away but keeps the sideways motion.
+    EXPECT_NEAR(solver.GetVelocity(taut).y, 0.0f, 0.0001f);
+    EXPECT_NEAR(solver.GetVelocity(taut).x, 1.0f, 0.0001f);
+    EXPECT_LT(solver.GetNormalImpulse(taut_cable), 0.0f);
+    //Moving towards the anchor is never resisted.
+    solver.Reset(ConstraintSolver::Settings{});
+    const auto a = solver.AddBody(Vector2::Zero, Vector2::Zero, 0.0f);
+    const auto b = solver.AddBody(Vector2{0.0f, -1.0f}, Vector2{0.0f, 3.0f}, 1.0f);
+    (void)solver.AddDistance(a, b, Vector2::Zero, Vector2{0.0f, -1.0f}, 1.0f, true);
+    solver.SolveVelocities(4);
+    EXPECT_EQ(solver.GetVelocity(b), Vector2(0.0f, 3.0f));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Core/FixedTimestep.hpp"
+
+#include <random>
+
+TEST(FixedTimestep, StepCountDoesNotDependOnFrameRate) {
+    std::mt19937 rng{5u};
+    for(const auto frame_rate : {24.0f, 30.0f, 60.0f, 144.0f, 240.0f}) {
+        FixedTimestep timestep{60.0f, 8};
+        //Frame times jitter by up to 20% around the average.
+        std::uniform_real_distribution<float> jitter(0.8f, 1.2f);
+        auto elapsed = 0.0f;
+        auto steps = 0;
+        while(elapsed < 10.0f) {
+            const auto frame = jitter(rng) / frame_rate;
+            elapsed += frame;
+            steps += timestep.Advance(TimeUtils::FPSeconds{frame});
+            ASSERT_GE(timestep.GetAlpha(), 0.0f);
+            ASSERT_LT(timestep.GetAlpha(), 1.0f);
+        }
+        //Simulated time plus the leftover accounts for all of the elapsed time.
+        const auto simulated = (static_cast<float>(steps) + timestep.GetAlpha()) * timestep.GetStepDuration().count();
+        EXPECT_NEAR(simulated, elapsed, 0.001f) << frame_rate << " fps";
+    }
+}
+
+TEST(FixedTimestep, LongFramesAreCappedAndDropped) {
+    FixedTimestep timestep{50.0f, 4};
+    EXPECT_FLOAT_EQ(timestep.GetStepDuration().count(), 0.02f);
+    EXPECT_EQ(timestep.Advance(TimeUtils::FPSeconds{0.03f}), 1);
+    EXPECT_NEAR(timestep.GetAlpha(), 0.5f, 0.0001f);
+    //A one second hitch runs the budget and does not leave a backlog for the following frames.
+    EXPECT_EQ(timestep.Advance(TimeUtils::FPSeconds{1.0f}), 4);
+    EXPECT_LT(timestep.GetAlpha(), 1.0f);
+    EXPECT_EQ(timestep.Advance(TimeUtils::FPSeconds{0.0f}), 0);
+    timestep.Reset();
+    EXPECT_EQ(timestep.GetAlpha(), 0.0f);
+    EXPECT_EQ(timestep.Advance(TimeUtils::FPSeconds{-1.0f}), 0);
+    EXPECT_EQ(timestep.GetAlpha(), 0.0f);
+}
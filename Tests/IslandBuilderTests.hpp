@@ -0,0 +1,92 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Physics/IslandBuilder.hpp"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace IslandBuilderTests {
+
+    //Labels connected components by flood fill, numbered in order of their lowest member like IslandBuilder.
+    [[nodiscard]] inline std::vector<std::size_t> FloodFill(std::size_t body_count, const std::vector<std::pair<std::size_t, std::size_t>>& links) {
+        std::vector<std::vector<std::size_t>> neighbours(body_count);
+        for(const auto& [a, b] : links) {
+            neighbours[a].push_back(b);
+            neighbours[b].push_back(a);
+        }
+        static constexpr auto unvisited = std::size_t(-1);
+        std::vector<std::size_t> islands(body_count, unvisited);
+        std::size_t island_count = 0u;
+        for(std::size_t start = 0u; start < body_count; ++start) {
+            if(islands[start] != unvisited) {
+                continue;
+            }
+            std::vector<std::size_t> open{start};
+            islands[start] = island_count;
+            while(!open.empty()) {
+                const auto body = open.back();
+                open.pop_back();
+                for(const auto next : neighbours[body]) {
+                    if(islands[next] == unvisited) {
+                        islands[next] = island_count;
+                        open.push_back(next);
+                    }
+                }
+            }
+            ++island_count;
+        }
+        return islands;
+    }
+
+} // namespace IslandBuilderTests
+
+TEST(IslandBuilder, MatchesFloodFill) {
+    using namespace IslandBuilderTests;
+    std::mt19937 rng{77u};
+    IslandBuilder builder{};
+    for(const std::size_t body_count : {1u, 10u, 500u, 5000u}) {
+        std::uniform_int_distribution<std::size_t> body(0u, body_count - 1u);
+        std::vector<std::pair<std::size_t, std::size_t>> links{};
+        for(std::size_t i = 0u; i < body_count * 3u / 4u; ++i) {
+            links.emplace_back(body(rng), body(rng));
+        }
+        builder.Reset(body_count);
+        for(const auto& [a, b] : links) {
+            builder.Link(a, b);
+        }
+        const auto island_count = builder.Build();
+        const auto expected = FloodFill(body_count, links);
+        std::size_t counted = 0u;
+        for(std::size_t island = 0u; island < island_count; ++island) {
+            auto previous = std::size_t(-1);
+            builder.ForEachBody(island, [&](std::size_t index) {
+                EXPECT_EQ(expected[index], island) << body_count << " bodies, body " << index;
+                EXPECT_TRUE(previous == std::size_t(-1) || previous < index);
+                previous = index;
+                ++counted;
+            });
+        }
+        EXPECT_EQ(counted, body_count);
+        for(std::size_t i = 0u; i < body_count; ++i) {
+            ASSERT_EQ(builder.GetIsland(i), expected[i]) << body_count << " bodies, body " << i;
+        }
+    }
+}
+
+TEST(IslandBuilder, UnlinkedBodiesAreTheirOwnIslands) {
+    IslandBuilder builder{};
+    builder.Reset(6u);
+    builder.Link(4u, 1u);
+    builder.Link(1u, 4u);
+    builder.Link(5u, 4u);
+    EXPECT_EQ(builder.Build(), std::size_t{4u});
+    EXPECT_EQ(builder.GetIsland(0u), std::size_t{0u});
+    EXPECT_EQ(builder.GetIsland(5u), std::size_t{1u});
+    EXPECT_EQ(builder.GetBodyCount(1u), std::size_t{3u});
+    EXPECT_EQ(builder.GetIsland(3u), std::size_t{3u});
+    builder.Reset(0u);
+    EXPECT_EQ(builder.Build(), std::size_t{0u});
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Core/InlineFunction.hpp"
+#include "Engine/Core/JobPool.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/TaskGraph.hpp"
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Profiling/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace JobSystemTests {
+
+    [[nodiscard]] inline double MeasureJobsPerSecond(JobSchedulerMode mode, int thread_count, std::size_t job_count) {
+        JobSystem js(thread_count, static_cast<std::size_t>(JobType::Max), nullptr, mode);
+        std::atomic<std::size_t> completed{0u};
+        const auto start = TimeUtils::Now();
+        for(std::size_t i = 0u; i < job_count; ++i) {
+            js.Run(JobType::Generic, [&completed](void*) { ++completed; }, nullptr);
+        }
+        while(completed != job_count) {
+            std::this_thread::yield();
+        }
+        const auto elapsed = TimeUtils::FPSeconds{TimeUtils::Now() - start};
+        js.Shutdown();
+        return static_cast<double>(job_count) / elapsed.count();
+    }
+
+    inline void RunBatch(JobSystem& js, std::atomic<std::size_t>& completed, std::size_t job_count) {
+        completed = 0u;
+        for(std::size_t i = 0u; i < job_count; ++i) {
+            js.Run(JobType::Generic, [&completed](void*) { ++completed; }, nullptr);
+        }
+        while(completed != job_count) {
+            std::this_thread::yield();
+        }
+    }
+
+} // namespace JobSystemTests
+
+TEST(JobSystem, WorkStealingRunsEveryGenericJob) {
+    JobSystem js(4, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic<std::size_t> completed{0u};
+    const auto job_count = std::size_t{10000u};
+    for(std::size_t i = 0u; i < job_count; ++i) {
+        js.Run(JobType::Generic, [&completed](void*) { ++completed; }, nullptr);
+    }
+    while(completed != job_count) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(completed, job_count);
+}
+
+TEST(JobSystem, WorkStealingJobsDispatchedFromWorkersAreExecuted) {
+    JobSystem js(2, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic<std::size_t> completed{0u};
+    const auto fanout = std::size_t{64u};
+    for(std::size_t i = 0u; i < fanout; ++i) {
+        js.Run(JobType::Generic, [&js, &completed, fanout](void*) {
+            for(std::size_t j = 0u; j < fanout; ++j) {
+                js.Run(JobType::Generic, [&completed](void*) { ++completed; }, nullptr);
+            }
+        }, nullptr);
+    }
+    while(completed != fanout * fanout) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(completed, fanout * fanout);
+}
+
+TEST(JobSystem, WaitReturnsAfterJobFinishes) {
+    JobSystem js(2, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic_bool ran = false;
+    auto* job = js.Create(JobType::Generic, [&ran](void*) { ran = true; }, nullptr);
+    js.Dispatch(job);
+    js.WaitAndRelease(job);
+    EXPECT_TRUE(ran);
+}
+
+TEST(JobSystem, WaitRunsTheJobWhenEveryWorkerIsBusy) {
+    JobSystem js(1, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic_bool released = false;
+    std::atomic_bool blocker_started = false;
+    js.Run(JobType::Generic, [&released, &blocker_started](void*) {
+        blocker_started = true;
+        while(!released) {
+            std::this_thread::yield();
+        }
+    }, nullptr);
+    while(!blocker_started) {
+        std::this_thread::yield();
+    }
+    //The only worker is stuck until this job runs, so the waiting thread has to run it itself.
+    auto* job = js.Create(JobType::Generic, [&released](void*) { released = true; }, nullptr);
+    js.Dispatch(job);
+    js.WaitAndRelease(job);
+    EXPECT_TRUE(released);
+}
+
+TEST(JobSystem, WaitOnMainThreadRunsQueuedMainJobs) {
+    JobSystem js(1, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic_bool ran = false;
+    auto* job = js.Create(JobType::Main, [&ran](void*) { ran = true; }, nullptr);
+    js.Dispatch(job);
+    js.WaitAndRelease(job);
+    EXPECT_TRUE(ran);
+}
+
+TEST(JobSystem, SteadyStateDispatchDoesNotAllocate) {
+    JobSystem js(2, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic<std::size_t> completed{0u};
+    JobSystemTests::RunBatch(js, completed, 2048u);
+    const auto slabs = JobPool::stats().slab_count;
+    const auto fallbacks = JobCallback::heap_fallback_count();
+    AllocationTracker::enable(true);
+    if(!AllocationTracker::is_enabled()) {
+        GTEST_SKIP() << "Allocation tracking is compiled out of this build.";
+    }
+    JobSystemTests::RunBatch(js, completed, 1024u);
+    //Every job has finished, so stop counting before reading the total.
+    AllocationTracker::enable(false);
+    const auto allocations = AllocationTracker::frameCount.load();
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(JobPool::stats().slab_count, slabs);
+    EXPECT_EQ(JobCallback::heap_fallback_count(), fallbacks);
+}
+
+TEST(InlineFunction, SmallCapturesAreStoredInline) {
+    int value = 0;
+    InlineFunction<void(int), 64> f = [&value](int x) { value += x; };
+    EXPECT_TRUE(f.is_inline());
+    f(5);
+    auto g = std::move(f);
+    g(2);
+    EXPECT_FALSE(static_cast<bool>(f));
+    EXPECT_EQ(value, 7);
+}
+
+TEST(InlineFunction, LargeCapturesFallBackToHeapAndAreCounted) {
+    using CharFunction = InlineFunction<char(), 64>;
+    std::array<char, 128> big{};
+    big[0] = 'a';
+    const auto before = CharFunction::heap_fallback_count();
+    CharFunction f = [big]() { return big[0]; };
+    EXPECT_FALSE(f.is_inline());
+    EXPECT_EQ(f(), 'a');
+    EXPECT_EQ(CharFunction::heap_fallback_count(), before + 1u);
+}
+
+TEST(InlineFunction, CallingEmptyThrows) {
+    InlineFunction<void(), 64> f{};
+    EXPECT_THROW(f(), std::bad_function_call);
+    f = []() {};
+    f.reset();
+    EXPECT_THROW(f(), std::bad_function_call);
+}
+
+TEST(JobSystem, ParallelForVisitsEveryIndexOnce) {
+    JobSystem js(3, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::vector<int> visits(100003u, 0);
+    js.ParallelFor(std::size_t{0u}, visits.size(), std::size_t{1000u}, [&visits](std::size_t i) { ++visits[i]; });
+    EXPECT_TRUE(std::all_of(std::cbegin(visits), std::cend(visits), [](int v) { return v == 1; }));
+}
+
+TEST(JobSystem, ParallelForNestedInsideJobsCompletes) {
+    JobSystem js(2, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::atomic<std::size_t> total{0u};
+    js.ParallelFor(std::size_t{0u}, std::size_t{16u}, std::size_t{1u}, [&js, &total](std::size_t) {
+        js.ParallelFor(std::size_t{0u}, std::size_t{1000u}, std::size_t{100u}, [&total](std::size_t first, std::size_t last) { total += last - first; });
+    });
+    EXPECT_EQ(total, std::size_t{16000u});
+}
+
+TEST(JobSystem, ParallelReduceMatchesSerialSum) {
+    JobSystem js(3, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    const auto count = std::size_t{250000u};
+    const auto sum = js.ParallelReduce(std::size_t{0u}, count, std::size_t{4096u}, std::uint64_t{0u}, [](std::size_t i) { return static_cast<std::uint64_t>(i); }, std::plus<>{});
+    EXPECT_EQ(sum, static_cast<std::uint64_t>(count) * (count - 1u) / 2u);
+}
+
+TEST(JobSystem, ParallelGatherMatchesSerialLoop) {
+    JobSystem js(3, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    const auto count = std::size_t{20000u};
+    //Keep the multiples of 3, each one twice, so chunks produce differently sized outputs.
+    const auto gather = [](std::size_t i, std::vector<std::size_t>& buffer) {
+        if(i % 3u == 0u) {
+            buffer.push_back(i);
+            buffer.push_back(i + 1u);
+        }
+    };
+    std::vector<std::size_t> expected{};
+    for(std::size_t i = 0u; i < count; ++i) {
+        gather(i, expected);
+    }
+    std::vector<std::vector<std::size_t>> buffers{};
+    for(int run = 0; run < 3; ++run) {
+        std::vector<std::size_t> gathered{};
+        js.ParallelGather(std::size_t{0u}, count, std::size_t{97u}, buffers, gathered, gather);
+        ASSERT_EQ(gathered, expected) << "run " << run;
+    }
+    EXPECT_EQ(buffers.size(), (count + 96u) / 97u);
+}
+
+TEST(JobSystem, ParallelGatherAfterShutdownStillFillsEveryChunk) {
+    JobSystem js(3, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    const auto count = std::size_t{1000u};
+    const auto gather = [](std::size_t i, std::vector<std::size_t>& buffer) { buffer.push_back(i); };
+    std::vector<std::vector<std::size_t>> buffers{};
+    std::vector<std::size_t> gathered{};
+    js.ParallelGather(std::size_t{0u}, count, std::size_t{100u}, buffers, gathered, gather);
+    ASSERT_EQ(gathered.size(), count);
+    //With no workers the range runs inline; every chunk must still be rebuilt rather than left over from the last call.
+    js.Shutdown();
+    gathered.clear();
+    js.ParallelGather(std::size_t{0u}, count, std::size_t{100u}, buffers, gathered, gather);
+    ASSERT_EQ(gathered.size(), count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        EXPECT_EQ(gathered[i], i);
+    }
+}
+
+TEST(JobSystem, ParallelSortSortsLikeStdSort) {
+    JobSystem js(3, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    std::vector<int> values(50000u);
+    std::mt19937 rng{1234u};
+    std::generate(std::begin(values), std::end(values), [&rng]() { return static_cast<int>(rng() % 100000u); });
+    auto expected = values;
+    std::sort(std::begin(expected), std::end(expected));
+    js.ParallelSort(std::begin(values), std::end(values), std::size_t{1024u});
+    EXPECT_EQ(values, expected);
+}
+
+TEST(TaskGraph, InfersDependenciesFromReadsAndWrites) {
+    TaskGraph graph;
+    const auto input = graph.AddStage({"input", {}, {"input"}}, nullptr);
+    const auto physics = graph.AddStage({"physics", {}, {"bodies"}}, nullptr);
+    const auto ui = graph.AddStage({"ui", {"input"}, {"ui"}}, nullptr);
+    const auto game = graph.AddStage({"game", {"input", "bodies"}, {"game"}}, nullptr);
+    const auto render = graph.AddStage({"render", {"game", "ui"}, {"input"}}, nullptr);
+    graph.ExecuteSerial(TimeUtils::FPSeconds{0.0f});
+    EXPECT_TRUE(graph.GetDependencies(input).empty());
+    EXPECT_TRUE(graph.GetDependencies(physics).empty());
+    EXPECT_EQ(graph.GetDependencies(ui), std::vector<std::size_t>({input}));
+    EXPECT_EQ(graph.GetDependencies(game), std::vector<std::size_t>({input, physics}));
+    //render reads game and ui and overwrites input, so it also waits for every earlier reader of input.
+    EXPECT_EQ(graph.GetDependencies(render), std::vector<std::size_t>({input, ui, game}));
+}
+
+TEST(TaskGraph, RunsStagesAfterTheirDependenciesAndMainStagesOnCaller) {
+    JobSystem js(3, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing);
+    TaskGraph graph;
+    std::array<std::atomic_bool, 5> finished{};
+    std::atomic_bool order_ok = true;
+    std::atomic_bool main_ok = true;
+    const auto caller = std::this_thread::get_id();
+    const auto stage = [&](std::size_t id, std::vector<std::size_t> prerequisites, bool on_main) {
+        return [&, id, prerequisites, on_main](TimeUtils::FPSeconds) {
+            for(const auto r : prerequisites) {
+                if(!finished[r]) {
+                    order_ok = false;
+                }
+            }
+            if(on_main && std::this_thread::get_id() != caller) {
+                main_ok = false;
+            }
+            finished[id] = true;
+        };
+    };
+    graph.AddStage({"input", {}, {"input"}, TaskAffinity::MainThread}, stage(0u, {}, true));
+    graph.AddStage({"physics", {}, {"bodies"}}, stage(1u, {}, false));
+    graph.AddStage({"particles", {"bodies"}, {"particles"}}, stage(2u, {1u}, false));
+    graph.AddStage({"ui", {"input"}, {"ui"}, TaskAffinity::MainThread}, stage(3u, {0u}, true));
+    graph.AddStage({"render", {"ui", "particles", "bodies"}, {"frame"}, TaskAffinity::MainThread}, stage(4u, {1u, 2u, 3u}, true));
+    for(int frame = 0; frame < 50; ++frame) {
+        for(auto& f : finished) {
+            f = false;
+        }
+        graph.Execute(js, TimeUtils::FPSeconds{1.0f / 60.0f});
+        EXPECT_TRUE(std::all_of(std::cbegin(finished), std::cend(finished), [](const auto& f) { return f.load(); }));
+    }
+    EXPECT_TRUE(order_ok);
+    EXPECT_TRUE(main_ok);
+}
+
+TEST(TaskGraph, DumpMarksCriticalPath) {
+    TaskGraph graph;
+    graph.AddStage({"fast", {}, {"a"}}, [](TimeUtils::FPSeconds) {});
+    graph.AddStage({"slow", {}, {"b"}}, [](TimeUtils::FPSeconds) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+    graph.AddStage({"join", {"a", "b"}, {"c"}}, [](TimeUtils::FPSeconds) {});
+    graph.ExecuteSerial(TimeUtils::FPSeconds{0.0f});
+    const auto& timings = graph.GetLastFrameTimings();
+    EXPECT_FALSE(timings[0].on_critical_path);
+    EXPECT_TRUE(timings[1].on_critical_path);
+    EXPECT_TRUE(timings[2].on_critical_path);
+    EXPECT_GE(graph.GetLastCriticalPathDuration().count(), 5.0f);
+    std::ostringstream ss;
+    graph.DumpLastFrame(ss);
+    EXPECT_NE(ss.str().find("* slow"), std::string::npos);
+    EXPECT_NE(ss.str().find("join"), std::string::npos);
+}
+
+TEST(JobSystemBenchmark, DISABLED_JobsPerSecondByThreadCount) {
+    const auto job_count = std::size_t{200000u};
+    const auto max_threads = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    std::cout << std::setw(8) << "threads" << std::setw(18) << "shared jobs/s" << std::setw(18) << "stealing jobs/s" << '\n';
+    for(int thread_count = 1; thread_count <= max_threads; ++thread_count) {
+        const auto shared = JobSystemTests::MeasureJobsPerSecond(JobSchedulerMode::SharedQueue, thread_count, job_count);
+        const auto stealing = JobSystemTests::MeasureJobsPerSecond(JobSchedulerMode::WorkStealing, thread_count, job_count);
+        std::cout << std::setw(8) << thread_count << std::setw(18) << std::fixed << std::setprecision(0) << shared << std::setw(18) << stealing << '\n';
+        EXPECT_GT(stealing, 0.0);
+    }
+}
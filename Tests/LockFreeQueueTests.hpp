@@ -0,0 +1,181 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Core/LockFreeQueue.hpp"
+#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/TimeUtils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LockFreeQueueTests {
+
+    //Each producer pushes (producer_id << 32 | sequence); consumers check every producer's values arrive in order exactly once.
+    template<typename PushFn, typename PopFn>
+    [[nodiscard]] bool RunOrderedStress(std::size_t producer_count, std::size_t consumer_count, std::uint64_t per_producer, PushFn&& push, PopFn&& pop) {
+        std::atomic<std::uint64_t> consumed{0u};
+        std::atomic_bool ok = true;
+        const auto total = producer_count * per_producer;
+        std::vector<std::thread> threads{};
+        for(std::size_t c = 0u; c < consumer_count; ++c) {
+            threads.emplace_back([&]() {
+                std::vector<std::uint64_t> last_seen(producer_count, 0u);
+                std::uint64_t value{};
+                while(consumed.load() < total) {
+                    if(!pop(value)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    const auto producer = static_cast<std::size_t>(value >> 32u);
+                    const auto sequence = value & 0xFFFFFFFFu;
+                    if(producer >= producer_count || sequence <= last_seen[producer]) {
+                        ok = false;
+                    } else {
+                        last_seen[producer] = sequence;
+                    }
+                    ++consumed;
+                }
+            });
+        }
+        for(std::size_t p = 0u; p < producer_count; ++p) {
+            threads.emplace_back([&, p]() {
+                for(std::uint64_t i = 1u; i <= per_producer; ++i) {
+                    const auto value = (static_cast<std::uint64_t>(p) << 32u) | i;
+                    while(!push(value)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for(auto& t : threads) {
+            t.join();
+        }
+        return ok && consumed == total;
+    }
+
+    struct QueueBenchmarkResult {
+        double ops_per_second = 0.0;
+        double p99_latency_us = 0.0;
+    };
+
+    //Values are the push timestamps so the consumer can measure enqueue-to-dequeue latency.
+    template<typename PushFn, typename PopFn>
+    [[nodiscard]] QueueBenchmarkResult Measure(std::size_t producer_count, std::size_t per_producer, PushFn&& push, PopFn&& pop) {
+        using clock = std::chrono::steady_clock;
+        const auto total = producer_count * per_producer;
+        std::vector<float> latencies{};
+        latencies.reserve(total);
+        const auto start = TimeUtils::Now();
+        std::vector<std::thread> producers{};
+        for(std::size_t p = 0u; p < producer_count; ++p) {
+            producers.emplace_back([&]() {
+                for(std::size_t i = 0u; i < per_producer; ++i) {
+                    while(!push(clock::now().time_since_epoch().count())) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        std::int64_t stamp{};
+        while(latencies.size() < total) {
+            if(!pop(stamp)) {
+                std::this_thread::yield();
+                continue;
+            }
+            const auto latency = clock::now() - clock::time_point{clock::duration{stamp}};
+            latencies.push_back(TimeUtils::FPMicroseconds{latency}.count());
+        }
+        const auto elapsed = TimeUtils::FPSeconds{TimeUtils::Now() - start};
+        for(auto& t : producers) {
+            t.join();
+        }
+        const auto p99 = latencies.begin() + static_cast<std::ptrdiff_t>(latencies.size() * 99u / 100u);
+        std::nth_element(latencies.begin(), p99, latencies.end());
+        return QueueBenchmarkResult{static_cast<double>(total) / elapsed.count(), static_cast<double>(*p99)};
+    }
+
+} // namespace LockFreeQueueTests
+
+TEST(LockFreeQueue, SpscPreservesOrderAndReportsFull) {
+    SpscQueue<int, 8> q;
+    for(int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(q.try_push(i));
+    }
+    EXPECT_FALSE(q.try_push(8));
+    EXPECT_EQ(q.size(), std::size_t{8u});
+    std::vector<int> out(8, -1);
+    EXPECT_EQ(q.pop_bulk(out.begin(), 5u), std::size_t{5u});
+    int value = -1;
+    EXPECT_TRUE(q.try_pop(value));
+    EXPECT_EQ(value, 5);
+    out[5] = value;
+    EXPECT_EQ(q.pop_bulk(out.begin() + 6, 10u), std::size_t{2u});
+    EXPECT_EQ(out, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(LockFreeQueue, SpscStress) {
+    auto q = std::make_unique<SpscQueue<std::uint64_t, 256>>();
+    const auto ok = LockFreeQueueTests::RunOrderedStress(1u, 1u, 200000u, [&q](std::uint64_t v) { return q->try_push(v); }, [&q](std::uint64_t& v) { return q->try_pop(v); });
+    EXPECT_TRUE(ok);
+}
+
+TEST(LockFreeQueue, MpscStress) {
+    auto q = std::make_unique<MpscQueue<std::uint64_t, 256>>();
+    const auto ok = LockFreeQueueTests::RunOrderedStress(4u, 1u, 50000u, [&q](std::uint64_t v) { return q->try_push(v); }, [&q](std::uint64_t& v) { return q->try_pop(v); });
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(q->empty());
+}
+
+TEST(LockFreeQueue, MpmcStressAcrossSegments) {
+    MpmcQueue<std::uint64_t, 32> q;
+    const auto ok = LockFreeQueueTests::RunOrderedStress(3u, 3u, 50000u, [&q](std::uint64_t v) { return q.try_push(v); }, [&q](std::uint64_t& v) { return q.try_pop(v); });
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(LockFreeQueue, MpmcDestroysQueuedElements) {
+    auto tracker = std::make_shared<int>(0);
+    {
+        MpmcQueue<std::shared_ptr<int>, 4> q;
+        for(int i = 0; i < 10; ++i) {
+            q.push(tracker);
+        }
+        std::shared_ptr<int> value{};
+        EXPECT_TRUE(q.try_pop(value));
+        EXPECT_EQ(tracker.use_count(), 11);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(LockFreeQueueBenchmark, DISABLED_OpsPerSecondAndP99AgainstThreadSafeQueue) {
+    const auto per_producer = std::size_t{100000u};
+    const auto producers = std::size_t{3u};
+    ThreadSafeQueue<std::int64_t> locked{};
+    const auto locked_result = LockFreeQueueTests::Measure(producers, per_producer, [&locked](std::int64_t v) { locked.push(v); return true; }, [&locked](std::int64_t& v) { return locked.try_pop(v); });
+    auto mpsc = std::make_unique<MpscQueue<std::int64_t, 4096>>();
+    const auto mpsc_result = LockFreeQueueTests::Measure(producers, per_producer, [&mpsc](std::int64_t v) { return mpsc->try_push(v); }, [&mpsc](std::int64_t& v) { return mpsc->try_pop(v); });
+    MpmcQueue<std::int64_t> mpmc{};
+    const auto mpmc_result = LockFreeQueueTests::Measure(producers, per_producer, [&mpmc](std::int64_t v) { return mpmc.try_push(v); }, [&mpmc](std::int64_t& v) { return mpmc.try_pop(v); });
+    auto spsc = std::make_unique<SpscQueue<std::int64_t, 4096>>();
+    const auto spsc_result = LockFreeQueueTests::Measure(1u, per_producer * producers, [&spsc](std::int64_t v) { return spsc->try_push(v); }, [&spsc](std::int64_t& v) { return spsc->try_pop(v); });
+    std::cout << std::setw(16) << "queue" << std::setw(16) << "ops/s" << std::setw(16) << "p99 us" << '\n';
+    const auto print = [](const char* name, const LockFreeQueueTests::QueueBenchmarkResult& r) {
+        std::cout << std::setw(16) << name << std::setw(16) << std::fixed << std::setprecision(0) << r.ops_per_second << std::setw(16) << std::setprecision(2) << r.p99_latency_us << '\n';
+    };
+    print("ThreadSafeQueue", locked_result);
+    print("MpscQueue", mpsc_result);
+    print("MpmcQueue", mpmc_result);
+    print("SpscQueue (1P)", spsc_result);
+    EXPECT_GT(mpsc_result.ops_per_second, 0.0);
+    EXPECT_GT(mpmc_result.ops_per_second, 0.0);
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Memory/ChunkedMemoryPool.hpp"
+#include "Engine/Memory/FrameArena.hpp"
+#include "Engine/Memory/LinearArena.hpp"
+#include "Engine/Memory/MemoryPool.hpp"
+#include "Engine/Memory/ThreadCachedPoolResource.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace MemoryPoolTests {
+
+    //Forwards to new/delete and counts what reaches it, so tests can tell pool hits from upstream fallbacks.
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        std::size_t allocations = 0u;
+        std::size_t deallocations = 0u;
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    struct Payload {
+        std::uint64_t a = 0u;
+        double b = 0.0;
+        std::uint32_t c = 0u;
+    };
+
+    //Allocate and free list nodes in a shuffled order to exercise the free lists.
+    template<typename ListType>
+    void ChurnList(ListType& list, std::size_t iterations, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        for(std::size_t i = 0u; i < iterations; ++i) {
+            if(list.size() < 64u || (rng() & 1u)) {
+                list.push_back(static_cast<int>(i));
+            } else {
+                auto iter = std::begin(list);
+                std::advance(iter, rng() % list.size());
+                list.erase(iter);
+            }
+        }
+    }
+
+} // namespace MemoryPoolTests
+
+TEST(MemoryPool, FreesInAnyOrderAndReusesBlocks) {
+    MemoryPoolTests::CountingResource upstream{};
+    MemoryPool<MemoryPoolTests::Payload, 8> pool{&upstream};
+    using Payload = MemoryPoolTests::Payload;
+    std::vector<void*> blocks{};
+    for(std::size_t i = 0u; i < pool.capacity(); ++i) {
+        blocks.push_back(pool.allocate(sizeof(Payload), alignof(Payload)));
+        EXPECT_TRUE(pool.owns(blocks.back()));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(blocks.back()) % alignof(Payload), std::uintptr_t{0u});
+    }
+    std::sort(std::begin(blocks), std::end(blocks));
+    EXPECT_EQ(std::adjacent_find(std::begin(blocks), std::end(blocks)), std::end(blocks));
+    EXPECT_EQ(pool.size(), std::size_t{8u});
+    EXPECT_EQ(upstream.allocations, std::size_t{0u});
+
+    //Free out of allocation order, then every freed block must be handed back out before upstream is used.
+    const auto freed = std::vector<void*>{blocks[5], blocks[1], blocks[6]};
+    for(auto* block : freed) {
+        pool.deallocate(block, sizeof(Payload), alignof(Payload));
+    }
+    EXPECT_EQ(pool.size(), std::size_t{5u});
+    std::vector<void*> reused{};
+    for(std::size_t i = 0u; i < freed.size(); ++i) {
+        reused.push_back(pool.allocate(sizeof(Payload), alignof(Payload)));
+    }
+    EXPECT_TRUE(std::is_permutation(std::begin(reused), std::end(reused), std::begin(freed)));
+    EXPECT_EQ(upstream.allocations, std::size_t{0u});
+
+    auto* overflow = pool.allocate(sizeof(Payload), alignof(Payload));
+    auto* oversized = pool.allocate(sizeof(Payload) * 4u, alignof(Payload));
+    EXPECT_FALSE(pool.owns(overflow));
+    EXPECT_EQ(upstream.allocations, std::size_t{2u});
+    pool.deallocate(overflow, sizeof(Payload), alignof(Payload));
+    pool.deallocate(oversized, sizeof(Payload) * 4u, alignof(Payload));
+    EXPECT_EQ(upstream.deallocations, std::size_t{2u});
+}
+
+TEST(MemoryPool, ChunkedPoolGrowsAndReleasesChunks) {
+    MemoryPoolTests::CountingResource upstream{};
+    {
+        ChunkedMemoryPool pool{24u, 16u, &upstream};
+        EXPECT_EQ(pool.block_size(), std::size_t{24u});
+        EXPECT_EQ(pool.block_alignment(), std::size_t{8u});
+        std::vector<void*> blocks{};
+        for(std::size_t i = 0u; i < 40u; ++i) {
+            blocks.push_back(pool.allocate(20u, 8u));
+        }
+        EXPECT_EQ(pool.chunk_count(), std::size_t{3u});
+        EXPECT_EQ(upstream.allocations, std::size_t{3u});
+        std::reverse(std::begin(blocks) + 10, std::end(blocks));
+        for(auto* block : blocks) {
+            pool.deallocate(block, 20u, 8u);
+        }
+        EXPECT_EQ(pool.size(), std::size_t{0u});
+        for(std::size_t i = 0u; i < 40u; ++i) {
+            blocks[i] = pool.allocate(24u, 8u);
+        }
+        EXPECT_EQ(pool.chunk_count(), std::size_t{3u});
+    }
+    EXPECT_EQ(upstream.deallocations, std::size_t{3u});
+}
+
+TEST(MemoryPool, ChunkedPoolBacksNodeContainers) {
+    ChunkedMemoryPool pool{64u};
+    std::pmr::list<int> pooled{&pool};
+    std::list<int> reference{};
+    MemoryPoolTests::ChurnList(pooled, 20000u, 7u);
+    MemoryPoolTests::ChurnList(reference, 20000u, 7u);
+    EXPECT_TRUE(std::equal(std::begin(pooled), std::end(pooled), std::begin(reference), std::end(reference)));
+    EXPECT_EQ(pool.size(), pooled.size());
+}
+
+TEST(MemoryPool, ThreadCachedResourceAcrossThreads) {
+    MemoryPoolTests::CountingResource upstream{};
+    {
+        ThreadCachedPoolResource resource{16u, 32u, &upstream};
+        std::vector<std::thread> threads{};
+        std::atomic_bool ok = true;
+        for(std::uint32_t t = 0u; t < 4u; ++t) {
+            threads.emplace_back([&resource, &ok, t]() {
+                std::pmr::list<int> list{&resource};
+                std::pmr::vector<std::uint64_t> values{&resource};
+                MemoryPoolTests::ChurnList(list, 20000u, t);
+                for(std::uint64_t i = 0u; i < 200u; ++i) {
+                    values.push_back(i);
+                }
+                if(std::accumulate(std::begin(values), std::end(values), std::uint64_t{0u}) != 199u * 200u / 2u) {
+                    ok = false;
+                }
+            });
+        }
+        for(auto& t : threads) {
+            t.join();
+        }
+        EXPECT_TRUE(ok);
+
+        //Blocks allocated on one thread and freed on another go back into the freeing thread's cache.
+        std::pmr::vector<int>* shared = nullptr;
+        std::thread producer([&]() { shared = new std::pmr::vector<int>(100u, 1, &resource); });
+        producer.join();
+        EXPECT_EQ(std::accumulate(std::begin(*shared), std::end(*shared), 0), 100);
+        delete shared;
+
+        auto* large = resource.allocate(ThreadCachedPoolResource::max_block_size * 2u);
+        resource.deallocate(large, ThreadCachedPoolResource::max_block_size * 2u);
+    }
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(MemoryPool, ThreadCachedResourceAtAReusedAddressStartsWithAnEmptyCache) {
+    alignas(ThreadCachedPoolResource) unsigned char storage[sizeof(ThreadCachedPoolResource)];
+    for(int generation = 0; generation < 100; ++generation) {
+        MemoryPoolTests::CountingResource upstream{};
+        auto* resource = ::new(storage) ThreadCachedPoolResource{16u, 32u, &upstream};
+        //Nothing cached by the resource that lived here before may be handed out: those blocks went back upstream.
+        auto* block = resource->allocate(64u);
+        EXPECT_EQ(upstream.allocations, std::size_t{1u}) << "generation " << generation;
+        resource->deallocate(block, 64u);
+        resource->~ThreadCachedPoolResource();
+        EXPECT_EQ(upstream.allocations, upstream.deallocations);
+    }
+}
+
+TEST(MemoryPool, LinearArenaAlignsAndFoldsBlocksOnReset) {
+    MemoryPoolTests::CountingResource upstream{};
+    {
+        LinearArena arena{256u, &upstream};
+        auto* a = arena.allocate(3u, 1u);
+        auto* b = arena.allocate(8u, 8u);
+        auto* c = arena.allocate(32u, 32u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8u, std::uintptr_t{0u});
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 32u, std::uintptr_t{0u});
+        EXPECT_LT(a, b);
+        EXPECT_LT(b, c);
+        for(int i = 0; i < 20; ++i) {
+            [[maybe_unused]] auto* filler = arena.allocate(100u);
+        }
+        EXPECT_GT(arena.block_count(), std::size_t{1u});
+        const auto capacity = arena.capacity();
+        arena.Reset();
+        EXPECT_EQ(arena.bytes_used(), std::size_t{0u});
+        EXPECT_EQ(arena.block_count(), std::size_t{0u});
+        for(int i = 0; i < 20; ++i) {
+            [[maybe_unused]] auto* filler = arena.allocate(100u);
+        }
+        EXPECT_EQ(arena.block_count(), std::size_t{1u});
+        EXPECT_EQ(arena.capacity(), capacity);
+
+        //Freeing the most recent allocation hands the space straight back.
+        const auto used = arena.bytes_used();
+        auto* scratch = arena.allocate(64u);
+        arena.deallocate(scratch, 64u);
+        EXPECT_EQ(arena.bytes_used(), used);
+        EXPECT_EQ(arena.allocate(64u), scratch);
+    }
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(MemoryPool, FrameArenaKeepsPreviousFrameAlive) {
+    auto* frame_a = FrameArena::Current();
+    std::pmr::vector<int> produced({1, 2, 3, 4}, frame_a);
+    EXPECT_GE(FrameArena::GetThreadBytesUsed(), sizeof(int) * 4u);
+    FrameArena::EndFrame();
+    EXPECT_EQ(FrameArena::Previous(), frame_a);
+    EXPECT_NE(FrameArena::Current(), frame_a);
+    EXPECT_EQ(FrameArena::GetThreadBytesUsed(), std::size_t{0u});
+    std::pmr::vector<int> next(4u, 9, FrameArena::Current());
+    EXPECT_EQ(produced, std::pmr::vector<int>({1, 2, 3, 4}));
+    FrameArena::EndFrame();
+    EXPECT_EQ(FrameArena::Current(), frame_a);
+    EXPECT_EQ(FrameArena::GetThreadBytesUsed(), std::size_t{0u});
+    EXPECT_EQ(next, std::pmr::vector<int>(4u, 9));
+
+    //Each thread has its own arenas.
+    std::pmr::memory_resource* worker_arena = nullptr;
+    std::thread worker([&worker_arena]() { worker_arena = FrameArena::Current(); });
+    worker.join();
+    EXPECT_NE(worker_arena, FrameArena::Current());
+    EXPECT_NE(worker_arena, FrameArena::Previous());
+}
+
+TEST(MemoryPoolBenchmark, DISABLED_ListChurnAgainstNewDelete) {
+    constexpr auto iterations = std::size_t{2000000u};
+    const auto measure = [](std::pmr::memory_resource* resource) {
+        const auto start = TimeUtils::Now();
+        std::pmr::list<int> list{resource};
+        for(std::size_t i = 0u; i < iterations; ++i) {
+            list.push_back(static_cast<int>(i));
+            if(list.size() > 256u) {
+                list.pop_front();
+            }
+        }
+        return TimeUtils::FPMilliseconds{TimeUtils::Now() - start}.count();
+    };
+    const auto new_delete_ms = measure(std::pmr::new_delete_resource());
+    ChunkedMemoryPool chunked{32u, 1024u};
+    const auto chunked_ms = measure(&chunked);
+    ThreadCachedPoolResource cached{};
+    const auto cached_ms = measure(&cached);
+    std::cout << std::setw(28) << "resource" << std::setw(12) << "ms" << '\n';
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(28) << "new_delete_resource" << std::setw(12) << new_delete_ms << '\n';
+    std::cout << std::setw(28) << "ChunkedMemoryPool" << std::setw(12) << chunked_ms << '\n';
+    std::cout << std::setw(28) << "ThreadCachedPoolResource" << std::setw(12) << cached_ms << '\n';
+    EXPECT_GT(new_delete_ms, 0.0f);
+}
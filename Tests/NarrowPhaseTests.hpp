@@ -0,0 +1,219 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/Collider.hpp"
+#include "Engine/Physics/PhysicsTypes.hpp"
+#include "Engine/Physics/PhysicsUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace NarrowPhaseTests {
+
+    //Shapes scattered so that roughly half of the neighbouring pairs overlap.
+    [[nodiscard]] inline std::vector<std::unique_ptr<Collider>> MakeColliders(ColliderShape shape, std::size_t count, unsigned int seed = 99u) {
+        TestUtils::Random random{seed};
+        std::vector<std::unique_ptr<Collider>> colliders{};
+        for(std::size_t i = 0u; i < count; ++i) {
+            const auto p = random.Value2(0.0f, 4.0f);
+            const auto half_extents = random.Value2(0.5f, 1.5f);
+            switch(shape) {
+            case ColliderShape::Circle:
+                colliders.push_back(std::make_unique<ColliderCircle>(Position{p}, half_extents.x));
+                break;
+            case ColliderShape::AABB:
+                colliders.push_back(std::make_unique<ColliderAABB>(p, half_extents));
+                break;
+            case ColliderShape::OBB:
+                colliders.push_back(std::make_unique<ColliderOBB>(p, half_extents));
+                colliders.back()->SetOrientationDegrees(random.Value(0.0f, 360.0f));
+                break;
+            default:
+                colliders.push_back(std::make_unique<ColliderPolygon>(5, p, half_extents, random.Value(0.0f, 360.0f)));
+                break;
+            }
+        }
+        return colliders;
+    }
+
+    [[nodiscard]] inline std::optional<EPAResult> CollideWithGJK(const Collider& a, const Collider& b) {
+        const auto gjk = PhysicsUtils::GJK(a, b);
+        if(!gjk.collides) {
+            return {};
+        }
+        return PhysicsUtils::EPA(gjk, a, b);
+    }
+
+} // namespace NarrowPhaseTests
+
+TEST(NarrowPhase, ClosedFormsAgreeWithGJKAndEPA) {
+    using namespace NarrowPhaseTests;
+    for(const auto shape : {ColliderShape::Circle, ColliderShape::AABB, ColliderShape::OBB}) {
+        const auto colliders = MakeColliders(shape, 200u);
+        std::size_t hits = 0u;
+        for(std::size_t i = 0u; i + 1u < colliders.size(); ++i) {
+            const auto& a = *colliders[i];
+            const auto& b = *colliders[i + 1u];
+            std::optional<EPAResult> closed{};
+            ASSERT_TRUE(PhysicsUtils::CollideClosedForm(a, b, closed));
+            const auto gjk = CollideWithGJK(a, b);
+            //Allow disagreement only for pairs that barely touch.
+            if(closed.has_value() != gjk.has_value()) {
+                EXPECT_LT((closed ? closed : gjk)->distance, 0.01f) << "shape " << static_cast<int>(shape) << ", pair " << i;
+                continue;
+            }
+            if(!closed) {
+                continue;
+            }
+            ++hits;
+            EXPECT_NEAR(closed->distance, gjk->distance, 0.01f) << "shape " << static_cast<int>(shape) << ", pair " << i;
+            //Boxes can have two equally shallow axes; then either normal resolves the overlap by the same amount.
+            if(std::abs(closed->distance - gjk->distance) < 0.001f && MathUtils::DotProduct(Vector2{closed->normal}, Vector2{gjk->normal}) < 0.99f) {
+                continue;
+            }
+            EXPECT_GT(MathUtils::DotProduct(Vector2{closed->normal}, Vector2{gjk->normal}), 0.99f) << "shape " << static_cast<int>(shape) << ", pair " << i;
+        }
+        EXPECT_GT(hits, std::size_t{20u});
+    }
+    //Mixed pairs still go through GJK.
+    const auto circle = ColliderCircle{Position{Vector2::Zero}, 1.0f};
+    const auto box = ColliderOBB{Vector2{1.5f, 0.0f}, Vector2{1.0f, 1.0f}};
+    std::optional<EPAResult> unused{};
+    EXPECT_FALSE(PhysicsUtils::CollideClosedForm(circle, box, unused));
+    auto direction = Vector2::Zero;
+    const auto contact = PhysicsUtils::Collide(circle, box, direction);
+    ASSERT_TRUE(contact.has_value());
+    EXPECT_NEAR(contact->distance, 0.5f, 0.01f);
+    EXPECT_NEAR(contact->normal.x, 1.0f, 0.01f);
+}
+
+TEST(NarrowPhase, WarmStartedGJKMatchesColdAndKeepsSeparatingAxis) {
+    using namespace NarrowPhaseTests;
+    const auto colliders = MakeColliders(ColliderShape::Polygon, 200u);
+    for(std::size_t i = 0u; i + 1u < colliders.size(); ++i) {
+        const auto& a = *colliders[i];
+        const auto& b = *colliders[i + 1u];
+        const auto cold = PhysicsUtils::GJK(a, b);
+        const auto warm = PhysicsUtils::GJK(a, b, cold.direction);
+        ASSERT_EQ(cold.collides, warm.collides) << "pair " << i;
+        if(cold.collides) {
+            EXPECT_EQ(cold.simplex_size, std::size_t{3u});
+            EXPECT_NEAR(PhysicsUtils::EPA(cold, a, b).distance, PhysicsUtils::EPA(warm, a, b).distance, 0.001f);
+        } else {
+            //Starting from last frame's separating axis rejects the pair with a single support query.
+            const auto support = a.Support(cold.direction) - b.Support(-cold.direction);
+            EXPECT_LE(MathUtils::DotProduct(support, cold.direction), 0.0f) << "pair " << i;
+        }
+    }
+}
+
+TEST(NarrowPhase, SeparationIsALowerBoundThatMeetsTheClosedForms) {
+    using namespace NarrowPhaseTests;
+    const ColliderCircle circle_a{Position{Vector2{0.0f, 0.0f}}, 1.0f};
+    const ColliderCircle circle_b{Position{Vector2{3.0f, 4.0f}}, 2.0f};
+    auto normal = Vector2::Zero;
+    EXPECT_NEAR(PhysicsUtils::CalcSeparation(circle_a, circle_b, normal), 2.0f, 0.001f);
+    EXPECT_NEAR(normal.x, 0.6f, 0.01f);
+    EXPECT_NEAR(normal.y, 0.8f, 0.01f);
+    const ColliderAABB box_a{Vector2{0.0f, 0.0f}, Vector2{1.0f, 1.0f}};
+    const ColliderAABB box_b{Vector2{-3.5f, 0.5f}, Vector2{1.0f, 1.0f}};
+    EXPECT_NEAR(PhysicsUtils::CalcSeparation(box_a, box_b, normal), 3.5f - box_a.GetHalfExtents().x - box_b.GetHalfExtents().x, 0.001f);
+    EXPECT_NEAR(normal.x, -1.0f, 0.001f);
+    for(const auto shape : {ColliderShape::OBB, ColliderShape::Polygon}) {
+        const auto colliders = MakeColliders(shape, 200u);
+        for(std::size_t i = 0u; i + 1u < colliders.size(); ++i) {
+            const auto& a = *colliders[i];
+            const auto& b = *colliders[i + 1u];
+            const auto separation = PhysicsUtils::CalcSeparation(a, b, normal);
+            if(PhysicsUtils::GJKIntersect(a, b)) {
+                EXPECT_NEAR(separation, 0.0f, 0.001f) << "pair " << i;
+                continue;
+            }
+            //Both shapes stay on their own side of the separating line along normal.
+            const auto gap = MathUtils::DotProduct(b.Support(-normal), normal) - MathUtils::DotProduct(a.Support(normal), normal);
+            EXPECT_NEAR(gap, separation, 0.001f) << "pair " << i;
+            EXPECT_LT(0.0f, separation) << "pair " << i;
+        }
+    }
+}
+
+TEST(NarrowPhase, TimeOfImpactCatchesTunneling) {
+    //A small fast circle passes right through a thin wall between two steps.
+    const ColliderCircle bullet{Position{Vector2{5.0f, 0.0f}}, 0.1f};
+    const ColliderAABB wall{Vector2{0.0f, 0.0f}, Vector2{0.01f, 2.0f}};
+    const Sweep sweep{Vector2{-10.0f, 0.0f}, Vector2{10.0f, 0.0f}};
+    EXPECT_FALSE(PhysicsUtils::GJKIntersect(bullet, wall));
+    const auto toi = PhysicsUtils::CalcTimeOfImpact(bullet, sweep, wall, Sweep{}, 0.005f);
+    ASSERT_TRUE(toi.has_value());
+    EXPECT_NEAR(toi->normal.x, 1.0f, 0.001f);
+    //Never closer than the target, never further than the target plus its tolerance.
+    const auto gap = -wall.GetHalfExtents().x - (-5.0f + 10.0f * toi->time + 0.1f);
+    EXPECT_GE(gap, 0.005f - 0.0001f);
+    EXPECT_LE(gap, 0.005f + 0.00125f + 0.0001f);
+    //The same impact seen with the wall doing the moving.
+    const auto wall_toi = PhysicsUtils::CalcTimeOfImpact(wall, Sweep{Vector2{5.0f, 0.0f}, Vector2{-10.0f, 0.0f}}, bullet, Sweep{Vector2{-5.0f, 0.0f}}, 0.005f);
+    ASSERT_TRUE(wall_toi.has_value());
+    EXPECT_NEAR(wall_toi->time, toi->time, 0.001f);
+    //Moving away, passing by and starting in contact are not impacts.
+    EXPECT_FALSE(PhysicsUtils::CalcTimeOfImpact(bullet, Sweep{Vector2{-10.0f, 0.0f}, Vector2{-10.0f, 0.0f}}, wall, Sweep{}, 0.005f));
+    EXPECT_FALSE(PhysicsUtils::CalcTimeOfImpact(bullet, Sweep{Vector2{-10.0f, 5.0f}, Vector2{10.0f, 0.0f}}, wall, Sweep{}, 0.005f));
+    const auto touching = Sweep{Vector2{-5.0f - wall.GetHalfExtents().x - 0.1f, 0.0f}, Vector2{10.0f, 0.0f}};
+    EXPECT_FALSE(PhysicsUtils::CalcTimeOfImpact(bullet, touching, wall, Sweep{}, 0.005f));
+}
+
+TEST(NarrowPhaseBenchmark, DISABLED_PairTestsPerSecond) {
+    using namespace NarrowPhaseTests;
+    constexpr std::size_t pair_count = 2000u;
+    constexpr int repeats = 20;
+    const auto measure = [](const char* name, auto&& fn) {
+        std::size_t hits = 0u;
+        const auto start = std::chrono::steady_clock::now();
+        for(int r = 0; r < repeats; ++r) {
+            hits += fn();
+        }
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(28) << name << std::setw(14) << std::fixed << std::setprecision(2) << (pair_count * repeats) / elapsed / 1.0e6 << " M pairs/s  (" << hits / repeats << " contacts)\n";
+    };
+    const std::array<std::pair<ColliderShape, const char*>, 4> shapes{{{ColliderShape::Circle, "circles"}, {ColliderShape::AABB, "aabbs"}, {ColliderShape::OBB, "obbs"}, {ColliderShape::Polygon, "pentagons"}}};
+    for(const auto& [shape, shape_name] : shapes) {
+        const auto colliders = MakeColliders(shape, pair_count + 1u);
+        std::vector<Vector2> directions(pair_count, Vector2::Zero);
+        std::cout << shape_name << ":\n";
+        measure("GJK + EPA, cold", [&]() {
+            std::size_t hits = 0u;
+            for(std::size_t i = 0u; i < pair_count; ++i) {
+                hits += CollideWithGJK(*colliders[i], *colliders[i + 1u]).has_value() ? 1u : 0u;
+            }
+            return hits;
+        });
+        measure("GJK + EPA, warm started", [&]() {
+            std::size_t hits = 0u;
+            for(std::size_t i = 0u; i < pair_count; ++i) {
+                const auto gjk = PhysicsUtils::GJK(*colliders[i], *colliders[i + 1u], directions[i] == Vector2::Zero ? Vector2::X_Axis : directions[i]);
+                directions[i] = gjk.direction;
+                if(gjk.collides) {
+                    hits += PhysicsUtils::EPA(gjk, *colliders[i], *colliders[i + 1u]).distance > 0.0f ? 1u : 0u;
+                }
+            }
+            return hits;
+        });
+        std::fill(std::begin(directions), std::end(directions), Vector2::Zero);
+        measure("Collide", [&]() {
+            std::size_t hits = 0u;
+            for(std::size_t i = 0u; i < pair_count; ++i) {
+                hits += PhysicsUtils::Collide(*colliders[i], *colliders[i + 1u], directions[i]).has_value() ? 1u : 0u;
+            }
+            return hits;
+        });
+    }
+}
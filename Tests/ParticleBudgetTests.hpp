@@ -0,0 +1,140 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/Particles/ParticleBudget.hpp"
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace ParticleBudgetTests {
+
+    //At the origin looking down +Z with a 90 degree square frustum, so the sides are the planes x = +-z and y = +-z.
+    ParticleView MakeView() {
+        ParticleView view{};
+        view.aspect_ratio = 1.0f;
+        view.vfov_degrees = 90.0f;
+        view.near_distance = 0.1f;
+        view.far_distance = 1000.0f;
+        return view;
+    }
+
+    ParticleBudget::Request MakeRequest(const Vector3& center, std::size_t particleCount = 0u, int priority = 0) {
+        ParticleBudget::Request request{};
+        request.bounds = AABB3{center, 1.0f, 1.0f, 1.0f};
+        request.particle_count = particleCount;
+        request.priority = priority;
+        return request;
+    }
+
+} // namespace ParticleBudgetTests
+
+TEST(ParticleBudget, CullsBoundsOutsideTheFrustum) {
+    using namespace ParticleBudgetTests;
+    const auto view = MakeView();
+    EXPECT_TRUE(ParticleBudget::IsInView(view, AABB3{Vector3{0.0f, 0.0f, 10.0f}, 1.0f, 1.0f, 1.0f}));
+    EXPECT_FALSE(ParticleBudget::IsInView(view, AABB3{Vector3{0.0f, 0.0f, -10.0f}, 1.0f, 1.0f, 1.0f}));
+    EXPECT_FALSE(ParticleBudget::IsInView(view, AABB3{Vector3{20.0f, 0.0f, 10.0f}, 1.0f, 1.0f, 1.0f}));
+    EXPECT_FALSE(ParticleBudget::IsInView(view, AABB3{Vector3{0.0f, -20.0f, 10.0f}, 1.0f, 1.0f, 1.0f}));
+    EXPECT_FALSE(ParticleBudget::IsInView(view, AABB3{Vector3{0.0f, 0.0f, 2000.0f}, 1.0f, 1.0f, 1.0f}));
+    //Only partly inside still counts as visible.
+    EXPECT_TRUE(ParticleBudget::IsInView(view, AABB3{Vector3{10.5f, 0.0f, 10.0f}, 1.0f, 1.0f, 1.0f}));
+    EXPECT_TRUE(ParticleBudget::IsInView(view, AABB3{Vector3::Zero, 1.0f, 1.0f, 1.0f}));
+
+    //Turning around brings what was behind into view.
+    auto behind = view;
+    behind.forward = -view.forward;
+    behind.right = -view.right;
+    EXPECT_TRUE(ParticleBudget::IsInView(behind, AABB3{Vector3{0.0f, 0.0f, -10.0f}, 1.0f, 1.0f, 1.0f}));
+    EXPECT_FALSE(ParticleBudget::IsInView(behind, AABB3{Vector3{0.0f, 0.0f, 10.0f}, 1.0f, 1.0f, 1.0f}));
+
+    //Without a projection nothing is culled.
+    EXPECT_TRUE(ParticleBudget::IsInView(ParticleView{}, AABB3{Vector3{0.0f, 0.0f, -10.0f}, 1.0f, 1.0f, 1.0f}));
+}
+
+TEST(ParticleBudget, ReducesRatesWithDistance) {
+    using namespace ParticleBudgetTests;
+    ParticleBudget::Settings settings{};
+    settings.full_rate_distance = 10.0f;
+    settings.min_rate_distance = 110.0f;
+    settings.max_update_interval = 5u;
+    settings.min_spawn_scale = 0.2f;
+    ParticleBudget budget{settings};
+    const std::vector<ParticleBudget::Request> requests{MakeRequest(Vector3{0.0f, 0.0f, 6.0f}), MakeRequest(Vector3{0.0f, 0.0f, 61.0f}), MakeRequest(Vector3{0.0f, 0.0f, 500.0f})};
+    std::vector<ParticleLod> lods{};
+    budget.Allocate(MakeView(), requests, lods);
+    ASSERT_EQ(lods.size(), requests.size());
+    EXPECT_EQ(lods[0].update_interval, 1u);
+    EXPECT_FLOAT_EQ(lods[0].spawn_scale, 1.0f);
+    //Halfway along the falloff; distance is measured to the nearest side of the bounds.
+    EXPECT_EQ(lods[1].update_interval, 3u);
+    EXPECT_FLOAT_EQ(lods[1].spawn_scale, 0.6f);
+    EXPECT_EQ(lods[2].update_interval, 5u);
+    EXPECT_FLOAT_EQ(lods[2].spawn_scale, 0.2f);
+    for(const auto& lod : lods) {
+        EXPECT_TRUE(lod.is_visible);
+    }
+}
+
+TEST(ParticleBudget, SharesBudgetByPriorityThenDistance) {
+    using namespace ParticleBudgetTests;
+    ParticleBudget::Settings settings{};
+    settings.max_particles = 1000u;
+    ParticleBudget budget{settings};
+    const std::vector<ParticleBudget::Request> requests{
+    MakeRequest(Vector3{0.0f, 0.0f, 50.0f}, 300u, 0),
+    MakeRequest(Vector3{0.0f, 0.0f, 20.0f}, 300u, 0),
+    MakeRequest(Vector3{0.0f, 0.0f, 90.0f}, 600u, 5),
+    //Offscreen, so its particles do not count against anyone.
+    MakeRequest(Vector3{0.0f, 0.0f, -20.0f}, 5000u, 10),
+    };
+    std::vector<ParticleLod> lods{};
+    budget.Allocate(MakeView(), requests, lods);
+    ASSERT_EQ(lods.size(), requests.size());
+    EXPECT_FALSE(lods[3].is_visible);
+    //Highest priority first, then the nearer of the two equal ones.
+    EXPECT_EQ(lods[2].max_particles, std::size_t{1000u});
+    EXPECT_EQ(lods[1].max_particles, std::size_t{400u});
+    EXPECT_EQ(lods[0].max_particles, std::size_t{100u});
+}
+
+TEST(ParticleBudget, PoolBoundsCoverEveryParticle) {
+    ParticlePool pool{};
+    EXPECT_EQ(pool.CalcBounds().CalcDimensions(), Vector3::Zero);
+    pool.SetScales(Vector3{2.0f, 1.0f, 1.0f}, Vector3{2.0f, 1.0f, 1.0f});
+    pool.Spawn(Vector3{-3.0f, 1.0f, 4.0f}, Vector3::Zero, 1.0f);
+    pool.Spawn(Vector3{5.0f, -2.0f, 0.0f}, Vector3::Zero, 1.0f);
+    const auto bounds = pool.CalcBounds();
+    EXPECT_EQ(bounds.mins, Vector3(-4.0f, -3.0f, -1.0f));
+    EXPECT_EQ(bounds.maxs, Vector3(6.0f, 2.0f, 5.0f));
+}
+
+TEST(ParticleBudgetBenchmark, DISABLED_AllocateTimeForHundredsOfEffects) {
+    using namespace ParticleBudgetTests;
+    constexpr int frames = 100;
+    TestUtils::Random random{23u};
+    ParticleBudget budget{};
+    const auto view = MakeView();
+    std::cout << std::setw(10) << "effects" << std::setw(10) << "visible" << std::setw(14) << "us per frame\n";
+    for(const std::size_t count : {100u, 500u, 2000u}) {
+        std::vector<ParticleBudget::Request> requests{};
+        for(std::size_t i = 0u; i < count; ++i) {
+            const auto center = random.Value3(-500.0f, 500.0f);
+            requests.push_back(MakeRequest(center, 500u, random.Integer(0, 3)));
+        }
+        std::vector<ParticleLod> lods{};
+        const auto start = std::chrono::steady_clock::now();
+        for(int frame = 0; frame < frames; ++frame) {
+            budget.Allocate(view, requests, lods);
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto visible = std::count_if(std::cbegin(lods), std::cend(lods), [](const ParticleLod& lod) { return lod.is_visible; });
+        EXPECT_LT(visible, static_cast<std::ptrdiff_t>(count));
+        std::cout << std::setw(10) << count << std::setw(10) << visible << std::fixed << std::setprecision(2) << std::setw(13) << seconds / frames * 1.0e6 << '\n';
+    }
+}
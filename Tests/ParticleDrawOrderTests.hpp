@@ -0,0 +1,148 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/Particles/ParticleDrawOrder.hpp"
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace ParticleDrawOrderTests {
+
+    ParticlePool MakePool(std::size_t count, unsigned int seed = 5u) {
+        TestUtils::Random random{seed};
+        ParticlePool pool{};
+        pool.Reserve(count);
+        for(std::size_t i = 0u; i < count; ++i) {
+            const auto position = random.Value3(-50.0f, 50.0f);
+            pool.Spawn(position, random.Value3(-1.0f, 1.0f), 100.0f);
+        }
+        return pool;
+    }
+
+    //Back to front, allowing for particles closer together than one quantisation step.
+    void ExpectBackToFront(const ParticlePool& pool, const ParticleDrawOrder& order, const Vector3& viewPosition, const Vector3& viewForward) {
+        std::vector<float> depths{};
+        pool.CalcViewDepths(viewPosition, viewForward, depths);
+        const auto& indices = order.GetOrder();
+        ASSERT_EQ(indices.size(), pool.size());
+        std::vector<std::uint32_t> sorted_indices(indices);
+        std::sort(std::begin(sorted_indices), std::end(sorted_indices));
+        std::vector<std::uint32_t> expected(pool.size());
+        std::iota(std::begin(expected), std::end(expected), std::uint32_t{0u});
+        ASSERT_EQ(sorted_indices, expected);
+        const auto [nearest, farthest] = std::minmax_element(std::cbegin(depths), std::cend(depths));
+        const auto tolerance = (*farthest - *nearest) / 65535.0f;
+        for(std::size_t i = 1u; i < indices.size(); ++i) {
+            ASSERT_LE(depths[indices[i]], depths[indices[i - 1u]] + tolerance) << "position " << i;
+        }
+    }
+
+} // namespace ParticleDrawOrderTests
+
+TEST(ParticleDrawOrder, SortsBackToFront) {
+    using namespace ParticleDrawOrderTests;
+    const auto pool = MakePool(10007u);
+    ParticleDrawOrder order{};
+    const auto view_position = Vector3{0.0f, 0.0f, -100.0f};
+    const auto view_forward = Vector3{0.0f, 0.0f, 1.0f};
+    //Nothing to reuse the first time, so the whole pool is radix sorted.
+    order.Sort(pool, view_position, view_forward);
+    EXPECT_EQ(order.GetLastSortMethod(), ParticleDrawOrder::SortMethod::Radix);
+    ExpectBackToFront(pool, order, view_position, view_forward);
+
+    //Turning around reverses the order, which is too much for the insertion sort.
+    order.Sort(pool, -view_position, -view_forward);
+    EXPECT_EQ(order.GetLastSortMethod(), ParticleDrawOrder::SortMethod::Radix);
+    ExpectBackToFront(pool, order, -view_position, -view_forward);
+}
+
+TEST(ParticleDrawOrder, ReusesPreviousOrder) {
+    using namespace ParticleDrawOrderTests;
+    auto pool = MakePool(10007u);
+    ParticleDrawOrder order{};
+    const auto view_position = Vector3{10.0f, 20.0f, -100.0f};
+    const auto view_forward = Vector3{0.0f, 0.0f, 1.0f};
+    order.Sort(pool, view_position, view_forward);
+    for(int frame = 0; frame < 10; ++frame) {
+        pool.Update(1.0f / 60.0f);
+        order.Sort(pool, view_position, view_forward);
+        EXPECT_EQ(order.GetLastSortMethod(), ParticleDrawOrder::SortMethod::Insertion) << "frame " << frame;
+        ExpectBackToFront(pool, order, view_position, view_forward);
+    }
+}
+
+TEST(ParticleDrawOrder, FollowsSpawnsAndRemovals) {
+    using namespace ParticleDrawOrderTests;
+    auto pool = MakePool(1000u);
+    ParticleDrawOrder order{};
+    const auto view_position = Vector3::Zero;
+    const auto view_forward = Vector3{0.0f, 1.0f, 0.0f};
+    order.Sort(pool, view_position, view_forward);
+    //Swap-removal leaves stale indices past the end and moves particles into the holes.
+    pool.Spawn(Vector3{0.0f, 1000.0f, 0.0f}, Vector3::Zero, 0.5f);
+    pool.Spawn(Vector3{0.0f, -1000.0f, 0.0f}, Vector3::Zero, 0.5f);
+    order.Sort(pool, view_position, view_forward);
+    ExpectBackToFront(pool, order, view_position, view_forward);
+    EXPECT_EQ(pool.GetPosition(order.GetOrder().front()).y, 1000.0f);
+    pool.Update(1.0f);
+    order.Sort(pool, view_position, view_forward);
+    ExpectBackToFront(pool, order, view_position, view_forward);
+
+    //A single particle or none need no sorting.
+    pool.Clear();
+    order.Sort(pool, view_position, view_forward);
+    EXPECT_TRUE(order.GetOrder().empty());
+    pool.Spawn(Vector3::One, Vector3::Zero, 1.0f);
+    order.Sort(pool, view_position, view_forward);
+    EXPECT_EQ(order.GetLastSortMethod(), ParticleDrawOrder::SortMethod::None);
+    ASSERT_EQ(order.GetOrder().size(), std::size_t{1u});
+}
+
+TEST(ParticleDrawOrderBenchmark, DISABLED_SortTimePerFrame) {
+    using namespace ParticleDrawOrderTests;
+    constexpr int frames = 20;
+    const auto view_position = Vector3{0.0f, 0.0f, -100.0f};
+    const auto view_forward = Vector3{0.0f, 0.0f, 1.0f};
+    const auto seconds_since = [](auto start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    std::cout << std::setw(10) << "particles" << std::setw(14) << "std::sort ms" << std::setw(10) << "radix ms" << std::setw(14) << "reused ms\n";
+    for(const std::size_t count : {10000u, 100000u, 1000000u}) {
+        auto pool = MakePool(count);
+        std::vector<float> depths{};
+        std::vector<std::uint32_t> indices(count);
+        double full_sort = 0.0;
+        double radix = 0.0;
+        double reused = 0.0;
+        ParticleDrawOrder fresh{};
+        for(int frame = 0; frame < frames; ++frame) {
+            pool.Update(1.0f / 60.0f);
+            auto start = std::chrono::steady_clock::now();
+            pool.CalcViewDepths(view_position, view_forward, depths);
+            std::iota(std::begin(indices), std::end(indices), std::uint32_t{0u});
+            std::sort(std::begin(indices), std::end(indices), [&depths](std::uint32_t a, std::uint32_t b) { return depths[b] < depths[a]; });
+            full_sort += seconds_since(start);
+            //Without the previous order every frame is a full radix sort.
+            fresh.Clear();
+            start = std::chrono::steady_clock::now();
+            fresh.Sort(pool, view_position, view_forward);
+            radix += seconds_since(start);
+            EXPECT_EQ(fresh.GetLastSortMethod(), ParticleDrawOrder::SortMethod::Radix);
+        }
+        ParticleDrawOrder order{};
+        order.Sort(pool, view_position, view_forward);
+        for(int frame = 0; frame < frames; ++frame) {
+            pool.Update(1.0f / 60.0f);
+            const auto start = std::chrono::steady_clock::now();
+            order.Sort(pool, view_position, view_forward);
+            reused += seconds_since(start);
+        }
+        const auto ms = [](double seconds) { return seconds / frames * 1000.0; };
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(2) << std::setw(14) << ms(full_sort) << std::setw(10) << ms(radix) << std::setw(13) << ms(reused) << '\n';
+    }
+}
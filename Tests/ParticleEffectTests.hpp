@@ -0,0 +1,169 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Physics/Particles/ParticleEffect.hpp"
+#include "Engine/Physics/Particles/ParticleEffectDefinition.hpp"
+#include "Engine/Renderer/Camera3D.hpp"
+#include "Engine/Services/ServiceLocator.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace ParticleEffectTests {
+
+    //Just enough renderer for an effect to update: no materials and a default camera.
+    class TestRendererService : public NullRendererService {
+    public:
+        [[nodiscard]] Material* GetMaterial([[maybe_unused]] const std::string& nameOrFile) noexcept override {
+            return nullptr;
+        }
+        [[nodiscard]] Camera3D GetCamera() const noexcept override {
+            return Camera3D{};
+        }
+    };
+
+    //One emitter spawning 60 long-lived quads a second.
+    inline const std::string& LoadEffectDefinition() {
+        static const std::string name{"ParticleEffectTests_Effect"};
+        if(!ParticleEffectDefinition::GetDefinition(name)) {
+            tinyxml2::XMLDocument doc;
+            doc.Parse(R"(<effect name="ParticleEffectTests_Effect">
+                             <emitter name="ParticleEffectTests_Emitter">
+                                 <lifetime>infinity</lifetime>
+                                 <per_second>60</per_second>
+                                 <particle_lifetime>100</particle_lifetime>
+                             </emitter>
+                         </effect>)");
+            ParticleEffectDefinition::LoadDefinition(*doc.RootElement());
+        }
+        return name;
+    }
+
+    //A single worker that can be held busy, so a job dispatched after Block() cannot start until Release().
+    //The services live as long as the process since the ServiceLocator keeps pointing at them.
+    class ParticleEffectAsync : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            static TestRendererService renderer{};
+            ServiceLocator::provide<IRendererService>(renderer);
+            ServiceLocator::provide<IJobSystemService>(GetJobSystem());
+        }
+        void TearDown() override {
+            Release();
+        }
+
+        [[nodiscard]] static JobSystem& GetJobSystem() {
+            static JobSystem jobs{1, static_cast<std::size_t>(JobType::Max), nullptr, JobSchedulerMode::WorkStealing};
+            return jobs;
+        }
+
+        void Block() {
+            _is_released = false;
+            _is_blocked = false;
+            GetJobSystem().Run(JobType::Generic, [this](void*) {
+                _is_blocked = true;
+                while(!_is_released) {
+                    std::this_thread::yield();
+                }
+                _is_blocked = false;
+            }, nullptr);
+            while(!_is_blocked) {
+                std::this_thread::yield();
+            }
+        }
+        //Returns once the blocker has stopped touching the fixture.
+        void Release() {
+            _is_released = true;
+            while(_is_blocked) {
+                std::this_thread::yield();
+            }
+        }
+
+        [[nodiscard]] static std::size_t FrontVertexCount(ParticleEffect& effect) {
+            return effect.GetEmitters().front().GetMeshBuilder().verticies.size();
+        }
+
+        std::atomic<bool> _is_blocked{false};
+        std::atomic<bool> _is_released{false};
+    };
+
+} // namespace ParticleEffectTests
+
+using ParticleEffectTests::ParticleEffectAsync;
+
+TEST_F(ParticleEffectAsync, FrontBufferIsUnchangedUntilEndUpdate) {
+    ParticleEffect effect{ParticleEffectTests::LoadEffectDefinition()};
+    effect.SetPlay(true);
+    effect.Update(0.0f, 0.5f);
+    const auto first_count = FrontVertexCount(effect);
+    ASSERT_LT(std::size_t{0u}, first_count);
+
+    Block();
+    effect.BeginUpdate(0.5f, 0.5f);
+    //The update job is still queued behind the blocker; Render may submit the last finished vertices meanwhile.
+    EXPECT_EQ(FrontVertexCount(effect), first_count);
+    effect.Render();
+    Release();
+    //Now the job may be running or done, but nothing is published before EndUpdate.
+    EXPECT_EQ(FrontVertexCount(effect), first_count);
+    effect.EndUpdate();
+    EXPECT_LT(first_count, FrontVertexCount(effect));
+}
+
+TEST_F(ParticleEffectAsync, UpdateThatSkipsSimulationDoesNotSwap) {
+    ParticleEffect effect{ParticleEffectTests::LoadEffectDefinition()};
+    effect.SetPlay(true);
+    ParticleLod lod{};
+    lod.update_interval = 2u;
+    effect.SetLod(lod);
+    effect.Update(0.0f, 0.5f);
+    effect.Update(0.5f, 0.5f);
+    const auto stale_count = FrontVertexCount(effect);
+    ASSERT_LT(std::size_t{0u}, stale_count);
+    //Skipped by the update interval.
+    effect.BeginUpdate(1.0f, 0.5f);
+    effect.EndUpdate();
+    EXPECT_EQ(FrontVertexCount(effect), stale_count);
+    //Simulates the time of both frames and publishes it; the back buffer now holds the stale vertices.
+    effect.BeginUpdate(1.5f, 0.5f);
+    effect.EndUpdate();
+    const auto current_count = FrontVertexCount(effect);
+    EXPECT_LT(stale_count, current_count);
+    //Skipped again: swapping now would bring the stale vertices back.
+    effect.BeginUpdate(2.0f, 0.5f);
+    effect.EndUpdate();
+    EXPECT_EQ(FrontVertexCount(effect), current_count);
+}
+
+TEST_F(ParticleEffectAsync, CopiesAndMovesPointEmittersAtTheirOwnEffect) {
+    ParticleEffect effect{ParticleEffectTests::LoadEffectDefinition()};
+    effect.SetPlay(true);
+    effect.Update(0.0f, 0.5f);
+    const auto first_count = FrontVertexCount(effect);
+    effect.BeginUpdate(0.5f, 0.5f);
+    //Moving finishes the pending update, which must not be left writing into the moved-from effect.
+    ParticleEffect moved{std::move(effect)};
+    EXPECT_LT(first_count, FrontVertexCount(moved));
+    for(const auto& emitter : moved.GetEmitters()) {
+        EXPECT_EQ(emitter.parent_effect, &moved);
+    }
+    ParticleEffect copy{moved};
+    for(const auto& emitter : copy.GetEmitters()) {
+        EXPECT_EQ(emitter.parent_effect, &copy);
+    }
+    //Each effect simulates at its own position.
+    copy.position = Vector3{1000.0f, 0.0f, 0.0f};
+    copy.BeginUpdate(1.0f, 0.5f);
+    moved.BeginUpdate(1.0f, 0.5f);
+    copy.EndUpdate();
+    moved.EndUpdate();
+    EXPECT_LT(500.0f, copy.GetBounds().mins.x);
+    EXPECT_GT(500.0f, moved.GetBounds().maxs.x);
+    moved = copy;
+    for(const auto& emitter : moved.GetEmitters()) {
+        EXPECT_EQ(emitter.parent_effect, &moved);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+#include "Engine/Renderer/ParticleInstance.hpp"
+#include "Engine/Renderer/Vertex3D.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace ParticleInstanceTests {
+
+    ParticlePool MakePool(std::size_t count, unsigned int seed = 17u) {
+        TestUtils::Random random{seed};
+        ParticlePool pool{};
+        pool.SetScales(Vector3{2.0f, 1.0f, 1.0f}, Vector3{0.5f, 0.25f, 0.25f});
+        pool.Reserve(count);
+        for(std::size_t i = 0u; i < count; ++i) {
+            pool.Spawn(random.Value3(-50.0f, 50.0f), Vector3::Zero, 100.0f);
+        }
+        return pool;
+    }
+
+    //The vertex path's quad: four full vertices and six indices per particle, as ParticleEmitter builds them.
+    void ExpandQuads(const ParticlePool& pool, std::vector<Vertex3D>& vertices, std::vector<unsigned int>& indices) {
+        vertices.clear();
+        indices.clear();
+        const auto right = Vector3::X_Axis;
+        const auto up = Vector3::Y_Axis;
+        for(std::size_t i = 0u; i < pool.size(); ++i) {
+            const auto position = pool.GetPosition(i);
+            const auto half_extents = pool.GetScale(i) * 0.5f;
+            const auto& color = pool.GetColor(i);
+            const auto l = right * -half_extents.x;
+            const auto r = right * half_extents.x;
+            const auto t = up * -half_extents.y;
+            const auto b = up * half_extents.y;
+            const auto first = static_cast<unsigned int>(vertices.size());
+            vertices.emplace_back(position + l + b, color, Vector2(0.0f, 1.0f), Vector3::Z_Axis);
+            vertices.emplace_back(position + l + t, color, Vector2(0.0f, 0.0f), Vector3::Z_Axis);
+            vertices.emplace_back(position + r + t, color, Vector2(1.0f, 0.0f), Vector3::Z_Axis);
+            vertices.emplace_back(position + r + b, color, Vector2(1.0f, 1.0f), Vector3::Z_Axis);
+            for(const auto offset : {0u, 1u, 2u, 0u, 2u, 3u}) {
+                indices.push_back(first + offset);
+            }
+        }
+    }
+
+} // namespace ParticleInstanceTests
+
+TEST(ParticleInstance, WritesVisibleParticlesInOrder) {
+    ParticlePool pool{};
+    pool.SetScales(Vector3{2.0f, 3.0f, 4.0f}, Vector3{2.0f, 3.0f, 4.0f});
+    pool.SetColors(Rgba(10, 20, 30, 255), Rgba(10, 20, 30, 255));
+    for(int i = 0; i < 4; ++i) {
+        pool.Spawn(Vector3{static_cast<float>(i), 0.0f, 0.0f}, Vector3::Zero, 10.0f);
+    }
+    std::vector<ParticleInstance> instances{};
+    pool.WriteInstances({}, instances);
+    ASSERT_EQ(instances.size(), std::size_t{4u});
+    for(std::size_t i = 0u; i < instances.size(); ++i) {
+        EXPECT_EQ(instances[i].position, Vector3(static_cast<float>(i), 0.0f, 0.0f));
+        EXPECT_EQ(instances[i].scale, Vector2(2.0f, 3.0f));
+        EXPECT_EQ(instances[i].color, Rgba(10, 20, 30, 255));
+        EXPECT_EQ(instances[i].uv_rect, Vector4(0.0f, 0.0f, 1.0f, 1.0f));
+    }
+
+    pool.WriteInstances({3u, 1u, 2u, 0u}, instances);
+    ASSERT_EQ(instances.size(), std::size_t{4u});
+    EXPECT_EQ(instances[0].position.x, 3.0f);
+    EXPECT_EQ(instances[1].position.x, 1.0f);
+    EXPECT_EQ(instances[2].position.x, 2.0f);
+    EXPECT_EQ(instances[3].position.x, 0.0f);
+}
+
+TEST(ParticleInstance, SkipsInvisibleParticles) {
+    ParticlePool pool{};
+    pool.SetColors(Rgba(255, 255, 255, 0), Rgba(255, 255, 255, 0));
+    pool.Spawn(Vector3::Zero, Vector3::Zero, 10.0f);
+    pool.SetColors(Rgba::White, Rgba::White);
+    pool.Spawn(Vector3::One, Vector3::Zero, 10.0f);
+    //Dead but not yet removed.
+    pool.Spawn(Vector3::Zero, Vector3::Zero, 0.0f);
+    std::vector<ParticleInstance> instances(10u);
+    pool.WriteInstances({}, instances);
+    ASSERT_EQ(instances.size(), std::size_t{1u});
+    EXPECT_EQ(instances[0].position, Vector3::One);
+}
+
+TEST(ParticleInstanceBenchmark, DISABLED_BytesAndTimePer100kParticles) {
+    using namespace ParticleInstanceTests;
+    constexpr std::size_t count = 100000u;
+    constexpr int frames = 20;
+    const auto pool = MakePool(count);
+    std::vector<Vertex3D> vertices{};
+    std::vector<unsigned int> indices{};
+    std::vector<ParticleInstance> instances{};
+    //Warm both paths up so neither pays for growing its buffers.
+    ExpandQuads(pool, vertices, indices);
+    pool.WriteInstances({}, instances);
+    const auto seconds_since = [](auto start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    double expanded = 0.0;
+    double instanced = 0.0;
+    for(int frame = 0; frame < frames; ++frame) {
+        auto start = std::chrono::steady_clock::now();
+        ExpandQuads(pool, vertices, indices);
+        expanded += seconds_since(start);
+        start = std::chrono::steady_clock::now();
+        pool.WriteInstances({}, instances);
+        instanced += seconds_since(start);
+    }
+    ASSERT_EQ(instances.size(), count);
+    const auto expanded_bytes = vertices.size() * sizeof(Vertex3D) + indices.size() * sizeof(unsigned int);
+    const auto instanced_bytes = instances.size() * sizeof(ParticleInstance);
+    EXPECT_LT(instanced_bytes * 4u, expanded_bytes);
+    const auto ms = [](double seconds) { return seconds / frames * 1000.0; };
+    std::cout << std::setw(12) << "path" << std::setw(14) << "bytes" << std::setw(10) << "ms\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(12) << "vertices" << std::setw(14) << expanded_bytes << std::setw(9) << ms(expanded) << '\n';
+    std::cout << std::setw(12) << "instances" << std::setw(14) << instanced_bytes << std::setw(9) << ms(instanced) << '\n';
+}
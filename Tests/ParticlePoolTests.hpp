@@ -0,0 +1,114 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/Particles/ParticlePool.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace ParticlePoolTests {
+
+    //Lifetimes are spread out so particles die on different steps.
+    ParticlePool MakePool(std::size_t count, unsigned int seed = 11u) {
+        TestUtils::Random random{seed};
+        ParticlePool pool{};
+        pool.SetAcceleration(Vector3{0.0f, -9.8f, 0.5f});
+        pool.SetColors(Rgba(255, 128, 0, 255), Rgba(0, 64, 255, 0));
+        pool.SetScales(Vector3{1.0f, 1.0f, 1.0f}, Vector3{0.25f, 0.5f, 2.0f});
+        pool.Reserve(count);
+        for(std::size_t i = 0u; i < count; ++i) {
+            const auto position = random.Value3(-10.0f, 10.0f);
+            const auto velocity = random.Value3(-10.0f, 10.0f);
+            pool.Spawn(position, velocity, random.Value(0.05f, 2.0f));
+        }
+        return pool;
+    }
+
+} // namespace ParticlePoolTests
+
+TEST(ParticlePool, BatchedUpdateMatchesScalarStep) {
+    using namespace ParticlePoolTests;
+    //250 four-particle batches, then three particles that Update finishes one at a time through Step.
+    auto pool = MakePool(1003u);
+    std::vector<ParticlePool::ParticleState> states{};
+    for(std::size_t i = 0u; i < pool.size(); ++i) {
+        states.push_back(pool.GetState(i));
+    }
+    constexpr auto dt = 1.0f / 60.0f;
+    for(int step = 0; step < 10; ++step) {
+        for(auto& state : states) {
+            pool.Step(state, dt);
+        }
+        pool.Update(dt, 0u, pool.size());
+        for(std::size_t i = 0u; i < pool.size(); ++i) {
+            const auto state = pool.GetState(i);
+            ASSERT_EQ(state.position, states[i].position) << "step " << step << ", particle " << i;
+            ASSERT_EQ(state.velocity, states[i].velocity) << "step " << step << ", particle " << i;
+            ASSERT_EQ(state.scale, states[i].scale) << "step " << step << ", particle " << i;
+            ASSERT_EQ(state.age, states[i].age) << "step " << step << ", particle " << i;
+            ASSERT_EQ(state.color, states[i].color) << "step " << step << ", particle " << i;
+        }
+    }
+}
+
+TEST(ParticlePool, ColorAndScaleFollowAge) {
+    ParticlePool pool{};
+    pool.SetColors(Rgba(255, 0, 0, 255), Rgba(0, 0, 255, 0));
+    pool.SetScales(Vector3{2.0f, 2.0f, 2.0f}, Vector3{0.0f, 0.0f, 0.0f});
+    pool.SetAcceleration(Vector3{0.0f, -10.0f, 0.0f});
+    pool.Spawn(Vector3::Zero, Vector3{1.0f, 0.0f, 0.0f}, 2.0f);
+    EXPECT_EQ(pool.GetColor(0u), Rgba(255, 0, 0, 255));
+    pool.Update(1.0f);
+    ASSERT_EQ(pool.size(), std::size_t{1u});
+    //Halfway through its life.
+    EXPECT_EQ(pool.GetColor(0u), Rgba(128, 0, 128, 128));
+    EXPECT_EQ(pool.GetScale(0u), Vector3(1.0f, 1.0f, 1.0f));
+    EXPECT_EQ(pool.GetVelocity(0u), Vector3(1.0f, -10.0f, 0.0f));
+    EXPECT_EQ(pool.GetPosition(0u), Vector3(1.0f, -10.0f, 0.0f));
+    pool.Update(1.0f);
+    EXPECT_TRUE(pool.empty());
+}
+
+TEST(ParticlePool, DeadParticlesAreSwapRemoved) {
+    ParticlePool pool{};
+    for(int i = 0; i < 9; ++i) {
+        //Every third particle dies on the first update, including the last one.
+        pool.Spawn(Vector3{static_cast<float>(i), 0.0f, 0.0f}, Vector3::Zero, i % 3 == 2 ? 0.5f : 5.0f);
+    }
+    pool.Update(1.0f);
+    ASSERT_EQ(pool.size(), std::size_t{6u});
+    std::vector<bool> seen(9u, false);
+    for(std::size_t i = 0u; i < pool.size(); ++i) {
+        EXPECT_TRUE(pool.IsAlive(i));
+        seen[static_cast<std::size_t>(pool.GetPosition(i).x)] = true;
+    }
+    for(int i = 0; i < 9; ++i) {
+        EXPECT_EQ(seen[i], i % 3 != 2) << "particle " << i;
+    }
+}
+
+TEST(ParticlePoolBenchmark, DISABLED_ParticlesUpdatedPerSecond) {
+    using namespace ParticlePoolTests;
+    constexpr int frames = 20;
+    constexpr auto dt = 1.0f / 60.0f;
+    std::cout << std::setw(10) << "particles" << std::setw(16) << "ms per frame" << "   (M particles/s)\n";
+    for(const std::size_t count : {10000u, 100000u, 1000000u}) {
+        auto pool = MakePool(count);
+        //Long lifetimes so the whole pool is updated every frame.
+        pool.Clear();
+        for(std::size_t i = 0u; i < count; ++i) {
+            pool.Spawn(Vector3::Zero, Vector3::One, 100.0f);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for(int frame = 0; frame < frames; ++frame) {
+            pool.Update(dt);
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(pool.size(), count);
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(2) << std::setw(16) << seconds / frames * 1000.0 << std::setw(16) << count * frames / seconds / 1.0e6 << '\n';
+    }
+}
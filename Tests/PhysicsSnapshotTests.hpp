@@ -0,0 +1,191 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Physics/PhysicsSnapshot.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace PhysicsSnapshotTests {
+
+    //Sized like RigidBody::SnapshotState so the benchmark moves as many bytes as a real world would.
+    struct Body {
+        Vector2 position{};
+        Vector2 velocity{};
+        Vector2 acceleration{};
+        Vector2 extra[3]{};
+        float scalars[8]{};
+        std::uint32_t flags[2]{};
+    };
+
+    std::vector<Body> MakeBodies(std::size_t count, unsigned int seed = 7u) {
+        TestUtils::Random random{seed};
+        std::vector<Body> bodies(count);
+        for(auto& body : bodies) {
+            body.position = random.Value2(-100.0f, 100.0f);
+            body.velocity = random.Value2(-100.0f, 100.0f);
+            body.scalars[0] = random.Value(-100.0f, 100.0f);
+        }
+        return bodies;
+    }
+
+    void Save(const std::vector<Body>& bodies, PhysicsSnapshot& snapshot) {
+        snapshot.Clear();
+        snapshot.Write(static_cast<std::uint32_t>(bodies.size()));
+        for(const auto& body : bodies) {
+            snapshot.Write(body);
+        }
+    }
+
+    //Moves every tenth body, the rest are asleep.
+    void Step(std::vector<Body>& bodies, float dt) {
+        for(std::size_t i = 0u; i < bodies.size(); i += 10u) {
+            bodies[i].position += bodies[i].velocity * dt;
+        }
+    }
+
+} // namespace PhysicsSnapshotTests
+
+TEST(PhysicsSnapshot, ValuesReadBackInOrder) {
+    PhysicsSnapshot snapshot{};
+    snapshot.Write(std::uint32_t{42u});
+    snapshot.Write(Vector2{1.0f, 2.0f});
+    const float values[] = {3.0f, 4.0f, 5.0f};
+    snapshot.Write(values, 3u);
+    EXPECT_EQ(snapshot.size(), sizeof(std::uint32_t) + sizeof(Vector2) + sizeof(values));
+
+    PhysicsSnapshot::Reader reader{snapshot};
+    auto count = std::uint32_t{};
+    auto position = Vector2{};
+    float read_values[3]{};
+    ASSERT_TRUE(reader.Read(count));
+    ASSERT_TRUE(reader.Read(position));
+    ASSERT_TRUE(reader.Read(read_values, 3u));
+    EXPECT_EQ(count, 42u);
+    EXPECT_EQ(position, Vector2(1.0f, 2.0f));
+    EXPECT_EQ(read_values[2], 5.0f);
+    EXPECT_TRUE(reader.IsAtEnd());
+    //Reading past the end fails instead of returning garbage.
+    EXPECT_FALSE(reader.Read(count));
+}
+
+TEST(PhysicsSnapshot, HashFollowsContents) {
+    using namespace PhysicsSnapshotTests;
+    auto bodies = MakeBodies(1001u);
+    PhysicsSnapshot a{};
+    PhysicsSnapshot b{};
+    Save(bodies, a);
+    Save(bodies, b);
+    EXPECT_EQ(a.CalcHash(), b.CalcHash());
+    //A single bit anywhere changes the hash.
+    bodies[500].scalars[3] = 1.0e-40f;
+    Save(bodies, b);
+    EXPECT_NE(a.CalcHash(), b.CalcHash());
+    //So does trailing data that is all zeroes.
+    Save(MakeBodies(1001u), b);
+    b.Write(std::uint8_t{0u});
+    EXPECT_NE(a.CalcHash(), b.CalcHash());
+}
+
+TEST(PhysicsSnapshot, DeltaRoundTrips) {
+    using namespace PhysicsSnapshotTests;
+    auto bodies = MakeBodies(1000u);
+    PhysicsSnapshot previous{};
+    PhysicsSnapshot current{};
+    PhysicsSnapshot decoded{};
+    std::vector<std::uint8_t> delta{};
+    Save(bodies, previous);
+    Step(bodies, 1.0f / 60.0f);
+    Save(bodies, current);
+    current.EncodeDelta(previous, delta);
+    EXPECT_LT(delta.size(), current.size() / 4u);
+    ASSERT_TRUE(decoded.DecodeDelta(previous, delta));
+    EXPECT_EQ(decoded.CalcHash(), current.CalcHash());
+
+    //Against nothing, or against a longer or shorter base.
+    current.EncodeDelta(PhysicsSnapshot{}, delta);
+    ASSERT_TRUE(decoded.DecodeDelta(PhysicsSnapshot{}, delta));
+    EXPECT_EQ(decoded.CalcHash(), current.CalcHash());
+    bodies.resize(900u);
+    Save(bodies, previous);
+    current.EncodeDelta(previous, delta);
+    ASSERT_TRUE(decoded.DecodeDelta(previous, delta));
+    EXPECT_EQ(decoded.CalcHash(), current.CalcHash());
+    previous.EncodeDelta(current, delta);
+    ASSERT_TRUE(decoded.DecodeDelta(current, delta));
+    EXPECT_EQ(decoded.CalcHash(), previous.CalcHash());
+
+    //Decoding in place over the base.
+    current.EncodeDelta(previous, delta);
+    ASSERT_TRUE(previous.DecodeDelta(previous, delta));
+    EXPECT_EQ(previous.CalcHash(), current.CalcHash());
+
+    //Truncated deltas are rejected and leave the snapshot as it was.
+    const auto decoded_hash = decoded.CalcHash();
+    Save(MakeBodies(10u, 1u), previous);
+    current.EncodeDelta(previous, delta);
+    delta.pop_back();
+    EXPECT_FALSE(decoded.DecodeDelta(previous, delta));
+    EXPECT_FALSE(decoded.DecodeDelta(previous, std::vector<std::uint8_t>{}));
+    EXPECT_EQ(decoded.CalcHash(), decoded_hash);
+
+    //So is a size far larger than the delta could fill.
+    std::vector<std::uint8_t> huge_size(8u, std::uint8_t{0xFFu});
+    huge_size.push_back(std::uint8_t{0x7Fu});
+    EXPECT_FALSE(decoded.DecodeDelta(previous, huge_size));
+    EXPECT_EQ(decoded.CalcHash(), decoded_hash);
+}
+
+TEST(PhysicsSnapshotBenchmark, DISABLED_FiveThousandBodies) {
+    using namespace PhysicsSnapshotTests;
+    constexpr std::size_t count = 5000u;
+    constexpr int steps = 100;
+    auto bodies = MakeBodies(count);
+    PhysicsSnapshot previous{};
+    PhysicsSnapshot current{};
+    PhysicsSnapshot decoded{};
+    std::vector<std::uint8_t> delta{};
+    std::vector<Body> restored(count);
+    Save(bodies, previous);
+    double save = 0.0;
+    double restore = 0.0;
+    double hash = 0.0;
+    double encode = 0.0;
+    double decode = 0.0;
+    std::size_t delta_bytes = 0u;
+    const auto seconds_since = [](auto start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    for(int step = 0; step < steps; ++step) {
+        Step(bodies, 1.0f / 60.0f);
+        auto start = std::chrono::steady_clock::now();
+        Save(bodies, current);
+        save += seconds_since(start);
+        start = std::chrono::steady_clock::now();
+        auto reader = PhysicsSnapshot::Reader{current};
+        auto read_count = std::uint32_t{};
+        ASSERT_TRUE(reader.Read(read_count));
+        ASSERT_TRUE(reader.Read(restored.data(), read_count));
+        restore += seconds_since(start);
+        start = std::chrono::steady_clock::now();
+        const auto current_hash = current.CalcHash();
+        hash += seconds_since(start);
+        start = std::chrono::steady_clock::now();
+        current.EncodeDelta(previous, delta);
+        encode += seconds_since(start);
+        delta_bytes += delta.size();
+        start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(decoded.DecodeDelta(previous, delta));
+        decode += seconds_since(start);
+        ASSERT_EQ(decoded.CalcHash(), current_hash);
+        std::swap(previous, current);
+    }
+    EXPECT_EQ(restored[count - 10u].position, bodies[count - 10u].position);
+    const auto us = [](double seconds) { return seconds / steps * 1.0e6; };
+    std::cout << std::fixed << std::setprecision(1) << count << " bodies, " << previous.size() << " bytes, delta " << delta_bytes / steps << " bytes\n"
+              << "save " << us(save) << "us, restore " << us(restore) << "us, hash " << us(hash) << "us, encode " << us(encode) << "us, decode " << us(decode) << "us\n";
+}
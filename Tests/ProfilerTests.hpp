@@ -0,0 +1,171 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Profiling/Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ProfilerTests {
+
+    [[nodiscard]] inline const Profiler::ScopeStats* FindStats(const std::string& name) {
+        const auto& stats = Profiler::GetLastFrameStats();
+        const auto found = std::find_if(std::begin(stats), std::end(stats), [&name](const Profiler::ScopeStats& s) { return s.name == name; });
+        return found != std::end(stats) ? &*found : nullptr;
+    }
+
+    inline void Spin(std::chrono::microseconds duration) {
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < end) {
+            /* DO NOTHING */
+        }
+    }
+
+    [[nodiscard]] inline std::size_t CountOccurrences(const std::string& str, const std::string& pattern) {
+        std::size_t count = 0u;
+        for(auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size())) {
+            ++count;
+        }
+        return count;
+    }
+
+} // namespace ProfilerTests
+
+TEST(Profiler, NestedScopesAggregateInclusiveAndExclusiveTime) {
+    using namespace ProfilerTests;
+    Profiler::Reset();
+    Profiler::Enable(true);
+    {
+        ProfileScope outer("outer");
+        Spin(std::chrono::microseconds{200});
+        for(int i = 0; i < 3; ++i) {
+            ProfileScope inner("inner");
+            Spin(std::chrono::microseconds{100});
+        }
+    }
+    EXPECT_FALSE(Profiler::EndFrame());
+    Profiler::Enable(false);
+
+    const auto* outer = FindStats("outer");
+    const auto* inner = FindStats("inner");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(outer->calls, std::uint64_t{1u});
+    EXPECT_EQ(inner->calls, std::uint64_t{3u});
+    EXPECT_GE(outer->inclusive_ms, inner->inclusive_ms);
+    EXPECT_NEAR(outer->exclusive_ms, outer->inclusive_ms - inner->inclusive_ms, 1e-6);
+    EXPECT_DOUBLE_EQ(inner->exclusive_ms, inner->inclusive_ms);
+    EXPECT_LE(inner->max_ms, inner->inclusive_ms);
+
+    //Disabled scopes are not recorded and the next frame only sees its own scopes.
+    {
+        ProfileScope ignored("ignored");
+    }
+    Profiler::EndFrame();
+    EXPECT_TRUE(Profiler::GetLastFrameStats().empty());
+}
+
+TEST(Profiler, ScopesFromEveryThreadAreDrained) {
+    using namespace ProfilerTests;
+    Profiler::Reset();
+    Profiler::Enable(true);
+    std::vector<std::thread> threads{};
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for(int i = 0; i < 1000; ++i) {
+                ProfileScope work("work");
+                ProfileScope step("step");
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    Profiler::EndFrame();
+    Profiler::Enable(false);
+    const auto* work = FindStats("work");
+    const auto* step = FindStats("step");
+    ASSERT_NE(work, nullptr);
+    ASSERT_NE(step, nullptr);
+    EXPECT_EQ(work->calls, std::uint64_t{4000u});
+    EXPECT_EQ(step->calls, std::uint64_t{4000u});
+    EXPECT_EQ(Profiler::GetDroppedCount(), std::uint64_t{0u});
+}
+
+TEST(Profiler, FullRingDropsWholeScopes) {
+    using namespace ProfilerTests;
+    Profiler::Reset();
+    Profiler::Enable(true);
+    {
+        ProfileScope outer("outer");
+        for(std::size_t i = 0u; i < Profiler::events_per_thread; ++i) {
+            ProfileScope inner("inner");
+        }
+    }
+    Profiler::EndFrame();
+    Profiler::Enable(false);
+    const auto* outer = FindStats("outer");
+    const auto* inner = FindStats("inner");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(outer->calls, std::uint64_t{1u});
+    EXPECT_GT(Profiler::GetDroppedCount(), std::uint64_t{0u});
+    EXPECT_EQ(inner->calls + Profiler::GetDroppedCount(), std::uint64_t{Profiler::events_per_thread});
+}
+
+TEST(Profiler, CaptureExportsChromeTraceEvents) {
+    using namespace ProfilerTests;
+    Profiler::Reset();
+    Profiler::Enable(true);
+    Profiler::SetThreadName("Test \"Main\" Thread");
+    Profiler::StartCapture(2u);
+    EXPECT_TRUE(Profiler::IsCapturing());
+    for(int frame = 0; frame < 3; ++frame) {
+        {
+            ProfileScope update("update");
+            ProfileScope physics("physics");
+        }
+        EXPECT_EQ(Profiler::EndFrame(), frame == 1);
+    }
+    Profiler::Enable(false);
+    EXPECT_FALSE(Profiler::IsCapturing());
+    EXPECT_EQ(Profiler::GetCapturedScopeCount(), std::size_t{4u});
+
+    std::ostringstream trace{};
+    Profiler::WriteChromeTrace(trace);
+    const auto json = trace.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), std::size_t{0u});
+    EXPECT_EQ(CountOccurrences(json, "\"ph\":\"X\""), std::size_t{4u});
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"physics\""), std::size_t{2u});
+    EXPECT_EQ(CountOccurrences(json, "\"ph\":\"i\""), std::size_t{2u});
+    EXPECT_NE(json.find("\"args\":{\"name\":\"Test \\\"Main\\\" Thread\"}"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4u), "\n]}\n");
+}
+
+TEST(ProfilerBenchmark, DISABLED_NanosecondsPerScope) {
+    using namespace ProfilerTests;
+    Profiler::Reset();
+    Profiler::Enable(true);
+    constexpr std::size_t frames = 100u;
+    constexpr std::size_t scopes_per_frame = 10000u;
+    auto elapsed = std::chrono::nanoseconds::zero();
+    for(std::size_t frame = 0u; frame < frames; ++frame) {
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0u; i < scopes_per_frame; ++i) {
+            ProfileScope scope("benchmark");
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+        Profiler::EndFrame();
+    }
+    Profiler::Enable(false);
+    const auto ns_per_scope = static_cast<double>(elapsed.count()) / static_cast<double>(frames * scopes_per_frame);
+    std::cout << "ProfileScope: " << std::fixed << std::setprecision(2) << ns_per_scope << " ns per scope\n";
+    EXPECT_EQ(Profiler::GetDroppedCount(), std::uint64_t{0u});
+}
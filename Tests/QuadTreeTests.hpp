@@ -0,0 +1,161 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/QuadTree.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace QuadTreeTests {
+
+    struct Element {
+        std::size_t id = 0u;
+    };
+
+    struct Scene {
+        explicit Scene(std::size_t count, float size = 1000.0f, unsigned int seed = 4242u)
+        : random{seed}
+        , world_size{size} {
+            elements.resize(count);
+            for(std::size_t i = 0u; i < count; ++i) {
+                elements[i].id = i;
+                bounds.push_back(RandomBox());
+            }
+        }
+
+        [[nodiscard]] AABB2 RandomBox() {
+            //A few boxes start outside the world so the root has to hold them.
+            return random.Box(-0.05f * world_size, 1.05f * world_size, 0.5f, 8.0f);
+        }
+
+        [[nodiscard]] std::vector<std::size_t> BruteForceQuery(const AABB2& area) const {
+            std::vector<std::size_t> result{};
+            for(std::size_t i = 0u; i < bounds.size(); ++i) {
+                if(MathUtils::DoAABBsOverlap(bounds[i], area)) {
+                    result.push_back(i);
+                }
+            }
+            return result;
+        }
+
+        TestUtils::Random random;
+        float world_size = 0.0f;
+        std::vector<Element> elements{};
+        std::vector<AABB2> bounds{};
+    };
+
+    [[nodiscard]] inline std::vector<std::size_t> TreeQuery(const QuadTree<Element>& tree, const AABB2& area) {
+        std::vector<std::size_t> result{};
+        tree.Query(area, [&result](Element* e) { result.push_back(e->id); });
+        std::sort(std::begin(result), std::end(result));
+        return result;
+    }
+
+} // namespace QuadTreeTests
+
+TEST(QuadTree, QueryMatchesBruteForceAfterMoves) {
+    using namespace QuadTreeTests;
+    Scene scene{2000u};
+    QuadTree<Element> tree{AABB2{Vector2::Zero, Vector2{scene.world_size, scene.world_size}}, 8u, 8u};
+    std::vector<QuadTree<Element>::Handle> handles{};
+    for(std::size_t i = 0u; i < scene.elements.size(); ++i) {
+        handles.push_back(tree.Add(&scene.elements[i], scene.bounds[i]));
+    }
+    EXPECT_EQ(tree.size(), scene.elements.size());
+    EXPECT_GT(tree.GetNodeCount(), std::size_t{1u});
+    for(int step = 0; step < 20; ++step) {
+        for(std::size_t i = 0u; i < scene.bounds.size(); ++i) {
+            scene.bounds[i].Translate(scene.random.Value2(-20.0f, 20.0f));
+            tree.Update(handles[i], scene.bounds[i]);
+        }
+        for(int q = 0; q < 10; ++q) {
+            const auto corner = scene.random.Value2(0.0f, scene.world_size);
+            const auto area = AABB2{corner, corner + Vector2{150.0f, 100.0f}};
+            ASSERT_EQ(TreeQuery(tree, area), scene.BruteForceQuery(area)) << "step " << step << ", query " << q;
+        }
+    }
+    const auto everything = AABB2{Vector2{-1e6f, -1e6f}, Vector2{1e6f, 1e6f}};
+    EXPECT_EQ(TreeQuery(tree, everything).size(), scene.elements.size());
+}
+
+TEST(QuadTree, RemoveMergesNodesAndRecyclesHandles) {
+    using namespace QuadTreeTests;
+    Scene scene{500u};
+    QuadTree<Element> tree{AABB2{Vector2::Zero, Vector2{scene.world_size, scene.world_size}}, 4u, 6u};
+    std::vector<QuadTree<Element>::Handle> handles{};
+    for(std::size_t i = 0u; i < scene.elements.size(); ++i) {
+        handles.push_back(tree.Add(&scene.elements[i], scene.bounds[i]));
+    }
+    const auto split_node_count = tree.GetNodeCount();
+    EXPECT_GT(split_node_count, std::size_t{1u});
+    for(std::size_t i = 0u; i < handles.size(); i += 2u) {
+        tree.Remove(handles[i]);
+    }
+    EXPECT_EQ(tree.size(), handles.size() / 2u);
+    const auto everything = AABB2{Vector2{-1e6f, -1e6f}, Vector2{1e6f, 1e6f}};
+    for(const auto id : TreeQuery(tree, everything)) {
+        EXPECT_EQ(id % 2u, std::size_t{1u});
+    }
+    for(std::size_t i = 1u; i < handles.size(); i += 2u) {
+        tree.Remove(handles[i]);
+    }
+    EXPECT_EQ(tree.size(), std::size_t{0u});
+    EXPECT_EQ(tree.GetNodeCount(), std::size_t{1u});
+    EXPECT_TRUE(TreeQuery(tree, everything).empty());
+
+    const auto handle = tree.Add(&scene.elements[7], scene.bounds[7]);
+    EXPECT_LT(handle, handles.size());
+    EXPECT_EQ(tree.GetElement(handle), &scene.elements[7]);
+
+    //Growing the world keeps handles valid.
+    tree.SetWorldBounds(AABB2{Vector2{-2000.0f, -2000.0f}, Vector2{2000.0f, 2000.0f}});
+    EXPECT_EQ(tree.GetElement(handle), &scene.elements[7]);
+    EXPECT_EQ(TreeQuery(tree, scene.bounds[7]), std::vector<std::size_t>{7u});
+}
+
+TEST(QuadTreeBenchmark, DISABLED_UpdateAndQueryByElementCount) {
+    using namespace QuadTreeTests;
+    constexpr int steps = 10;
+    std::cout << std::setw(10) << "elements" << std::setw(14) << "update" << std::setw(14) << "query" << std::setw(14) << "brute" << "   (ms per step)\n";
+    for(const std::size_t count : {1000u, 10000u, 50000u}) {
+        Scene scene{count, std::sqrt(static_cast<float>(count)) * 20.0f};
+        QuadTree<Element> tree{AABB2{Vector2::Zero, Vector2{scene.world_size, scene.world_size}}};
+        std::vector<QuadTree<Element>::Handle> handles{};
+        for(std::size_t i = 0u; i < count; ++i) {
+            handles.push_back(tree.Add(&scene.elements[i], scene.bounds[i]));
+        }
+        //A camera sized view into the middle of the world.
+        const auto center = Vector2{scene.world_size, scene.world_size} * 0.5f;
+        const auto area = AABB2{center - Vector2{160.0f, 90.0f}, center + Vector2{160.0f, 90.0f}};
+        auto update = std::chrono::duration<double, std::milli>::zero();
+        auto query = std::chrono::duration<double, std::milli>::zero();
+        auto brute = std::chrono::duration<double, std::milli>::zero();
+        std::size_t visible = 0u;
+        std::size_t expected = 0u;
+        for(int step = 0; step < steps; ++step) {
+            for(auto& box : scene.bounds) {
+                box.Translate(scene.random.Value2(-1.0f, 1.0f));
+            }
+            auto start = std::chrono::steady_clock::now();
+            for(std::size_t i = 0u; i < count; ++i) {
+                tree.Update(handles[i], scene.bounds[i]);
+            }
+            update += std::chrono::steady_clock::now() - start;
+            start = std::chrono::steady_clock::now();
+            visible = 0u;
+            tree.Query(area, [&visible](Element*) { ++visible; });
+            query += std::chrono::steady_clock::now() - start;
+            start = std::chrono::steady_clock::now();
+            expected = scene.BruteForceQuery(area).size();
+            brute += std::chrono::steady_clock::now() - start;
+        }
+        EXPECT_EQ(visible, expected);
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(3) << std::setw(14) << update.count() / steps << std::setw(14) << query.count() / steps << std::setw(14) << brute.count() / steps << '\n';
+    }
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "pch.h"
+#include "TestUtils.hpp"
+
+#include "Engine/Physics/RigidBodyStore.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace RigidBodyStoreTests {
+
+    struct Scene {
+        explicit Scene(std::size_t count, unsigned int seed = 2024u)
+        : random{seed} {
+            for(std::size_t i = 0u; i < count; ++i) {
+                RigidBodyStore::BodyState state{};
+                state.position = random.Value2(-100.0f, 100.0f);
+                state.velocity = random.Value2(-100.0f, 100.0f);
+                state.inverse_mass = random.Value(0.01f, 2.0f);
+                state.linear_damping = random.Value(0.9f, 1.0f);
+                states.push_back(state);
+                forces.push_back(random.Value2(-100.0f, 100.0f));
+                active.push_back(i % 7u != 3u);
+            }
+        }
+
+        TestUtils::Random random;
+        std::vector<RigidBodyStore::BodyState> states{};
+        std::vector<Vector2> forces{};
+        std::vector<bool> active{};
+    };
+
+} // namespace RigidBodyStoreTests
+
+TEST(RigidBodyStore, BatchedIntegrationMatchesScalarStep) {
+    using namespace RigidBodyStoreTests;
+    //Not a multiple of the SIMD width so the scalar tail runs too.
+    Scene scene{1003u};
+    scene.forces[10] = Vector2{std::numeric_limits<float>::quiet_NaN(), 1.0f};
+    scene.forces[11] = Vector2{std::numeric_limits<float>::infinity(), 1.0f};
+    scene.active[10] = scene.active[11] = true;
+    RigidBodyStore store{};
+    std::vector<RigidBodyStore::Handle> handles{};
+    for(std::size_t i = 0u; i < scene.states.size(); ++i) {
+        handles.push_back(store.Add(scene.states[i]));
+        store.SetActive(handles[i], scene.active[i]);
+    }
+    constexpr auto dt = 1.0f / 60.0f;
+    for(int step = 0; step < 10; ++step) {
+        for(std::size_t i = 0u; i < scene.states.size(); ++i) {
+            store.AddForce(handles[i], scene.forces[i]);
+            if(scene.active[i]) {
+                RigidBodyStore::Step(scene.states[i], scene.forces[i], dt);
+            }
+        }
+        store.Integrate(dt);
+        for(std::size_t i = 0u; i < scene.states.size(); ++i) {
+            const auto state = store.GetState(handles[i]);
+            ASSERT_EQ(state.position, scene.states[i].position) << "step " << step << ", body " << i;
+            ASSERT_EQ(state.velocity, scene.states[i].velocity) << "step " << step << ", body " << i;
+            ASSERT_EQ(state.acceleration, scene.states[i].acceleration) << "step " << step << ", body " << i;
+        }
+    }
+    //Non-finite results are clamped rather than spreading.
+    EXPECT_EQ(store.GetAcceleration(handles[10]).x, 0.0f);
+    EXPECT_EQ(store.GetAcceleration(handles[11]).x, 0.0f);
+    EXPECT_TRUE(std::isfinite(store.GetPosition(handles[11]).x));
+    //Forces only last one step.
+    const auto before = store.GetState(handles[0]);
+    store.Integrate(dt);
+    EXPECT_EQ(store.GetAcceleration(handles[0]), Vector2::Zero);
+    EXPECT_EQ(store.GetVelocity(handles[0]), before.velocity * before.linear_damping);
+}
+
+TEST(RigidBodyStore, SplitIntegrationMatchesIntegrate) {
+    using namespace RigidBodyStoreTests;
+    Scene scene{1003u};
+    RigidBodyStore fused{};
+    RigidBodyStore split{};
+    for(std::size_t i = 0u; i < scene.states.size(); ++i) {
+        const auto handle = fused.Add(scene.states[i]);
+        ASSERT_EQ(split.Add(scene.states[i]), handle);
+        fused.SetActive(handle, scene.active[i]);
+        split.SetActive(handle, scene.active[i]);
+    }
+    constexpr auto dt = 1.0f / 60.0f;
+    for(int step = 0; step < 10; ++step) {
+        for(std::size_t i = 0u; i < scene.states.size(); ++i) {
+            const auto handle = static_cast<RigidBodyStore::Handle>(i);
+            fused.AddForce(handle, scene.forces[i]);
+            split.AddForce(handle, scene.forces[i]);
+        }
+        fused.Integrate(dt);
+        //Uneven batches so both the SIMD and scalar paths run.
+        split.IntegrateVelocities(dt, 0u, 501u);
+        split.IntegrateVelocities(dt, 501u, split.size());
+        split.IntegratePositions(dt, 0u, 13u);
+        split.IntegratePositions(dt, 13u, split.size());
+        for(std::size_t i = 0u; i < scene.states.size(); ++i) {
+            const auto handle = static_cast<RigidBodyStore::Handle>(i);
+            const auto a = fused.GetState(handle);
+            const auto b = split.GetState(handle);
+            ASSERT_EQ(a.position, b.position) << "step " << step << ", body " << i;
+            ASSERT_EQ(a.velocity, b.velocity) << "step " << step << ", body " << i;
+            ASSERT_EQ(a.acceleration, b.acceleration) << "step " << step << ", body " << i;
+        }
+    }
+}
+
+TEST(RigidBodyStore, HandlesSurviveRemoval) {
+    using namespace RigidBodyStoreTests;
+    Scene scene{64u};
+    RigidBodyStore store{};
+    std::vector<RigidBodyStore::Handle> handles{};
+    for(const auto& state : scene.states) {
+        handles.push_back(store.Add(state));
+    }
+    for(std::size_t i = 0u; i < handles.size(); i += 3u) {
+        store.Remove(handles[i]);
+    }
+    EXPECT_EQ(store.size(), handles.size() - (handles.size() + 2u) / 3u);
+    for(std::size_t i = 0u; i < handles.size(); ++i) {
+        if(i % 3u) {
+            EXPECT_EQ(store.GetPosition(handles[i]), scene.states[i].position) << "body " << i;
+        }
+    }
+    const auto recycled = store.Add(scene.states[1]);
+    EXPECT_LT(recycled, handles.size());
+    EXPECT_EQ(store.GetVelocity(recycled), scene.states[1].velocity);
+    store.Clear();
+    EXPECT_EQ(store.size(), std::size_t{0u});
+}
+
+TEST(RigidBodyStore, StateMovesIntoAndOutOfTheStore) {
+    RigidBodyStore::BodyState initial{};
+    initial.position = Vector2{1.0f, 2.0f};
+    initial.inverse_mass = 0.5f;
+    RigidBodyState state{initial};
+    state.AddForce(Vector2{4.0f, 0.0f});
+
+    RigidBodyStore store{};
+    state.Bind(store);
+    EXPECT_TRUE(state.IsBound());
+    EXPECT_EQ(store.size(), std::size_t{1u});
+    const auto copy = state;
+    EXPECT_FALSE(copy.IsBound());
+    EXPECT_EQ(copy.GetPosition(), initial.position);
+
+    store.Integrate(1.0f);
+    EXPECT_EQ(state.GetVelocity(), (Vector2{2.0f, 0.0f}));
+    EXPECT_EQ(state.GetPosition(), (Vector2{3.0f, 2.0f}));
+    EXPECT_EQ(copy.GetPosition(), initial.position);
+
+    state.Unbind();
+    EXPECT_FALSE(state.IsBound());
+    EXPECT_EQ(store.size(), std::size_t{0u});
+    EXPECT_EQ(state.GetPosition(), (Vector2{3.0f, 2.0f}));
+    state.Integrate(1.0f);
+    EXPECT_EQ(state.GetPosition(), (Vector2{5.0f, 2.0f}));
+}
+
+TEST(RigidBodyStoreBenchmark, DISABLED_BodiesIntegratedPerSecond) {
+    using namespace RigidBodyStoreTests;
+    constexpr int steps = 100;
+    constexpr auto dt = 1.0f / 60.0f;
+    std::cout << std::setw(10) << "bodies" << std::setw(16) << "per body" << std::setw(16) << "store" << "   (M bodies/s)\n";
+    for(const std::size_t count : {1000u, 10000u, 100000u}) {
+        Scene scene{count};
+        auto states = scene.states;
+        RigidBodyStore store{};
+        std::vector<RigidBodyStore::Handle> handles{};
+        for(const auto& state : scene.states) {
+            handles.push_back(store.Add(state));
+        }
+        auto start = std::chrono::steady_clock::now();
+        for(int step = 0; step < steps; ++step) {
+            for(std::size_t i = 0u; i < count; ++i) {
+                RigidBodyStore::Step(states[i], scene.forces[i], dt);
+            }
+        }
+        const auto per_body = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for(int step = 0; step < steps; ++step) {
+            for(std::size_t i = 0u; i < count; ++i) {
+                store.AddForce(handles[i], scene.forces[i]);
+            }
+            store.Integrate(dt);
+        }
+        const auto batched = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(store.GetPosition(handles[count / 2u]), states[count / 2u].position);
+        const auto rate = [count](double seconds) { return count * steps / seconds / 1.0e6; };
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(2) << std::setw(16) << rate(per_body) << std::setw(16) << rate(batched) << '\n';
+    }
+}
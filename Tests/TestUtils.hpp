@@ -0,0 +1,49 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+#include <random>
+
+namespace TestUtils {
+
+    //Seeded source for the random scenes tests build, so every run sees the same scene.
+    //Components are drawn in x, y, z order; a scene only changes if its seed or its sequence of draws does.
+    class Random {
+    public:
+        explicit Random(unsigned int seed)
+        : _rng{seed} {
+            /* DO NOTHING */
+        }
+
+        [[nodiscard]] float Value(float min, float max) {
+            return std::uniform_real_distribution<float>(min, max)(_rng);
+        }
+
+        [[nodiscard]] int Integer(int min, int max) {
+            return std::uniform_int_distribution<int>(min, max)(_rng);
+        }
+
+        [[nodiscard]] Vector2 Value2(float min, float max) {
+            return Vector2{Value(min, max), Value(min, max)};
+        }
+
+        [[nodiscard]] Vector3 Value3(float min, float max) {
+            return Vector3{Value(min, max), Value(min, max), Value(min, max)};
+        }
+
+        //Centered anywhere in [positionMin, positionMax] on both axes, with each half extent in [extentMin, extentMax].
+        [[nodiscard]] AABB2 Box(float positionMin, float positionMax, float extentMin, float extentMax) {
+            const auto center = Value2(positionMin, positionMax);
+            const auto half_extents = Value2(extentMin, extentMax);
+            return AABB2{center - half_extents, center + half_extents};
+        }
+
+    private:
+        std::mt19937 _rng;
+    };
+
+} // namespace TestUtils
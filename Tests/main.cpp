@@ -10,6 +10,42 @@
 
 #include "UuidTests.hpp"
 
+#include "JobSystemTests.hpp"
+
+#include "LockFreeQueueTests.hpp"
+
+#include "MemoryPoolTests.hpp"
+
+#include "AllocationProfilerTests.hpp"
+
+#include "ProfilerTests.hpp"
+
+#include "BroadPhaseTests.hpp"
+
+#include "QuadTreeTests.hpp"
+
+#include "NarrowPhaseTests.hpp"
+
+#include "RigidBodyStoreTests.hpp"
+
+#include "IslandBuilderTests.hpp"
+
+#include "FixedTimestepTests.hpp"
+
+#include "ConstraintSolverTests.hpp"
+
+#include "PhysicsSnapshotTests.hpp"
+
+#include "ParticlePoolTests.hpp"
+
+#include "ParticleDrawOrderTests.hpp"
+
+#include "ParticleInstanceTests.hpp"
+
+#include "ParticleBudgetTests.hpp"
+
+#include "ParticleEffectTests.hpp"
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();